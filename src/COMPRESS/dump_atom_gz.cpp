@@ -14,6 +14,7 @@
 #include "dump_atom_gz.h"
 #include "domain.h"
 #include "error.h"
+#include "force.h"
 #include "update.h"
 
 #include <string.h>
@@ -24,6 +25,8 @@ DumpAtomGZ::DumpAtomGZ(LAMMPS *lmp, int narg, char **arg) :
   DumpAtom(lmp, narg, arg)
 {
   gzFp = NULL;
+  gzlevel = 9;
+  gzthreads = 1;
 
   if (!compressed)
     error->all(FLERR,"Dump atom/gz only writes compressed files");
@@ -33,7 +36,8 @@ DumpAtomGZ::DumpAtomGZ(LAMMPS *lmp, int narg, char **arg) :
 
 DumpAtomGZ::~DumpAtomGZ()
 {
-  if (gzFp) gzclose(gzFp);
+  async_stop();
+  delete gzFp;
   gzFp = NULL;
   fp = NULL;
 }
@@ -76,13 +80,9 @@ void DumpAtomGZ::openfile()
   // each proc with filewriter = 1 opens a file
 
   if (filewriter) {
-    if (append_flag) {
-      gzFp = gzopen(filecurrent,"ab9");
-    } else {
-      gzFp = gzopen(filecurrent,"wb9");
-    }
-
-    if (gzFp == NULL) error->one(FLERR,"Cannot open dump file");
+    if (gzFp == NULL) gzFp = new GZWriter(gzthreads,gzlevel);
+    if (gzFp->open(filecurrent,append_flag))
+      error->one(FLERR,"Cannot open dump file");
   } else gzFp = NULL;
 
   // delete string with timestep replaced
@@ -94,27 +94,35 @@ void DumpAtomGZ::openfile()
 
 void DumpAtomGZ::write_header(bigint ndump)
 {
+  // if async, format into staging stream like the uncompressed style
+  // writer thread then compresses it
+
+  if (async_flag) {
+    DumpAtom::write_header(ndump);
+    return;
+  }
+
   if ((multiproc) || (!multiproc && me == 0)) {
     if (domain->triclinic == 0) {
-      gzprintf(gzFp,"ITEM: TIMESTEP\n");
-      gzprintf(gzFp,BIGINT_FORMAT "\n",update->ntimestep);
-      gzprintf(gzFp,"ITEM: NUMBER OF ATOMS\n");
-      gzprintf(gzFp,BIGINT_FORMAT "\n",ndump);
-      gzprintf(gzFp,"ITEM: BOX BOUNDS %s\n",boundstr);
-      gzprintf(gzFp,"%g %g\n",boxxlo,boxxhi);
-      gzprintf(gzFp,"%g %g\n",boxylo,boxyhi);
-      gzprintf(gzFp,"%g %g\n",boxzlo,boxzhi);
-      gzprintf(gzFp,"ITEM: ATOMS %s\n",columns);
+      gzFp->print("ITEM: TIMESTEP\n");
+      gzFp->print(BIGINT_FORMAT "\n",update->ntimestep);
+      gzFp->print("ITEM: NUMBER OF ATOMS\n");
+      gzFp->print(BIGINT_FORMAT "\n",ndump);
+      gzFp->print("ITEM: BOX BOUNDS %s\n",boundstr);
+      gzFp->print("%g %g\n",boxxlo,boxxhi);
+      gzFp->print("%g %g\n",boxylo,boxyhi);
+      gzFp->print("%g %g\n",boxzlo,boxzhi);
+      gzFp->print("ITEM: ATOMS %s\n",columns);
     } else {
-      gzprintf(gzFp,"ITEM: TIMESTEP\n");
-      gzprintf(gzFp,BIGINT_FORMAT "\n",update->ntimestep);
-      gzprintf(gzFp,"ITEM: NUMBER OF ATOMS\n");
-      gzprintf(gzFp,BIGINT_FORMAT "\n",ndump);
-      gzprintf(gzFp,"ITEM: BOX BOUNDS xy xz yz %s\n",boundstr);
-      gzprintf(gzFp,"%g %g %g\n",boxxlo,boxxhi,boxxy);
-      gzprintf(gzFp,"%g %g %g\n",boxylo,boxyhi,boxxz);
-      gzprintf(gzFp,"%g %g %g\n",boxzlo,boxzhi,boxyz);
-      gzprintf(gzFp,"ITEM: ATOMS %s\n",columns);
+      gzFp->print("ITEM: TIMESTEP\n");
+      gzFp->print(BIGINT_FORMAT "\n",update->ntimestep);
+      gzFp->print("ITEM: NUMBER OF ATOMS\n");
+      gzFp->print(BIGINT_FORMAT "\n",ndump);
+      gzFp->print("ITEM: BOX BOUNDS xy xz yz %s\n",boundstr);
+      gzFp->print("%g %g %g\n",boxxlo,boxxhi,boxxy);
+      gzFp->print("%g %g %g\n",boxylo,boxyhi,boxxz);
+      gzFp->print("%g %g %g\n",boxzlo,boxzhi,boxyz);
+      gzFp->print("ITEM: ATOMS %s\n",columns);
     }
   }
 }
@@ -123,7 +131,8 @@ void DumpAtomGZ::write_header(bigint ndump)
 
 void DumpAtomGZ::write_data(int n, double *mybuf)
 {
-  gzwrite(gzFp,mybuf,sizeof(char)*n);
+  if (async_flag) DumpAtom::write_data(n,mybuf);
+  else gzFp->write(mybuf,sizeof(char)*n);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -131,14 +140,60 @@ void DumpAtomGZ::write_data(int n, double *mybuf)
 void DumpAtomGZ::write()
 {
   DumpAtom::write();
-  if (filewriter) {
+  if (filewriter && async_flag) {
+    if (multifile) gzFp = NULL;
+  } else if (filewriter) {
     if (multifile) {
-      gzclose(gzFp);
-      gzFp = NULL;
+      gzFp->close();
     } else {
       if (flush_flag)
-        gzflush(gzFp,Z_SYNC_FLUSH);
+        gzFp->flush();
     }
   }
 }
 
+/* ----------------------------------------------------------------------
+   output of queued snapshots by writer thread, compressed by its own GZWriter
+------------------------------------------------------------------------- */
+
+void DumpAtomGZ::async_write(void *handle, char *text, size_t nbytes)
+{
+  ((GZWriter *) handle)->write(text,nbytes);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void DumpAtomGZ::async_flush(void *handle)
+{
+  ((GZWriter *) handle)->flush();
+}
+
+/* ---------------------------------------------------------------------- */
+
+void DumpAtomGZ::async_close(void *handle)
+{
+  delete (GZWriter *) handle;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int DumpAtomGZ::modify_param(int narg, char **arg)
+{
+  if (strcmp(arg[0],"compression_level") == 0) {
+    if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+    gzlevel = force->inumeric(FLERR,arg[1]);
+    if (gzlevel < 0 || gzlevel > 9)
+      error->all(FLERR,"Dump atom/gz compression level is invalid");
+    return 2;
+  }
+
+  if (strcmp(arg[0],"compression_threads") == 0) {
+    if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+    gzthreads = force->inumeric(FLERR,arg[1]);
+    if (gzthreads < 1)
+      error->all(FLERR,"Dump atom/gz compression threads is invalid");
+    return 2;
+  }
+
+  return DumpAtom::modify_param(narg,arg);
+}
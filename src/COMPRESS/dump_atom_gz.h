@@ -21,7 +21,7 @@ DumpStyle(atom/gz,DumpAtomGZ)
 #define LMP_DUMP_ATOM_GZ_H
 
 #include "dump_atom.h"
-#include <zlib.h>
+#include "gz_writer.h"
 
 namespace LAMMPS_NS {
 
@@ -31,12 +31,20 @@ class DumpAtomGZ : public DumpAtom {
   virtual ~DumpAtomGZ();
 
  protected:
-  gzFile gzFp;  // file pointer for the compressed output stream
+  GZWriter *gzFp;      // block-parallel writer of the compressed stream
+  int gzlevel;         // zlib compression level
+  int gzthreads;       // # of compression threads per file writer
 
   virtual void openfile();
   virtual void write_header(bigint);
   virtual void write_data(int, double *);
   virtual void write();
+  virtual int modify_param(int, char **);
+
+  virtual void *async_handle() {return gzFp;}
+  virtual void async_write(void *, char *, size_t);
+  virtual void async_flush(void *);
+  virtual void async_close(void *);
 };
 
 }
@@ -54,4 +62,18 @@ E: Cannot open dump file
 
 Self-explanatory.
 
+E: Dump atom/gz compression level is invalid
+
+The level must be from 0 (no compression) to 9.
+
+E: Dump atom/gz compression threads is invalid
+
+The number of compression threads must be 1 or more.
+
+E: Illegal dump_modify command
+
+Self-explanatory.  Check the input script syntax and compare to the
+documentation for the command.  You can use -echo screen as a
+command-line option when running LAMMPS to see the offending line.
+
 */
@@ -15,6 +15,7 @@
 #include "atom.h"
 #include "domain.h"
 #include "error.h"
+#include "force.h"
 #include "update.h"
 
 #include <string.h>
@@ -26,6 +27,8 @@ DumpCFGGZ::DumpCFGGZ(LAMMPS *lmp, int narg, char **arg) :
   DumpCFG(lmp, narg, arg)
 {
   gzFp = NULL;
+  gzlevel = 9;
+  gzthreads = 1;
 
   if (!compressed)
     error->all(FLERR,"Dump cfg/gz only writes compressed files");
@@ -36,7 +39,8 @@ DumpCFGGZ::DumpCFGGZ(LAMMPS *lmp, int narg, char **arg) :
 
 DumpCFGGZ::~DumpCFGGZ()
 {
-  if (gzFp) gzclose(gzFp);
+  async_stop();
+  delete gzFp;
   gzFp = NULL;
   fp = NULL;
 }
@@ -80,13 +84,9 @@ void DumpCFGGZ::openfile()
   // each proc with filewriter = 1 opens a file
 
   if (filewriter) {
-    if (append_flag) {
-      gzFp = gzopen(filecurrent,"ab9");
-    } else {
-      gzFp = gzopen(filecurrent,"wb9");
-    }
-
-    if (gzFp == NULL) error->one(FLERR,"Cannot open dump file");
+    if (gzFp == NULL) gzFp = new GZWriter(gzthreads,gzlevel);
+    if (gzFp->open(filecurrent,append_flag))
+      error->one(FLERR,"Cannot open dump file");
   } else gzFp = NULL;
 
   // delete string with timestep replaced
@@ -98,6 +98,14 @@ void DumpCFGGZ::openfile()
 
 void DumpCFGGZ::write_header(bigint n)
 {
+  // if async, format into staging stream like the uncompressed style
+  // writer thread then compresses it
+
+  if (async_flag) {
+    DumpCFG::write_header(n);
+    return;
+  }
+
   // set scale factor used by AtomEye for CFG viz
   // default = 1.0
   // for peridynamics, set to pre-computed PD scale factor
@@ -111,28 +119,29 @@ void DumpCFGGZ::write_header(bigint n)
 
   char str[64];
   sprintf(str,"Number of particles = %s\n",BIGINT_FORMAT);
-  gzprintf(gzFp,str,n);
-  gzprintf(gzFp,"A = %g Angstrom (basic length-scale)\n",scale);
-  gzprintf(gzFp,"H0(1,1) = %g A\n",domain->xprd);
-  gzprintf(gzFp,"H0(1,2) = 0 A \n");
-  gzprintf(gzFp,"H0(1,3) = 0 A \n");
-  gzprintf(gzFp,"H0(2,1) = %g A \n",domain->xy);
-  gzprintf(gzFp,"H0(2,2) = %g A\n",domain->yprd);
-  gzprintf(gzFp,"H0(2,3) = 0 A \n");
-  gzprintf(gzFp,"H0(3,1) = %g A \n",domain->xz);
-  gzprintf(gzFp,"H0(3,2) = %g A \n",domain->yz);
-  gzprintf(gzFp,"H0(3,3) = %g A\n",domain->zprd);
-  gzprintf(gzFp,".NO_VELOCITY.\n");
-  gzprintf(gzFp,"entry_count = %d\n",nfield-2);
+  gzFp->print(str,n);
+  gzFp->print("A = %g Angstrom (basic length-scale)\n",scale);
+  gzFp->print("H0(1,1) = %g A\n",domain->xprd);
+  gzFp->print("H0(1,2) = 0 A \n");
+  gzFp->print("H0(1,3) = 0 A \n");
+  gzFp->print("H0(2,1) = %g A \n",domain->xy);
+  gzFp->print("H0(2,2) = %g A\n",domain->yprd);
+  gzFp->print("H0(2,3) = 0 A \n");
+  gzFp->print("H0(3,1) = %g A \n",domain->xz);
+  gzFp->print("H0(3,2) = %g A \n",domain->yz);
+  gzFp->print("H0(3,3) = %g A\n",domain->zprd);
+  gzFp->print(".NO_VELOCITY.\n");
+  gzFp->print("entry_count = %d\n",nfield-2);
   for (int i = 0; i < nfield-5; i++)
-    gzprintf(gzFp,"auxiliary[%d] = %s\n",i,auxname[i]);
+    gzFp->print("auxiliary[%d] = %s\n",i,auxname[i]);
 }
 
 /* ---------------------------------------------------------------------- */
 
 void DumpCFGGZ::write_data(int n, double *mybuf)
 {
-  gzwrite(gzFp,mybuf,sizeof(char)*n);
+  if (async_flag) DumpCFG::write_data(n,mybuf);
+  else gzFp->write(mybuf,sizeof(char)*n);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -140,14 +149,60 @@ void DumpCFGGZ::write_data(int n, double *mybuf)
 void DumpCFGGZ::write()
 {
   DumpCFG::write();
-  if (filewriter) {
+  if (filewriter && async_flag) {
+    if (multifile) gzFp = NULL;
+  } else if (filewriter) {
     if (multifile) {
-      gzclose(gzFp);
-      gzFp = NULL;
+      gzFp->close();
     } else {
       if (flush_flag)
-        gzflush(gzFp,Z_SYNC_FLUSH);
+        gzFp->flush();
     }
   }
 }
 
+/* ----------------------------------------------------------------------
+   output of queued snapshots by writer thread, compressed by its own GZWriter
+------------------------------------------------------------------------- */
+
+void DumpCFGGZ::async_write(void *handle, char *text, size_t nbytes)
+{
+  ((GZWriter *) handle)->write(text,nbytes);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void DumpCFGGZ::async_flush(void *handle)
+{
+  ((GZWriter *) handle)->flush();
+}
+
+/* ---------------------------------------------------------------------- */
+
+void DumpCFGGZ::async_close(void *handle)
+{
+  delete (GZWriter *) handle;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int DumpCFGGZ::modify_param(int narg, char **arg)
+{
+  if (strcmp(arg[0],"compression_level") == 0) {
+    if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+    gzlevel = force->inumeric(FLERR,arg[1]);
+    if (gzlevel < 0 || gzlevel > 9)
+      error->all(FLERR,"Dump cfg/gz compression level is invalid");
+    return 2;
+  }
+
+  if (strcmp(arg[0],"compression_threads") == 0) {
+    if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+    gzthreads = force->inumeric(FLERR,arg[1]);
+    if (gzthreads < 1)
+      error->all(FLERR,"Dump cfg/gz compression threads is invalid");
+    return 2;
+  }
+
+  return DumpCFG::modify_param(narg,arg);
+}
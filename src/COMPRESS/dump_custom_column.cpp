@@ -0,0 +1,448 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+#include "dump_custom_column.h"
+#include "domain.h"
+#include "update.h"
+#include "force.h"
+#include "memory.h"
+#include "error.h"
+
+using namespace LAMMPS_NS;
+
+// file layout = sequence of blocks, each starting with 8-char magic
+//   and bigint # of bytes in the rest of the block
+// HEAD block = version, # of columns, # of atom types,
+//   datatype of each column, column names, element names
+// FRAME block = timestep, # of atoms, box, chunk directory, chunks
+//   directory has offset, size, # of atoms, codec of every chunk,
+//   ordered by column, then chunk
+// INDEX block = # of frames, timestep and offset of each frame,
+//   last 16 bytes are offset of INDEX block and END magic,
+//   so a reader can find it from the end of the file
+
+#define VERSION 1
+#define CHUNKSIZE 65536
+#define MAGIC_HEAD "LMPCOLHD"
+#define MAGIC_FRAME "LMPCOLFR"
+#define MAGIC_INDEX "LMPCOLIX"
+#define MAGIC_END "LMPCOLEN"
+
+enum{INT,DOUBLE,STRING,BIGINT};    // same as in DumpCustom
+enum{COL_INT32=1,COL_INT64,COL_FLOAT,COL_DOUBLE};
+
+// codec bits of a chunk, applied in this order when writing
+
+#define CODEC_DELTA 1             // integers stored as differences
+#define CODEC_SHUFFLE 2           // bytes of values transposed
+#define CODEC_ZLIB 4              // zlib compressed
+
+/* ---------------------------------------------------------------------- */
+
+DumpCustomColumn::DumpCustomColumn(LAMMPS *lmp, int narg, char **arg) :
+  DumpCustom(lmp, narg, arg)
+{
+  if (compressed)
+    error->all(FLERR,"Dump custom/column cannot write a gzipped file");
+
+  // values must reach write_data() as doubles, not formatted strings
+
+  buffer_allow = 0;
+  buffer_flag = 0;
+
+  chunksize = CHUNKSIZE;
+  floatflag = 0;
+  level = 6;
+
+  coltype = new int[size_one];
+
+  filepos = 0;
+  nindex = maxindex = 0;
+  index_step = index_offset = NULL;
+
+  ndump = nrow = maxrow = 0;
+  rows = NULL;
+
+  maxchunk = 0;
+  raw = shuffled = NULL;
+  packed = NULL;
+  maxframe = 0;
+  framebuf = NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+
+DumpCustomColumn::~DumpCustomColumn()
+{
+  // single file gets its index once all frames are written
+
+  async_stop();
+  if (filewriter && fp && !multifile && nindex) write_index();
+
+  delete [] coltype;
+  memory->destroy(index_step);
+  memory->destroy(index_offset);
+  memory->sfree(rows);
+  memory->sfree(raw);
+  memory->sfree(shuffled);
+  memory->sfree(packed);
+  memory->sfree(framebuf);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void DumpCustomColumn::init_style()
+{
+  DumpCustom::init_style();
+
+  // element names are stored as type indices, names go in HEAD block
+
+  for (int i = 0; i < size_one; i++) {
+    if (vtype[i] == INT || vtype[i] == STRING) coltype[i] = COL_INT32;
+    else if (vtype[i] == BIGINT) coltype[i] = COL_INT64;
+    else if (floatflag) coltype[i] = COL_FLOAT;
+    else coltype[i] = COL_DOUBLE;
+  }
+
+  if (chunksize > maxchunk) {
+    maxchunk = chunksize;
+    bigint nbytes = (bigint) maxchunk * sizeof(double);
+    raw = (char *) memory->srealloc(raw,nbytes,"dump:raw");
+    shuffled = (char *) memory->srealloc(shuffled,nbytes,"dump:shuffled");
+    packed = (unsigned char *)
+      memory->srealloc(packed,compressBound(nbytes),"dump:packed");
+  }
+}
+
+/* ----------------------------------------------------------------------
+   open file via Dump, then reset per-file offsets and frame index
+------------------------------------------------------------------------- */
+
+void DumpCustomColumn::openfile()
+{
+  int opened = multifile || !singlefile_opened;
+  Dump::openfile();
+  if (!opened) return;
+
+  filepos = 0;
+  nindex = 0;
+  if (append_flag && fp) {
+    fseek(fp,0,SEEK_END);
+    filepos = ftell(fp);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   start gathering a frame of ndump atoms
+   frame is written by write_data() once all atoms have arrived
+------------------------------------------------------------------------- */
+
+void DumpCustomColumn::write_header(bigint n)
+{
+  ndump = n;
+  nrow = 0;
+  if (ndump > maxrow) {
+    maxrow = ndump;
+    rows = (double *)
+      memory->srealloc(rows,maxrow*size_one*sizeof(double),"dump:rows");
+  }
+  if (ndump == 0) write_frame();
+}
+
+/* ---------------------------------------------------------------------- */
+
+void DumpCustomColumn::write_data(int n, double *mybuf)
+{
+  memcpy(&rows[nrow*size_one],mybuf,(bigint) n*size_one*sizeof(double));
+  nrow += n;
+  if (nrow == ndump) write_frame();
+}
+
+/* ----------------------------------------------------------------------
+   write HEAD block at start of each file
+------------------------------------------------------------------------- */
+
+void DumpCustomColumn::write_file_header()
+{
+  int ncol = size_one;
+  int ntype = ntypes;
+  int version = VERSION;
+  int ncolumns = strlen(columns) + 1;
+
+  bigint nbytes = 3*sizeof(int) + ncol*sizeof(int) + sizeof(int) + ncolumns;
+  for (int i = 1; i <= ntypes; i++)
+    nbytes += sizeof(int) + strlen(typenames[i]) + 1;
+
+  output(MAGIC_HEAD,8);
+  output(&nbytes,sizeof(bigint));
+  output(&version,sizeof(int));
+  output(&ncol,sizeof(int));
+  output(&ntype,sizeof(int));
+  output(coltype,ncol*sizeof(int));
+  output(&ncolumns,sizeof(int));
+  output(columns,ncolumns);
+  for (int i = 1; i <= ntypes; i++) {
+    int n = strlen(typenames[i]) + 1;
+    output(&n,sizeof(int));
+    output(typenames[i],n);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   encode all chunks of all columns of gathered frame, then write
+   FRAME block = frame info, chunk directory, encoded chunks
+------------------------------------------------------------------------- */
+
+void DumpCustomColumn::write_frame()
+{
+  if (nindex == 0) write_file_header();
+
+  int ncol = size_one;
+  int nchunk = (ndump + chunksize-1) / chunksize;
+  bigint ndir = (bigint) ncol*nchunk;
+
+  // frame info, then one directory entry per chunk
+
+  int triclinic = domain->triclinic;
+  double box[9];
+  box[0] = boxxlo; box[1] = boxxhi;
+  box[2] = boxylo; box[3] = boxyhi;
+  box[4] = boxzlo; box[5] = boxzhi;
+  box[6] = box[7] = box[8] = 0.0;
+  if (triclinic) {
+    box[6] = boxxy;
+    box[7] = boxxz;
+    box[8] = boxyz;
+  }
+
+  bigint ninfo = 2*sizeof(bigint) + 7*sizeof(int) + 9*sizeof(double) +
+    4*sizeof(int);
+  bigint nentry = 2*sizeof(bigint) + 2*sizeof(int);
+  bigint nhead = 16 + ninfo + ndir*nentry;
+
+  bigint *dir_offset = new bigint[ndir];
+  bigint *dir_bytes = new bigint[ndir];
+  int *dir_natom = new int[ndir];
+  int *dir_codec = new int[ndir];
+
+  // encode chunks into framebuf, offsets are from start of FRAME block
+
+  bigint nframe = 0;
+  int m = 0;
+  for (int icol = 0; icol < ncol; icol++)
+    for (int ichunk = 0; ichunk < nchunk; ichunk++) {
+      bigint first = (bigint) ichunk*chunksize;
+      int n = static_cast<int> (MIN(chunksize,ndump-first));
+      int codec;
+      int nbytes = encode_chunk(icol,first,n,codec);
+      if (nframe + nbytes > maxframe) {
+        maxframe = 2*(nframe + nbytes);
+        framebuf = (char *) memory->srealloc(framebuf,maxframe,"dump:frame");
+      }
+      memcpy(&framebuf[nframe],packed,nbytes);
+      dir_offset[m] = nhead + nframe;
+      dir_bytes[m] = nbytes;
+      dir_natom[m] = n;
+      dir_codec[m] = codec;
+      nframe += nbytes;
+      m++;
+    }
+
+  // add frame to index of this file
+
+  if (nindex == maxindex) {
+    maxindex += 64;
+    memory->grow(index_step,maxindex,"dump:index_step");
+    memory->grow(index_offset,maxindex,"dump:index_offset");
+  }
+  index_step[nindex] = update->ntimestep;
+  index_offset[nindex] = filepos;
+  nindex++;
+
+  bigint nblock = nhead - 16 + nframe;
+  int zero = 0;
+
+  output(MAGIC_FRAME,8);
+  output(&nblock,sizeof(bigint));
+  output(&update->ntimestep,sizeof(bigint));
+  output(&ndump,sizeof(bigint));
+  output(&triclinic,sizeof(int));
+  output(&domain->boundary[0][0],6*sizeof(int));
+  output(box,9*sizeof(double));
+  output(&ncol,sizeof(int));
+  output(&chunksize,sizeof(int));
+  output(&nchunk,sizeof(int));
+  output(&zero,sizeof(int));
+  for (m = 0; m < ndir; m++) {
+    output(&dir_offset[m],sizeof(bigint));
+    output(&dir_bytes[m],sizeof(bigint));
+    output(&dir_natom[m],sizeof(int));
+    output(&dir_codec[m],sizeof(int));
+  }
+  output(framebuf,nframe);
+
+  delete [] dir_offset;
+  delete [] dir_bytes;
+  delete [] dir_natom;
+  delete [] dir_codec;
+
+  // file with one frame per timestep gets its index right away
+
+  if (multifile) write_index();
+}
+
+/* ----------------------------------------------------------------------
+   write INDEX block of frames in current file
+------------------------------------------------------------------------- */
+
+void DumpCustomColumn::write_index()
+{
+  bigint offset = filepos;
+  bigint n = nindex;
+  bigint nbytes = sizeof(bigint) + 2*n*sizeof(bigint) + sizeof(bigint) + 8;
+
+  output(MAGIC_INDEX,8);
+  output(&nbytes,sizeof(bigint));
+  output(&n,sizeof(bigint));
+  output(index_step,n*sizeof(bigint));
+  output(index_offset,n*sizeof(bigint));
+  output(&offset,sizeof(bigint));
+  output(MAGIC_END,8);
+  if (flush_flag && !async_flag) fflush(fp);
+}
+
+/* ----------------------------------------------------------------------
+   encode N values of column icol of gathered frame starting at row first
+   convert to native type of column, delta integers, shuffle bytes,
+     then zlib compress if that makes chunk smaller
+   return # of bytes of encoded chunk in packed, and its codec
+------------------------------------------------------------------------- */
+
+int DumpCustomColumn::encode_chunk(int icol, bigint first, int n, int &codec)
+{
+  int i,j;
+
+  double *value = &rows[first*size_one + icol];
+  int width;
+
+  codec = CODEC_SHUFFLE;
+
+  if (coltype[icol] == COL_INT32) {
+    width = sizeof(int32_t);
+    int32_t *ivec = (int32_t *) raw;
+    uint32_t prev = 0;
+    for (i = 0; i < n; i++) {
+      uint32_t v = (uint32_t) static_cast<int32_t> (value[i*size_one]);
+      ivec[i] = (int32_t) (v - prev);
+      prev = v;
+    }
+    codec |= CODEC_DELTA;
+  } else if (coltype[icol] == COL_INT64) {
+    width = sizeof(int64_t);
+    int64_t *ivec = (int64_t *) raw;
+    uint64_t prev = 0;
+    for (i = 0; i < n; i++) {
+      uint64_t v = (uint64_t) static_cast<int64_t> (value[i*size_one]);
+      ivec[i] = (int64_t) (v - prev);
+      prev = v;
+    }
+    codec |= CODEC_DELTA;
+  } else if (coltype[icol] == COL_FLOAT) {
+    width = sizeof(float);
+    float *fvec = (float *) raw;
+    for (i = 0; i < n; i++) fvec[i] = value[i*size_one];
+  } else {
+    width = sizeof(double);
+    double *dvec = (double *) raw;
+    for (i = 0; i < n; i++) dvec[i] = value[i*size_one];
+  }
+
+  // byte j of value i goes to position j*n + i
+
+  for (i = 0; i < n; i++)
+    for (j = 0; j < width; j++)
+      shuffled[j*n + i] = raw[i*width + j];
+
+  int nbytes = n*width;
+  if (level != 0) {
+    uLongf npacked = compressBound(nbytes);
+    if (compress2(packed,&npacked,(Bytef *) shuffled,nbytes,level) == Z_OK &&
+        npacked < (uLongf) nbytes) {
+      codec |= CODEC_ZLIB;
+      return npacked;
+    }
+  }
+
+  memcpy(packed,shuffled,nbytes);
+  return nbytes;
+}
+
+/* ----------------------------------------------------------------------
+   write bytes to file and track file offset
+   offset is tracked here, since fp is a staging stream for async output
+------------------------------------------------------------------------- */
+
+void DumpCustomColumn::output(const void *ptr, bigint nbytes)
+{
+  fwrite(ptr,1,nbytes,fp);
+  filepos += nbytes;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int DumpCustomColumn::modify_param(int narg, char **arg)
+{
+  if (strcmp(arg[0],"chunksize") == 0) {
+    if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+    chunksize = force->inumeric(FLERR,arg[1]);
+    if (chunksize <= 0)
+      error->all(FLERR,"Dump custom/column chunk size is invalid");
+    return 2;
+  }
+
+  if (strcmp(arg[0],"compression_level") == 0) {
+    if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+    level = force->inumeric(FLERR,arg[1]);
+    if (level < 0 || level > 9)
+      error->all(FLERR,"Dump custom/column compression level is invalid");
+    return 2;
+  }
+
+  if (strcmp(arg[0],"float") == 0) {
+    if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+    if (strcmp(arg[1],"yes") == 0) floatflag = 1;
+    else if (strcmp(arg[1],"no") == 0) floatflag = 0;
+    else error->all(FLERR,"Illegal dump_modify command");
+    return 2;
+  }
+
+  return DumpCustom::modify_param(narg,arg);
+}
+
+/* ----------------------------------------------------------------------
+   return # of bytes of allocated memory in buf, choose, variable arrays
+------------------------------------------------------------------------- */
+
+bigint DumpCustomColumn::memory_usage()
+{
+  bigint bytes = DumpCustom::memory_usage();
+  bytes += maxrow*size_one * sizeof(double);
+  bytes += 2 * (bigint) maxchunk*sizeof(double);
+  if (maxchunk) bytes += compressBound(maxchunk*sizeof(double));
+  bytes += maxframe;
+  bytes += 2*maxindex * sizeof(bigint);
+  return bytes;
+}
@@ -0,0 +1,94 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifdef DUMP_CLASS
+
+DumpStyle(custom/column,DumpCustomColumn)
+
+#else
+
+#ifndef LMP_DUMP_CUSTOM_COLUMN_H
+#define LMP_DUMP_CUSTOM_COLUMN_H
+
+#include "dump_custom.h"
+
+namespace LAMMPS_NS {
+
+class DumpCustomColumn : public DumpCustom {
+ public:
+  DumpCustomColumn(class LAMMPS *, int, char **);
+  virtual ~DumpCustomColumn();
+
+ protected:
+  int chunksize;             // max # of atoms in one compressed chunk
+  int floatflag;             // 1 to store double columns as float
+  int level;                 // zlib compression level, 0 = none
+  int *coltype;              // datatype of each column in file
+
+  bigint filepos;            // # of bytes written to current file
+  int nindex,maxindex;       // # of frames in current file, size of index
+  bigint *index_step;        // timestep of each frame in current file
+  bigint *index_offset;      // file offset of each frame
+
+  bigint ndump;              // # of atoms in frame being gathered
+  bigint nrow;               // # of atoms gathered so far
+  bigint maxrow;             // size of rows
+  double *rows;              // gathered per-atom values of frame
+
+  int maxchunk;              // size of raw/shuffled/packed chunk buffers
+  char *raw,*shuffled;
+  unsigned char *packed;
+  bigint maxframe;           // size of framebuf
+  char *framebuf;            // encoded chunks of frame being written
+
+  virtual void init_style();
+  virtual void openfile();
+  virtual void write_header(bigint);
+  virtual void write_data(int, double *);
+  virtual int modify_param(int, char **);
+  bigint memory_usage();
+
+  void write_file_header();
+  void write_frame();
+  void write_index();
+  int encode_chunk(int, bigint, int, int &);
+  void output(const void *, bigint);
+};
+
+}
+
+#endif
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Dump custom/column cannot write a gzipped file
+
+Compression is done per column chunk inside the file, so the file
+name cannot end in .gz.
+
+E: Dump custom/column chunk size is invalid
+
+The chunk size must be a positive number of atoms.
+
+E: Dump custom/column compression level is invalid
+
+The level must be from 0 (no zlib compression) to 9.
+
+E: Illegal dump_modify command
+
+Self-explanatory.  Check the input script syntax and compare to the
+documentation for the command.  You can use -echo screen as a
+command-line option when running LAMMPS to see the offending line.
+
+*/
@@ -14,6 +14,7 @@
 #include "dump_xyz_gz.h"
 #include "domain.h"
 #include "error.h"
+#include "force.h"
 #include "update.h"
 
 #include <string.h>
@@ -24,6 +25,8 @@ DumpXYZGZ::DumpXYZGZ(LAMMPS *lmp, int narg, char **arg) :
   DumpXYZ(lmp, narg, arg)
 {
   gzFp = NULL;
+  gzlevel = 9;
+  gzthreads = 1;
 
   if (!compressed)
     error->all(FLERR,"Dump xyz/gz only writes compressed files");
@@ -34,7 +37,7 @@ DumpXYZGZ::DumpXYZGZ(LAMMPS *lmp, int narg, char **arg) :
 
 DumpXYZGZ::~DumpXYZGZ()
 {
-  if (gzFp) gzclose(gzFp);
+  delete gzFp;
   gzFp = NULL;
   fp = NULL;
 }
@@ -78,13 +81,9 @@ void DumpXYZGZ::openfile()
   // each proc with filewriter = 1 opens a file
 
   if (filewriter) {
-    if (append_flag) {
-      gzFp = gzopen(filecurrent,"ab9");
-    } else {
-      gzFp = gzopen(filecurrent,"wb9");
-    }
-
-    if (gzFp == NULL) error->one(FLERR,"Cannot open dump file");
+    if (gzFp == NULL) gzFp = new GZWriter(gzthreads,gzlevel);
+    if (gzFp->open(filecurrent,append_flag))
+      error->one(FLERR,"Cannot open dump file");
   } else gzFp = NULL;
 
   // delete string with timestep replaced
@@ -95,8 +94,8 @@ void DumpXYZGZ::openfile()
 void DumpXYZGZ::write_header(bigint ndump)
 {
   if (me == 0) {
-    gzprintf(gzFp,BIGINT_FORMAT "\n",ndump);
-    gzprintf(gzFp,"Atoms. Timestep: " BIGINT_FORMAT "\n",update->ntimestep);
+    gzFp->print(BIGINT_FORMAT "\n",ndump);
+    gzFp->print("Atoms. Timestep: " BIGINT_FORMAT "\n",update->ntimestep);
   }
 }
 
@@ -104,7 +103,7 @@ void DumpXYZGZ::write_header(bigint ndump)
 
 void DumpXYZGZ::write_data(int n, double *mybuf)
 {
-  gzwrite(gzFp,mybuf,sizeof(char)*n);
+  gzFp->write(mybuf,sizeof(char)*n);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -114,11 +113,33 @@ void DumpXYZGZ::write()
   DumpXYZ::write();
   if (filewriter) {
     if (multifile) {
-      gzclose(gzFp);
-      gzFp = NULL;
+      gzFp->close();
     } else {
       if (flush_flag)
-        gzflush(gzFp,Z_SYNC_FLUSH);
+        gzFp->flush();
     }
   }
 }
+
+/* ---------------------------------------------------------------------- */
+
+int DumpXYZGZ::modify_param(int narg, char **arg)
+{
+  if (strcmp(arg[0],"compression_level") == 0) {
+    if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+    gzlevel = force->inumeric(FLERR,arg[1]);
+    if (gzlevel < 0 || gzlevel > 9)
+      error->all(FLERR,"Dump xyz/gz compression level is invalid");
+    return 2;
+  }
+
+  if (strcmp(arg[0],"compression_threads") == 0) {
+    if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+    gzthreads = force->inumeric(FLERR,arg[1]);
+    if (gzthreads < 1)
+      error->all(FLERR,"Dump xyz/gz compression threads is invalid");
+    return 2;
+  }
+
+  return DumpXYZ::modify_param(narg,arg);
+}
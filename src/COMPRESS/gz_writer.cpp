@@ -0,0 +1,277 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <zlib.h>
+#include "gz_writer.h"
+
+using namespace LAMMPS_NS;
+
+#define BLOCKSIZE 131072        // bytes of input per gzip member
+#define MAXTHREADS 64
+
+enum{FREE,QUEUED,BUSY,DONE};
+
+/* ---------------------------------------------------------------------- */
+
+GZWriter::GZWriter(int nthreads_caller, int level_caller)
+{
+  fp = NULL;
+  level = level_caller;
+  nthreads = nthreads_caller;
+  if (nthreads <= 1) nthreads = 0;
+  if (nthreads > MAXTHREADS) nthreads = MAXTHREADS;
+
+  // 2 blocks per thread, so caller can fill one while another compresses
+
+  nblock = nthreads ? 2*nthreads : 1;
+  blocks = new Block[nblock];
+
+  z_stream strm;
+  memset(&strm,0,sizeof(z_stream));
+  deflateInit2(&strm,level,Z_DEFLATED,15+16,8,Z_DEFAULT_STRATEGY);
+  maxout = deflateBound(&strm,BLOCKSIZE);
+  deflateEnd(&strm);
+
+  for (int i = 0; i < nblock; i++) {
+    blocks[i].in = (char *) malloc(BLOCKSIZE);
+    blocks[i].out = (unsigned char *) malloc(maxout);
+    blocks[i].nin = blocks[i].nout = 0;
+    blocks[i].state = FREE;
+  }
+  ifill = icompress = iwrite = 0;
+
+  maxline = 256;
+  line = (char *) malloc(maxline);
+
+  threads = NULL;
+  done = 0;
+  if (nthreads) {
+    pthread_mutex_init(&mutex,NULL);
+    pthread_cond_init(&cond,NULL);
+    threads = new pthread_t[nthreads];
+    for (int i = 0; i < nthreads; i++)
+      pthread_create(&threads[i],NULL,&GZWriter::loop,this);
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+
+GZWriter::~GZWriter()
+{
+  close();
+
+  if (nthreads) {
+    pthread_mutex_lock(&mutex);
+    done = 1;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+    for (int i = 0; i < nthreads; i++) pthread_join(threads[i],NULL);
+    delete [] threads;
+    pthread_cond_destroy(&cond);
+    pthread_mutex_destroy(&mutex);
+  }
+
+  for (int i = 0; i < nblock; i++) {
+    free(blocks[i].in);
+    free(blocks[i].out);
+  }
+  delete [] blocks;
+  free(line);
+}
+
+/* ----------------------------------------------------------------------
+   open file for writing, or appending if append is set
+   return 0 if successful, 1 if file cannot be opened
+------------------------------------------------------------------------- */
+
+int GZWriter::open(const char *filename, int append)
+{
+  close();
+  if (append) fp = fopen(filename,"ab");
+  else fp = fopen(filename,"wb");
+  if (fp == NULL) return 1;
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   append n bytes of buf to the file
+   each full block is handed off for compression
+------------------------------------------------------------------------- */
+
+void GZWriter::write(const void *buf, size_t n)
+{
+  const char *ptr = (const char *) buf;
+
+  while (n) {
+    Block *b = &blocks[ifill];
+    size_t m = BLOCKSIZE - b->nin;
+    if (m > n) m = n;
+    memcpy(&b->in[b->nin],ptr,m);
+    b->nin += m;
+    ptr += m;
+    n -= m;
+    if (b->nin == BLOCKSIZE) submit();
+  }
+}
+
+/* ----------------------------------------------------------------------
+   append printf-formatted text to the file
+------------------------------------------------------------------------- */
+
+void GZWriter::print(const char *format, ...)
+{
+  va_list args;
+  va_start(args,format);
+  int n = vsnprintf(line,maxline,format,args);
+  va_end(args);
+
+  if (n >= maxline) {
+    maxline = n+1;
+    line = (char *) realloc(line,maxline);
+    va_start(args,format);
+    vsnprintf(line,maxline,format,args);
+    va_end(args);
+  }
+
+  if (n > 0) write(line,n);
+}
+
+/* ----------------------------------------------------------------------
+   compress and write all buffered data, then flush the file
+   ends the current gzip member, so a reader sees complete lines
+------------------------------------------------------------------------- */
+
+void GZWriter::flush()
+{
+  if (fp == NULL) return;
+  if (blocks[ifill].nin) submit();
+  drain(nblock);
+  fflush(fp);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void GZWriter::close()
+{
+  if (fp == NULL) return;
+  if (blocks[ifill].nin) submit();
+  drain(nblock);
+  fclose(fp);
+  fp = NULL;
+}
+
+/* ----------------------------------------------------------------------
+   hand off the block being filled, advance to the next block in the ring
+   the next block is written out first if it still holds compressed data
+------------------------------------------------------------------------- */
+
+void GZWriter::submit()
+{
+  Block *b = &blocks[ifill];
+
+  if (nthreads == 0) {
+    compress(b);
+    if (fwrite(b->out,1,b->nout,fp) != b->nout) clearerr(fp);
+    b->nin = 0;
+    return;
+  }
+
+  pthread_mutex_lock(&mutex);
+  b->state = QUEUED;
+  pthread_cond_broadcast(&cond);
+  ifill = (ifill+1) % nblock;
+  int busy = (blocks[ifill].state != FREE);
+  pthread_mutex_unlock(&mutex);
+
+  if (busy) drain(1);
+}
+
+/* ----------------------------------------------------------------------
+   write up to n blocks to the file in submission order
+   waits for each one to finish compressing
+------------------------------------------------------------------------- */
+
+void GZWriter::drain(int n)
+{
+  if (nthreads == 0) return;
+
+  for (int i = 0; i < n; i++) {
+    Block *b = &blocks[iwrite];
+    pthread_mutex_lock(&mutex);
+    if (b->state == FREE) {
+      pthread_mutex_unlock(&mutex);
+      return;
+    }
+    while (b->state != DONE) pthread_cond_wait(&cond,&mutex);
+    pthread_mutex_unlock(&mutex);
+
+    if (fwrite(b->out,1,b->nout,fp) != b->nout) clearerr(fp);
+    b->nin = 0;
+
+    pthread_mutex_lock(&mutex);
+    b->state = FREE;
+    pthread_mutex_unlock(&mutex);
+    iwrite = (iwrite+1) % nblock;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   compress input of one block into a complete gzip member
+------------------------------------------------------------------------- */
+
+void GZWriter::compress(Block *b)
+{
+  z_stream strm;
+  memset(&strm,0,sizeof(z_stream));
+  deflateInit2(&strm,level,Z_DEFLATED,15+16,8,Z_DEFAULT_STRATEGY);
+  strm.next_in = (Bytef *) b->in;
+  strm.avail_in = b->nin;
+  strm.next_out = b->out;
+  strm.avail_out = maxout;
+  deflate(&strm,Z_FINISH);
+  b->nout = maxout - strm.avail_out;
+  deflateEnd(&strm);
+}
+
+/* ----------------------------------------------------------------------
+   thread loop: compress queued blocks in ring order until told to exit
+------------------------------------------------------------------------- */
+
+void *GZWriter::loop(void *ptr)
+{
+  GZWriter *w = (GZWriter *) ptr;
+
+  pthread_mutex_lock(&w->mutex);
+  while (1) {
+    while (!w->done && w->blocks[w->icompress].state != QUEUED)
+      pthread_cond_wait(&w->cond,&w->mutex);
+    if (w->done) break;
+
+    Block *b = &w->blocks[w->icompress];
+    b->state = BUSY;
+    w->icompress = (w->icompress+1) % w->nblock;
+    pthread_mutex_unlock(&w->mutex);
+
+    w->compress(b);
+
+    pthread_mutex_lock(&w->mutex);
+    b->state = DONE;
+    pthread_cond_broadcast(&w->cond);
+  }
+  pthread_mutex_unlock(&w->mutex);
+
+  return NULL;
+}
@@ -0,0 +1,76 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------------
+   GZWriter = write one gzipped file as a series of independent gzip
+     members, one per block of input, compressed by a pool of threads
+   output is a valid gzip file, gunzip concatenates the members
+   blocks are written to the file in order by the calling thread
+   with nthreads <= 1, blocks are compressed by the calling thread
+------------------------------------------------------------------------- */
+
+#ifndef LMP_GZ_WRITER_H
+#define LMP_GZ_WRITER_H
+
+#include <stdio.h>
+#include <pthread.h>
+
+namespace LAMMPS_NS {
+
+class GZWriter {
+ public:
+  GZWriter(int, int);
+  ~GZWriter();
+  int open(const char *, int);
+  void write(const void *, size_t);
+  void print(const char *, ...);
+  void flush();
+  void close();
+
+ private:
+  FILE *fp;                  // file being written, NULL if not open
+  int level;                 // zlib compression level
+  int nthreads;              // # of compression threads, 0 if none
+
+  struct Block {
+    char *in;                // uncompressed input
+    size_t nin;              // # of bytes in input
+    unsigned char *out;      // gzip member of compressed input
+    size_t nout;             // # of bytes in out
+    int state;               // FREE, QUEUED, BUSY, or DONE
+  };
+
+  int nblock;                // # of blocks in ring
+  Block *blocks;             // ring of blocks in order of submission
+  int ifill;                 // block being filled by caller
+  int icompress;             // next block for a thread to compress
+  int iwrite;                // next block to write to file
+  size_t maxout;             // size of out for a full block
+
+  char *line;                // buffer for formatting via print()
+  int maxline;
+
+  pthread_t *threads;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  int done;                  // 1 when threads should exit
+
+  void submit();
+  void drain(int);
+  void compress(Block *);
+  static void *loop(void *);
+};
+
+}
+
+#endif
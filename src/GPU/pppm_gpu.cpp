@@ -94,6 +94,7 @@ PPPMGPU::PPPMGPU(LAMMPS *lmp, int narg, char **arg) : PPPM(lmp, narg, arg)
   if (narg != 1) error->all(FLERR,"Illegal kspace_style pppm/gpu command");
 
   triclinic_support = 0;
+  r2c_support = 0;
   density_brick_gpu = vd_brick = NULL;
   kspace_split = false;
   im_real_space = false;
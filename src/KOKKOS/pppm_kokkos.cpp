@@ -75,6 +75,7 @@ PPPMKokkos<DeviceType>::PPPMKokkos(LAMMPS *lmp, int narg, char **arg) : PPPM(lmp
   pppmflag = 1;
   group_group_enable = 0;
   triclinic_support = 0;
+  r2c_support = 0;
 
   accuracy_relative = fabs(force->numeric(FLERR,arg[0]));
 
@@ -191,7 +192,7 @@ void PPPMKokkos<DeviceType>::init()
                "slab correction");
   if (domain->dimension == 2) error->all(FLERR,
                                          "Cannot use PPPM with 2d simulation");
-  if (comm->style != 0)
+  if (comm->style == 1)
     error->universe_all(FLERR,"PPPM can only currently be used with "
                         "comm_style brick");
 
@@ -34,6 +34,8 @@
 #define MIN(A,B) ((A) < (B) ? (A) : (B))
 #define MAX(A,B) ((A) > (B) ? (A) : (B))
 
+static void fft_1d_real(FFT_SCALAR *, FFT_DATA *, int, struct fft_plan_3d *);
+
 /* ----------------------------------------------------------------------
    Data layout for 3d FFTs:
 
@@ -51,6 +53,9 @@
      by specifying hi index < lo index
    on both input and output, data is stored contiguously on a processor
      with a fast-varying, mid-varying, and slow-varying index
+   for real-to-complex FFTs, the complex data only has the Nfast/2+1
+     elements with fast index 0 to Nfast/2, the rest follows from
+     Hermitian symmetry, and real data has 1 instead of 2 values per element
 ------------------------------------------------------------------------- */
 
 /* ----------------------------------------------------------------------
@@ -62,13 +67,15 @@
                   will be placed (can be same as in)
    flag         1 for forward FFT, -1 for inverse FFT
    plan         plan returned by previous call to fft_3d_create_plan
+   for real-to-complex plans, forward FFTs go from real in to complex out,
+     inverse FFTs from complex in to real out
 ------------------------------------------------------------------------- */
 
 void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
 {
   int i,total,length,offset,num;
   FFT_SCALAR norm, *out_ptr;
-  FFT_DATA *data,*copy;
+  FFT_DATA *data,*copy,*dest;
 
   // system specific constants
 
@@ -105,58 +112,67 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
     data = in;
 
   // 1d FFTs along fast axis
+  // for real-to-complex FFTs, forward FFTs go from real data to copy,
+  //   inverse FFTs are done last, after the post-remap
 
-  total = plan->total1;
-  length = plan->length1;
+  if (plan->real) {
+    if (flag == 1) {
+      fft_1d_real((FFT_SCALAR *) data,plan->copy,1,plan);
+      data = plan->copy;
+    }
+  } else {
+    total = plan->total1;
+    length = plan->length1;
 
 #if defined(FFT_SGI)
-  for (offset = 0; offset < total; offset += length)
-    FFT_1D(flag,length,&data[offset],1,plan->coeff1);
+    for (offset = 0; offset < total; offset += length)
+      FFT_1D(flag,length,&data[offset],1,plan->coeff1);
 #elif defined(FFT_SCSL)
-  for (offset = 0; offset < total; offset += length)
-    FFT_1D(flag,length,scalef,&data[offset],&data[offset],plan->coeff1,
-           plan->work1,&isys);
+    for (offset = 0; offset < total; offset += length)
+      FFT_1D(flag,length,scalef,&data[offset],&data[offset],plan->coeff1,
+             plan->work1,&isys);
 #elif defined(FFT_ACML)
-  num=total/length;
-  FFT_1D(&flag,&num,&length,data,plan->coeff1,&info);
+    num=total/length;
+    FFT_1D(&flag,&num,&length,data,plan->coeff1,&info);
 #elif defined(FFT_INTEL)
-  for (offset = 0; offset < total; offset += length)
-    FFT_1D(&data[offset],&length,&flag,plan->coeff1);
+    for (offset = 0; offset < total; offset += length)
+      FFT_1D(&data[offset],&length,&flag,plan->coeff1);
 #elif defined(FFT_MKL)
-  if (flag == -1)
-    DftiComputeForward(plan->handle_fast,data);
-  else
-    DftiComputeBackward(plan->handle_fast,data);
+    if (flag == -1)
+      DftiComputeForward(plan->handle_fast,data);
+    else
+      DftiComputeBackward(plan->handle_fast,data);
 #elif defined(FFT_DEC)
-  if (flag == -1)
-    for (offset = 0; offset < total; offset += length)
-      FFT_1D(&c,&c,&f,&data[offset],&data[offset],&length,&one);
-  else
-    for (offset = 0; offset < total; offset += length)
-      FFT_1D(&c,&c,&b,&data[offset],&data[offset],&length,&one);
+    if (flag == -1)
+      for (offset = 0; offset < total; offset += length)
+        FFT_1D(&c,&c,&f,&data[offset],&data[offset],&length,&one);
+    else
+      for (offset = 0; offset < total; offset += length)
+        FFT_1D(&c,&c,&b,&data[offset],&data[offset],&length,&one);
 #elif defined(FFT_T3E)
-  for (offset = 0; offset < total; offset += length)
-    FFT_1D(&flag,&length,&scalef,&data[offset],&data[offset],plan->coeff1,
-           plan->work1,&isys);
+    for (offset = 0; offset < total; offset += length)
+      FFT_1D(&flag,&length,&scalef,&data[offset],&data[offset],plan->coeff1,
+             plan->work1,&isys);
 #elif defined(FFT_FFTW2)
-  if (flag == -1)
-    fftw(plan->plan_fast_forward,total/length,data,1,length,NULL,0,0);
-  else
-    fftw(plan->plan_fast_backward,total/length,data,1,length,NULL,0,0);
+    if (flag == -1)
+      fftw(plan->plan_fast_forward,total/length,data,1,length,NULL,0,0);
+    else
+      fftw(plan->plan_fast_backward,total/length,data,1,length,NULL,0,0);
 #elif defined(FFT_FFTW3)
-  if (flag == -1)
-    theplan=plan->plan_fast_forward;
-  else
-    theplan=plan->plan_fast_backward;
-  FFTW_API(execute_dft)(theplan,data,data);
+    if (flag == -1)
+      theplan=plan->plan_fast_forward;
+    else
+      theplan=plan->plan_fast_backward;
+    FFTW_API(execute_dft)(theplan,data,data);
 #else
-  if (flag == -1)
-    for (offset = 0; offset < total; offset += length)
-      kiss_fft(plan->cfg_fast_forward,&data[offset],&data[offset]);
-  else
-    for (offset = 0; offset < total; offset += length)
-      kiss_fft(plan->cfg_fast_backward,&data[offset],&data[offset]);
+    if (flag == -1)
+      for (offset = 0; offset < total; offset += length)
+        kiss_fft(plan->cfg_fast_forward,&data[offset],&data[offset]);
+    else
+      for (offset = 0; offset < total; offset += length)
+        kiss_fft(plan->cfg_fast_backward,&data[offset],&data[offset]);
 #endif
+  }
 
   // 1st mid-remap to prepare for 2nd FFTs
   // copy = loc for remap result
@@ -285,12 +301,34 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
 #endif
 
   // post-remap to put data in output format if needed
-  // destination is always out
-
-  if (plan->post_plan)
-    remap_3d((FFT_SCALAR *) data, (FFT_SCALAR *) out, (FFT_SCALAR *) plan->scratch,
+  // destination is out, except for inverse real-to-complex FFTs,
+  //   where it is copy, for the 1d FFTs along fast axis that follow
+  // for pencil FFTs, it is done in 2 steps via copy, along columns and rows
+
+  if (plan->real && flag == -1) dest = plan->copy;
+  else dest = out;
+
+  if (plan->post_plan && plan->post2_plan) {
+    remap_3d((FFT_SCALAR *) data, (FFT_SCALAR *) plan->copy,
+             (FFT_SCALAR *) plan->scratch, plan->post_plan);
+    remap_3d((FFT_SCALAR *) plan->copy, (FFT_SCALAR *) dest,
+             (FFT_SCALAR *) plan->scratch, plan->post2_plan);
+  } else if (plan->post_plan)
+    remap_3d((FFT_SCALAR *) data, (FFT_SCALAR *) dest, (FFT_SCALAR *) plan->scratch,
              plan->post_plan);
 
+  // inverse real-to-complex 1d FFTs along fast axis
+  // real result goes to out, or to scratch if it is remapped to out,
+  //   with copy as remap buffer
+
+  if (plan->real && flag == -1) {
+    if (plan->real_plan) {
+      fft_1d_real((FFT_SCALAR *) plan->scratch,plan->copy,-1,plan);
+      remap_3d((FFT_SCALAR *) plan->scratch, (FFT_SCALAR *) out,
+               (FFT_SCALAR *) plan->copy, plan->real_plan);
+    } else fft_1d_real((FFT_SCALAR *) out,plan->copy,-1,plan);
+  }
+
   // scaling if required
 #if !defined(FFT_T3E) && !defined(FFT_ACML)
   if (flag == 1 && plan->scaled) {
@@ -349,6 +387,17 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
                           2 = permute twice = slow->fast, fast->mid, mid->slow
    nbuf                 returns size of internal storage buffers used by FFT
    usecollective        use collective MPI operations for remapping data
+                          0 = point-to-point
+                          1 = Alltoallv on sub-comms of remap partners
+                          2 = pencil FFTs, Alltoallv within rows and
+                                columns of the 2d grid of procs
+   real                 1 = real-to-complex FFTs, 0 = complex FFTs
+                          all procs must own the entire fast axis on input
+                            and permute must be 0
+                          complex data is stored in the input layout,
+                            the output layout is only used for real output
+                            of inverse FFTs, so it must be the same as the
+                            input layout for forward FFTs
 ------------------------------------------------------------------------- */
 
 struct fft_plan_3d *fft_3d_create_plan(
@@ -357,7 +406,7 @@ struct fft_plan_3d *fft_3d_create_plan(
        int in_klo, int in_khi,
        int out_ilo, int out_ihi, int out_jlo, int out_jhi,
        int out_klo, int out_khi,
-       int scaled, int permute, int *nbuf, int usecollective)
+       int scaled, int permute, int *nbuf, int usecollective, int real)
 {
   struct fft_plan_3d *plan;
   int me,nprocs;
@@ -366,8 +415,10 @@ struct fft_plan_3d *fft_3d_create_plan(
   int second_ilo,second_ihi,second_jlo,second_jhi,second_klo,second_khi;
   int third_ilo,third_ihi,third_jlo,third_jhi,third_klo,third_khi;
   int out_size,first_size,second_size,third_size,copy_size,scratch_size;
+  int nreal,real_size;
   int np1,np2,ip1,ip2;
   int list[50];
+  MPI_Comm rowcomm,colcomm;
 
   // system specific variables
 
@@ -391,17 +442,79 @@ struct fft_plan_3d *fft_3d_create_plan(
   MPI_Comm_rank(comm,&me);
   MPI_Comm_size(comm,&nprocs);
 
-  // compute division of procs in 2 dimensions not on-processor
+  // real-to-complex FFTs need library support and input which owns the
+  //   entire fast axis, which then has nfast/2+1 complex elements
 
-  bifactor(nprocs,&np1,&np2);
+  nreal = nfast;
+
+  if (real) {
+#ifndef FFT_REAL
+    return NULL;
+#endif
+    if (in_ilo != 0 || in_ihi != nfast-1 || permute != 0) return NULL;
+    nfast = nreal/2 + 1;
+    in_ihi = nfast - 1;
+  }
+
+  // compute division of procs in 2 dimensions not on-processor
+  // for pencil FFTs, prefer the grid the input is already distributed on,
+  //   and split procs into rows (same ip2) and columns (same ip1) of it
+  // remaps from 1st to 2nd and 2nd to 3rd FFTs are then within a row/column
+
+  if (usecollective == 2)
+    pencil_grid(comm,nfast,nmid,nslow,in_ilo,in_ihi,in_jlo,in_jhi,
+                in_klo,in_khi,&np1,&np2);
+  else bifactor(nprocs,&np1,&np2);
   ip1 = me % np1;
   ip2 = me/np1;
 
+  if (usecollective == 2) {
+    MPI_Comm_split(comm,ip2,ip1,&rowcomm);
+    MPI_Comm_split(comm,ip1,ip2,&colcomm);
+  }
+
   // allocate memory for plan data struct
 
   plan = (struct fft_plan_3d *) malloc(sizeof(struct fft_plan_3d));
   if (plan == NULL) return NULL;
 
+  plan->real = real;
+  plan->nreal = nreal;
+  plan->real_plan = NULL;
+  real_size = 0;
+
+  // for real-to-complex FFTs, remap real output of inverse FFTs
+  //   from input to output layout if needed
+  // complex data then stays in input layout
+
+  if (real) {
+    if (out_ilo == in_ilo && out_ihi == nreal-1 &&
+        out_jlo == in_jlo && out_jhi == in_jhi &&
+        out_klo == in_klo && out_khi == in_khi)
+      flag = 0;
+    else
+      flag = 1;
+
+    MPI_Allreduce(&flag,&remapflag,1,MPI_INT,MPI_MAX,comm);
+
+    if (remapflag) {
+      plan->real_plan =
+        remap_3d_create_plan(comm,0,nreal-1,in_jlo,in_jhi,in_klo,in_khi,
+                             out_ilo,out_ihi,out_jlo,out_jhi,out_klo,out_khi,
+                             1,0,0,FFT_PRECISION,0);
+      if (plan->real_plan == NULL) return NULL;
+      real_size = (out_ihi-out_ilo+1) * (out_jhi-out_jlo+1) *
+        (out_khi-out_klo+1);
+    }
+
+    out_ilo = in_ilo;
+    out_ihi = in_ihi;
+    out_jlo = in_jlo;
+    out_jhi = in_jhi;
+    out_klo = in_klo;
+    out_khi = in_khi;
+  }
+
   // remap from initial distribution to layout needed for 1st set of 1d FFTs
   // not needed if all procs own entire fast axis initially
   // first indices = distribution after 1st set of FFTs
@@ -452,7 +565,7 @@ struct fft_plan_3d *fft_3d_create_plan(
   second_klo = ip2*nslow/np2;
   second_khi = (ip2+1)*nslow/np2 - 1;
   plan->mid1_plan =
-      remap_3d_create_plan(comm,
+      remap_3d_create_plan(usecollective == 2 ? rowcomm : comm,
                            first_ilo,first_ihi,first_jlo,first_jhi,
                            first_klo,first_khi,
                            second_ilo,second_ihi,second_jlo,second_jhi,
@@ -468,8 +581,10 @@ struct fft_plan_3d *fft_3d_create_plan(
   // if final distribution is permute=2 with all procs owning entire slow axis
   //   then this remapping goes directly to final distribution
   //  third indices = distribution after 3rd set of FFTs
+  // for pencil FFTs, the 3rd FFTs must be on a column of the proc grid
 
-  if (permute == 2 && out_klo == 0 && out_khi == nslow-1)
+  if (permute == 2 && out_klo == 0 && out_khi == nslow-1 &&
+      usecollective != 2)
     flag = 0;
   else
     flag = 1;
@@ -494,7 +609,7 @@ struct fft_plan_3d *fft_3d_create_plan(
   }
 
   plan->mid2_plan =
-    remap_3d_create_plan(comm,
+    remap_3d_create_plan(usecollective == 2 ? colcomm : comm,
                          second_jlo,second_jhi,second_klo,second_khi,
                          second_ilo,second_ihi,
                          third_jlo,third_jhi,third_klo,third_khi,
@@ -519,9 +634,45 @@ struct fft_plan_3d *fft_3d_create_plan(
 
   MPI_Allreduce(&flag,&remapflag,1,MPI_INT,MPI_MAX,comm);
 
+  // for pencil FFTs, if permute = 0 and out indices = first indices on all
+  //   procs, do the remap as the reverse of mid2 and mid1 instead:
+  //   3rd -> 2nd FFT distribution in a column, 2nd -> 1st in a row
+
+  plan->post2_plan = NULL;
+
+  if (remapflag && usecollective == 2) {
+    if (permute == 0 &&
+        out_ilo == first_ilo && out_ihi == first_ihi &&
+        out_jlo == first_jlo && out_jhi == first_jhi &&
+        out_klo == first_klo && out_khi == first_khi)
+      flag = 0;
+    else
+      flag = 1;
+
+    int pencilflag;
+    MPI_Allreduce(&flag,&pencilflag,1,MPI_INT,MPI_MAX,comm);
+
+    if (pencilflag == 0) {
+      plan->post_plan =
+        remap_3d_create_plan(colcomm,
+                             third_klo,third_khi,third_ilo,third_ihi,
+                             third_jlo,third_jhi,
+                             second_klo,second_khi,second_ilo,second_ihi,
+                             second_jlo,second_jhi,2,2,0,FFT_PRECISION,2);
+      if (plan->post_plan == NULL) return NULL;
+      plan->post2_plan =
+        remap_3d_create_plan(rowcomm,
+                             second_jlo,second_jhi,second_klo,second_khi,
+                             second_ilo,second_ihi,
+                             first_jlo,first_jhi,first_klo,first_khi,
+                             first_ilo,first_ihi,2,2,0,FFT_PRECISION,2);
+      if (plan->post2_plan == NULL) return NULL;
+    }
+  }
+
   if (remapflag == 0)
     plan->post_plan = NULL;
-  else {
+  else if (plan->post2_plan == NULL) {
     plan->post_plan =
       remap_3d_create_plan(comm,
                            third_klo,third_khi,third_ilo,third_ihi,
@@ -531,6 +682,13 @@ struct fft_plan_3d *fft_3d_create_plan(
     if (plan->post_plan == NULL) return NULL;
   }
 
+  // remap plans hold their own copy of the row and column comms
+
+  if (usecollective == 2) {
+    MPI_Comm_free(&rowcomm);
+    MPI_Comm_free(&colcomm);
+  }
+
   // configure plan memory pointers and allocate work space
   // out_size = amount of memory given to FFT by user
   // first/second/third_size = amount of memory needed after pre,mid1,mid2 remaps
@@ -539,6 +697,8 @@ struct fft_plan_3d *fft_3d_create_plan(
   // for each remap:
   //   out space used for result if big enough, else require copy buffer
   //   accumulate largest required remap scratch space
+  // for real-to-complex FFTs, out may hold less than the complex data,
+  //   so copy is always used, and it is the buffer for the real remap
 
   out_size = (out_ihi-out_ilo+1) * (out_jhi-out_jlo+1) * (out_khi-out_klo+1);
   first_size = (first_ihi-first_ilo+1) * (first_jhi-first_jlo+1) *
@@ -562,7 +722,7 @@ struct fft_plan_3d *fft_3d_create_plan(
   }
 
   if (plan->mid1_plan) {
-    if (second_size <= out_size)
+    if (second_size <= out_size && !real)
       plan->mid1_target = 0;
     else {
       plan->mid1_target = 1;
@@ -572,7 +732,7 @@ struct fft_plan_3d *fft_3d_create_plan(
   }
 
   if (plan->mid2_plan) {
-    if (third_size <= out_size)
+    if (third_size <= out_size && !real)
       plan->mid2_target = 0;
     else {
       plan->mid2_target = 1;
@@ -581,9 +741,20 @@ struct fft_plan_3d *fft_3d_create_plan(
     scratch_size = MAX(scratch_size,third_size);
   }
 
+  if (plan->post2_plan) {
+    copy_size = MAX(copy_size,second_size);
+    scratch_size = MAX(scratch_size,second_size);
+  }
+
   if (plan->post_plan)
     scratch_size = MAX(scratch_size,out_size);
 
+  if (real) copy_size = MAX(copy_size,first_size);
+  if (plan->real_plan) {
+    copy_size = MAX(copy_size,(real_size+1)/2);
+    scratch_size = MAX(scratch_size,first_size);
+  }
+
   *nbuf = copy_size + scratch_size;
 
   if (copy_size) {
@@ -731,12 +902,32 @@ struct fft_plan_3d *fft_3d_create_plan(
     plan->scaled = 0;
 
 #elif defined(FFT_MKL)
-  DftiCreateDescriptor( &(plan->handle_fast), FFT_MKL_PREC, DFTI_COMPLEX, 1, (MKL_LONG)nfast);
-  DftiSetValue(plan->handle_fast, DFTI_NUMBER_OF_TRANSFORMS, (MKL_LONG)plan->total1/nfast);
-  DftiSetValue(plan->handle_fast, DFTI_PLACEMENT,DFTI_INPLACE);
-  DftiSetValue(plan->handle_fast, DFTI_INPUT_DISTANCE, (MKL_LONG)nfast);
-  DftiSetValue(plan->handle_fast, DFTI_OUTPUT_DISTANCE, (MKL_LONG)nfast);
-  DftiCommitDescriptor(plan->handle_fast);
+  if (real) {
+    // input and output distances refer to the direction of the transform,
+    // so real -> complex and complex -> real FFTs need separate descriptors
+    DftiCreateDescriptor( &(plan->handle_fast), FFT_MKL_PREC, DFTI_REAL, 1, (MKL_LONG)nreal);
+    DftiSetValue(plan->handle_fast, DFTI_NUMBER_OF_TRANSFORMS, (MKL_LONG)plan->total1/nfast);
+    DftiSetValue(plan->handle_fast, DFTI_PLACEMENT,DFTI_NOT_INPLACE);
+    DftiSetValue(plan->handle_fast, DFTI_CONJUGATE_EVEN_STORAGE,DFTI_COMPLEX_COMPLEX);
+    DftiSetValue(plan->handle_fast, DFTI_INPUT_DISTANCE, (MKL_LONG)nreal);
+    DftiSetValue(plan->handle_fast, DFTI_OUTPUT_DISTANCE, (MKL_LONG)nfast);
+    DftiCommitDescriptor(plan->handle_fast);
+
+    DftiCreateDescriptor( &(plan->handle_fast_c2r), FFT_MKL_PREC, DFTI_REAL, 1, (MKL_LONG)nreal);
+    DftiSetValue(plan->handle_fast_c2r, DFTI_NUMBER_OF_TRANSFORMS, (MKL_LONG)plan->total1/nfast);
+    DftiSetValue(plan->handle_fast_c2r, DFTI_PLACEMENT,DFTI_NOT_INPLACE);
+    DftiSetValue(plan->handle_fast_c2r, DFTI_CONJUGATE_EVEN_STORAGE,DFTI_COMPLEX_COMPLEX);
+    DftiSetValue(plan->handle_fast_c2r, DFTI_INPUT_DISTANCE, (MKL_LONG)nfast);
+    DftiSetValue(plan->handle_fast_c2r, DFTI_OUTPUT_DISTANCE, (MKL_LONG)nreal);
+    DftiCommitDescriptor(plan->handle_fast_c2r);
+  } else {
+    DftiCreateDescriptor( &(plan->handle_fast), FFT_MKL_PREC, DFTI_COMPLEX, 1, (MKL_LONG)nfast);
+    DftiSetValue(plan->handle_fast, DFTI_NUMBER_OF_TRANSFORMS, (MKL_LONG)plan->total1/nfast);
+    DftiSetValue(plan->handle_fast, DFTI_PLACEMENT,DFTI_INPLACE);
+    DftiSetValue(plan->handle_fast, DFTI_INPUT_DISTANCE, (MKL_LONG)nfast);
+    DftiSetValue(plan->handle_fast, DFTI_OUTPUT_DISTANCE, (MKL_LONG)nfast);
+    DftiCommitDescriptor(plan->handle_fast);
+  }
 
   DftiCreateDescriptor( &(plan->handle_mid), FFT_MKL_PREC, DFTI_COMPLEX, 1, (MKL_LONG)nmid);
   DftiSetValue(plan->handle_mid, DFTI_NUMBER_OF_TRANSFORMS, (MKL_LONG)plan->total2/nmid);
@@ -756,7 +947,7 @@ struct fft_plan_3d *fft_3d_create_plan(
     plan->scaled = 0;
   else {
     plan->scaled = 1;
-    plan->norm = 1.0/(nfast*nmid*nslow);
+    plan->norm = 1.0/(nreal*nmid*nslow);
     plan->normnum = (out_ihi-out_ilo+1) * (out_jhi-out_jlo+1) *
       (out_khi-out_klo+1);
   }
@@ -848,16 +1039,37 @@ struct fft_plan_3d *fft_3d_create_plan(
   }
 
 #elif defined(FFT_FFTW3)
-  plan->plan_fast_forward =
-    FFTW_API(plan_many_dft)(1, &nfast,plan->total1/plan->length1,
-                            NULL,&nfast,1,plan->length1,
-                            NULL,&nfast,1,plan->length1,
-                            FFTW_FORWARD,FFTW_ESTIMATE);
-  plan->plan_fast_backward =
-    FFTW_API(plan_many_dft)(1, &nfast,plan->total1/plan->length1,
-                            NULL,&nfast,1,plan->length1,
-                            NULL,&nfast,1,plan->length1,
-                            FFTW_BACKWARD,FFTW_ESTIMATE);
+  if (real) {
+    // real -> complex FFTs are out-of-place, so they are planned on
+    //   separate temporary arrays instead of NULL, which means in-place
+    num = MAX(plan->total1/plan->length1,1);
+    FFT_SCALAR *rtmp = (FFT_SCALAR *) FFTW_API(malloc)(num*nreal*sizeof(FFT_SCALAR));
+    FFT_DATA *ctmp = (FFT_DATA *) FFTW_API(malloc)(num*nfast*sizeof(FFT_DATA));
+    if (rtmp == NULL || ctmp == NULL) return NULL;
+    plan->plan_fast_forward =
+      FFTW_API(plan_many_dft_r2c)(1, &nreal,plan->total1/plan->length1,
+                                  rtmp,NULL,1,nreal,
+                                  ctmp,NULL,1,plan->length1,
+                                  FFTW_ESTIMATE);
+    plan->plan_fast_backward =
+      FFTW_API(plan_many_dft_c2r)(1, &nreal,plan->total1/plan->length1,
+                                  ctmp,NULL,1,plan->length1,
+                                  rtmp,NULL,1,nreal,
+                                  FFTW_ESTIMATE);
+    FFTW_API(free)(rtmp);
+    FFTW_API(free)(ctmp);
+  } else {
+    plan->plan_fast_forward =
+      FFTW_API(plan_many_dft)(1, &nfast,plan->total1/plan->length1,
+                              NULL,&nfast,1,plan->length1,
+                              NULL,&nfast,1,plan->length1,
+                              FFTW_FORWARD,FFTW_ESTIMATE);
+    plan->plan_fast_backward =
+      FFTW_API(plan_many_dft)(1, &nfast,plan->total1/plan->length1,
+                              NULL,&nfast,1,plan->length1,
+                              NULL,&nfast,1,plan->length1,
+                              FFTW_BACKWARD,FFTW_ESTIMATE);
+  }
   plan->plan_mid_forward =
     FFTW_API(plan_many_dft)(1, &nmid,plan->total2/plan->length2,
                             NULL,&nmid,1,plan->length2,
@@ -883,15 +1095,24 @@ struct fft_plan_3d *fft_3d_create_plan(
     plan->scaled = 0;
   else {
     plan->scaled = 1;
-    plan->norm = 1.0/(nfast*nmid*nslow);
+    plan->norm = 1.0/(nreal*nmid*nslow);
     plan->normnum = (out_ihi-out_ilo+1) * (out_jhi-out_jlo+1) *
       (out_khi-out_klo+1);
   }
 #else
-  plan->cfg_fast_forward = kiss_fft_alloc(nfast,0,NULL,NULL);
-  plan->cfg_fast_backward = kiss_fft_alloc(nfast,1,NULL,NULL);
+  if (real) {
+    plan->cfg_fast_forward = NULL;
+    plan->cfg_fast_backward = NULL;
+    plan->cfgr_fast_forward = kiss_fftr_alloc(nreal,0,NULL,NULL);
+    plan->cfgr_fast_backward = kiss_fftr_alloc(nreal,1,NULL,NULL);
+  } else {
+    plan->cfg_fast_forward = kiss_fft_alloc(nfast,0,NULL,NULL);
+    plan->cfg_fast_backward = kiss_fft_alloc(nfast,1,NULL,NULL);
+    plan->cfgr_fast_forward = NULL;
+    plan->cfgr_fast_backward = NULL;
+  }
 
-  if (nmid == nfast) {
+  if (nmid == nfast && !real) {
     plan->cfg_mid_forward = plan->cfg_fast_forward;
     plan->cfg_mid_backward = plan->cfg_fast_backward;
   }
@@ -900,7 +1121,7 @@ struct fft_plan_3d *fft_3d_create_plan(
     plan->cfg_mid_backward = kiss_fft_alloc(nmid,1,NULL,NULL);
   }
 
-  if (nslow == nfast) {
+  if (nslow == nfast && !real) {
     plan->cfg_slow_forward = plan->cfg_fast_forward;
     plan->cfg_slow_backward = plan->cfg_fast_backward;
   }
@@ -917,7 +1138,7 @@ struct fft_plan_3d *fft_3d_create_plan(
     plan->scaled = 0;
   else {
     plan->scaled = 1;
-    plan->norm = 1.0/(nfast*nmid*nslow);
+    plan->norm = 1.0/(nreal*nmid*nslow);
     plan->normnum = (out_ihi-out_ilo+1) * (out_jhi-out_jlo+1) *
       (out_khi-out_klo+1);
   }
@@ -937,6 +1158,8 @@ void fft_3d_destroy_plan(struct fft_plan_3d *plan)
   if (plan->mid1_plan) remap_3d_destroy_plan(plan->mid1_plan);
   if (plan->mid2_plan) remap_3d_destroy_plan(plan->mid2_plan);
   if (plan->post_plan) remap_3d_destroy_plan(plan->post_plan);
+  if (plan->post2_plan) remap_3d_destroy_plan(plan->post2_plan);
+  if (plan->real_plan) remap_3d_destroy_plan(plan->real_plan);
 
   if (plan->copy) free(plan->copy);
   if (plan->scratch) free(plan->scratch);
@@ -964,6 +1187,7 @@ void fft_3d_destroy_plan(struct fft_plan_3d *plan)
   DftiFreeDescriptor(&(plan->handle_fast));
   DftiFreeDescriptor(&(plan->handle_mid));
   DftiFreeDescriptor(&(plan->handle_slow));
+  if (plan->real) DftiFreeDescriptor(&(plan->handle_fast_c2r));
 #elif defined(FFT_T3E)
   free(plan->coeff1);
   free(plan->coeff2);
@@ -1002,6 +1226,8 @@ void fft_3d_destroy_plan(struct fft_plan_3d *plan)
   }
   free(plan->cfg_fast_forward);
   free(plan->cfg_fast_backward);
+  free(plan->cfgr_fast_forward);
+  free(plan->cfgr_fast_backward);
 #endif
 
   free(plan);
@@ -1073,6 +1299,44 @@ void bifactor(int n, int *factor1, int *factor2)
   }
 }
 
+/* ----------------------------------------------------------------------
+   choose np1 x np2 grid of procs for pencil FFTs
+   use a grid the input is already distributed on for the 1st FFTs,
+     so that no remap to them is needed, else the one bifactor() returns
+------------------------------------------------------------------------- */
+
+void pencil_grid(MPI_Comm comm, int nfast, int nmid, int nslow,
+                 int in_ilo, int in_ihi, int in_jlo, int in_jhi,
+                 int in_klo, int in_khi, int *np1, int *np2)
+{
+  int me,nprocs,n1,n2,ip1,ip2,flag,flagall;
+
+  MPI_Comm_rank(comm,&me);
+  MPI_Comm_size(comm,&nprocs);
+
+  for (n1 = 1; n1 <= nprocs; n1++) {
+    if (nprocs % n1) continue;
+    n2 = nprocs/n1;
+    ip1 = me % n1;
+    ip2 = me/n1;
+    if (in_ilo == 0 && in_ihi == nfast-1 &&
+        in_jlo == ip1*nmid/n1 && in_jhi == (ip1+1)*nmid/n1 - 1 &&
+        in_klo == ip2*nslow/n2 && in_khi == (ip2+1)*nslow/n2 - 1)
+      flag = 1;
+    else
+      flag = 0;
+
+    MPI_Allreduce(&flag,&flagall,1,MPI_INT,MPI_MIN,comm);
+    if (flagall) {
+      *np1 = n1;
+      *np2 = n2;
+      return;
+    }
+  }
+
+  bifactor(nprocs,np1,np2);
+}
+
 /* ----------------------------------------------------------------------
    perform just the 1d FFTs needed by a 3d FFT, no data movement
    used for timing purposes
@@ -1128,6 +1392,14 @@ void fft_1d_only(FFT_DATA *data, int nsize, int flag, struct fft_plan_3d *plan)
   if (total2 > nsize) total2 = (nsize/length2) * length2;
   if (total3 > nsize) total3 = (nsize/length3) * length3;
 
+  // for real-to-complex FFTs, 1d FFTs along fast axis go between
+  //   real data and complex copy, and are skipped below
+
+  if (plan->real) {
+    fft_1d_real((FFT_SCALAR *) data,plan->copy,flag,plan);
+    total1 = 0;
+  }
+
   // perform 1d FFTs in each of 3 dimensions
   // data is just an array of 0.0
 
@@ -1165,11 +1437,11 @@ void fft_1d_only(FFT_DATA *data, int nsize, int flag, struct fft_plan_3d *plan)
     FFT_1D(&data[offset],&length3,&flag,plan->coeff3);
 #elif defined(FFT_MKL)
   if (flag == -1) {
-    DftiComputeForward(plan->handle_fast,data);
+    if (total1) DftiComputeForward(plan->handle_fast,data);
     DftiComputeForward(plan->handle_mid,data);
     DftiComputeForward(plan->handle_slow,data);
   } else {
-    DftiComputeBackward(plan->handle_fast,data);
+    if (total1) DftiComputeBackward(plan->handle_fast,data);
     DftiComputeBackward(plan->handle_mid,data);
     DftiComputeBackward(plan->handle_slow,data);
   }
@@ -1215,7 +1487,7 @@ void fft_1d_only(FFT_DATA *data, int nsize, int flag, struct fft_plan_3d *plan)
     theplan=plan->plan_fast_forward;
   else
     theplan=plan->plan_fast_backward;
-  FFTW_API(execute_dft)(theplan,data,data);
+  if (total1) FFTW_API(execute_dft)(theplan,data,data);
   if (flag == -1)
     theplan=plan->plan_mid_forward;
   else
@@ -1274,3 +1546,51 @@ void fft_1d_only(FFT_DATA *data, int nsize, int flag, struct fft_plan_3d *plan)
   }
 #endif
 }
+
+/* ----------------------------------------------------------------------
+   1d FFTs along fast axis for real-to-complex FFTs
+   flag = 1: real rdata -> complex cdata, flag = -1: cdata -> rdata
+   the libraries transform real -> complex with exp(-i), opposite to the
+     forward FFTs here, so complex data is conjugated after forward FFTs
+     and before inverse FFTs, which then overwrite cdata
+------------------------------------------------------------------------- */
+
+static void fft_1d_real(FFT_SCALAR *rdata, FFT_DATA *cdata, int flag,
+                        struct fft_plan_3d *plan)
+{
+#ifdef FFT_REAL
+  int i;
+  int total = 2*plan->total1;
+  FFT_SCALAR *cdata_ptr = (FFT_SCALAR *) cdata;
+
+  if (flag == -1)
+    for (i = 1; i < total; i += 2) cdata_ptr[i] = -cdata_ptr[i];
+
+#if defined(FFT_MKL)
+  if (flag == 1)
+    DftiComputeForward(plan->handle_fast,rdata,cdata);
+  else
+    DftiComputeBackward(plan->handle_fast_c2r,cdata,rdata);
+#elif defined(FFT_FFTW3)
+  if (flag == 1)
+    FFTW_API(execute_dft_r2c)(plan->plan_fast_forward,rdata,cdata);
+  else
+    FFTW_API(execute_dft_c2r)(plan->plan_fast_backward,cdata,rdata);
+#else
+  int offset,roffset;
+  int length = plan->length1;
+  int nreal = plan->nreal;
+  if (flag == 1)
+    for (offset = 0, roffset = 0; offset < plan->total1;
+         offset += length, roffset += nreal)
+      kiss_fftr(plan->cfgr_fast_forward,&rdata[roffset],&cdata[offset]);
+  else
+    for (offset = 0, roffset = 0; offset < plan->total1;
+         offset += length, roffset += nreal)
+      kiss_fftri(plan->cfgr_fast_backward,&cdata[offset],&rdata[roffset]);
+#endif
+
+  if (flag == 1)
+    for (i = 1; i < total; i += 2) cdata_ptr[i] = -cdata_ptr[i];
+#endif
+}
@@ -130,6 +130,8 @@ typedef struct {
 
 struct kiss_fft_state;
 typedef struct kiss_fft_state* kiss_fft_cfg;
+struct kiss_fftr_state;
+typedef struct kiss_fftr_state* kiss_fftr_cfg;
 #endif
 
 // -------------------------------------------------------------------------
@@ -232,12 +234,20 @@ typedef struct {
 
 struct kiss_fft_state;
 typedef struct kiss_fft_state* kiss_fft_cfg;
+struct kiss_fftr_state;
+typedef struct kiss_fftr_state* kiss_fftr_cfg;
 #endif
 
 #else
 #error "FFT_PRECISION needs to be either 1 (=single) or 2 (=double)"
 #endif
 
+// real-to-complex FFTs are only supported by some libraries
+
+#if defined(FFT_FFTW3) || defined(FFT_MKL) || defined(FFT_KISSFFT)
+#define FFT_REAL
+#endif
+
 // -------------------------------------------------------------------------
 
 // details of how to do a 3d FFT
@@ -247,12 +257,17 @@ struct fft_plan_3d {
   struct remap_plan_3d *mid1_plan;      // remap from 1st -> 2nd FFTs
   struct remap_plan_3d *mid2_plan;      // remap from 2nd -> 3rd FFTs
   struct remap_plan_3d *post_plan;      // remap from 3rd FFTs -> output
+  struct remap_plan_3d *post2_plan;     // 2nd step of it for pencil FFTs
+  struct remap_plan_3d *real_plan;      // remap of real output of inverse
+                                        //   real-to-complex FFTs
   FFT_DATA *copy;                   // memory for remap results (if needed)
   FFT_DATA *scratch;                // scratch space for remaps
   int total1,total2,total3;         // # of 1st,2nd,3rd FFTs (times length)
   int length1,length2,length3;      // length of 1st,2nd,3rd FFTs
   int pre_target;                   // where to put remap results
   int mid1_target,mid2_target;
+  int real;                         // 1 if real-to-complex FFTs
+  int nreal;                        // length of real data along fast axis
   int scaled;                       // whether to scale FFT results
   int normnum;                      // # of values to rescale
   double norm;                      // normalization factor for rescaling
@@ -281,6 +296,7 @@ struct fft_plan_3d {
   DFTI_DESCRIPTOR *handle_fast;
   DFTI_DESCRIPTOR *handle_mid;
   DFTI_DESCRIPTOR *handle_slow;
+  DFTI_DESCRIPTOR *handle_fast_c2r;
 #elif defined(FFT_T3E)
   double *coeff1;
   double *coeff2;
@@ -309,6 +325,8 @@ struct fft_plan_3d {
   kiss_fft_cfg cfg_mid_backward;
   kiss_fft_cfg cfg_slow_forward;
   kiss_fft_cfg cfg_slow_backward;
+  kiss_fftr_cfg cfgr_fast_forward;
+  kiss_fftr_cfg cfgr_fast_backward;
 #endif
 };
 
@@ -319,10 +337,12 @@ extern "C" {
   struct fft_plan_3d *fft_3d_create_plan(MPI_Comm, int, int, int,
                                          int, int, int, int, int,
                                          int, int, int, int, int, int, int,
-                                         int, int, int *, int);
+                                         int, int, int *, int, int);
   void fft_3d_destroy_plan(struct fft_plan_3d *);
   void factor(int, int *, int *);
   void bifactor(int, int *, int *);
+  void pencil_grid(MPI_Comm, int, int, int, int, int, int, int, int, int,
+                   int *, int *);
   void fft_1d_only(FFT_DATA *, int, int, struct fft_plan_3d *);
 }
 
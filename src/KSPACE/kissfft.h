@@ -465,4 +465,154 @@ static void kiss_fft(kiss_fft_cfg cfg, const FFT_DATA *fin, FFT_DATA *fout)
     kiss_fft_stride(cfg,fin,fout,1);
 }
 
+/*
+ * real-to-complex FFTs, adapted from kiss_fftr.c of kiss_fft_v1_2_9
+ *
+ * kiss_fftr() transforms nfft real values into nfft/2+1 complex values,
+ * kiss_fftri() does the inverse, without normalization, and only uses
+ * the real parts of the 0th (and nfft/2th for even nfft) complex value.
+ * For even nfft, the real values are packed into nfft/2 complex values,
+ * transformed by a complex FFT of half length, and then untangled using
+ * the super_twiddles. For odd nfft, a complex FFT of full length is used.
+ */
+struct kiss_fftr_state {
+    kiss_fft_cfg substate;
+    FFT_DATA * tmpbuf;
+    FFT_DATA * super_twiddles;
+    int nfft;
+};
+
+static kiss_fftr_cfg kiss_fftr_alloc(int nfft, int inverse_fft, void *mem, size_t *lenmem)
+{
+    int i, ncfft;
+    kiss_fftr_cfg st = NULL;
+    size_t subsize, memneeded;
+
+    ncfft = (nfft & 1) ? nfft : nfft/2;
+
+    kiss_fft_alloc(ncfft, inverse_fft, NULL, &subsize);
+    memneeded = sizeof(struct kiss_fftr_state) + subsize;
+    if (nfft & 1)
+        memneeded += sizeof(FFT_DATA) * 2 * ncfft;
+    else
+        memneeded += sizeof(FFT_DATA) * (ncfft * 3 / 2);
+
+    if (lenmem == NULL) {
+        st = (kiss_fftr_cfg) KISS_FFT_MALLOC(memneeded);
+    } else {
+        if (*lenmem >= memneeded)
+            st = (kiss_fftr_cfg) mem;
+        *lenmem = memneeded;
+    }
+    if (!st)
+        return NULL;
+
+    st->nfft = nfft;
+    st->substate = (kiss_fft_cfg) (st + 1); /* just beyond kiss_fftr_state struct */
+    st->tmpbuf = (FFT_DATA *) (((char *) st->substate) + subsize);
+    st->super_twiddles = st->tmpbuf + ncfft;
+    kiss_fft_alloc(ncfft, inverse_fft, st->substate, &subsize);
+
+    if ((nfft & 1) == 0) {
+        for (i = 0; i < ncfft/2; ++i) {
+            double phase = -M_PI * ((double) (i+1) / ncfft + .5);
+            if (inverse_fft)
+                phase *= -1;
+            kf_cexp(st->super_twiddles+i, phase);
+        }
+    }
+    return st;
+}
+
+static void kiss_fftr(kiss_fftr_cfg st, const kiss_fft_scalar *timedata, FFT_DATA *freqdata)
+{
+    int k, ncfft;
+    FFT_DATA fpnk, fpk, f1k, f2k, tw, tdc;
+
+    ncfft = st->substate->nfft;
+
+    if (st->nfft & 1) {
+        for (k = 0; k < ncfft; ++k) {
+            st->tmpbuf[k].re = timedata[k];
+            st->tmpbuf[k].im = 0;
+        }
+        kiss_fft(st->substate, st->tmpbuf, st->super_twiddles);
+        memcpy(freqdata, st->super_twiddles, sizeof(FFT_DATA)*(ncfft/2+1));
+        return;
+    }
+
+    /* perform the parallel fft of two real signals packed in real,imag */
+    kiss_fft(st->substate, (const FFT_DATA *) timedata, st->tmpbuf);
+
+    /* The real part of the DC element of the frequency spectrum in st->tmpbuf
+     * contains the sum of the even-numbered elements of the input time sequence
+     * The imag part is the sum of the odd-numbered elements
+     *
+     * The sum of tdc.re and tdc.im is the sum of the input time sequence.
+     *      yielding DC of input time sequence
+     * The difference of tdc.re - tdc.im is the sum of the input (dot product) [1,-1,1,-1...
+     *      yielding Nyquist bin of input time sequence
+     */
+
+    tdc.re = st->tmpbuf[0].re;
+    tdc.im = st->tmpbuf[0].im;
+    freqdata[0].re = tdc.re + tdc.im;
+    freqdata[ncfft].re = tdc.re - tdc.im;
+    freqdata[ncfft].im = freqdata[0].im = 0;
+
+    for (k = 1; k <= ncfft/2; ++k) {
+        fpk = st->tmpbuf[k];
+        fpnk.re =   st->tmpbuf[ncfft-k].re;
+        fpnk.im = - st->tmpbuf[ncfft-k].im;
+
+        C_ADD(f1k, fpk, fpnk);
+        C_SUB(f2k, fpk, fpnk);
+        C_MUL(tw, f2k, st->super_twiddles[k-1]);
+
+        freqdata[k].re = HALF_OF(f1k.re + tw.re);
+        freqdata[k].im = HALF_OF(f1k.im + tw.im);
+        freqdata[ncfft-k].re = HALF_OF(f1k.re - tw.re);
+        freqdata[ncfft-k].im = HALF_OF(tw.im - f1k.im);
+    }
+}
+
+static void kiss_fftri(kiss_fftr_cfg st, const FFT_DATA *freqdata, kiss_fft_scalar *timedata)
+{
+    int k, ncfft;
+
+    ncfft = st->substate->nfft;
+
+    if (st->nfft & 1) {
+        st->tmpbuf[0].re = freqdata[0].re;
+        st->tmpbuf[0].im = 0;
+        for (k = 1; k <= ncfft/2; ++k) {
+            st->tmpbuf[k] = freqdata[k];
+            st->tmpbuf[ncfft-k].re = freqdata[k].re;
+            st->tmpbuf[ncfft-k].im = -freqdata[k].im;
+        }
+        kiss_fft(st->substate, st->tmpbuf, st->super_twiddles);
+        for (k = 0; k < ncfft; ++k)
+            timedata[k] = st->super_twiddles[k].re;
+        return;
+    }
+
+    st->tmpbuf[0].re = freqdata[0].re + freqdata[ncfft].re;
+    st->tmpbuf[0].im = freqdata[0].re - freqdata[ncfft].re;
+
+    for (k = 1; k <= ncfft/2; ++k) {
+        FFT_DATA fk, fnkc, fek, fok, tmp;
+        fk = freqdata[k];
+        fnkc.re =   freqdata[ncfft-k].re;
+        fnkc.im = - freqdata[ncfft-k].im;
+
+        C_ADD(fek, fk, fnkc);
+        C_SUB(tmp, fk, fnkc);
+        C_MUL(fok, tmp, st->super_twiddles[k-1]);
+        C_ADD(st->tmpbuf[k], fek, fok);
+        C_SUB(st->tmpbuf[ncfft-k], fek, fok);
+        st->tmpbuf[ncfft-k].im *= -1;
+    }
+    kiss_fft(st->substate, st->tmpbuf, (FFT_DATA *) timedata);
+}
+
 #endif
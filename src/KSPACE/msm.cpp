@@ -148,7 +148,7 @@ void MSM::init()
   triclinic_check();
   if (domain->dimension == 2)
     error->all(FLERR,"Cannot (yet) use MSM with 2d simulation");
-  if (comm->style != 0)
+  if (comm->style == 1)
     error->universe_all(FLERR,"MSM can only currently be used with "
                         "comm_style brick");
 
@@ -54,12 +54,21 @@ PairLJCutCoulLong::PairLJCutCoulLong(LAMMPS *lmp) : Pair(lmp)
   writedata = 1;
   ftable = NULL;
   qdist = 0.0;
+
+  maxcluster = 0;
+  xcluster = NULL;
+  qcluster = NULL;
+  tcluster = NULL;
 }
 
 /* ---------------------------------------------------------------------- */
 
 PairLJCutCoulLong::~PairLJCutCoulLong()
 {
+  memory->destroy(xcluster);
+  memory->destroy(qcluster);
+  memory->destroy(tcluster);
+
   if (allocated) {
     memory->destroy(setflag);
     memory->destroy(cutsq);
@@ -103,6 +112,13 @@ void PairLJCutCoulLong::compute(int eflag, int vflag)
   int newton_pair = force->newton_pair;
   double qqrd2e = force->qqrd2e;
 
+  // cluster-pair list: regular list below only stores special pairs
+
+  if (list->clusterflag) {
+    if (evflag) eval_cluster<1>(eflag);
+    else eval_cluster<0>(eflag);
+  }
+
   inum = list->inum;
   ilist = list->ilist;
   numneigh = list->numneigh;
@@ -204,6 +220,200 @@ void PairLJCutCoulLong::compute(int eflag, int vflag)
   if (vflag_fdotr) virial_fdotr_compute();
 }
 
+/* ----------------------------------------------------------------------
+   compute all non-special pairs of a cluster-pair list
+   coords, charges and types are gathered into cluster order once per step,
+     so the loop over the atoms of a J cluster has no indirection
+   per-pair math is the same as in compute() with factor_lj = factor_coul = 1
+------------------------------------------------------------------------- */
+
+template <int EVFLAG>
+void PairLJCutCoulLong::eval_cluster(int eflag)
+{
+  int a,b,c,i,j,ci,cj,jj,jnum,itype,jtype,bits,itable;
+  double qtmp,xi,yi,zi,fxi,fyi,fzi,delx,dely,delz,evdwl,ecoul,fpair;
+  double fraction,table;
+  double r,rsq,r2inv,r6inv,forcecoul,forcelj;
+  double grij,expm2,prefactor,t,erfc;
+  double fxj[NCLUSTER],fyj[NCLUSTER],fzj[NCLUSTER];
+  double fcluster[3][NCLUSTER];
+  int *jlist;
+
+  double **x = atom->x;
+  double **f = atom->f;
+  double *q = atom->q;
+  int *type = atom->type;
+  int nlocal = atom->nlocal;
+  int newton_pair = force->newton_pair;
+  double qqrd2e = force->qqrd2e;
+
+  int ncluster = list->ncluster;
+  int nclusterlocal = list->nclusterlocal;
+  int *catom = list->catom;
+  int *cnumneigh = list->cnumneigh;
+  int **cfirstneigh = list->cfirstneigh;
+
+  // gather coords, charges and types, empty slots are never in a pair mask
+
+  if (ncluster > maxcluster) {
+    maxcluster = list->maxcluster;
+    memory->destroy(xcluster);
+    memory->destroy(qcluster);
+    memory->destroy(tcluster);
+    memory->create(xcluster,3*NCLUSTER*maxcluster,"pair:xcluster");
+    memory->create(qcluster,NCLUSTER*maxcluster,"pair:qcluster");
+    memory->create(tcluster,NCLUSTER*maxcluster,"pair:tcluster");
+  }
+
+  for (c = 0; c < ncluster; c++) {
+    double *xc = &xcluster[3*NCLUSTER*c];
+    for (a = 0; a < NCLUSTER; a++) {
+      i = catom[c*NCLUSTER+a];
+      if (i >= 0) {
+        xc[a] = x[i][0];
+        xc[NCLUSTER+a] = x[i][1];
+        xc[2*NCLUSTER+a] = x[i][2];
+        qcluster[c*NCLUSTER+a] = q[i];
+        tcluster[c*NCLUSTER+a] = type[i];
+      } else {
+        xc[a] = xc[NCLUSTER+a] = xc[2*NCLUSTER+a] = 0.0;
+        qcluster[c*NCLUSTER+a] = 0.0;
+        tcluster[c*NCLUSTER+a] = 1;
+      }
+    }
+  }
+
+  evdwl = ecoul = 0.0;
+  prefactor = erfc = fraction = 0.0;
+  itable = 0;
+
+  // loop over J clusters of my clusters
+
+  for (ci = 0; ci < nclusterlocal; ci++) {
+    const double *xci = &xcluster[3*NCLUSTER*ci];
+    const double *qci = &qcluster[NCLUSTER*ci];
+    const int *tci = &tcluster[NCLUSTER*ci];
+    jlist = cfirstneigh[ci];
+    jnum = cnumneigh[ci];
+
+    for (a = 0; a < NCLUSTER; a++)
+      fcluster[0][a] = fcluster[1][a] = fcluster[2][a] = 0.0;
+
+    for (jj = 0; jj < jnum; jj += 2) {
+      cj = jlist[jj];
+      bits = jlist[jj+1];
+      const double *xcj = &xcluster[3*NCLUSTER*cj];
+      const double *qcj = &qcluster[NCLUSTER*cj];
+      const int *tcj = &tcluster[NCLUSTER*cj];
+
+      for (b = 0; b < NCLUSTER; b++) fxj[b] = fyj[b] = fzj[b] = 0.0;
+
+      for (a = 0; a < NCLUSTER; a++) {
+        if (((bits >> (a*NCLUSTER)) & ((1 << NCLUSTER) - 1)) == 0) continue;
+        qtmp = qci[a];
+        xi = xci[a];
+        yi = xci[NCLUSTER+a];
+        zi = xci[2*NCLUSTER+a];
+        itype = tci[a];
+        const double *cutsqi = cutsq[itype];
+        const double *cut_ljsqi = cut_ljsq[itype];
+        const double *lj1i = lj1[itype];
+        const double *lj2i = lj2[itype];
+        fxi = fyi = fzi = 0.0;
+
+        for (b = 0; b < NCLUSTER; b++) {
+          if (((bits >> (a*NCLUSTER+b)) & 1) == 0) continue;
+          delx = xi - xcj[b];
+          dely = yi - xcj[NCLUSTER+b];
+          delz = zi - xcj[2*NCLUSTER+b];
+          rsq = delx*delx + dely*dely + delz*delz;
+          jtype = tcj[b];
+          if (rsq >= cutsqi[jtype]) continue;
+
+          r2inv = 1.0/rsq;
+
+          if (rsq < cut_coulsq) {
+            if (!ncoultablebits || rsq <= tabinnersq) {
+              r = sqrt(rsq);
+              grij = g_ewald * r;
+              expm2 = exp(-grij*grij);
+              t = 1.0 / (1.0 + EWALD_P*grij);
+              erfc = t * (A1+t*(A2+t*(A3+t*(A4+t*A5)))) * expm2;
+              prefactor = qqrd2e * qtmp*qcj[b]/r;
+              forcecoul = prefactor * (erfc + EWALD_F*grij*expm2);
+            } else {
+              union_int_float_t rsq_lookup;
+              rsq_lookup.f = rsq;
+              itable = rsq_lookup.i & ncoulmask;
+              itable >>= ncoulshiftbits;
+              fraction = (rsq_lookup.f - rtable[itable]) * drtable[itable];
+              table = ftable[itable] + fraction*dftable[itable];
+              forcecoul = qtmp*qcj[b] * table;
+            }
+          } else forcecoul = 0.0;
+
+          if (rsq < cut_ljsqi[jtype]) {
+            r6inv = r2inv*r2inv*r2inv;
+            forcelj = r6inv * (lj1i[jtype]*r6inv - lj2i[jtype]);
+          } else forcelj = 0.0;
+
+          fpair = (forcecoul + forcelj) * r2inv;
+
+          fxi += delx*fpair;
+          fyi += dely*fpair;
+          fzi += delz*fpair;
+          fxj[b] -= delx*fpair;
+          fyj[b] -= dely*fpair;
+          fzj[b] -= delz*fpair;
+
+          if (EVFLAG) {
+            if (eflag) {
+              if (rsq < cut_coulsq) {
+                if (!ncoultablebits || rsq <= tabinnersq)
+                  ecoul = prefactor*erfc;
+                else {
+                  table = etable[itable] + fraction*detable[itable];
+                  ecoul = qtmp*qcj[b] * table;
+                }
+              } else ecoul = 0.0;
+
+              if (rsq < cut_ljsqi[jtype]) {
+                evdwl = r6inv*(lj3[itype][jtype]*r6inv-lj4[itype][jtype]) -
+                  offset[itype][jtype];
+              } else evdwl = 0.0;
+            }
+
+            ev_tally(catom[ci*NCLUSTER+a],catom[cj*NCLUSTER+b],
+                     nlocal,newton_pair,evdwl,ecoul,fpair,delx,dely,delz);
+          }
+        }
+
+        fcluster[0][a] += fxi;
+        fcluster[1][a] += fyi;
+        fcluster[2][a] += fzi;
+      }
+
+      for (b = 0; b < NCLUSTER; b++) {
+        j = catom[cj*NCLUSTER+b];
+        if (j < 0) break;
+        if (newton_pair || j < nlocal) {
+          f[j][0] += fxj[b];
+          f[j][1] += fyj[b];
+          f[j][2] += fzj[b];
+        }
+      }
+    }
+
+    for (a = 0; a < NCLUSTER; a++) {
+      i = catom[ci*NCLUSTER+a];
+      if (i < 0) break;
+      f[i][0] += fcluster[0][a];
+      f[i][1] += fcluster[1][a];
+      f[i][2] += fcluster[2][a];
+    }
+  }
+}
+
 /* ---------------------------------------------------------------------- */
 
 void PairLJCutCoulLong::compute_inner()
@@ -690,7 +900,14 @@ void PairLJCutCoulLong::init_style()
       neighbor->requests[irequest]->respaouter = 1;
     }
 
-  } else irequest = neighbor->request(this,instance_me);
+  } else {
+    irequest = neighbor->request(this,instance_me);
+
+    // cluster-pair list only if compute() is not overridden by a derived style
+
+    if (strcmp(force->pair_style,"lj/cut/coul/long") == 0)
+      neighbor->requests[irequest]->cluster = 1;
+  }
 
   cut_coulsq = cut_coul * cut_coul;
 
@@ -58,7 +58,13 @@ class PairLJCutCoulLong : public Pair {
   double qdist;             // TIP4P distance from O site to negative charge
   double g_ewald;
 
+  int maxcluster;           // size of cluster-pair list gather arrays
+  double *xcluster;         // coords of atoms in each cluster
+  double *qcluster;         // charges of atoms in each cluster
+  int *tcluster;            // types of atoms in each cluster
+
   virtual void allocate();
+  template <int EVFLAG> void eval_cluster(int);
 };
 
 }
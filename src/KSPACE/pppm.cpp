@@ -70,6 +70,8 @@ PPPM::PPPM(LAMMPS *lmp, int narg, char **arg) : KSpace(lmp, narg, arg)
 
   pppmflag = 1;
   group_group_enable = 1;
+  r2c_support = 1;
+  r2c = 0;
 
   accuracy_relative = fabs(force->numeric(FLERR,arg[0]));
 
@@ -87,6 +89,7 @@ PPPM::PPPM(LAMMPS *lmp, int narg, char **arg) : KSpace(lmp, narg, arg)
   u_brick = NULL;
   v0_brick = v1_brick = v2_brick = v3_brick = v4_brick = v5_brick = NULL;
   greensfn = NULL;
+  kweight = NULL;
   work1 = work2 = NULL;
   vg = NULL;
   fkx = fky = fkz = NULL;
@@ -184,7 +187,7 @@ void PPPM::init()
                "slab correction");
   if (domain->dimension == 2) error->all(FLERR,
                                          "Cannot use PPPM with 2d simulation");
-  if (comm->style != 0)
+  if (comm->style == 1)
     error->universe_all(FLERR,"PPPM can only currently be used with "
                         "comm_style brick");
 
@@ -209,6 +212,17 @@ void PPPM::init()
   triclinic = domain->triclinic;
   pair_check();
 
+  // use real-to-complex FFTs if FFT library and style support them
+  // triclinic Green's function is not symmetric at Nyquist frequency
+
+#ifdef FFT_REAL
+  r2c = r2c_support && !triclinic;
+#else
+  r2c = 0;
+#endif
+  if (r2c) rstride = 1;
+  else rstride = 2;
+
   int itmp = 0;
   double *p_cutoff = (double *) force->pair->extract("cut_coul",itmp);
   if (p_cutoff == NULL)
@@ -449,7 +463,7 @@ void PPPM::setup()
   n = 0;
   for (k = nzlo_fft; k <= nzhi_fft; k++) {
     for (j = nylo_fft; j <= nyhi_fft; j++) {
-      for (i = nxlo_fft; i <= nxhi_fft; i++) {
+      for (i = nxlo_fft; i <= nxhi_kspace; i++) {
         sqk = fkx[i]*fkx[i] + fky[j]*fky[j] + fkz[k]*fkz[k];
         if (sqk == 0.0) {
           vg[n][0] = 0.0;
@@ -472,6 +486,37 @@ void PPPM::setup()
     }
   }
 
+  // real-to-complex FFTs treat k-space data as that of a real function,
+  //   like complex FFTs do when only the real part of results is kept
+  // at the Nyquist index of an even grid, k and its -k partner have the
+  //   same component, so terms odd in it cancel in that real part
+  // drop them from virial coefficients and ik gradient factors, since
+  //   k-space sums and per-atom virials would otherwise include them
+
+  if (r2c) {
+    int nyqx,nyqy,nyqz;
+    n = 0;
+    for (k = nzlo_fft; k <= nzhi_fft; k++) {
+      nyqz = (2*k == nz_pppm);
+      for (j = nylo_fft; j <= nyhi_fft; j++) {
+        nyqy = (2*j == ny_pppm);
+        for (i = nxlo_fft; i <= nxhi_kspace; i++) {
+          nyqx = (2*i == nx_pppm);
+          if (nyqx != nyqy) vg[n][3] = 0.0;
+          if (nyqx != nyqz) vg[n][4] = 0.0;
+          if (nyqy != nyqz) vg[n][5] = 0.0;
+          n++;
+        }
+      }
+    }
+
+    if (nx_pppm % 2 == 0) fkx[nx_pppm/2] = 0.0;
+    if (ny_pppm % 2 == 0 && nylo_fft <= ny_pppm/2 && ny_pppm/2 <= nyhi_fft)
+      fky[ny_pppm/2] = 0.0;
+    if (nz_pppm % 2 == 0 && nzlo_fft <= nz_pppm/2 && nz_pppm/2 <= nzhi_fft)
+      fkz[nz_pppm/2] = 0.0;
+  }
+
   if (differentiation_flag == 1) compute_gf_ad();
   else compute_gf_ik();
 }
@@ -757,10 +802,11 @@ void PPPM::allocate()
                           nxlo_out,nxhi_out,"pppm:density_brick");
 
   memory->create(density_fft,nfft_both,"pppm:density_fft");
-  memory->create(greensfn,nfft_both,"pppm:greensfn");
-  memory->create(work1,2*nfft_both,"pppm:work1");
-  memory->create(work2,2*nfft_both,"pppm:work2");
-  memory->create(vg,nfft_both,6,"pppm:vg");
+  memory->create(greensfn,nfft_kspace,"pppm:greensfn");
+  memory->create(kweight,nfft_kspace,"pppm:kweight");
+  memory->create(work1,nwork,"pppm:work1");
+  memory->create(work2,nwork,"pppm:work2");
+  memory->create(vg,nfft_kspace,6,"pppm:vg");
 
   if (triclinic == 0) {
     memory->create1d_offset(fkx,nxlo_fft,nxhi_fft,"pppm:fkx");
@@ -776,12 +822,12 @@ void PPPM::allocate()
     memory->create3d_offset(u_brick,nzlo_out,nzhi_out,nylo_out,nyhi_out,
                           nxlo_out,nxhi_out,"pppm:u_brick");
 
-    memory->create(sf_precoeff1,nfft_both,"pppm:sf_precoeff1");
-    memory->create(sf_precoeff2,nfft_both,"pppm:sf_precoeff2");
-    memory->create(sf_precoeff3,nfft_both,"pppm:sf_precoeff3");
-    memory->create(sf_precoeff4,nfft_both,"pppm:sf_precoeff4");
-    memory->create(sf_precoeff5,nfft_both,"pppm:sf_precoeff5");
-    memory->create(sf_precoeff6,nfft_both,"pppm:sf_precoeff6");
+    memory->create(sf_precoeff1,nfft_kspace,"pppm:sf_precoeff1");
+    memory->create(sf_precoeff2,nfft_kspace,"pppm:sf_precoeff2");
+    memory->create(sf_precoeff3,nfft_kspace,"pppm:sf_precoeff3");
+    memory->create(sf_precoeff4,nfft_kspace,"pppm:sf_precoeff4");
+    memory->create(sf_precoeff5,nfft_kspace,"pppm:sf_precoeff5");
+    memory->create(sf_precoeff6,nfft_kspace,"pppm:sf_precoeff6");
 
   } else {
     memory->create3d_offset(vdx_brick,nzlo_out,nzhi_out,nylo_out,nyhi_out,
@@ -792,6 +838,19 @@ void PPPM::allocate()
                             nxlo_out,nxhi_out,"pppm:vdz_brick");
   }
 
+  // with real-to-complex FFTs, k-space pts with 0 < kx < nx/2
+  //   also stand for their -k partner, which is not stored
+
+  int i,j,k,n;
+
+  n = 0;
+  for (k = nzlo_fft; k <= nzhi_fft; k++)
+    for (j = nylo_fft; j <= nyhi_fft; j++)
+      for (i = nxlo_fft; i <= nxhi_kspace; i++) {
+        if (r2c && i > 0 && 2*i < nx_pppm) kweight[n++] = 2.0;
+        else kweight[n++] = 1.0;
+      }
+
   // summation coeffs
 
   order_allocated = order;
@@ -806,18 +865,19 @@ void PPPM::allocate()
   // 1st FFT keeps data in FFT decompostion
   // 2nd FFT returns data in 3d brick decomposition
   // remap takes data from 3d brick to FFT decomposition
+  // real-to-complex FFTs return/take only x indices 0 to nx/2 in k-space
 
   int tmp;
 
   fft1 = new FFT3d(lmp,world,nx_pppm,ny_pppm,nz_pppm,
                    nxlo_fft,nxhi_fft,nylo_fft,nyhi_fft,nzlo_fft,nzhi_fft,
                    nxlo_fft,nxhi_fft,nylo_fft,nyhi_fft,nzlo_fft,nzhi_fft,
-                   0,0,&tmp,collective_flag);
+                   0,0,&tmp,collective_flag,r2c);
 
   fft2 = new FFT3d(lmp,world,nx_pppm,ny_pppm,nz_pppm,
                    nxlo_fft,nxhi_fft,nylo_fft,nyhi_fft,nzlo_fft,nzhi_fft,
                    nxlo_in,nxhi_in,nylo_in,nyhi_in,nzlo_in,nzhi_in,
-                   0,0,&tmp,collective_flag);
+                   0,0,&tmp,collective_flag,r2c);
 
   remap = new Remap(lmp,world,
                     nxlo_in,nxhi_in,nylo_in,nyhi_in,nzlo_in,nzhi_in,
@@ -866,6 +926,7 @@ void PPPM::deallocate()
 
   memory->destroy(density_fft);
   memory->destroy(greensfn);
+  memory->destroy(kweight);
   memory->destroy(work1);
   memory->destroy(work2);
   memory->destroy(vg);
@@ -1496,6 +1557,18 @@ void PPPM::set_grid_local()
   int nfft_brick = (nxhi_in-nxlo_in+1) * (nyhi_in-nylo_in+1) *
     (nzhi_in-nzlo_in+1);
   nfft_both = MAX(nfft,nfft_brick);
+
+  // k-space pts owned by this proc
+  // real-to-complex FFTs only store x indices 0 to nx/2 of k-space
+  // nwork = values in work arrays, for complex k-space data or
+  //   complex (real) data in 3d brick decomposition without (with) r2c
+
+  if (r2c) nxhi_kspace = nx_pppm/2;
+  else nxhi_kspace = nxhi_fft;
+  nfft_kspace = (nxhi_kspace-nxlo_fft+1) * (nyhi_fft-nylo_fft+1) *
+    (nzhi_fft-nzlo_fft+1);
+  if (r2c) nwork = MAX(2*nfft_kspace,nfft_both);
+  else nwork = 2*nfft_both;
 }
 
 /* ----------------------------------------------------------------------
@@ -1562,7 +1635,7 @@ void PPPM::compute_gf_ik()
       lper = l - ny_pppm*(2*l/ny_pppm);
       sny = square(sin(0.5*unitky*lper*yprd/ny_pppm));
 
-      for (k = nxlo_fft; k <= nxhi_fft; k++) {
+      for (k = nxlo_fft; k <= nxhi_kspace; k++) {
         kper = k - nx_pppm*(2*k/nx_pppm);
         snx = square(sin(0.5*unitkx*kper*xprd/nx_pppm));
 
@@ -1738,7 +1811,7 @@ void PPPM::compute_gf_ad()
       argy = 0.5*qy*yprd/ny_pppm;
       wy = powsinxx(argy,twoorder);
 
-      for (k = nxlo_fft; k <= nxhi_fft; k++) {
+      for (k = nxlo_fft; k <= nxhi_kspace; k++) {
         kper = k - nx_pppm*(2*k/nx_pppm);
         qx = unitkx*kper;
         snx = square(sin(0.5*qx*xprd/nx_pppm));
@@ -1752,21 +1825,21 @@ void PPPM::compute_gf_ad()
           numerator = MY_4PI/sqk;
           denominator = gf_denom(snx,sny,snz);
           greensfn[n] = numerator*sx*sy*sz*wx*wy*wz/denominator;
-          sf_coeff[0] += sf_precoeff1[n]*greensfn[n];
-          sf_coeff[1] += sf_precoeff2[n]*greensfn[n];
-          sf_coeff[2] += sf_precoeff3[n]*greensfn[n];
-          sf_coeff[3] += sf_precoeff4[n]*greensfn[n];
-          sf_coeff[4] += sf_precoeff5[n]*greensfn[n];
-          sf_coeff[5] += sf_precoeff6[n]*greensfn[n];
+          sf_coeff[0] += kweight[n]*sf_precoeff1[n]*greensfn[n];
+          sf_coeff[1] += kweight[n]*sf_precoeff2[n]*greensfn[n];
+          sf_coeff[2] += kweight[n]*sf_precoeff3[n]*greensfn[n];
+          sf_coeff[3] += kweight[n]*sf_precoeff4[n]*greensfn[n];
+          sf_coeff[4] += kweight[n]*sf_precoeff5[n]*greensfn[n];
+          sf_coeff[5] += kweight[n]*sf_precoeff6[n]*greensfn[n];
           n++;
         } else {
           greensfn[n] = 0.0;
-          sf_coeff[0] += sf_precoeff1[n]*greensfn[n];
-          sf_coeff[1] += sf_precoeff2[n]*greensfn[n];
-          sf_coeff[2] += sf_precoeff3[n]*greensfn[n];
-          sf_coeff[3] += sf_precoeff4[n]*greensfn[n];
-          sf_coeff[4] += sf_precoeff5[n]*greensfn[n];
-          sf_coeff[5] += sf_precoeff6[n]*greensfn[n];
+          sf_coeff[0] += kweight[n]*sf_precoeff1[n]*greensfn[n];
+          sf_coeff[1] += kweight[n]*sf_precoeff2[n]*greensfn[n];
+          sf_coeff[2] += kweight[n]*sf_precoeff3[n]*greensfn[n];
+          sf_coeff[3] += kweight[n]*sf_precoeff4[n]*greensfn[n];
+          sf_coeff[4] += kweight[n]*sf_precoeff5[n]*greensfn[n];
+          sf_coeff[5] += kweight[n]*sf_precoeff6[n]*greensfn[n];
           n++;
         }
       }
@@ -1814,7 +1887,7 @@ void PPPM::compute_sf_precoeff()
     for (l = nylo_fft; l <= nyhi_fft; l++) {
       lper = l - ny_pppm*(2*l/ny_pppm);
 
-      for (k = nxlo_fft; k <= nxhi_fft; k++) {
+      for (k = nxlo_fft; k <= nxhi_kspace; k++) {
         kper = k - nx_pppm*(2*k/nx_pppm);
 
         sum1 = sum2 = sum3 = sum4 = sum5 = sum6 = 0.0;
@@ -2014,15 +2087,18 @@ void PPPM::poisson_ik()
   double eng;
 
   // transform charge density (r -> k)
+  // real-to-complex FFT needs no complex copy of it
 
-  n = 0;
-  for (i = 0; i < nfft; i++) {
-    work1[n++] = density_fft[i];
-    work1[n++] = ZEROF;
+  if (r2c) fft1->compute(density_fft,work1,1);
+  else {
+    n = 0;
+    for (i = 0; i < nfft; i++) {
+      work1[n++] = density_fft[i];
+      work1[n++] = ZEROF;
+    }
+    fft1->compute(work1,work1,1);
   }
 
-  fft1->compute(work1,work1,1);
-
   // global energy and virial contribution
 
   double scaleinv = 1.0/(nx_pppm*ny_pppm*nz_pppm);
@@ -2031,17 +2107,18 @@ void PPPM::poisson_ik()
   if (eflag_global || vflag_global) {
     if (vflag_global) {
       n = 0;
-      for (i = 0; i < nfft; i++) {
-        eng = s2 * greensfn[i] * (work1[n]*work1[n] + work1[n+1]*work1[n+1]);
+      for (i = 0; i < nfft_kspace; i++) {
+        eng = s2 * kweight[i] * greensfn[i] *
+          (work1[n]*work1[n] + work1[n+1]*work1[n+1]);
         for (j = 0; j < 6; j++) virial[j] += eng*vg[i][j];
         if (eflag_global) energy += eng;
         n += 2;
       }
     } else {
       n = 0;
-      for (i = 0; i < nfft; i++) {
-        energy +=
-          s2 * greensfn[i] * (work1[n]*work1[n] + work1[n+1]*work1[n+1]);
+      for (i = 0; i < nfft_kspace; i++) {
+        energy += s2 * kweight[i] * greensfn[i] *
+          (work1[n]*work1[n] + work1[n+1]*work1[n+1]);
         n += 2;
       }
     }
@@ -2051,7 +2128,7 @@ void PPPM::poisson_ik()
   // multiply by Green's function to get V(k)
 
   n = 0;
-  for (i = 0; i < nfft; i++) {
+  for (i = 0; i < nfft_kspace; i++) {
     work1[n++] *= scaleinv * greensfn[i];
     work1[n++] *= scaleinv * greensfn[i];
   }
@@ -2076,7 +2153,7 @@ void PPPM::poisson_ik()
   n = 0;
   for (k = nzlo_fft; k <= nzhi_fft; k++)
     for (j = nylo_fft; j <= nyhi_fft; j++)
-      for (i = nxlo_fft; i <= nxhi_fft; i++) {
+      for (i = nxlo_fft; i <= nxhi_kspace; i++) {
         work2[n] = fkx[i]*work1[n+1];
         work2[n+1] = -fkx[i]*work1[n];
         n += 2;
@@ -2089,7 +2166,7 @@ void PPPM::poisson_ik()
     for (j = nylo_in; j <= nyhi_in; j++)
       for (i = nxlo_in; i <= nxhi_in; i++) {
         vdx_brick[k][j][i] = work2[n];
-        n += 2;
+        n += rstride;
       }
 
   // y direction gradient
@@ -2097,7 +2174,7 @@ void PPPM::poisson_ik()
   n = 0;
   for (k = nzlo_fft; k <= nzhi_fft; k++)
     for (j = nylo_fft; j <= nyhi_fft; j++)
-      for (i = nxlo_fft; i <= nxhi_fft; i++) {
+      for (i = nxlo_fft; i <= nxhi_kspace; i++) {
         work2[n] = fky[j]*work1[n+1];
         work2[n+1] = -fky[j]*work1[n];
         n += 2;
@@ -2110,7 +2187,7 @@ void PPPM::poisson_ik()
     for (j = nylo_in; j <= nyhi_in; j++)
       for (i = nxlo_in; i <= nxhi_in; i++) {
         vdy_brick[k][j][i] = work2[n];
-        n += 2;
+        n += rstride;
       }
 
   // z direction gradient
@@ -2118,7 +2195,7 @@ void PPPM::poisson_ik()
   n = 0;
   for (k = nzlo_fft; k <= nzhi_fft; k++)
     for (j = nylo_fft; j <= nyhi_fft; j++)
-      for (i = nxlo_fft; i <= nxhi_fft; i++) {
+      for (i = nxlo_fft; i <= nxhi_kspace; i++) {
         work2[n] = fkz[k]*work1[n+1];
         work2[n+1] = -fkz[k]*work1[n];
         n += 2;
@@ -2131,7 +2208,7 @@ void PPPM::poisson_ik()
     for (j = nylo_in; j <= nyhi_in; j++)
       for (i = nxlo_in; i <= nxhi_in; i++) {
         vdz_brick[k][j][i] = work2[n];
-        n += 2;
+        n += rstride;
       }
 }
 
@@ -2215,15 +2292,18 @@ void PPPM::poisson_ad()
   double eng;
 
   // transform charge density (r -> k)
+  // real-to-complex FFT needs no complex copy of it
 
-  n = 0;
-  for (i = 0; i < nfft; i++) {
-    work1[n++] = density_fft[i];
-    work1[n++] = ZEROF;
+  if (r2c) fft1->compute(density_fft,work1,1);
+  else {
+    n = 0;
+    for (i = 0; i < nfft; i++) {
+      work1[n++] = density_fft[i];
+      work1[n++] = ZEROF;
+    }
+    fft1->compute(work1,work1,1);
   }
 
-  fft1->compute(work1,work1,1);
-
   // global energy and virial contribution
 
   double scaleinv = 1.0/(nx_pppm*ny_pppm*nz_pppm);
@@ -2232,17 +2312,18 @@ void PPPM::poisson_ad()
   if (eflag_global || vflag_global) {
     if (vflag_global) {
       n = 0;
-      for (i = 0; i < nfft; i++) {
-        eng = s2 * greensfn[i] * (work1[n]*work1[n] + work1[n+1]*work1[n+1]);
+      for (i = 0; i < nfft_kspace; i++) {
+        eng = s2 * kweight[i] * greensfn[i] *
+          (work1[n]*work1[n] + work1[n+1]*work1[n+1]);
         for (j = 0; j < 6; j++) virial[j] += eng*vg[i][j];
         if (eflag_global) energy += eng;
         n += 2;
       }
     } else {
       n = 0;
-      for (i = 0; i < nfft; i++) {
-        energy +=
-          s2 * greensfn[i] * (work1[n]*work1[n] + work1[n+1]*work1[n+1]);
+      for (i = 0; i < nfft_kspace; i++) {
+        energy += s2 * kweight[i] * greensfn[i] *
+          (work1[n]*work1[n] + work1[n+1]*work1[n+1]);
         n += 2;
       }
     }
@@ -2252,7 +2333,7 @@ void PPPM::poisson_ad()
   // multiply by Green's function to get V(k)
 
   n = 0;
-  for (i = 0; i < nfft; i++) {
+  for (i = 0; i < nfft_kspace; i++) {
     work1[n++] *= scaleinv * greensfn[i];
     work1[n++] *= scaleinv * greensfn[i];
   }
@@ -2262,7 +2343,7 @@ void PPPM::poisson_ad()
   if (vflag_atom) poisson_peratom();
 
   n = 0;
-  for (i = 0; i < nfft; i++) {
+  for (i = 0; i < nfft_kspace; i++) {
     work2[n] = work1[n];
     work2[n+1] = work1[n+1];
     n += 2;
@@ -2275,7 +2356,7 @@ void PPPM::poisson_ad()
     for (j = nylo_in; j <= nyhi_in; j++)
       for (i = nxlo_in; i <= nxhi_in; i++) {
         u_brick[k][j][i] = work2[n];
-        n += 2;
+        n += rstride;
       }
 }
 
@@ -2291,7 +2372,7 @@ void PPPM::poisson_peratom()
 
   if (eflag_atom && differentiation_flag != 1) {
     n = 0;
-    for (i = 0; i < nfft; i++) {
+    for (i = 0; i < nfft_kspace; i++) {
       work2[n] = work1[n];
       work2[n+1] = work1[n+1];
       n += 2;
@@ -2304,7 +2385,7 @@ void PPPM::poisson_peratom()
       for (j = nylo_in; j <= nyhi_in; j++)
         for (i = nxlo_in; i <= nxhi_in; i++) {
           u_brick[k][j][i] = work2[n];
-          n += 2;
+          n += rstride;
         }
   }
 
@@ -2313,7 +2394,7 @@ void PPPM::poisson_peratom()
   if (!vflag_atom) return;
 
   n = 0;
-  for (i = 0; i < nfft; i++) {
+  for (i = 0; i < nfft_kspace; i++) {
     work2[n] = work1[n]*vg[i][0];
     work2[n+1] = work1[n+1]*vg[i][0];
     n += 2;
@@ -2326,11 +2407,11 @@ void PPPM::poisson_peratom()
     for (j = nylo_in; j <= nyhi_in; j++)
       for (i = nxlo_in; i <= nxhi_in; i++) {
         v0_brick[k][j][i] = work2[n];
-        n += 2;
+        n += rstride;
       }
 
   n = 0;
-  for (i = 0; i < nfft; i++) {
+  for (i = 0; i < nfft_kspace; i++) {
     work2[n] = work1[n]*vg[i][1];
     work2[n+1] = work1[n+1]*vg[i][1];
     n += 2;
@@ -2343,11 +2424,11 @@ void PPPM::poisson_peratom()
     for (j = nylo_in; j <= nyhi_in; j++)
       for (i = nxlo_in; i <= nxhi_in; i++) {
         v1_brick[k][j][i] = work2[n];
-        n += 2;
+        n += rstride;
       }
 
   n = 0;
-  for (i = 0; i < nfft; i++) {
+  for (i = 0; i < nfft_kspace; i++) {
     work2[n] = work1[n]*vg[i][2];
     work2[n+1] = work1[n+1]*vg[i][2];
     n += 2;
@@ -2360,11 +2441,11 @@ void PPPM::poisson_peratom()
     for (j = nylo_in; j <= nyhi_in; j++)
       for (i = nxlo_in; i <= nxhi_in; i++) {
         v2_brick[k][j][i] = work2[n];
-        n += 2;
+        n += rstride;
       }
 
   n = 0;
-  for (i = 0; i < nfft; i++) {
+  for (i = 0; i < nfft_kspace; i++) {
     work2[n] = work1[n]*vg[i][3];
     work2[n+1] = work1[n+1]*vg[i][3];
     n += 2;
@@ -2377,11 +2458,11 @@ void PPPM::poisson_peratom()
     for (j = nylo_in; j <= nyhi_in; j++)
       for (i = nxlo_in; i <= nxhi_in; i++) {
         v3_brick[k][j][i] = work2[n];
-        n += 2;
+        n += rstride;
       }
 
   n = 0;
-  for (i = 0; i < nfft; i++) {
+  for (i = 0; i < nfft_kspace; i++) {
     work2[n] = work1[n]*vg[i][4];
     work2[n+1] = work1[n+1]*vg[i][4];
     n += 2;
@@ -2394,11 +2475,11 @@ void PPPM::poisson_peratom()
     for (j = nylo_in; j <= nyhi_in; j++)
       for (i = nxlo_in; i <= nxhi_in; i++) {
         v4_brick[k][j][i] = work2[n];
-        n += 2;
+        n += rstride;
       }
 
   n = 0;
-  for (i = 0; i < nfft; i++) {
+  for (i = 0; i < nfft_kspace; i++) {
     work2[n] = work1[n]*vg[i][5];
     work2[n+1] = work1[n+1]*vg[i][5];
     n += 2;
@@ -2411,7 +2492,7 @@ void PPPM::poisson_peratom()
     for (j = nylo_in; j <= nyhi_in; j++)
       for (i = nxlo_in; i <= nxhi_in; i++) {
         v5_brick[k][j][i] = work2[n];
-        n += 2;
+        n += rstride;
       }
 }
 
@@ -2999,17 +3080,17 @@ int PPPM::timing_1d(int n, double &time1d)
 {
   double time1,time2;
 
-  for (int i = 0; i < 2*nfft_both; i++) work1[i] = ZEROF;
+  for (int i = 0; i < nwork; i++) work1[i] = ZEROF;
 
   MPI_Barrier(world);
   time1 = MPI_Wtime();
 
   for (int i = 0; i < n; i++) {
-    fft1->timing1d(work1,nfft_both,1);
-    fft2->timing1d(work1,nfft_both,-1);
+    fft1->timing1d(work1,nwork/2,1);
+    fft2->timing1d(work1,nwork/2,-1);
     if (differentiation_flag != 1) {
-      fft2->timing1d(work1,nfft_both,-1);
-      fft2->timing1d(work1,nfft_both,-1);
+      fft2->timing1d(work1,nwork/2,-1);
+      fft2->timing1d(work1,nwork/2,-1);
     }
   }
 
@@ -3029,7 +3110,7 @@ int PPPM::timing_3d(int n, double &time3d)
 {
   double time1,time2;
 
-  for (int i = 0; i < 2*nfft_both; i++) work1[i] = ZEROF;
+  for (int i = 0; i < nwork; i++) work1[i] = ZEROF;
 
   MPI_Barrier(world);
   time1 = MPI_Wtime();
@@ -3066,9 +3147,10 @@ double PPPM::memory_usage()
     bytes += 4 * nbrick * sizeof(FFT_SCALAR);
   }
   if (triclinic) bytes += 3 * nfft_both * sizeof(double);
-  bytes += 6 * nfft_both * sizeof(double);
-  bytes += nfft_both * sizeof(double);
-  bytes += nfft_both*5 * sizeof(FFT_SCALAR);
+  bytes += 6 * nfft_kspace * sizeof(double);
+  bytes += 2 * nfft_kspace * sizeof(double);
+  bytes += nfft_both * sizeof(FFT_SCALAR);
+  bytes += 2 * nwork * sizeof(FFT_SCALAR);
 
   if (peratom_allocate_flag)
     bytes += 6 * nbrick * sizeof(FFT_SCALAR);
@@ -3302,26 +3384,32 @@ void PPPM::poisson_groups(int AA_flag)
 
   // transform charge density (r -> k)
 
+  // real-to-complex FFTs need no complex copies of them
+
   // group A
 
-  n = 0;
-  for (i = 0; i < nfft; i++) {
-    work_A[n++] = density_A_fft[i];
-    work_A[n++] = ZEROF;
+  if (r2c) fft1->compute(density_A_fft,work_A,1);
+  else {
+    n = 0;
+    for (i = 0; i < nfft; i++) {
+      work_A[n++] = density_A_fft[i];
+      work_A[n++] = ZEROF;
+    }
+    fft1->compute(work_A,work_A,1);
   }
 
-  fft1->compute(work_A,work_A,1);
-
   // group B
 
-  n = 0;
-  for (i = 0; i < nfft; i++) {
-    work_B[n++] = density_B_fft[i];
-    work_B[n++] = ZEROF;
+  if (r2c) fft1->compute(density_B_fft,work_B,1);
+  else {
+    n = 0;
+    for (i = 0; i < nfft; i++) {
+      work_B[n++] = density_B_fft[i];
+      work_B[n++] = ZEROF;
+    }
+    fft1->compute(work_B,work_B,1);
   }
 
-  fft1->compute(work_B,work_B,1);
-
   // group-group energy and force contribution,
   //  keep everything in reciprocal space so
   //  no inverse FFTs needed
@@ -3332,8 +3420,8 @@ void PPPM::poisson_groups(int AA_flag)
   // energy
 
   n = 0;
-  for (i = 0; i < nfft; i++) {
-    e2group += s2 * greensfn[i] *
+  for (i = 0; i < nfft_kspace; i++) {
+    e2group += s2 * kweight[i] * greensfn[i] *
       (work_A[n]*work_B[n] + work_A[n+1]*work_B[n+1]);
     n += 2;
   }
@@ -3341,13 +3429,13 @@ void PPPM::poisson_groups(int AA_flag)
   if (AA_flag) return;
 
 
-  // multiply by Green's function and s2
+  // multiply by Green's function, s2 and k-space weight
   //  (only for work_A so it is not squared below)
 
   n = 0;
-  for (i = 0; i < nfft; i++) {
-    work_A[n++] *= s2 * greensfn[i];
-    work_A[n++] *= s2 * greensfn[i];
+  for (i = 0; i < nfft_kspace; i++) {
+    work_A[n++] *= s2 * kweight[i] * greensfn[i];
+    work_A[n++] *= s2 * kweight[i] * greensfn[i];
   }
 
   // triclinic system
@@ -3364,7 +3452,7 @@ void PPPM::poisson_groups(int AA_flag)
   n = 0;
   for (k = nzlo_fft; k <= nzhi_fft; k++)
     for (j = nylo_fft; j <= nyhi_fft; j++)
-      for (i = nxlo_fft; i <= nxhi_fft; i++) {
+      for (i = nxlo_fft; i <= nxhi_kspace; i++) {
         partial_group = work_A[n+1]*work_B[n] - work_A[n]*work_B[n+1];
         f2group[0] += fkx[i] * partial_group;
         n += 2;
@@ -3375,7 +3463,7 @@ void PPPM::poisson_groups(int AA_flag)
   n = 0;
   for (k = nzlo_fft; k <= nzhi_fft; k++)
     for (j = nylo_fft; j <= nyhi_fft; j++)
-      for (i = nxlo_fft; i <= nxhi_fft; i++) {
+      for (i = nxlo_fft; i <= nxhi_kspace; i++) {
         partial_group = work_A[n+1]*work_B[n] - work_A[n]*work_B[n+1];
         f2group[1] += fky[j] * partial_group;
         n += 2;
@@ -3386,7 +3474,7 @@ void PPPM::poisson_groups(int AA_flag)
   n = 0;
   for (k = nzlo_fft; k <= nzhi_fft; k++)
     for (j = nylo_fft; j <= nyhi_fft; j++)
-      for (i = nxlo_fft; i <= nxhi_fft; i++) {
+      for (i = nxlo_fft; i <= nxhi_kspace; i++) {
         partial_group = work_A[n+1]*work_B[n] - work_A[n]*work_B[n+1];
         f2group[2] += fkz[k] * partial_group;
         n += 2;
@@ -66,6 +66,11 @@ class PPPM : public KSpace {
   int nxlo_fft,nylo_fft,nzlo_fft,nxhi_fft,nyhi_fft,nzhi_fft;
   int nlower,nupper;
   int ngrid,nfft,nfft_both;
+  int r2c_support;             // 1 if style can use real-to-complex FFTs
+  int r2c;                     // 1 if real-to-complex FFTs are used
+  int nxhi_kspace,nfft_kspace; // hi x index and # of k-space pts on this proc
+  int nwork;                   // # of values in work1,work2
+  int rstride;                 // stride of real values in work2 after FFT
 
   FFT_SCALAR ***density_brick;
   FFT_SCALAR ***vdx_brick,***vdy_brick,***vdz_brick;
@@ -73,6 +78,7 @@ class PPPM : public KSpace {
   FFT_SCALAR ***v0_brick,***v1_brick,***v2_brick;
   FFT_SCALAR ***v3_brick,***v4_brick,***v5_brick;
   double *greensfn;
+  double *kweight;             // weight of k-space pts in sums over k
   double **vg;
   double *fkx,*fky,*fkz;
   FFT_SCALAR *density_fft;
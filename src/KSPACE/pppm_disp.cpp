@@ -212,7 +212,7 @@ void PPPMDisp::init()
   triclinic_check();
   if (domain->dimension == 2)
     error->all(FLERR,"Cannot use PPPMDisp with 2d simulation");
-  if (comm->style != 0)
+  if (comm->style == 1)
     error->universe_all(FLERR,"PPPMDisp can only currently be used with "
                         "comm_style brick");
 
@@ -57,6 +57,7 @@ PPPMStagger::PPPMStagger(LAMMPS *lmp, int narg, char **arg) :
   if (narg < 1) error->all(FLERR,"Illegal kspace_style pppm/stagger command");
   stagger_flag = 1;
   group_group_enable = 0;
+  r2c_support = 0;
 
   memory->create(gf_b2,8,7,"pppm_stagger:gf_b2");
   gf_b2[1][0] = 1.0;
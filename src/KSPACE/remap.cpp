@@ -109,6 +109,32 @@ void remap_3d(FFT_SCALAR *in, FFT_SCALAR *out, FFT_SCALAR *buf,
                    &out[plan->recv_offset[irecv]],&plan->unpackplan[irecv]);
     }
 
+  // use one All2Allv on a comm which holds all partners, e.g. a row or
+  // column of procs in a pencil FFT, with counts computed by the plan
+  // all of in is packed before out is written, so in can be same as out
+
+  } else if (plan->usecollective == 2) {
+    int isend,irecv;
+    FFT_SCALAR *scratch;
+
+    if (plan->memory == 0)
+      scratch = buf;
+    else
+      scratch = plan->scratch;
+
+    for (isend = 0; isend < plan->nsend; isend++)
+      plan->pack(&in[plan->send_offset[isend]],
+                 &plan->sendbuf[plan->sdispls[plan->send_proc[isend]]],
+                 &plan->packplan[isend]);
+
+    MPI_Alltoallv(plan->sendbuf,plan->sendcnts,plan->sdispls,MPI_FFT_SCALAR,
+                  scratch,plan->recvcnts,plan->rdispls,MPI_FFT_SCALAR,
+                  plan->comm);
+
+    for (irecv = 0; irecv < plan->nrecv; irecv++)
+      plan->unpack(&scratch[plan->recv_bufloc[irecv]],
+                   &out[plan->recv_offset[irecv]],&plan->unpackplan[irecv]);
+
   // use All2Allv collective for remap communication
 
   } else {
@@ -226,6 +252,10 @@ void remap_3d(FFT_SCALAR *in, FFT_SCALAR *out, FFT_SCALAR *buf,
                           1 = single precision (4 bytes per datum)
                           2 = double precision (8 bytes per datum)
    usecollective        whether to use collective MPI or point-to-point
+                          0 = point-to-point
+                          1 = Alltoallv on a sub-comm of my partners
+                          2 = Alltoallv on comm, which must be small,
+                                e.g. a row or column of a proc grid
 ------------------------------------------------------------------------- */
 
 struct remap_plan_3d *remap_3d_create_plan(
@@ -454,7 +484,7 @@ struct remap_plan_3d *remap_3d_create_plan(
 
   // create sub-comm rank list
 
-  if (plan->usecollective) {
+  if (plan->usecollective == 1) {
     plan->commringlist = NULL;
 
     // merge recv and send rank lists
@@ -575,13 +605,45 @@ struct remap_plan_3d *remap_3d_create_plan(
   free(inarray);
   free(outarray);
 
+  // for a single Alltoallv on comm, store counts and offsets of all procs
+  // send offsets follow send order, recvs land where recv_bufloc says
+
+  if (plan->usecollective == 2) {
+    plan->commringlen = 0;
+    plan->commringlist = NULL;
+    plan->sendcnts = (int *) malloc(nprocs*sizeof(int));
+    plan->sdispls = (int *) malloc(nprocs*sizeof(int));
+    plan->recvcnts = (int *) malloc(nprocs*sizeof(int));
+    plan->rdispls = (int *) malloc(nprocs*sizeof(int));
+    if (plan->sendcnts == NULL || plan->sdispls == NULL ||
+        plan->recvcnts == NULL || plan->rdispls == NULL) return NULL;
+
+    for (iproc = 0; iproc < nprocs; iproc++) {
+      plan->sendcnts[iproc] = plan->sdispls[iproc] = 0;
+      plan->recvcnts[iproc] = plan->rdispls[iproc] = 0;
+    }
+    ibuf = 0;
+    for (i = 0; i < plan->nsend; i++) {
+      plan->sendcnts[plan->send_proc[i]] = plan->send_size[i];
+      plan->sdispls[plan->send_proc[i]] = ibuf;
+      ibuf += plan->send_size[i];
+    }
+    for (i = 0; i < plan->nrecv; i++) {
+      plan->recvcnts[plan->recv_proc[i]] = plan->recv_size[i];
+      plan->rdispls[plan->recv_proc[i]] = plan->recv_bufloc[i];
+    }
+  }
+
   // find biggest send message (not including self) and malloc space for it
+  // for a single Alltoallv on comm, space for all of them
 
   plan->sendbuf = NULL;
 
   size = 0;
-  for (nsend = 0; nsend < plan->nsend; nsend++)
-    size = MAX(size,plan->send_size[nsend]);
+  for (nsend = 0; nsend < plan->nsend; nsend++) {
+    if (plan->usecollective == 2) size += plan->send_size[nsend];
+    else size = MAX(size,plan->send_size[nsend]);
+  }
 
   if (size) {
     plan->sendbuf = (FFT_SCALAR *) malloc(size*sizeof(FFT_SCALAR));
@@ -606,7 +668,7 @@ struct remap_plan_3d *remap_3d_create_plan(
   // communicator for the plan based off an MPI_Group created with
   // ranks from the commringlist
 
-  if ((plan->usecollective && (plan->commringlen > 0))) {
+  if ((plan->usecollective == 1) && (plan->commringlen > 0)) {
     MPI_Group orig_group, new_group;
     MPI_Comm_group(comm, &orig_group);
     MPI_Group_incl(orig_group, plan->commringlen,
@@ -617,11 +679,11 @@ struct remap_plan_3d *remap_3d_create_plan(
   // if using collective and the comm ring list is empty create
   // a communicator for the plan with an empty group
 
-  else if ((plan->usecollective) && (plan->commringlen == 0)) {
+  else if ((plan->usecollective == 1) && (plan->commringlen == 0)) {
     MPI_Comm_create(comm, MPI_GROUP_EMPTY, &plan->comm);
   }
 
-  // not using collective - dup comm
+  // not using collective or Alltoallv on all of comm - dup comm
 
   else MPI_Comm_dup(comm,&plan->comm);
 
@@ -638,14 +700,21 @@ void remap_3d_destroy_plan(struct remap_plan_3d *plan)
 {
   // free MPI communicator
 
-  if (!((plan->usecollective) && (plan->commringlen == 0)))
+  if (!((plan->usecollective == 1) && (plan->commringlen == 0)))
     MPI_Comm_free(&plan->comm);
 
-  if (plan->usecollective) {
+  if (plan->usecollective == 1) {
     if (plan->commringlist != NULL)
       free(plan->commringlist);
   }
 
+  if (plan->usecollective == 2) {
+    free(plan->sendcnts);
+    free(plan->sdispls);
+    free(plan->recvcnts);
+    free(plan->rdispls);
+  }
+
   // free internal arrays
 
   if (plan->nsend || plan->self) {
@@ -48,6 +48,8 @@ struct remap_plan_3d {
   int usecollective;                // use collective or point-to-point MPI
   int commringlen;                  // length of commringlist
   int *commringlist;                // ranks on communication ring of this plan
+  int *sendcnts,*sdispls;           // Alltoallv counts and offsets for each
+  int *recvcnts,*rdispls;           //   proc in comm, if usecollective = 2
 };
 
 // collision between 2 regions
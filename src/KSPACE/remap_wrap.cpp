@@ -27,6 +27,11 @@ Remap::Remap(LAMMPS *lmp, MPI_Comm comm,
              int nqty, int permute, int memory,
              int precision, int usecollective) : Pointers(lmp)
 {
+  // pencil FFTs (usecollective = 2) only use Alltoallv within rows and
+  // columns, a remap between grid and FFT layouts on comm is point-to-point
+
+  if (usecollective == 2) usecollective = 0;
+
   plan = remap_3d_create_plan(comm,
                               in_ilo,in_ihi,in_jlo,in_jhi,in_klo,in_khi,
                               out_ilo,out_ihi,out_jlo,out_jhi,out_klo,out_khi,
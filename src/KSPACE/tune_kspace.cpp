@@ -0,0 +1,314 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include <mpi.h>
+#include <stdio.h>
+#include <string.h>
+#include "tune_kspace.h"
+#include "domain.h"
+#include "comm.h"
+#include "force.h"
+#include "pair.h"
+#include "kspace.h"
+#include "update.h"
+#include "integrate.h"
+#include "finish.h"
+#include "timer.h"
+#include "memory.h"
+#include "error.h"
+
+using namespace LAMMPS_NS;
+
+/* ---------------------------------------------------------------------- */
+
+TuneKspace::TuneKspace(LAMMPS *lmp) : Pointers(lmp)
+{
+  MPI_Comm_rank(world,&me);
+  MPI_Comm_size(world,&nprocs);
+
+  ntrial = 0;
+  cutoff = NULL;
+  order = NULL;
+  mesh = NULL;
+  gewald = NULL;
+  tstep = tpair = tkspace = NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+
+TuneKspace::~TuneKspace()
+{
+  memory->destroy(cutoff);
+  memory->destroy(order);
+  memory->destroy(mesh);
+  memory->destroy(gewald);
+  memory->destroy(tstep);
+  memory->destroy(tpair);
+  memory->destroy(tkspace);
+}
+
+/* ----------------------------------------------------------------------
+   time short runs for a range of Coulomb cutoffs and orders
+   grid and G-ewald are chosen by the kspace style for the set accuracy
+   keep the fastest combination
+------------------------------------------------------------------------- */
+
+void TuneKspace::command(int narg, char **arg)
+{
+  if (domain->box_exist == 0)
+    error->all(FLERR,"Tune_kspace command before simulation box is defined");
+  if (narg < 1) error->all(FLERR,"Illegal tune_kspace command");
+  if (!force->kspace || !(force->kspace->pppmflag || force->kspace->msmflag))
+    error->all(FLERR,"Tune_kspace requires a PPPM or MSM kspace style");
+
+  int itmp;
+  double *p_cutoff = NULL;
+  if (force->pair)
+    p_cutoff = (double *) force->pair->extract("cut_coul",itmp);
+  if (p_cutoff == NULL)
+    error->all(FLERR,"Pair style does not support tune_kspace");
+
+  int nsteps = force->inumeric(FLERR,arg[0]);
+  if (nsteps <= 0) error->all(FLERR,"Illegal tune_kspace command");
+
+  // default is current cutoff and order
+
+  int msmflag = force->kspace->msmflag;
+  double cutlo = *p_cutoff;
+  double cuthi = *p_cutoff;
+  int ncut = 1;
+  int orderlo = force->kspace->order;
+  int orderhi = force->kspace->order;
+
+  int iarg = 1;
+  while (iarg < narg) {
+    if (strcmp(arg[iarg],"cutoff") == 0) {
+      if (iarg+4 > narg) error->all(FLERR,"Illegal tune_kspace command");
+      cutlo = force->numeric(FLERR,arg[iarg+1]);
+      cuthi = force->numeric(FLERR,arg[iarg+2]);
+      ncut = force->inumeric(FLERR,arg[iarg+3]);
+      if (cutlo <= 0.0 || cuthi < cutlo || ncut < 1)
+        error->all(FLERR,"Illegal tune_kspace command");
+      iarg += 4;
+    } else if (strcmp(arg[iarg],"order") == 0) {
+      if (iarg+3 > narg) error->all(FLERR,"Illegal tune_kspace command");
+      orderlo = force->inumeric(FLERR,arg[iarg+1]);
+      orderhi = force->inumeric(FLERR,arg[iarg+2]);
+      iarg += 3;
+    } else error->all(FLERR,"Illegal tune_kspace command");
+  }
+
+  // MSM only supports even orders
+
+  int orderstep = 1;
+  if (msmflag) {
+    orderstep = 2;
+    if (orderlo < 4 || orderhi > 10 || orderlo > orderhi || orderlo % 2)
+      error->all(FLERR,"Invalid order range in tune_kspace command");
+  } else {
+    if (orderlo < 2 || orderhi > 7 || orderlo > orderhi)
+      error->all(FLERR,"Invalid order range in tune_kspace command");
+  }
+  int norder = (orderhi-orderlo)/orderstep + 1;
+
+  ntrial = ncut*norder;
+  memory->create(cutoff,ntrial,"tune_kspace:cutoff");
+  memory->create(order,ntrial,"tune_kspace:order");
+  memory->create(mesh,ntrial,3,"tune_kspace:mesh");
+  memory->create(gewald,ntrial,"tune_kspace:gewald");
+  memory->create(tstep,ntrial,"tune_kspace:tstep");
+  memory->create(tpair,ntrial,"tune_kspace:tpair");
+  memory->create(tkspace,ntrial,"tune_kspace:tkspace");
+
+  if (me == 0) {
+    if (screen)
+      fprintf(screen,"Tuning kspace with %d trial runs of %d steps ...\n",
+              ntrial,nsteps);
+    if (logfile)
+      fprintf(logfile,"Tuning kspace with %d trial runs of %d steps ...\n",
+              ntrial,nsteps);
+  }
+
+  // each trial run continues the dynamics from the previous one
+
+  int n = 0;
+  for (int i = 0; i < ncut; i++) {
+    double cut = cutlo;
+    if (ncut > 1) cut = cutlo + i*(cuthi-cutlo)/(ncut-1);
+    for (int j = 0; j < norder; j++) {
+      cutoff[n] = cut;
+      set_params(cut,orderlo + j*orderstep);
+      trial(n,nsteps);
+      n++;
+    }
+  }
+
+  // pick fastest trial and keep its settings
+
+  int best = 0;
+  for (int i = 1; i < ntrial; i++)
+    if (tstep[i] < tstep[best]) best = i;
+
+  set_params(cutoff[best],order[best]);
+  output(best,nsteps);
+  if (force->kspace->pppmflag) suggest_partition(best);
+}
+
+/* ----------------------------------------------------------------------
+   set Coulomb cutoff of pair style and order of kspace style
+   grid and G-ewald are reset so the kspace style chooses them
+------------------------------------------------------------------------- */
+
+void TuneKspace::set_params(double cut, int ord)
+{
+  int itmp;
+  double *p_cutoff = (double *) force->pair->extract("cut_coul",itmp);
+  *p_cutoff = cut;
+
+  char str[8];
+  sprintf(str,"%d",ord);
+  char *args[8];
+  args[0] = (char *) "order";
+  args[1] = str;
+  args[2] = (char *) "mesh";
+  args[3] = args[4] = args[5] = (char *) "0";
+  args[6] = (char *) "gewald";
+  args[7] = (char *) "0.0";
+  force->kspace->modify_params(8,args);
+}
+
+/* ----------------------------------------------------------------------
+   perform one trial run of nsteps, same as the run command
+   store settings chosen by kspace style and timings
+------------------------------------------------------------------------- */
+
+void TuneKspace::trial(int n, int nsteps)
+{
+  update->whichflag = 1;
+  timer->init_timeout();
+
+  update->nsteps = nsteps;
+  update->beginstep = update->firststep = update->ntimestep;
+  update->endstep = update->laststep = update->firststep + nsteps;
+  if (update->laststep < 0 || update->laststep < update->firststep)
+    error->all(FLERR,"Too many timesteps");
+
+  lmp->init();
+  update->integrate->setup();
+
+  timer->init();
+  timer->barrier_start();
+  update->integrate->run(nsteps);
+  timer->barrier_stop();
+
+  update->integrate->cleanup();
+
+  Finish finish(lmp);
+  finish.end(0);
+
+  update->whichflag = 0;
+  update->firststep = update->laststep = 0;
+  update->beginstep = update->endstep = 0;
+
+  // the kspace style may have lowered the order to fit the stencil
+  // the run may have been cut short by a timeout
+
+  KSpace *kspace = force->kspace;
+  order[n] = kspace->order;
+  if (kspace->pppmflag) {
+    mesh[n][0] = kspace->nx_pppm;
+    mesh[n][1] = kspace->ny_pppm;
+    mesh[n][2] = kspace->nz_pppm;
+  } else {
+    mesh[n][0] = kspace->nx_msm_max;
+    mesh[n][1] = kspace->ny_msm_max;
+    mesh[n][2] = kspace->nz_msm_max;
+  }
+  gewald[n] = kspace->g_ewald;
+
+  double steps = MAX(update->nsteps,1);
+  double time[2],time_all[2];
+  time[0] = timer->get_wall(Timer::PAIR);
+  time[1] = timer->get_wall(Timer::KSPACE);
+  MPI_Allreduce(time,time_all,2,MPI_DOUBLE,MPI_SUM,world);
+
+  tstep[n] = timer->get_wall(Timer::TOTAL)/steps;
+  tpair[n] = time_all[0]/nprocs/steps;
+  tkspace[n] = time_all[1]/nprocs/steps;
+}
+
+/* ----------------------------------------------------------------------
+   print timings of all trials and the chosen settings
+------------------------------------------------------------------------- */
+
+void TuneKspace::output(int best, int nsteps)
+{
+  if (me) return;
+
+  FILE *fp;
+  for (int m = 0; m < 2; m++) {
+    if (m == 0) fp = screen;
+    else fp = logfile;
+    if (!fp) continue;
+
+    fprintf(fp,"Tune_kspace timings per step of %d step trial runs:\n",
+            nsteps);
+    fprintf(fp,"  %8s %5s %15s %10s %10s %10s %10s\n","Cutoff","Order",
+            "Grid","G_ewald","Total","Pair","Kspace");
+    for (int i = 0; i < ntrial; i++)
+      fprintf(fp,"  %8g %5d %4d %4d %4d %10.4g %10.4g %10.4g %10.4g%s\n",
+              cutoff[i],order[i],mesh[i][0],mesh[i][1],mesh[i][2],
+              gewald[i],tstep[i],tpair[i],tkspace[i],
+              (i == best) ? " *" : "");
+    fprintf(fp,"Tune_kspace settings: Coulomb cutoff %g, order %d\n",
+            cutoff[best],order[best]);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   estimate how many procs to give to kspace with run_style verlet/split
+   assumes pair and kspace parts both scale linearly with # of procs
+   verlet/split requires the kspace partition to divide the other one
+------------------------------------------------------------------------- */
+
+void TuneKspace::suggest_partition(int best)
+{
+  if (nprocs == 1 || strcmp(update->integrate_style,"verlet") != 0) return;
+  if (tkspace[best] <= 0.0) return;
+
+  double tk = tkspace[best]*nprocs;
+  double tr = (tstep[best]-tkspace[best])*nprocs;
+
+  int pbest = 0;
+  double tbest = tstep[best];
+  for (int pk = 1; pk <= nprocs/2; pk++) {
+    if (nprocs % pk) continue;
+    double t = MAX(tr/(nprocs-pk),tk/pk);
+    if (t < tbest) {
+      tbest = t;
+      pbest = pk;
+    }
+  }
+
+  if (me) return;
+
+  char str[128];
+  if (pbest)
+    sprintf(str,"Tune_kspace estimate for run_style verlet/split: "
+            "-partition %d %d, %g per step",nprocs-pbest,pbest,tbest);
+  else
+    sprintf(str,"Tune_kspace estimate: run_style verlet/split "
+            "would not be faster");
+  if (screen) fprintf(screen,"%s\n",str);
+  if (logfile) fprintf(logfile,"%s\n",str);
+}
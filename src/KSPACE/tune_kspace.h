@@ -0,0 +1,86 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifdef COMMAND_CLASS
+
+CommandStyle(tune_kspace,TuneKspace)
+
+#else
+
+#ifndef LMP_TUNE_KSPACE_H
+#define LMP_TUNE_KSPACE_H
+
+#include "pointers.h"
+
+namespace LAMMPS_NS {
+
+class TuneKspace : protected Pointers {
+ public:
+  TuneKspace(class LAMMPS *);
+  ~TuneKspace();
+  void command(int, char **);
+
+ private:
+  int me,nprocs;
+  int ntrial;                  // # of trial runs
+  double *cutoff;              // Coulomb cutoff of each trial
+  int *order;                  // interpolation order used by each trial
+  int **mesh;                  // grid chosen by the kspace style
+  double *gewald;              // G-ewald chosen by the kspace style
+  double *tstep;               // wall time per timestep
+  double *tpair,*tkspace;      // pair and kspace time per step, avg of procs
+
+  void set_params(double, int);
+  void trial(int, int);
+  void output(int, int);
+  void suggest_partition(int);
+};
+
+}
+
+#endif
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Illegal ... command
+
+Self-explanatory.  Check the input script syntax and compare to the
+documentation for the command.  You can use -echo screen as a
+command-line option when running LAMMPS to see the offending line.
+
+E: Tune_kspace command before simulation box is defined
+
+The tune_kspace command cannot be used before a read_data,
+read_restart, or create_box command.
+
+E: Tune_kspace requires a PPPM or MSM kspace style
+
+Only the grid-based kspace solvers have parameters the command can
+tune.
+
+E: Pair style does not support tune_kspace
+
+The pair style does not give access to its Coulombic cutoff, so it
+cannot be varied.
+
+E: Invalid order range in tune_kspace command
+
+PPPM orders must be between 2 and 7, MSM orders must be even and
+between 4 and 10.
+
+E: Too many timesteps
+
+The cumulative timesteps must fit in a 64-bit integer.
+
+*/
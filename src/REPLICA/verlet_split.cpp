@@ -52,7 +52,7 @@ VerletSplit::VerletSplit(LAMMPS *lmp, int narg, char **arg) :
   if (universe->procs_per_world[0] % universe->procs_per_world[1])
     error->universe_all(FLERR,"Verlet/split requires Rspace partition "
                         "size be multiple of Kspace partition size");
-  if (comm->style != 0)
+  if (comm->style == 1)
     error->universe_all(FLERR,"Verlet/split can only currently be used with "
                         "comm_style brick");
 
@@ -217,7 +217,7 @@ VerletSplit::~VerletSplit()
 
 void VerletSplit::init()
 {
-  if (comm->style != 0)
+  if (comm->style == 1)
     error->universe_all(FLERR,"Verlet/split can only currently be used with "
                         "comm_style brick");
   if (!force->kspace && comm->me == 0)
@@ -41,10 +41,6 @@ using namespace LAMMPS_NS;
 using namespace FixConst;
 using namespace MathConst;
 
-// allocate space for static class variable
-
-FixRigidSmall *FixRigidSmall::frsptr;
-
 #define MAXLINE 1024
 #define CHUNK 1024
 #define ATTRIBUTE_PERBODY 20
@@ -1409,7 +1405,9 @@ void FixRigidSmall::set_v()
 void FixRigidSmall::create_bodies()
 {
   int i,m,n;
-  double unwrap[3];
+
+  MPI_Barrier(world);
+  double time1 = MPI_Wtime();
 
   // error check on image flags of atoms in rigid bodies
 
@@ -1435,275 +1433,231 @@ void FixRigidSmall::create_bodies()
   if (flagall) error->all(FLERR,"Fix rigid/small atom has non-zero image flag "
                           "in a non-periodic dimension");
 
-  // allocate buffer for passing messages around ring of procs
-  // percount = max number of values to put in buffer for each of ncount
+  // create a rendezvous datum for every atom in a rigid body
+  // datum = my proc, local index, atom ID, body ID, unwrapped coords
+  // rendezvous proc for each datum = body ID % nprocs
 
   int ncount = 0;
   for (i = 0; i < nlocal; i++)
     if (mask[i] & groupbit) ncount++;
 
-  int percount = 5;
-  double *buf;
-  memory->create(buf,ncount*percount,"rigid/small:buf");
-
-  // create map hash for storing unique molecule IDs of my atoms
-  // key = molecule ID
-  // value = index into per-body data structure
-  // n = # of entries in hash
-
-  hash = new std::map<tagint,int>();
-  hash->clear();
-
-  // setup hash
-  // key = body ID
-  // value = index into N-length data structure
-  // n = count of unique bodies my atoms are part of
+  int *proclist;
+  memory->create(proclist,ncount,"rigid/small:proclist");
+  InRvous *inbuf = (InRvous *)
+    memory->smalloc(ncount*sizeof(InRvous),"rigid/small:inbuf");
 
+  tagint *tag = atom->tag;
   tagint *molecule = atom->molecule;
+  double **x = atom->x;
 
-  n = 0;
+  m = 0;
   for (i = 0; i < nlocal; i++) {
     if (!(mask[i] & groupbit)) continue;
-    if (hash->find(molecule[i]) == hash->end()) (*hash)[molecule[i]] = n++;
+    proclist[m] = molecule[i] % nprocs;
+    inbuf[m].me = me;
+    inbuf[m].ilocal = i;
+    inbuf[m].atomID = tag[i];
+    inbuf[m].bodyID = molecule[i];
+    domain->unmap(x[i],image[i],inbuf[m].x);
+    m++;
   }
 
-  // bbox = bounding box of each rigid body my atoms are part of
+  // perform rendezvous operation
+  // callback owns all atoms of each body it is assigned,
+  //   sets bodytag = ID of atom closest to body center and rsqfar
+  // each datum is returned to proc that owns the atom, with its bodytag
 
-  memory->create(bbox,n,6,"rigid/small:bbox");
+  rsqfar = 0.0;
+  single = 0;
 
-  for (i = 0; i < n; i++) {
-    bbox[i][0] = bbox[i][2] = bbox[i][4] = BIG;
-    bbox[i][1] = bbox[i][3] = bbox[i][5] = -BIG;
-  }
+  char *buf;
+  n = comm->rendezvous(ncount,(char *) inbuf,sizeof(InRvous),proclist,
+                       rendezvous_body,buf,sizeof(OutRvous),(void *) this);
+  OutRvous *outbuf = (OutRvous *) buf;
 
-  // pack my atoms into buffer as molecule ID, unwrapped coords
+  memory->destroy(proclist);
+  memory->sfree(inbuf);
 
-  double **x = atom->x;
+  // set bodytag of all owned atoms based on outbuf info for constituent atoms
 
-  m = 0;
-  for (i = 0; i < nlocal; i++) {
-    if (!(mask[i] & groupbit)) continue;
-    domain->unmap(x[i],image[i],unwrap);
-    buf[m++] = molecule[i];
-    buf[m++] = unwrap[0];
-    buf[m++] = unwrap[1];
-    buf[m++] = unwrap[2];
-  }
+  for (i = 0; i < nlocal; i++)
+    if (!(mask[i] & groupbit)) bodytag[i] = 0;
 
-  // pass buffer around ring of procs
-  // func = update bbox with atom coords from every proc
-  // when done, have full bbox for every rigid body my atoms are part of
+  for (m = 0; m < n; m++)
+    bodytag[outbuf[m].ilocal] = outbuf[m].atomID;
 
-  frsptr = this;
-  comm->ring(m,sizeof(double),buf,1,ring_bbox,NULL);
+  memory->sfree(outbuf);
 
-  // check if any bbox is size 0.0, meaning rigid body is a single particle
+  // check if any body is a single particle, i.e. has bbox of size 0.0
 
-  flag = 0;
-  for (i = 0; i < n; i++)
-    if (bbox[i][0] == bbox[i][1] && bbox[i][2] == bbox[i][3] &&
-        bbox[i][4] == bbox[i][5]) flag = 1;
-  MPI_Allreduce(&flag,&flagall,1,MPI_INT,MPI_SUM,world);
+  MPI_Allreduce(&single,&flagall,1,MPI_INT,MPI_SUM,world);
   if (flagall)
     error->all(FLERR,"One or more rigid bodies are a single particle");
 
-  // ctr = center pt of each rigid body my atoms are part of
+  // find maxextent of rsqfar across all procs
+  // if defined, include molecule->maxextent
 
-  memory->create(ctr,n,6,"rigid/small:bbox");
+  MPI_Allreduce(&rsqfar,&maxextent,1,MPI_DOUBLE,MPI_MAX,world);
+  maxextent = sqrt(maxextent);
+  if (onemols) {
+    for (int i = 0; i < nmol; i++)
+      maxextent = MAX(maxextent,onemols[i]->maxextent);
+  }
 
-  for (i = 0; i < n; i++) {
-    ctr[i][0] = 0.5 * (bbox[i][0] + bbox[i][1]);
-    ctr[i][1] = 0.5 * (bbox[i][2] + bbox[i][3]);
-    ctr[i][2] = 0.5 * (bbox[i][4] + bbox[i][5]);
+  double time2 = MPI_Wtime();
+  if (me == 0) {
+    if (screen)
+      fprintf(screen,"  create bodies CPU = %g secs\n",time2-time1);
+    if (logfile)
+      fprintf(logfile,"  create bodies CPU = %g secs\n",time2-time1);
   }
+}
 
-  // idclose = ID of atom in body closest to center pt (smaller ID if tied)
-  // rsqclose = distance squared from idclose to center pt
+/* ----------------------------------------------------------------------
+   process rigid bodies assigned to me
+   inbuf = list of N atoms, with all atoms of each body I own
+   set bodytag of each atom = ID of atom closest to center of body bbox,
+     smaller ID if tied
+   update rsqfar = max distance from closest atom to other atoms in body
+   outbuf = local index and bodytag of each atom, sent back to its owner
+------------------------------------------------------------------------- */
 
-  memory->create(idclose,n,"rigid/small:idclose");
-  memory->create(rsqclose,n,"rigid/small:rsqclose");
+int FixRigidSmall::rendezvous_body(int n, char *inbuf,
+                                   int &rflag, int *&proclist, char *&outbuf,
+                                   void *ptr)
+{
+  int i,m;
+  double delx,dely,delz,rsq;
+  double *x;
 
-  for (i = 0; i < n; i++) rsqclose[i] = BIG;
+  FixRigidSmall *frsptr = (FixRigidSmall *) ptr;
+  Memory *memory = frsptr->memory;
+  InRvous *in = (InRvous *) inbuf;
 
-  // pack my atoms into buffer as molecule ID, atom ID, unwrapped coords
+  // hash = unique body IDs of atoms I received
+  // key = body ID, value = index into per-body data structures
+  // nbody = # of bodies I own
 
-  tagint *tag = atom->tag;
+  std::map<tagint,int> hash;
+  std::map<tagint,int>::iterator loc;
 
-  m = 0;
-  for (i = 0; i < nlocal; i++) {
-    if (!(mask[i] & groupbit)) continue;
-    domain->unmap(x[i],image[i],unwrap);
-    buf[m++] = molecule[i];
-    buf[m++] = ubuf(tag[i]).d;
-    buf[m++] = unwrap[0];
-    buf[m++] = unwrap[1];
-    buf[m++] = unwrap[2];
-  }
+  int *body;
+  memory->create(body,n,"rigid/small:body");
 
-  // pass buffer around ring of procs
-  // func = update idclose,rsqclose with atom IDs from every proc
-  // when done, have idclose for every rigid body my atoms are part of
+  int nbody = 0;
+  for (i = 0; i < n; i++) {
+    loc = hash.find(in[i].bodyID);
+    if (loc == hash.end()) {
+      body[i] = nbody;
+      hash[in[i].bodyID] = nbody++;
+    } else body[i] = loc->second;
+  }
 
-  frsptr = this;
-  comm->ring(m,sizeof(double),buf,2,ring_nearest,NULL);
+  // bbox = bounding box of each rigid body
 
-  // set bodytag of all owned atoms, based on idclose
-  // find max value of rsqclose across all procs
+  double **bbox;
+  memory->create(bbox,nbody,6,"rigid/small:bbox");
 
-  double rsqmax = 0.0;
-  for (i = 0; i < nlocal; i++) {
-    bodytag[i] = 0;
-    if (!(mask[i] & groupbit)) continue;
-    m = hash->find(molecule[i])->second;
-    bodytag[i] = idclose[m];
-    rsqmax = MAX(rsqmax,rsqclose[m]);
+  for (m = 0; m < nbody; m++) {
+    bbox[m][0] = bbox[m][2] = bbox[m][4] = BIG;
+    bbox[m][1] = bbox[m][3] = bbox[m][5] = -BIG;
   }
 
-  // pack my atoms into buffer as bodytag of owning atom, unwrapped coords
-
-  m = 0;
-  for (i = 0; i < nlocal; i++) {
-    if (!(mask[i] & groupbit)) continue;
-    domain->unmap(x[i],image[i],unwrap);
-    buf[m++] = ubuf(bodytag[i]).d;
-    buf[m++] = unwrap[0];
-    buf[m++] = unwrap[1];
-    buf[m++] = unwrap[2];
+  for (i = 0; i < n; i++) {
+    m = body[i];
+    x = in[i].x;
+    bbox[m][0] = MIN(bbox[m][0],x[0]);
+    bbox[m][1] = MAX(bbox[m][1],x[0]);
+    bbox[m][2] = MIN(bbox[m][2],x[1]);
+    bbox[m][3] = MAX(bbox[m][3],x[1]);
+    bbox[m][4] = MIN(bbox[m][4],x[2]);
+    bbox[m][5] = MAX(bbox[m][5],x[2]);
   }
 
-  // pass buffer around ring of procs
-  // func = update rsqfar for atoms belonging to bodies I own
-  // when done, have rsqfar for all atoms in bodies I own
+  // check if any bbox is size 0.0, meaning rigid body is a single particle
 
-  rsqfar = 0.0;
-  frsptr = this;
-  comm->ring(m,sizeof(double),buf,3,ring_farthest,NULL);
+  for (m = 0; m < nbody; m++)
+    if (bbox[m][0] == bbox[m][1] && bbox[m][2] == bbox[m][3] &&
+        bbox[m][4] == bbox[m][5]) frsptr->single = 1;
 
-  // find maxextent of rsqfar across all procs
-  // if defined, include molecule->maxextent
+  // ctr = center pt of each rigid body
 
-  MPI_Allreduce(&rsqfar,&maxextent,1,MPI_DOUBLE,MPI_MAX,world);
-  maxextent = sqrt(maxextent);
-  if (onemols) {
-    for (int i = 0; i < nmol; i++)
-      maxextent = MAX(maxextent,onemols[i]->maxextent);
+  double **ctr;
+  memory->create(ctr,nbody,3,"rigid/small:ctr");
+
+  for (m = 0; m < nbody; m++) {
+    ctr[m][0] = 0.5 * (bbox[m][0] + bbox[m][1]);
+    ctr[m][1] = 0.5 * (bbox[m][2] + bbox[m][3]);
+    ctr[m][2] = 0.5 * (bbox[m][4] + bbox[m][5]);
   }
 
-  // clean up
+  // idclose = atom in body closest to center pt (smaller ID if tied)
+  // rsqclose = distance squared from idclose to center pt
 
-  delete hash;
-  memory->destroy(buf);
-  memory->destroy(bbox);
-  memory->destroy(ctr);
-  memory->destroy(idclose);
-  memory->destroy(rsqclose);
-}
+  int *idclose;
+  double *rsqclose;
+  memory->create(idclose,nbody,"rigid/small:idclose");
+  memory->create(rsqclose,nbody,"rigid/small:rsqclose");
 
-/* ----------------------------------------------------------------------
-   process rigid body atoms from another proc
-   update bounding box for rigid bodies my atoms are part of
-------------------------------------------------------------------------- */
+  for (m = 0; m < nbody; m++) rsqclose[m] = BIG;
 
-void FixRigidSmall::ring_bbox(int n, char *cbuf)
-{
-  std::map<tagint,int> *hash = frsptr->hash;
-  double **bbox = frsptr->bbox;
+  for (i = 0; i < n; i++) {
+    m = body[i];
+    x = in[i].x;
+    delx = x[0] - ctr[m][0];
+    dely = x[1] - ctr[m][1];
+    delz = x[2] - ctr[m][2];
+    rsq = delx*delx + dely*dely + delz*delz;
+    if (rsq <= rsqclose[m]) {
+      if (rsq == rsqclose[m] && in[i].atomID > in[idclose[m]].atomID)
+        continue;
+      idclose[m] = i;
+      rsqclose[m] = rsq;
+    }
+  }
 
-  double *buf = (double *) cbuf;
-  int ndatums = n/4;
+  // rsqfar = max distance from closest atom to any atom in its body
 
-  int j,imol;
-  double *x;
+  double rsqfar = 0.0;
+  double *xclose;
 
-  int m = 0;
-  for (int i = 0; i < ndatums; i++, m += 4) {
-    imol = static_cast<int> (buf[m]);
-    if (hash->find(imol) != hash->end()) {
-      j = hash->find(imol)->second;
-      x = &buf[m+1];
-      bbox[j][0] = MIN(bbox[j][0],x[0]);
-      bbox[j][1] = MAX(bbox[j][1],x[0]);
-      bbox[j][2] = MIN(bbox[j][2],x[1]);
-      bbox[j][3] = MAX(bbox[j][3],x[1]);
-      bbox[j][4] = MIN(bbox[j][4],x[2]);
-      bbox[j][5] = MAX(bbox[j][5],x[2]);
-    }
+  for (i = 0; i < n; i++) {
+    m = body[i];
+    x = in[i].x;
+    xclose = in[idclose[m]].x;
+    delx = x[0] - xclose[0];
+    dely = x[1] - xclose[1];
+    delz = x[2] - xclose[2];
+    rsq = delx*delx + dely*dely + delz*delz;
+    rsqfar = MAX(rsqfar,rsq);
   }
-}
 
-/* ----------------------------------------------------------------------
-   process rigid body atoms from another proc
-   update nearest atom to body center for rigid bodies my atoms are part of
-------------------------------------------------------------------------- */
+  frsptr->rsqfar = rsqfar;
 
-void FixRigidSmall::ring_nearest(int n, char *cbuf)
-{
-  std::map<tagint,int> *hash = frsptr->hash;
-  double **ctr = frsptr->ctr;
-  tagint *idclose = frsptr->idclose;
-  double *rsqclose = frsptr->rsqclose;
-
-  double *buf = (double *) cbuf;
-  int ndatums = n/5;
+  // outbuf = local index and bodytag of each atom, sent to atom owner
 
-  int j,imol;
-  tagint tag;
-  double delx,dely,delz,rsq;
-  double *x;
+  memory->create(proclist,n,"rigid/small:proclist");
+  OutRvous *out = (OutRvous *)
+    memory->smalloc(n*sizeof(OutRvous),"rigid/small:out");
 
-  int m = 0;
-  for (int i = 0; i < ndatums; i++, m += 5) {
-    imol = static_cast<int> (buf[m]);
-    if (hash->find(imol) != hash->end()) {
-      j = hash->find(imol)->second;
-      tag = (tagint) ubuf(buf[m+1]).i;
-      x = &buf[m+2];
-      delx = x[0] - ctr[j][0];
-      dely = x[1] - ctr[j][1];
-      delz = x[2] - ctr[j][2];
-      rsq = delx*delx + dely*dely + delz*delz;
-      if (rsq <= rsqclose[j]) {
-        if (rsq == rsqclose[j] && tag > idclose[j]) continue;
-        idclose[j] = tag;
-        rsqclose[j] = rsq;
-      }
-    }
+  for (i = 0; i < n; i++) {
+    proclist[i] = in[i].me;
+    out[i].ilocal = in[i].ilocal;
+    out[i].atomID = in[idclose[body[i]]].atomID;
   }
-}
-
-/* ----------------------------------------------------------------------
-   process rigid body atoms from another proc
-   update rsqfar = distance from owning atom to other atom
-------------------------------------------------------------------------- */
 
-void FixRigidSmall::ring_farthest(int n, char *cbuf)
-{
-  double **x = frsptr->atom->x;
-  imageint *image = frsptr->atom->image;
-  int nlocal = frsptr->atom->nlocal;
+  outbuf = (char *) out;
 
-  double *buf = (double *) cbuf;
-  int ndatums = n/4;
+  // clean up
 
-  int iowner;
-  tagint tag;
-  double delx,dely,delz,rsq;
-  double *xx;
-  double unwrap[3];
+  memory->destroy(body);
+  memory->destroy(bbox);
+  memory->destroy(ctr);
+  memory->destroy(idclose);
+  memory->destroy(rsqclose);
 
-  int m = 0;
-  for (int i = 0; i < ndatums; i++, m += 4) {
-    tag = (tagint) ubuf(buf[m]).i;
-    iowner = frsptr->atom->map(tag);
-    if (iowner < 0 || iowner >= nlocal) continue;
-    frsptr->domain->unmap(x[iowner],image[iowner],unwrap);
-    xx = &buf[m+1];
-    delx = xx[0] - unwrap[0];
-    dely = xx[1] - unwrap[1];
-    delz = xx[2] - unwrap[2];
-    rsq = delx*delx + dely*dely + delz*delz;
-    frsptr->rsqfar = MAX(frsptr->rsqfar,rsq);
-  }
+  rflag = 2;
+  return n;
 }
 
 /* ----------------------------------------------------------------------
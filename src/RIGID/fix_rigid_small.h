@@ -31,10 +31,6 @@ class FixRigidSmall : public Fix {
   friend class ComputeRigidLocal;
 
  public:
-  // static variable for ring communication callback to access class data
-
-  static FixRigidSmall *frsptr;
-
   FixRigidSmall(class LAMMPS *, int, char **);
   virtual ~FixRigidSmall();
   virtual int setmask();
@@ -178,14 +174,12 @@ class FixRigidSmall : public Fix {
   class Molecule **onemols;
   int nmol;
 
-  // class data used by ring communication callbacks
-
   std::map<tagint,int> *hash;
-  double **bbox;
-  double **ctr;
-  tagint *idclose;
-  double *rsqclose;
+
+  // class data used by rendezvous communication callback
+
   double rsqfar;
+  int single;
 
   void image_shift();
   void set_xv();
@@ -197,11 +191,22 @@ class FixRigidSmall : public Fix {
   void grow_body();
   void reset_atom2body();
 
-  // callback functions for ring communication
+  // structs for rendezvous communication
+
+  struct InRvous {
+    int me,ilocal;
+    tagint atomID,bodyID;
+    double x[3];
+  };
+
+  struct OutRvous {
+    int ilocal;
+    tagint atomID;
+  };
+
+  // callback function for rendezvous communication
 
-  static void ring_bbox(int, char *);
-  static void ring_nearest(int, char *);
-  static void ring_farthest(int, char *);
+  static int rendezvous_body(int, char *, int &, int *&, char *&, void *);
 
   // debug
 
@@ -39,10 +39,6 @@ using namespace LAMMPS_NS;
 using namespace FixConst;
 using namespace MathConst;
 
-// allocate space for static class variable
-
-FixShake *FixShake::fsptr;
-
 #define BIG 1.0e20
 #define MASSDELTA 0.1
 
@@ -675,16 +671,19 @@ int FixShake::dof(int igroup)
 void FixShake::find_clusters()
 {
   int i,j,m,n,imol,iatom;
-  int flag,flag_all,nbuf,size;
+  int flag,flag_all,nsend,nreturn;
   tagint tagprev;
   double massone;
-  tagint *buf;
+  char *outbuf;
   
   if (me == 0 && screen) {
     if (!rattle) fprintf(screen,"Finding SHAKE clusters ...\n");
     else fprintf(screen,"Finding RATTLE clusters ...\n");
   }
 
+  MPI_Barrier(world);
+  double time1 = MPI_Wtime();
+
   atommols = atom->avec->onemols;
 
   tagint *tag = atom->tag;
@@ -701,13 +700,6 @@ void FixShake::find_clusters()
   int nlocal = atom->nlocal;
   int angles_allow = atom->avec->angles_allow;
 
-  // setup ring of procs
-
-  int next = me + 1;
-  int prev = me -1;
-  if (next == nprocs) next = 0;
-  if (prev < 0) prev = nprocs - 1;
-
   // -----------------------------------------------------
   // allocate arrays for self (1d) and bond partners (2d)
   // max = max # of bond partners for owned atoms = 2nd dim of partner arrays
@@ -778,13 +770,11 @@ void FixShake::find_clusters()
   // -----------------------------------------------------
 
   // fill in mask, type, massflag, bondtype if own bond partner
-  // info to store in buf for each off-proc bond = nper = 6
-  //   2 atoms IDs in bond, space for mask, type, massflag, bondtype
-  // nbufmax = largest buffer needed to hold info from any proc
+  // send my own info to each off-proc bond partner via rendezvous comm
+  //   partner then stores it for me, since partner lists are symmetric
+  // bondtype is sent if I store the bond, else partner may store it
 
-  int nper = 6;
-
-  nbuf = 0;
+  nsend = 0;
   for (i = 0; i < nlocal; i++) {
     for (j = 0; j < npartner[i]; j++) {
       partner_mask[i][j] = 0;
@@ -807,52 +797,59 @@ void FixShake::find_clusters()
           n = bondtype_findset(m,tag[i],partner_tag[i][j],0);
           if (n) partner_bondtype[i][j] = n;
         }
-      } else nbuf += nper;
+      } else {
+        partner_bondtype[i][j] =
+          bondtype_findset(i,tag[i],partner_tag[i][j],0);
+        nsend++;
+      }
     }
   }
 
-  memory->create(buf,nbuf,"shake:buf");
-
-  // fill buffer with info
+  PartnerInfo *pinbuf = (PartnerInfo *)
+    memory->smalloc((bigint) nsend*sizeof(PartnerInfo),"shake:pinbuf");
 
-  size = 0;
+  nsend = 0;
   for (i = 0; i < nlocal; i++) {
+    if (nmass) {
+      if (rmass) massone = rmass[i];
+      else massone = mass[type[i]];
+      flag = masscheck(massone);
+    } else flag = 0;
     for (j = 0; j < npartner[i]; j++) {
       m = atom->map(partner_tag[i][j]);
-      if (m < 0 || m >= nlocal) {
-        buf[size] = tag[i];
-        buf[size+1] = partner_tag[i][j];
-        buf[size+2] = 0;
-        buf[size+3] = 0;
-        buf[size+4] = 0;
-        n = bondtype_findset(i,tag[i],partner_tag[i][j],0);
-        if (n) buf[size+5] = n;
-        else buf[size+5] = 0;
-        size += nper;
-      }
+      if (m >= 0 && m < nlocal) continue;
+      pinbuf[nsend].atomID = partner_tag[i][j];
+      pinbuf[nsend].partnerID = tag[i];
+      pinbuf[nsend].mask = mask[i];
+      pinbuf[nsend].type = type[i];
+      pinbuf[nsend].massflag = flag;
+      pinbuf[nsend].bondtype = partner_bondtype[i][j];
+      nsend++;
     }
   }
 
-  // cycle buffer around ring of procs back to self
+  // each datum is sent to proc that owns its atomID
 
-  fsptr = this;
-  comm->ring(size,sizeof(tagint),buf,1,ring_bonds,buf);
+  nreturn = comm->rendezvous_atoms(nsend,(char *) pinbuf,
+                                   sizeof(PartnerInfo),outbuf);
+  PartnerInfo *poutbuf = (PartnerInfo *) outbuf;
+  memory->sfree(pinbuf);
 
-  // store partner info returned to me
+  // store partner info sent to me
 
-  m = 0;
-  while (m < size) {
-    i = atom->map(buf[m]);
+  for (m = 0; m < nreturn; m++) {
+    i = atom->map(poutbuf[m].atomID);
     for (j = 0; j < npartner[i]; j++)
-      if (buf[m+1] == partner_tag[i][j]) break;
-    partner_mask[i][j] = buf[m+2];
-    partner_type[i][j] = buf[m+3];
-    partner_massflag[i][j] = buf[m+4];
-    partner_bondtype[i][j] = buf[m+5];
-    m += nper;
+      if (poutbuf[m].partnerID == partner_tag[i][j]) break;
+    if (j == npartner[i]) continue;
+    partner_mask[i][j] = poutbuf[m].mask;
+    partner_type[i][j] = poutbuf[m].type;
+    partner_massflag[i][j] = poutbuf[m].massflag;
+    if (partner_bondtype[i][j] == 0)
+      partner_bondtype[i][j] = poutbuf[m].bondtype;
   }
 
-  memory->destroy(buf);
+  memory->sfree(poutbuf);
 
   // error check for unfilled partner info
   // if partner_type not set, is an error
@@ -930,52 +927,50 @@ void FixShake::find_clusters()
   // -----------------------------------------------------
 
   // fill in partner_nshake if own bond partner
-  // info to store in buf for each off-proc bond =
-  //   2 atoms IDs in bond, space for nshake value
-  // nbufmax = largest buffer needed to hold info from any proc
+  // send my nshake value to each off-proc bond partner via rendezvous comm
 
-  nbuf = 0;
+  nsend = 0;
   for (i = 0; i < nlocal; i++) {
     for (j = 0; j < npartner[i]; j++) {
       m = atom->map(partner_tag[i][j]);
       if (m >= 0 && m < nlocal) partner_nshake[i][j] = nshake[m];
-      else nbuf += 3;
+      else nsend++;
     }
   }
 
-  memory->create(buf,nbuf,"shake:buf");
-
-  // fill buffer with info
+  NShakeInfo *ninbuf = (NShakeInfo *)
+    memory->smalloc((bigint) nsend*sizeof(NShakeInfo),"shake:ninbuf");
 
-  size = 0;
+  nsend = 0;
   for (i = 0; i < nlocal; i++) {
     for (j = 0; j < npartner[i]; j++) {
       m = atom->map(partner_tag[i][j]);
-      if (m < 0 || m >= nlocal) {
-        buf[size] = tag[i];
-        buf[size+1] = partner_tag[i][j];
-        size += 3;
-      }
+      if (m >= 0 && m < nlocal) continue;
+      ninbuf[nsend].atomID = partner_tag[i][j];
+      ninbuf[nsend].partnerID = tag[i];
+      ninbuf[nsend].nshake = nshake[i];
+      nsend++;
     }
   }
 
-  // cycle buffer around ring of procs back to self
+  // each datum is sent to proc that owns its atomID
 
-  fsptr = this;
-  comm->ring(size,sizeof(tagint),buf,2,ring_nshake,buf);
+  nreturn = comm->rendezvous_atoms(nsend,(char *) ninbuf,
+                                   sizeof(NShakeInfo),outbuf);
+  NShakeInfo *noutbuf = (NShakeInfo *) outbuf;
+  memory->sfree(ninbuf);
 
-  // store partner info returned to me
-  
-  m = 0;
-  while (m < size) {
-    i = atom->map(buf[m]);
+  // store partner info sent to me
+
+  for (m = 0; m < nreturn; m++) {
+    i = atom->map(noutbuf[m].atomID);
     for (j = 0; j < npartner[i]; j++)
-      if (buf[m+1] == partner_tag[i][j]) break;
-    partner_nshake[i][j] = buf[m+2];
-    m += 3;
+      if (noutbuf[m].partnerID == partner_tag[i][j]) break;
+    if (j == npartner[i]) continue;
+    partner_nshake[i][j] = noutbuf[m].nshake;
   }
 
-  memory->destroy(buf);
+  memory->sfree(noutbuf);
 
   // -----------------------------------------------------
   // error checks
@@ -1064,11 +1059,9 @@ void FixShake::find_clusters()
   // -----------------------------------------------------
 
   // fill in shake arrays for each bond partner I own
-  // info to store in buf for each off-proc bond =
-  //   all values from shake_flag, shake_atom, shake_type
-  // nbufmax = largest buffer needed to hold info from any proc
+  // send shake arrays to each off-proc bond partner via rendezvous comm
 
-  nbuf = 0;
+  nsend = 0;
   for (i = 0; i < nlocal; i++) {
     if (shake_flag[i] == 0) continue;
     for (j = 0; j < npartner[i]; j++) {
@@ -1083,41 +1076,55 @@ void FixShake::find_clusters()
         shake_type[m][0] = shake_type[i][0];
         shake_type[m][1] = shake_type[i][1];
         shake_type[m][2] = shake_type[i][2];
-      } else nbuf += 9;
+      } else nsend++;
     }
   }
 
-  memory->create(buf,nbuf,"shake:buf");
+  ShakeInfo *sinbuf = (ShakeInfo *)
+    memory->smalloc((bigint) nsend*sizeof(ShakeInfo),"shake:sinbuf");
 
-  // fill buffer with info
-
-  size = 0;
+  nsend = 0;
   for (i = 0; i < nlocal; i++) {
     if (shake_flag[i] == 0) continue;
     for (j = 0; j < npartner[i]; j++) {
       if (partner_shake[i][j] == 0) continue;
       m = atom->map(partner_tag[i][j]);
-      if (m < 0 || m >= nlocal) {
-        buf[size] = partner_tag[i][j];
-        buf[size+1] = shake_flag[i];
-        buf[size+2] = shake_atom[i][0];
-        buf[size+3] = shake_atom[i][1];
-        buf[size+4] = shake_atom[i][2];
-        buf[size+5] = shake_atom[i][3];
-        buf[size+6] = shake_type[i][0];
-        buf[size+7] = shake_type[i][1];
-        buf[size+8] = shake_type[i][2];
-        size += 9;
-      }
+      if (m >= 0 && m < nlocal) continue;
+      sinbuf[nsend].atomID = partner_tag[i][j];
+      sinbuf[nsend].shake_flag = shake_flag[i];
+      sinbuf[nsend].shake_atom[0] = shake_atom[i][0];
+      sinbuf[nsend].shake_atom[1] = shake_atom[i][1];
+      sinbuf[nsend].shake_atom[2] = shake_atom[i][2];
+      sinbuf[nsend].shake_atom[3] = shake_atom[i][3];
+      sinbuf[nsend].shake_type[0] = shake_type[i][0];
+      sinbuf[nsend].shake_type[1] = shake_type[i][1];
+      sinbuf[nsend].shake_type[2] = shake_type[i][2];
+      nsend++;
     }
   }
 
-  // cycle buffer around ring of procs back to self
+  // each datum is sent to proc that owns its atomID
+
+  nreturn = comm->rendezvous_atoms(nsend,(char *) sinbuf,
+                                   sizeof(ShakeInfo),outbuf);
+  ShakeInfo *soutbuf = (ShakeInfo *) outbuf;
+  memory->sfree(sinbuf);
+
+  // store shake info sent to me
 
-  fsptr = this;
-  comm->ring(size,sizeof(tagint),buf,3,ring_shake,NULL);
+  for (m = 0; m < nreturn; m++) {
+    i = atom->map(soutbuf[m].atomID);
+    shake_flag[i] = soutbuf[m].shake_flag;
+    shake_atom[i][0] = soutbuf[m].shake_atom[0];
+    shake_atom[i][1] = soutbuf[m].shake_atom[1];
+    shake_atom[i][2] = soutbuf[m].shake_atom[2];
+    shake_atom[i][3] = soutbuf[m].shake_atom[3];
+    shake_type[i][0] = soutbuf[m].shake_type[0];
+    shake_type[i][1] = soutbuf[m].shake_type[1];
+    shake_type[i][2] = soutbuf[m].shake_type[2];
+  }
 
-  memory->destroy(buf);
+  memory->sfree(soutbuf);
 
   // -----------------------------------------------------
   // free local memory
@@ -1193,97 +1200,13 @@ void FixShake::find_clusters()
       fprintf(logfile,"  %d = # of frozen angles\n",count1/3);
     }
   }
-}
-
-/* ----------------------------------------------------------------------
-   when receive buffer, scan bond partner IDs for atoms I own
-   if I own partner:
-     fill in mask and type and massflag
-     search for bond with 1st atom and fill in bondtype
-------------------------------------------------------------------------- */
-
-void FixShake::ring_bonds(int ndatum, char *cbuf)
-{
-  Atom *atom = fsptr->atom;
-  double *rmass = atom->rmass;
-  double *mass = atom->mass;
-  int *mask = atom->mask;
-  int *type = atom->type;
-  int nlocal = atom->nlocal;
-  int nmass = fsptr->nmass;
 
-  tagint *buf = (tagint *) cbuf;
-  int m,n;
-  double massone;
-
-  for (int i = 0; i < ndatum; i += 6) {
-    m = atom->map(buf[i+1]);
-    if (m >= 0 && m < nlocal) {
-      buf[i+2] = mask[m];
-      buf[i+3] = type[m];
-      if (nmass) {
-        if (rmass) massone = rmass[m];
-        else massone = mass[type[m]];
-        buf[i+4] = fsptr->masscheck(massone);
-      }
-      if (buf[i+5] == 0) {
-        n = fsptr->bondtype_findset(m,buf[i],buf[i+1],0);
-        if (n) buf[i+5] = n;
-      }
-    }
-  }
-}
-
-/* ----------------------------------------------------------------------
-   when receive buffer, scan bond partner IDs for atoms I own
-   if I own partner, fill in nshake value
-------------------------------------------------------------------------- */
-
-void FixShake::ring_nshake(int ndatum, char *cbuf)
-{
-  Atom *atom = fsptr->atom;
-  int nlocal = atom->nlocal;
-
-  int *nshake = fsptr->nshake;
-
-  tagint *buf = (tagint *) cbuf;
-  int m;
-
-  for (int i = 0; i < ndatum; i += 3) {
-    m = atom->map(buf[i+1]);
-    if (m >= 0 && m < nlocal) buf[i+2] = nshake[m];
-  }
-}
-
-/* ----------------------------------------------------------------------
-   when receive buffer, scan bond partner IDs for atoms I own
-   if I own partner, fill in nshake value
-------------------------------------------------------------------------- */
-
-void FixShake::ring_shake(int ndatum, char *cbuf)
-{
-  Atom *atom = fsptr->atom;
-  int nlocal = atom->nlocal;
-
-  int *shake_flag = fsptr->shake_flag;
-  tagint **shake_atom = fsptr->shake_atom;
-  int **shake_type = fsptr->shake_type;
-
-  tagint *buf = (tagint *) cbuf;
-  int m;
-
-  for (int i = 0; i < ndatum; i += 9) {
-    m = atom->map(buf[i]);
-    if (m >= 0 && m < nlocal) {
-      shake_flag[m] = buf[i+1];
-      shake_atom[m][0] = buf[i+2];
-      shake_atom[m][1] = buf[i+3];
-      shake_atom[m][2] = buf[i+4];
-      shake_atom[m][3] = buf[i+5];
-      shake_type[m][0] = buf[i+6];
-      shake_type[m][1] = buf[i+7];
-      shake_type[m][2] = buf[i+8];
-    }
+  double time2 = MPI_Wtime();
+  if (me == 0) {
+    if (screen)
+      fprintf(screen,"  find clusters CPU = %g secs\n",time2-time1);
+    if (logfile)
+      fprintf(logfile,"  find clusters CPU = %g secs\n",time2-time1);
   }
 }
 
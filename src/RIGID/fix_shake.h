@@ -131,13 +131,24 @@ class FixShake : public Fix {
   int bondtype_findset(int, tagint, tagint, int);
   int angletype_findset(int, tagint, tagint, int);
 
-  // static variable for ring communication callback to access class data
-  // callback functions for ring communication
-
-  static FixShake *fsptr;
-  static void ring_bonds(int, char *);
-  static void ring_nshake(int, char *);
-  static void ring_shake(int, char *);
+  // datums for rendezvous communication, sent to owner of atomID
+
+  struct PartnerInfo {
+    tagint atomID,partnerID;
+    int mask,type,massflag,bondtype;
+  };
+
+  struct NShakeInfo {
+    tagint atomID,partnerID;
+    int nshake;
+  };
+
+  struct ShakeInfo {
+    tagint atomID;
+    tagint shake_atom[4];
+    int shake_flag;
+    int shake_type[3];
+  };
 };
 
 }
@@ -279,6 +279,40 @@ int MPI_Get_count(MPI_Status *status, MPI_Datatype datatype, int *count)
 
 /* ---------------------------------------------------------------------- */
 
+int MPI_Send_init(const void *buf, int count, MPI_Datatype datatype,
+                  int dest, int tag, MPI_Comm comm, MPI_Request *request)
+{
+  printf("MPI Stub WARNING: Should not send message to self\n");
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int MPI_Recv_init(void *buf, int count, MPI_Datatype datatype,
+                  int source, int tag, MPI_Comm comm, MPI_Request *request)
+{
+  printf("MPI Stub WARNING: Should not recv message from self\n");
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int MPI_Start(MPI_Request *request)
+{
+  printf("MPI Stub WARNING: Should not start message to/from self\n");
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int MPI_Request_free(MPI_Request *request)
+{
+  *request = MPI_REQUEST_NULL;
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
 int MPI_Comm_split(MPI_Comm comm, int color, int key, MPI_Comm *comm_out)
 {
   *comm_out = comm;
@@ -287,6 +321,15 @@ int MPI_Comm_split(MPI_Comm comm, int color, int key, MPI_Comm *comm_out)
 
 /* ---------------------------------------------------------------------- */
 
+int MPI_Comm_split_type(MPI_Comm comm, int split_type, int key,
+                        MPI_Info info, MPI_Comm *comm_out)
+{
+  *comm_out = comm;
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
 int MPI_Comm_dup(MPI_Comm comm, MPI_Comm *comm_out)
 {
   *comm_out = comm;
@@ -331,6 +374,69 @@ int MPI_Group_incl(MPI_Group group, int n, int *ranks, MPI_Group *newgroup)
      *newgroup = group;
    return 0;
 }
+
+/* ---------------------------------------------------------------------- */
+
+int MPI_Group_translate_ranks(MPI_Group group1, int n, const int *ranks1,
+                              MPI_Group group2, int *ranks2)
+{
+  int i;
+  for (i = 0; i < n; i++) ranks2[i] = ranks1[i];
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int MPI_Group_free(MPI_Group *group)
+{
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int MPI_Win_allocate_shared(MPI_Aint size, int disp_unit, MPI_Info info,
+                            MPI_Comm comm, void *baseptr, MPI_Win *win)
+{
+  printf("MPI Stub WARNING: Should not allocate shared window in serial\n");
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int MPI_Win_shared_query(MPI_Win win, int rank, MPI_Aint *size,
+                         int *disp_unit, void *baseptr)
+{
+  printf("MPI Stub WARNING: Should not query shared window in serial\n");
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int MPI_Win_lock_all(int assert, MPI_Win win)
+{
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int MPI_Win_unlock_all(MPI_Win win)
+{
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int MPI_Win_sync(MPI_Win win)
+{
+  return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int MPI_Win_free(MPI_Win *win)
+{
+  return 0;
+}
 /* ---------------------------------------------------------------------- */
 
 int MPI_Cart_create(MPI_Comm comm_old, int ndims, int *dims, int *periods,
@@ -50,7 +50,13 @@ extern "C" {
 #define MPI_GROUP_EMPTY -1
 
 #define MPI_ANY_SOURCE -1
+#define MPI_PROC_NULL -2
 #define MPI_STATUS_IGNORE NULL
+#define MPI_STATUSES_IGNORE NULL
+#define MPI_REQUEST_NULL 0
+#define MPI_INFO_NULL 0
+#define MPI_COMM_TYPE_SHARED 1
+#define MPI_MODE_NOCHECK 1024
 
 #define MPI_Comm int
 #define MPI_Request int
@@ -59,6 +65,9 @@ extern "C" {
 #define MPI_Fint int
 #define MPI_Group int
 #define MPI_Offset long
+#define MPI_Aint long
+#define MPI_Info int
+#define MPI_Win int
 
 #define MPI_IN_PLACE NULL
 
@@ -110,7 +119,16 @@ int MPI_Sendrecv(const void *sbuf, int scount, MPI_Datatype sdatatype,
                   MPI_Comm comm, MPI_Status *status);
 int MPI_Get_count(MPI_Status *status, MPI_Datatype datatype, int *count);
 
+int MPI_Send_init(const void *buf, int count, MPI_Datatype datatype,
+                  int dest, int tag, MPI_Comm comm, MPI_Request *request);
+int MPI_Recv_init(void *buf, int count, MPI_Datatype datatype,
+                  int source, int tag, MPI_Comm comm, MPI_Request *request);
+int MPI_Start(MPI_Request *request);
+int MPI_Request_free(MPI_Request *request);
+
 int MPI_Comm_split(MPI_Comm comm, int color, int key, MPI_Comm *comm_out);
+int MPI_Comm_split_type(MPI_Comm comm, int split_type, int key,
+                        MPI_Info info, MPI_Comm *comm_out);
 int MPI_Comm_dup(MPI_Comm comm, MPI_Comm *comm_out);
 int MPI_Comm_free(MPI_Comm *comm);
 MPI_Fint MPI_Comm_c2f(MPI_Comm comm);
@@ -118,6 +136,18 @@ MPI_Comm MPI_Comm_f2c(MPI_Fint comm);
 int MPI_Comm_group(MPI_Comm comm, MPI_Group *group);
 int MPI_Comm_create(MPI_Comm comm, MPI_Group group, MPI_Comm *newcomm);
 int MPI_Group_incl(MPI_Group group, int n, int *ranks, MPI_Group *newgroup);
+int MPI_Group_translate_ranks(MPI_Group group1, int n, const int *ranks1,
+                              MPI_Group group2, int *ranks2);
+int MPI_Group_free(MPI_Group *group);
+
+int MPI_Win_allocate_shared(MPI_Aint size, int disp_unit, MPI_Info info,
+                            MPI_Comm comm, void *baseptr, MPI_Win *win);
+int MPI_Win_shared_query(MPI_Win win, int rank, MPI_Aint *size,
+                         int *disp_unit, void *baseptr);
+int MPI_Win_lock_all(int assert, MPI_Win win);
+int MPI_Win_unlock_all(MPI_Win win);
+int MPI_Win_sync(MPI_Win win);
+int MPI_Win_free(MPI_Win *win);
 
 int MPI_Cart_create(MPI_Comm comm_old, int ndims, int *dims, int *periods,
                     int reorder, MPI_Comm *comm_cart);
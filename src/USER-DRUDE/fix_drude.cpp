@@ -23,13 +23,12 @@
 #include "atom_vec.h"
 
 #include <set>
+#include <map>
 #include <vector>
 
 using namespace LAMMPS_NS;
 using namespace FixConst;
 
-FixDrude *FixDrude::sptr = NULL;
-
 /* ---------------------------------------------------------------------- */
 
 FixDrude::FixDrude(LAMMPS *lmp, int narg, char **arg) :
@@ -107,122 +106,95 @@ void FixDrude::build_drudeid(){
   int nlocal = atom->nlocal;
   int *type = atom->type;
 
-  std::vector<tagint> drude_vec; // list of my Drudes' tags
-  std::vector<tagint> core_drude_vec;
+  std::vector<PartnerRvous> partner_vec; // bond partners of off-proc atoms
+  std::vector<PartnerRvous> drude_vec;   // Drudes of off-proc cores
   partner_set = new std::set<tagint>[nlocal]; // Temporary sets of bond partner tags
 
-  sptr = this;
-  if (atom->molecular == 1)
-  {
-    // Build list of my atoms' bond partners
-    for (int i=0; i<nlocal; i++){
-      if (drudetype[type[i]] == NOPOL_TYPE) continue;
-      drudeid[i] = 0;
-      for (int k=0; k<atom->num_bond[i]; k++){
-        core_drude_vec.push_back(atom->tag[i]);
-        core_drude_vec.push_back(atom->bond_atom[i][k]);
-      }
-    }
-  }
-  else
-  {
-    // Template case
-    class Molecule **atommols;
-    atommols = atom->avec->onemols;
-
-    // Build list of my atoms' bond partners
-    for (int i=0; i<nlocal; i++){
+  // Build list of my atoms' bond partners
+  for (int i=0; i<nlocal; i++){
+    if (drudetype[type[i]] == NOPOL_TYPE) continue;
+    drudeid[i] = 0;
+
+    int nbonds;
+    tagint *batom, tagprev;
+    if (atom->molecular == 1) {
+      nbonds = atom->num_bond[i];
+      batom = atom->bond_atom[i];
+      tagprev = 0;
+    } else {
+      // Template case
+      class Molecule **atommols = atom->avec->onemols;
       int imol = atom->molindex[i];
       int iatom = atom->molatom[i];
-      tagint *batom = atommols[imol]->bond_atom[iatom];
-      tagint tagprev = atom->tag[i] - iatom - 1;
-      int nbonds = atommols[imol]->num_bond[iatom];
-
-      if (drudetype[type[i]] == NOPOL_TYPE) continue;
-      drudeid[i] = 0;
-      for (int k=0; k<nbonds; k++){
-        core_drude_vec.push_back(atom->tag[i]);
-        core_drude_vec.push_back(batom[k]+tagprev);
+      nbonds = atommols[imol]->num_bond[iatom];
+      batom = atommols[imol]->bond_atom[iatom];
+      tagprev = atom->tag[i] - iatom - 1;
+    }
+
+    for (int k=0; k<nbonds; k++){
+      tagint partner = batom[k] + tagprev;
+      partner_set[i].insert(partner);
+      int j = atom->map(partner);
+      if (j >= 0 && j < nlocal) {
+        partner_set[j].insert(atom->tag[i]);
+      } else {
+        PartnerRvous datum = {partner, atom->tag[i]};
+        partner_vec.push_back(datum);
       }
     }
   }
-  // Loop on procs to fill my atoms' sets of bond partners
-  comm->ring(core_drude_vec.size(), sizeof(tagint),
-             (char *) core_drude_vec.data(),
-             4, ring_build_partner, NULL, 1);
+  // Send each pair to the owner of the partner atom,
+  // which adds my atom's tag to the partner's set of bond partners
+  char *buf;
+  int nreturn = comm->rendezvous_atoms(partner_vec.size(),
+                                       (char *) partner_vec.data(),
+                                       sizeof(PartnerRvous), buf);
+  PartnerRvous *outbuf = (PartnerRvous *) buf;
+  for (int m=0; m<nreturn; m++)
+    partner_set[atom->map(outbuf[m].atomID)].insert(outbuf[m].partnerID);
+  memory->sfree(outbuf);
 
-  // Build the list of my Drudes' tags
   // The only bond partners of a Drude particle is its core,
   // so fill drudeid for my Drudes.
   for (int i=0; i<nlocal; i++){
     if (drudetype[type[i]] == DRUDE_TYPE){
-      drude_vec.push_back(atom->tag[i]);
       drudeid[i] = *partner_set[i].begin(); // only one 1-2 neighbor, the core
     }
   }
   // At this point each of my Drudes knows its core.
-  // Send my list of Drudes to other procs and myself
-  // so that each core finds its Drude.
-  comm->ring(drude_vec.size(), sizeof(tagint),
-             (char *) drude_vec.data(),
-             3, ring_search_drudeid, NULL, 1);
-  delete [] partner_set;
-}
-
-/* ----------------------------------------------------------------------
- * when receive buffer, build the set of received Drude tags.
- * Look in my cores' bond partner tags if there is a Drude tag.
- * If so fill this core's dureid.
-------------------------------------------------------------------------- */
-void FixDrude::ring_search_drudeid(int size, char *cbuf){
-  // Search for the drude partner of my cores
-  Atom *atom = sptr->atom;
-  int nlocal = atom->nlocal;
-  int *type = atom->type;
-  std::set<tagint> *partner_set = sptr->partner_set;
-  tagint *drudeid = sptr->drudeid;
-  int *drudetype = sptr->drudetype;
-
-  tagint *first = (tagint *) cbuf;
-  tagint *last = first + size;
-  std::set<tagint> drude_set(first, last);
-  std::set<tagint>::iterator it;
-
-  for (int i=0; i<nlocal; i++) {
-    if (drudetype[type[i]] != CORE_TYPE || drudeid[i] > 0) continue;
-    for (it = partner_set[i].begin(); it != partner_set[i].end(); it++) { // Drude-core are 1-2 neighbors
-      if (drude_set.count(*it) > 0){
-        drudeid[i] = *it;
-        break;
-      }
+  // Each Drude tells its core about itself, a core takes the
+  // Drude of smallest tag among its bond partners.
+  for (int i=0; i<nlocal; i++){
+    if (drudetype[type[i]] != DRUDE_TYPE) continue;
+    int j = atom->map(drudeid[i]);
+    if (j >= 0 && j < nlocal) {
+      set_core_drudeid(j, atom->tag[i]);
+    } else {
+      PartnerRvous datum = {drudeid[i], atom->tag[i]};
+      drude_vec.push_back(datum);
     }
   }
+  nreturn = comm->rendezvous_atoms(drude_vec.size(),
+                                   (char *) drude_vec.data(),
+                                   sizeof(PartnerRvous), buf);
+  outbuf = (PartnerRvous *) buf;
+  for (int m=0; m<nreturn; m++)
+    set_core_drudeid(atom->map(outbuf[m].atomID), outbuf[m].partnerID);
+  memory->sfree(outbuf);
+
+  delete [] partner_set;
 }
 
 /* ----------------------------------------------------------------------
- * buffer contains bond partners. Look for my atoms and add their partner's
- * tag in its set of bond partners.
+ * Drude with tag drude is a bond partner of my atom i.
+ * If i is a core, keep the Drude of smallest tag as its drudeid.
 ------------------------------------------------------------------------- */
-void FixDrude::ring_build_partner(int size, char *cbuf){
-  // Add partners from incoming list
-  Atom *atom = sptr->atom;
-  int nlocal = atom->nlocal;
-  std::set<tagint> *partner_set = sptr->partner_set;
-  tagint *it = (tagint *) cbuf;
-  tagint *last = it + size;
-
-  while (it < last) {
-    int j = atom->map(*it);
-    if (j >= 0 && j < nlocal)
-      partner_set[j].insert(*(it+1));
-    j = atom->map(*(it+1));
-    if (j >= 0 && j < nlocal)
-      partner_set[j].insert(*it);
-    it += 2;
-  }
+void FixDrude::set_core_drudeid(int i, tagint drude){
+  if (drudetype[atom->type[i]] != CORE_TYPE) return;
+  if (partner_set[i].count(drude) == 0) return;
+  if (drudeid[i] == 0 || drude < drudeid[i]) drudeid[i] = drude;
 }
 
-
 /* ----------------------------------------------------------------------
    allocate atom-based array for drudeid
 ------------------------------------------------------------------------- */
@@ -325,24 +297,41 @@ void FixDrude::rebuild_special(){
     if (logfile) fprintf(logfile, "Old max number of 1-2 to 1-4 neighbors: %d\n", nspecmax_old);
   }
 
-  // Build lists of drude and core-drude pairs
-  std::vector<tagint> drude_vec, core_drude_vec, core_special_vec;
+  // Look up which atoms of my special lists are Drudes or cores.
+  // Drudes are stored in the rendezvous table with value -1,
+  // cores with the tag of their Drude.
+  std::vector<tagint> keys, values;
+  std::set<tagint> query_set;
   for (int i=0; i<nlocal; i++) {
     if (drudetype[type[i]] == DRUDE_TYPE) {
-      drude_vec.push_back(atom->tag[i]);
+      keys.push_back(atom->tag[i]);
+      values.push_back(-1);
     } else if (drudetype[type[i]] == CORE_TYPE){
-      core_drude_vec.push_back(atom->tag[i]);
-      core_drude_vec.push_back(drudeid[i]);
+      keys.push_back(atom->tag[i]);
+      values.push_back(drudeid[i]);
     }
+    if (drudetype[type[i]] == DRUDE_TYPE) continue;
+    for (int j=0; j<nspecial[i][2]; j++)
+      query_set.insert(special[i][j]);
+  }
+  std::vector<tagint> queries(query_set.begin(), query_set.end());
+
+  tagint *result;
+  int nfound = comm->rendezvous_lookup(keys.size(), keys.data(),
+                                       values.data(), queries.size(),
+                                       queries.data(), result);
+  std::set<tagint> drude_set;
+  std::map<tagint, tagint> core_drude_map;
+  for (int m=0; m<nfound; m++) {
+    if (result[2*m+1] < 0) drude_set.insert(result[2*m]);
+    else core_drude_map[result[2*m]] = result[2*m+1];
   }
-  // Remove Drude particles from the special lists of each proc
-  comm->ring(drude_vec.size(), sizeof(tagint),
-             (char *) drude_vec.data(),
-             9, ring_remove_drude, NULL, 1);
+  memory->destroy(result);
+
+  // Remove Drude particles from the special lists
+  remove_drude(drude_set);
   // Add back Drude particles in the lists just after their core
-  comm->ring(core_drude_vec.size(), sizeof(tagint),
-             (char *) core_drude_vec.data(),
-             10, ring_add_drude, NULL, 1);
+  add_drude(core_drude_map);
 
   // Check size of special list
   nspecmax_loc = 0;
@@ -360,37 +349,53 @@ void FixDrude::rebuild_special(){
     error->all(FLERR, str);
   }
 
-  // Build list of cores' special lists to communicate to ghost drude particles
+  // Copy cores' special lists into the lists of their Drude particles,
+  // one datum per special list entry sent to the owner of the Drude
+  std::vector<SpecialRvous> special_vec;
   for (int i=0; i<nlocal; i++) {
     if (drudetype[type[i]] != CORE_TYPE) continue;
-    core_special_vec.push_back(atom->tag[i]);
-    core_special_vec.push_back((tagint) nspecial[i][0]);
-    core_special_vec.push_back((tagint) nspecial[i][1]);
-    core_special_vec.push_back((tagint) nspecial[i][2]);
-    for (int j=1; j<nspecial[i][2]; j++)
-      core_special_vec.push_back(special[i][j]);
+    int j = atom->map(drudeid[i]);
+    if (j >= 0 && j < nlocal) {
+      copy_special(j, i);
+      continue;
+    }
+    for (int k=0; k<nspecial[i][2] || k==0; k++) {
+      SpecialRvous datum;
+      datum.atomID = drudeid[i];
+      datum.n0 = nspecial[i][0];
+      datum.n1 = nspecial[i][1];
+      datum.n2 = nspecial[i][2];
+      datum.k = k;
+      datum.value = k ? special[i][k] : atom->tag[i];
+      special_vec.push_back(datum);
+    }
   }
-  // Copy core's list into their drude list
-  comm->ring(core_special_vec.size(), sizeof(tagint),
-             (char *) core_special_vec.data(),
-             11, ring_copy_drude, NULL, 1);
+  char *buf;
+  int nreturn = comm->rendezvous_atoms(special_vec.size(),
+                                       (char *) special_vec.data(),
+                                       sizeof(SpecialRvous), buf);
+  SpecialRvous *outbuf = (SpecialRvous *) buf;
+  for (int m=0; m<nreturn; m++) {
+    int i = atom->map(outbuf[m].atomID);
+    if (drudetype[type[i]] != DRUDE_TYPE) continue;
+    nspecial[i][0] = outbuf[m].n0;
+    nspecial[i][1] = outbuf[m].n1;
+    nspecial[i][2] = outbuf[m].n2;
+    special[i][outbuf[m].k] = outbuf[m].value;
+  }
+  memory->sfree(outbuf);
 }
 
 /* ----------------------------------------------------------------------
- * When receive buffer, build a set of drude tags, look into my atoms'
- * special list if some tags are drude particles. If so, remove it.
+ * Look into my atoms' special list if some tags are drude particles.
+ * If so, remove it.
 ------------------------------------------------------------------------- */
-void FixDrude::ring_remove_drude(int size, char *cbuf){
+void FixDrude::remove_drude(std::set<tagint> &drude_set){
   // Remove all drude particles from special list
-  Atom *atom = sptr->atom;
   int nlocal = atom->nlocal;
   int **nspecial = atom->nspecial;
   tagint **special = atom->special;
   int *type = atom->type;
-  tagint *first = (tagint *) cbuf;
-  tagint *last = first + size;
-  std::set<tagint> drude_set(first, last);
-  int *drudetype = sptr->drudetype;
 
   for (int i=0; i<nlocal; i++) {
     if (drudetype[type[i]] == DRUDE_TYPE) continue;
@@ -411,36 +416,20 @@ void FixDrude::ring_remove_drude(int size, char *cbuf){
 }
 
 /* ----------------------------------------------------------------------
- * When receive buffer, build a map core tag -> drude tag.
  * Loop on my atoms' special list to find core tags. Insert their Drude
  * particle if they have one.
 ------------------------------------------------------------------------- */
-void FixDrude::ring_add_drude(int size, char *cbuf){
+void FixDrude::add_drude(std::map<tagint, tagint> &core_drude_map){
   // Assume special array size is big enough
   // Add all particle just after their core in the special list
-  Atom *atom = sptr->atom;
   int nlocal = atom->nlocal;
   int **nspecial = atom->nspecial;
   tagint **special = atom->special;
   int *type = atom->type;
-  tagint *drudeid = sptr->drudeid;
-  int *drudetype = sptr->drudetype;
-
-  tagint *first = (tagint *) cbuf;
-  tagint *last = first + size;
-  std::map<tagint, tagint> core_drude_map;
-
-  tagint *it = first;
-  while (it < last) {
-    tagint core_tag = *it;
-    it++;
-    core_drude_map[core_tag] = *it;
-    it++;
-  }
 
   for (int i=0; i<nlocal; i++) {
     if (drudetype[type[i]] == DRUDE_TYPE) continue;
-    if (core_drude_map.count(atom->tag[i]) > 0) { // I identify myself as a core, add my own drude
+    if (drudetype[type[i]] == CORE_TYPE) { // I am a core, add my own drude
       // right shift
       for (int k=nspecial[i][2]-1; k>=0; k--)
         special[i][k+1] = special[i][k];
@@ -467,50 +456,19 @@ void FixDrude::ring_add_drude(int size, char *cbuf){
 }
 
 /* ----------------------------------------------------------------------
- * When receive buffer, build a map core tag -> pointer to special info
- * in the buffer. Loop on my Drude particles and copy their special
- * info from that of their core if the latter is found in the map.
+ * Copy special info of my Drude particle i from that of my core j.
 ------------------------------------------------------------------------- */
-void FixDrude::ring_copy_drude(int size, char *cbuf){
+void FixDrude::copy_special(int i, int j){
   // Copy special list of drude from its core (except itself)
-  Atom *atom = sptr->atom;
-  int nlocal = atom->nlocal;
   int **nspecial = atom->nspecial;
   tagint **special = atom->special;
-  int *type = atom->type;
-  tagint *drudeid = sptr->drudeid;
-  int *drudetype = sptr->drudetype;
-
-  tagint *first = (tagint *) cbuf;
-  tagint *last = first + size;
-  std::map<tagint, tagint*> core_special_map;
-
-  tagint *it = first;
-  while (it < last) {
-    tagint core_tag = *it;
-    it++;
-    core_special_map[core_tag] = it;
-    it += 2;
-    it += (int) *it;
-  }
 
-  for (int i=0; i<nlocal; i++) {
-    if (drudetype[type[i]] != DRUDE_TYPE) continue;
-    if (core_special_map.count(drudeid[i]) > 0) { // My core is in this list, copy its special info
-      it = core_special_map[drudeid[i]];
-      nspecial[i][0] = (int) *it;
-      it++;
-      nspecial[i][1] = (int) *it;
-      it++;
-      nspecial[i][2] = (int) *it;
-      it++;
-      special[i][0] = drudeid[i];
-      for (int k=1; k<nspecial[i][2]; k++) {
-        special[i][k] = *it;
-        it++;
-      }
-    }
-  }
+  nspecial[i][0] = nspecial[j][0];
+  nspecial[i][1] = nspecial[j][1];
+  nspecial[i][2] = nspecial[j][2];
+  special[i][0] = atom->tag[j];
+  for (int k=1; k<nspecial[i][2]; k++)
+    special[i][k] = special[j][k];
 }
 
 /* ----------------------------------------------------------------------
@@ -22,6 +22,7 @@ FixStyle(drude,FixDrude)
 
 #include "fix.h"
 #include <set>
+#include <map>
 
 #define NOPOL_TYPE 0
 #define CORE_TYPE  1
@@ -50,16 +51,24 @@ class FixDrude : public Fix {
 
 private:
   int rebuildflag;
-  static FixDrude *sptr;
   std::set<tagint> * partner_set;
 
   void build_drudeid();
-  static void ring_search_drudeid(int size, char *cbuf);
-  static void ring_build_partner(int size, char *cbuf);
+  void set_core_drudeid(int i, tagint drude);
   void rebuild_special();
-  static void ring_remove_drude(int size, char *cbuf);
-  static void ring_add_drude(int size, char *cbuf);
-  static void ring_copy_drude(int size, char *cbuf);
+  void remove_drude(std::set<tagint> &drude_set);
+  void add_drude(std::map<tagint, tagint> &core_drude_map);
+  void copy_special(int i, int j);
+
+  // datums for rendezvous communication, sent to owner of atomID
+  struct PartnerRvous {
+    tagint atomID, partnerID;
+  };
+  struct SpecialRvous {
+    tagint atomID;
+    int n0, n1, n2, k;
+    tagint value;
+  };
 };
 
 }
@@ -87,7 +87,7 @@ FixLbFluid::FixLbFluid(LAMMPS *lmp, int narg, char **arg) :
 
   if(narg <7) error->all(FLERR,"Illegal fix lb/fluid command");
 
-  if (comm->style != 0)
+  if (comm->style == 1)
     error->universe_all(FLERR,"Fix lb/fluid can only currently be used with "
                         "comm_style brick");
 
@@ -562,7 +562,7 @@ void FixLbFluid::init(void)
 {
   int i,j;
 
-  if (comm->style != 0)
+  if (comm->style == 1)
     error->universe_all(FLERR,"Fix lb/fluid can only currently be used with "
                         "comm_style brick");
 
@@ -51,6 +51,7 @@ PPPMCGOMP::PPPMCGOMP(LAMMPS *lmp, int narg, char **arg) :
   PPPMCG(lmp, narg, arg), ThrOMP(lmp, THR_KSPACE)
 {
   triclinic_support = 0;
+  r2c_support = 0;
   suffix_flag |= Suffix::OMP;
 }
 
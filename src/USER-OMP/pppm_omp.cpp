@@ -42,13 +42,64 @@ using namespace MathSpecial;
 
 #define EPS_HOC 1.0e-7
 
+/* ----------------------------------------------------------------------
+   evaluate coeff polynomials at dx,dy,dz for all N pts of a stencil
+   with compile-time N, the loops over stencil pts can be vectorized
+------------------------------------------------------------------------- */
+
+template <int N>
+static inline void stencil1d(FFT_SCALAR * const * const r1d,
+                             FFT_SCALAR * const * const coeff,
+                             const int nterms, const FFT_SCALAR &dx,
+                             const FFT_SCALAR &dy, const FFT_SCALAR &dz)
+{
+  const int lo = (1-N)/2;
+  FFT_SCALAR r1[N],r2[N],r3[N];
+  int k,l;
+
+  for (k = 0; k < N; k++) r1[k] = r2[k] = r3[k] = ZEROF;
+
+  for (l = nterms-1; l >= 0; l--) {
+    const FFT_SCALAR * const c = coeff[l] + lo;
+    for (k = 0; k < N; k++) {
+      r1[k] = c[k] + r1[k]*dx;
+      r2[k] = c[k] + r2[k]*dy;
+      r3[k] = c[k] + r3[k]*dz;
+    }
+  }
+
+  for (k = 0; k < N; k++) {
+    r1d[0][lo+k] = r1[k];
+    r1d[1][lo+k] = r2[k];
+    r1d[2][lo+k] = r3[k];
+  }
+}
+
 /* ---------------------------------------------------------------------- */
 
 PPPMOMP::PPPMOMP(LAMMPS *lmp, int narg, char **arg) :
   PPPM(lmp, narg, arg), ThrOMP(lmp, THR_KSPACE)
 {
   triclinic_support = 0;
+  r2c_support = 0;
   suffix_flag |= Suffix::OMP;
+
+  nblock = 0;
+  yblock = zblock = NULL;
+  blockslot = blockstart = NULL;
+  nsorted = maxsort = 0;
+  sortlist = NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+
+PPPMOMP::~PPPMOMP()
+{
+  memory->destroy(yblock);
+  memory->destroy(zblock);
+  memory->destroy(blockslot);
+  memory->destroy(blockstart);
+  memory->destroy(sortlist);
 }
 
 /* ----------------------------------------------------------------------
@@ -59,6 +110,43 @@ void PPPMOMP::allocate()
 {
   PPPM::allocate();
 
+  // blocks of stencil origins for charge assignment without conflicts
+  // stencil origins of owned atoms range from lo_out-nlower to hi_out-nupper
+  // blocks in y and z are at least order pts wide, so stencils of atoms
+  //   in blocks 2 apart in y or z do not overlap
+  // 4 colors by parity of y,z block index, blocks are stored color by color,
+  //   so that all blocks of one color can be done at once
+
+  int i,c,by,bz;
+
+  yorigin = nylo_out - nlower;
+  zorigin = nzlo_out - nlower;
+  const int nyorigin = nyhi_out - nupper - yorigin + 1;
+  const int nzorigin = nzhi_out - nupper - zorigin + 1;
+
+  nblocky = nyorigin/order;
+  nblockz = nzorigin/order;
+  if (nblocky < 1) nblocky = 1;
+  if (nblockz < 1) nblockz = 1;
+  nblock = nblocky*nblockz;
+
+  memory->create(yblock,nyorigin,"pppm:yblock");
+  memory->create(zblock,nzorigin,"pppm:zblock");
+  memory->create(blockslot,nblock,"pppm:blockslot");
+  memory->create(blockstart,nblock+1,"pppm:blockstart");
+
+  for (i = 0; i < nyorigin; i++) yblock[i] = i*nblocky/nyorigin;
+  for (i = 0; i < nzorigin; i++) zblock[i] = i*nblockz/nzorigin;
+
+  i = 0;
+  for (c = 0; c < 4; c++) {
+    colorstart[c] = i;
+    for (bz = c/2; bz < nblockz; bz += 2)
+      for (by = c%2; by < nblocky; by += 2)
+        blockslot[bz*nblocky+by] = i++;
+  }
+  colorstart[4] = i;
+
 #if defined(_OPENMP)
 #pragma omp parallel default(none)
 #endif
@@ -81,6 +169,14 @@ void PPPMOMP::deallocate()
 {
   PPPM::deallocate();
 
+  memory->destroy(yblock);
+  memory->destroy(zblock);
+  memory->destroy(blockslot);
+  memory->destroy(blockstart);
+  yblock = zblock = NULL;
+  blockslot = blockstart = NULL;
+  nblock = 0;
+
 #if defined(_OPENMP)
 #pragma omp parallel default(none)
 #endif
@@ -314,6 +410,10 @@ void PPPMOMP::compute(int eflag, int vflag)
 
   PPPM::compute(eflag,vflag);
 
+  // atoms may move or migrate before the next make_rho()
+
+  nsorted = 0;
+
 #if defined(_OPENMP)
 #pragma omp parallel default(none) shared(eflag,vflag)
 #endif
@@ -346,12 +446,88 @@ void PPPMOMP::make_rho()
 
   // no local atoms => nothing else to do
 
+  nsorted = 0;
   const int nlocal = atom->nlocal;
   if (nlocal == 0) return;
 
   const int ix = nxhi_out - nxlo_out + 1;
   const int iy = nyhi_out - nylo_out + 1;
 
+  // with enough blocks to keep all threads busy, assign charges
+  //   block by block, all blocks of one color at the same time
+  // else each thread loops over all atoms and only updates
+  //   its own range of grid points
+
+  if (nblock >= 4*comm->nthreads) {
+    sort_blocks();
+
+#if defined(_OPENMP)
+#pragma omp parallel default(none)
+#endif
+    {
+      const double * _noalias const q = atom->q;
+      const dbl3_t * _noalias const x = (dbl3_t *) atom->x[0];
+      const int3_t * _noalias const p2g = (int3_t *) part2grid[0];
+
+      const double boxlox = boxlo[0];
+      const double boxloy = boxlo[1];
+      const double boxloz = boxlo[2];
+
+#if defined(_OPENMP)
+      const int tid = omp_get_thread_num();
+#else
+      const int tid = 0;
+#endif
+
+      // get per thread data
+      ThrData *thr = fix->get_thr(tid);
+      thr->timer(Timer::START);
+      FFT_SCALAR * const * const r1d = static_cast<FFT_SCALAR **>(thr->get_rho1d());
+
+      // loop over my charges, add their contribution to nearby grid points
+      // (nx,ny,nz) = global coords of grid pt to "lower left" of charge
+      // (dx,dy,dz) = distance to "lower left" grid pt
+      // implicit barrier at the end of each omp for separates the colors
+
+      for (int c = 0; c < 4; c++) {
+#if defined(_OPENMP)
+#pragma omp for schedule(dynamic,1)
+#endif
+        for (int b = colorstart[c]; b < colorstart[c+1]; b++) {
+          for (int ii = blockstart[b]; ii < blockstart[b+1]; ii++) {
+            const int i = sortlist[ii];
+
+            const int nx = p2g[i].a;
+            const int ny = p2g[i].b;
+            const int nz = p2g[i].t;
+            const FFT_SCALAR dx = nx+shiftone - (x[i].x-boxlox)*delxinv;
+            const FFT_SCALAR dy = ny+shiftone - (x[i].y-boxloy)*delyinv;
+            const FFT_SCALAR dz = nz+shiftone - (x[i].z-boxloz)*delzinv;
+
+            compute_rho1d_thr(r1d,dx,dy,dz);
+
+            const FFT_SCALAR z0 = delvolinv * q[i];
+
+            for (int n = nlower; n <= nupper; ++n) {
+              const int jn = (nz+n-nzlo_out)*ix*iy;
+              const FFT_SCALAR y0 = z0*r1d[2][n];
+
+              for (int m = nlower; m <= nupper; ++m) {
+                const int jm = jn+(ny+m-nylo_out)*ix+nx-nxlo_out;
+                const FFT_SCALAR x0 = y0*r1d[1][m];
+
+                for (int l = nlower; l <= nupper; ++l)
+                  d[jm+l] += x0*r1d[0][l];
+              }
+            }
+          }
+        }
+      }
+      thr->timer(Timer::KSPACE);
+    }
+    return;
+  }
+
 #if defined(_OPENMP)
 #pragma omp parallel default(none)
 #endif
@@ -454,7 +630,7 @@ void PPPMOMP::fieldforce_ik()
 #endif
   {
     FFT_SCALAR x0,y0,z0,ekx,eky,ekz;
-    int i,ifrom,ito,tid,l,m,n,mx,my,mz;
+    int i,ii,ifrom,ito,tid,l,m,n,mx,my,mz;
 
     loop_setup_thr(ifrom,ito,tid,nlocal,nthreads);
 
@@ -464,7 +640,8 @@ void PPPMOMP::fieldforce_ik()
     dbl3_t * _noalias const f = (dbl3_t *) thr->get_f()[0];
     FFT_SCALAR * const * const r1d = static_cast<FFT_SCALAR **>(thr->get_rho1d());
 
-    for (i = ifrom; i < ito; ++i) {
+    for (ii = ifrom; ii < ito; ++ii) {
+      i = (nsorted) ? sortlist[ii] : ii;
       const int nx = p2g[i].a;
       const int ny = p2g[i].b;
       const int nz = p2g[i].t;
@@ -540,7 +717,7 @@ void PPPMOMP::fieldforce_ad()
   {
     double s1,s2,s3,sf;
     FFT_SCALAR ekx,eky,ekz;
-    int i,ifrom,ito,tid,l,m,n,mx,my,mz;
+    int i,ii,ifrom,ito,tid,l,m,n,mx,my,mz;
 
     loop_setup_thr(ifrom,ito,tid,nlocal,nthreads);
 
@@ -551,7 +728,8 @@ void PPPMOMP::fieldforce_ad()
     FFT_SCALAR * const * const r1d = static_cast<FFT_SCALAR **>(thr->get_rho1d());
     FFT_SCALAR * const * const d1d = static_cast<FFT_SCALAR **>(thr->get_drho1d());
 
-    for (i = ifrom; i < ito; ++i) {
+    for (ii = ifrom; ii < ito; ++ii) {
+      i = (nsorted) ? sortlist[ii] : ii;
       const int nx = p2g[i].a;
       const int ny = p2g[i].b;
       const int nz = p2g[i].t;
@@ -633,7 +811,7 @@ void PPPMOMP::fieldforce_peratom()
   {
     FFT_SCALAR dx,dy,dz,x0,y0,z0;
     FFT_SCALAR u,v0,v1,v2,v3,v4,v5;
-    int i,ifrom,ito,tid,l,m,n,nx,ny,nz,mx,my,mz;
+    int i,ii,ifrom,ito,tid,l,m,n,nx,ny,nz,mx,my,mz;
 
     loop_setup_thr(ifrom,ito,tid,nlocal,nthreads);
 
@@ -642,7 +820,8 @@ void PPPMOMP::fieldforce_peratom()
     thr->timer(Timer::START);
     FFT_SCALAR * const * const r1d = static_cast<FFT_SCALAR **>(thr->get_rho1d());
 
-    for (i = ifrom; i < ito; ++i) {
+    for (ii = ifrom; ii < ito; ++ii) {
+      i = (nsorted) ? sortlist[ii] : ii;
       nx = part2grid[i][0];
       ny = part2grid[i][1];
       nz = part2grid[i][2];
@@ -690,6 +869,44 @@ void PPPMOMP::fieldforce_peratom()
   } // end of parallel region
 }
 
+/* ----------------------------------------------------------------------
+   counting sort of owned atoms by block of their stencil origin
+   blockstart[b] to blockstart[b+1]-1 = atoms in sortlist for block b
+------------------------------------------------------------------------- */
+
+void PPPMOMP::sort_blocks()
+{
+  int i,b;
+
+  const int nlocal = atom->nlocal;
+  const int3_t * _noalias const p2g = (int3_t *) part2grid[0];
+
+  if (nlocal > maxsort) {
+    maxsort = atom->nmax;
+    memory->destroy(sortlist);
+    memory->create(sortlist,maxsort,"pppm:sortlist");
+  }
+
+  for (b = 0; b <= nblock; b++) blockstart[b] = 0;
+
+  for (i = 0; i < nlocal; i++) {
+    b = blockslot[zblock[p2g[i].t-zorigin]*nblocky + yblock[p2g[i].b-yorigin]];
+    blockstart[b+1]++;
+  }
+  for (b = 0; b < nblock; b++) blockstart[b+1] += blockstart[b];
+
+  // fill blocks, which shifts blockstart to 1st atom of next block
+
+  for (i = 0; i < nlocal; i++) {
+    b = blockslot[zblock[p2g[i].t-zorigin]*nblocky + yblock[p2g[i].b-yorigin]];
+    sortlist[blockstart[b]++] = i;
+  }
+  for (b = nblock; b > 0; b--) blockstart[b] = blockstart[b-1];
+  blockstart[0] = 0;
+
+  nsorted = nlocal;
+}
+
 /* ----------------------------------------------------------------------
    charge assignment into rho1d
    dx,dy,dz = distance of particle from "lower left" grid point
@@ -700,6 +917,12 @@ void PPPMOMP::compute_rho1d_thr(FFT_SCALAR * const * const r1d, const FFT_SCALAR
   int k,l;
   FFT_SCALAR r1,r2,r3;
 
+  switch (order) {
+  case 5: stencil1d<5>(r1d,rho_coeff,order,dx,dy,dz); return;
+  case 6: stencil1d<6>(r1d,rho_coeff,order,dx,dy,dz); return;
+  case 7: stencil1d<7>(r1d,rho_coeff,order,dx,dy,dz); return;
+  }
+
   for (k = (1-order)/2; k <= order/2; k++) {
     r1 = r2 = r3 = ZEROF;
 
@@ -725,6 +948,12 @@ void PPPMOMP::compute_drho1d_thr(FFT_SCALAR * const * const d1d, const FFT_SCALA
   int k,l;
   FFT_SCALAR r1,r2,r3;
 
+  switch (order) {
+  case 5: stencil1d<5>(d1d,drho_coeff,order-1,dx,dy,dz); return;
+  case 6: stencil1d<6>(d1d,drho_coeff,order-1,dx,dy,dz); return;
+  case 7: stencil1d<7>(d1d,drho_coeff,order-1,dx,dy,dz); return;
+  }
+
   for (k = (1-order)/2; k <= order/2; k++) {
     r1 = r2 = r3 = ZEROF;
 
@@ -28,7 +28,7 @@ namespace LAMMPS_NS {
 class PPPMOMP : public PPPM, public ThrOMP {
  public:
   PPPMOMP(class LAMMPS *, int, char **);
-  virtual ~PPPMOMP () {};
+  virtual ~PPPMOMP ();
   virtual void compute(int, int);
 
  protected:
@@ -44,6 +44,18 @@ class PPPMOMP : public PPPM, public ThrOMP {
   virtual void fieldforce_peratom();
 
  private:
+  int nblocky,nblockz;         // # of blocks of stencil origins in y,z
+  int nblock;                  // nblocky*nblockz
+  int yorigin,zorigin;         // lowest y,z stencil origin of owned atoms
+  int *yblock,*zblock;         // block index of each y,z stencil origin
+  int *blockslot;              // position of each block in color order
+  int colorstart[5];           // 1st block of each of 4 colors
+  int *blockstart;             // 1st atom of each block in sortlist
+  int nsorted;                 // # of atoms in sortlist, 0 if not sorted
+  int maxsort;                 // allocated length of sortlist
+  int *sortlist;               // owned atoms sorted by block
+
+  void sort_blocks();
   void compute_rho1d_thr(FFT_SCALAR * const * const, const FFT_SCALAR &,
                          const FFT_SCALAR &, const FFT_SCALAR &);
   void compute_drho1d_thr(FFT_SCALAR * const * const, const FFT_SCALAR &,
@@ -49,6 +49,7 @@ PPPMTIP4POMP::PPPMTIP4POMP(LAMMPS *lmp, int narg, char **arg) :
   PPPMTIP4P(lmp, narg, arg), ThrOMP(lmp, THR_KSPACE)
 {
   triclinic_support = 0;
+  r2c_support = 0;
   suffix_flag |= Suffix::OMP;
 }
 
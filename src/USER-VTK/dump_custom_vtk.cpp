@@ -98,6 +98,10 @@ DumpCustomVTK::DumpCustomVTK(LAMMPS *lmp, int narg, char **arg) :
 {
   if (narg == 5) error->all(FLERR,"No dump custom/vtk arguments specified");
 
+  // VTK output bypasses write_header() and write_data(), so no async
+
+  async_allow = 0;
+
   pack_choice.clear();
   vtype.clear();
   name.clear();
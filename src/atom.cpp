@@ -799,10 +799,11 @@ void Atom::deallocate_topology()
 /* ----------------------------------------------------------------------
    unpack N lines from Atom section of data file
    call style-specific routine to parse line
+   if allflag, keep all atoms inside global box, caller migrates them to owners
 ------------------------------------------------------------------------- */
 
 void Atom::data_atoms(int n, char *buf, tagint id_offset, int type_offset,
-                      int shiftflag, double *shift)
+                      int shiftflag, double *shift, int allflag)
 {
   int m,xptr,iptr;
   imageint imagedata;
@@ -820,7 +821,7 @@ void Atom::data_atoms(int n, char *buf, tagint id_offset, int type_offset,
 
   char **values = new char*[nwords];
 
-  // set bounds for my proc
+  // set bounds for my proc, or for entire box if allflag
   // if periodic and I am lo/hi proc, adjust bounds by EPSILON
   // insures all data atoms will be owned even with round-off
 
@@ -845,7 +846,22 @@ void Atom::data_atoms(int n, char *buf, tagint id_offset, int type_offset,
     sublo[2] = domain->sublo_lamda[2]; subhi[2] = domain->subhi_lamda[2];
   }
 
-  if (comm->layout != LAYOUT_TILED) {
+  if (allflag) {
+    for (int idim = 0; idim < 3; idim++) {
+      if (triclinic == 0) {
+        sublo[idim] = domain->boxlo[idim];
+        subhi[idim] = domain->boxhi[idim];
+      } else {
+        sublo[idim] = 0.0;
+        subhi[idim] = 1.0;
+      }
+      if (domain->periodicity[idim]) {
+        sublo[idim] -= epsilon[idim];
+        subhi[idim] += epsilon[idim];
+      }
+    }
+
+  } else if (comm->layout != LAYOUT_TILED) {
     if (domain->xperiodic) {
       if (comm->myloc[0] == 0) sublo[0] -= epsilon[0];
       if (comm->myloc[0] == comm->procgrid[0]-1) subhi[0] += epsilon[0];
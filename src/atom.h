@@ -223,7 +223,7 @@ class Atom : protected Pointers {
 
   void deallocate_topology();
 
-  void data_atoms(int, char *, tagint, int, int, double *);
+  void data_atoms(int, char *, tagint, int, int, double *, int);
   void data_vels(int, char *, tagint);
 
   void data_bonds(int, char *, int *, tagint, int);
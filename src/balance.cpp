@@ -245,7 +245,7 @@ void Balance::command(int narg, char **arg)
     }
   }
 
-  if (style == BISECTION && comm->style == 0)
+  if (style == BISECTION && comm->style != 1)
     error->all(FLERR,"Balance rcb cannot be used with comm_style brick");
 
   // process remaining optional args
@@ -28,16 +28,37 @@
 #include "dump.h"
 #include "group.h"
 #include "procmap.h"
+#include "irregular.h"
 #include "accelerator_kokkos.h"
 #include "memory.h"
 #include "error.h"
 
+#include <map>
+
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
 using namespace LAMMPS_NS;
 
+// datums and callback data for rendezvous operations keyed by atom ID
+
+struct OwnerRvous {
+  int proc;
+  tagint atomID;
+};
+
+struct LookupRvous {
+  int proc,flag;
+  tagint key,value;
+};
+
+struct RouteData {
+  Comm *comm;
+  int nbytes;
+  std::map<tagint,int> owners;
+};
+
 #define BUFMIN 1000             // also in comm styles
 
 enum{SINGLE,MULTI};             // same as in Comm sub-styles
@@ -55,6 +76,10 @@ Comm::Comm(LAMMPS *lmp) : Pointers(lmp)
 
   mode = 0;
   bordergroup = 0;
+  overlap = 0;
+  persist = 0;
+  shm = 0;
+  xfloat = 0;
   cutghostuser = 0.0;
   cutusermulti = NULL;
   ghost_velocity = 0;
@@ -301,6 +326,30 @@ void Comm::modify_params(int narg, char **arg)
       else if (strcmp(arg[iarg+1],"no") == 0) ghost_velocity = 0;
       else error->all(FLERR,"Illegal comm_modify command");
       iarg += 2;
+    } else if (strcmp(arg[iarg],"overlap") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal comm_modify command");
+      if (strcmp(arg[iarg+1],"yes") == 0) overlap = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) overlap = 0;
+      else error->all(FLERR,"Illegal comm_modify command");
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"persist") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal comm_modify command");
+      if (strcmp(arg[iarg+1],"yes") == 0) persist = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) persist = 0;
+      else error->all(FLERR,"Illegal comm_modify command");
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"shm") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal comm_modify command");
+      if (strcmp(arg[iarg+1],"yes") == 0) shm = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) shm = 0;
+      else error->all(FLERR,"Illegal comm_modify command");
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"xfloat") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal comm_modify command");
+      if (strcmp(arg[iarg+1],"yes") == 0) xfloat = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) xfloat = 0;
+      else error->all(FLERR,"Illegal comm_modify command");
+      iarg += 2;
     } else error->all(FLERR,"Illegal comm_modify command");
   }
 }
@@ -720,6 +769,301 @@ void Comm::ring(int n, int nper, void *inbuf, int messtag,
   memory->destroy(bufcopy);
 }
 
+/* ----------------------------------------------------------------------
+   rendezvous communication operation
+   alternative to ring() for data that can be keyed to a specific proc,
+     e.g. via hash of atom ID, cost is O(N/P) per proc instead of O(N)
+   three stages:
+     first Irregular converts inbuf from caller decomp to rendezvous decomp
+     callback() operates on data in rendezvous decomp
+     second Irregular converts outbuf from rendezvous decomp back to caller
+   inputs:
+     n = # of datums in inbuf
+     inbuf = vector of input datums
+     insize = byte size of each input datum
+     procs = proc to send each input datum to, can include self
+     callback = caller function invoked in rendezvous decomp
+     outsize = byte size of each output datum
+     ptr = pointer to caller class, passed to callback()
+   callback(n,inbuf,flag,procs,outbuf,ptr) in rendezvous decomp:
+     n,inbuf = datums received by this proc
+     returns # of output datums, allocates procs via memory->create()
+     flag = 0 if no datums are sent back, must be same on all procs
+     flag = 1 if outbuf = inbuf, so callback() can update datums in place
+     flag = 2 if outbuf was allocated by callback() via memory->smalloc()
+   outputs:
+     return = # of output datums received by this proc
+     outbuf = vector of output datums, allocated here via memory->smalloc()
+       caller must free it via memory->sfree()
+------------------------------------------------------------------------- */
+
+int Comm::rendezvous(int n, char *inbuf, int insize, int *procs,
+                     int (*callback)(int, char *, int &, int *&, char *&,
+                                     void *),
+                     char *&outbuf, int outsize, void *ptr)
+{
+  // comm inbuf from caller decomposition to rendezvous decomposition
+
+  Irregular *irregular = new Irregular(lmp);
+
+  int nrvous = irregular->create_data(n,procs);
+  char *inbuf_rvous = (char *)
+    memory->smalloc((bigint) nrvous*insize,"rendezvous:inbuf");
+  irregular->exchange_data(inbuf,insize,inbuf_rvous);
+  irregular->destroy_data();
+
+  // perform rendezvous computation via callback()
+  // callback() allocates/populates procs_rvous and outbuf_rvous
+
+  int flag;
+  int *procs_rvous = NULL;
+  char *outbuf_rvous = NULL;
+
+  int nrvous_out = callback(nrvous,inbuf_rvous,flag,
+                            procs_rvous,outbuf_rvous,ptr);
+
+  if (flag != 1) memory->sfree(inbuf_rvous);
+  outbuf = NULL;
+
+  if (flag == 0) {
+    memory->destroy(procs_rvous);
+    delete irregular;
+    return 0;
+  }
+
+  // comm outbuf from rendezvous decomposition back to caller
+
+  int nout = irregular->create_data(nrvous_out,procs_rvous);
+  outbuf = (char *) memory->smalloc((bigint) nout*outsize,"rendezvous:outbuf");
+  irregular->exchange_data(outbuf_rvous,outsize,outbuf);
+  irregular->destroy_data();
+  delete irregular;
+
+  memory->destroy(procs_rvous);
+  memory->sfree(outbuf_rvous);
+
+  return nout;
+}
+
+/* ----------------------------------------------------------------------
+   send datums to the procs that own the atoms they refer to
+   rendezvous proc of each atom ID = ID % nprocs
+   first rendezvous op tells each rendezvous proc which procs own its IDs
+   second rendezvous op sends each datum to the rendezvous proc of its
+     atom ID, which routes it on to the proc that owns the atom
+   inputs:
+     n = # of datums in inbuf
+     inbuf = vector of input datums, each starts with a tagint atom ID
+     nbytes = byte size of each datum
+   outputs:
+     return = # of datums received by this proc, for atoms it owns
+     outbuf = vector of received datums, allocated here
+       caller must free it via memory->sfree()
+------------------------------------------------------------------------- */
+
+int Comm::rendezvous_atoms(int n, char *inbuf, int nbytes, char *&outbuf)
+{
+  int i;
+
+  int nlocal = atom->nlocal;
+  tagint *tag = atom->tag;
+
+  RouteData data;
+  data.comm = this;
+  data.nbytes = nbytes;
+
+  int *proclist;
+  memory->create(proclist,MAX(nlocal,n),"comm:proclist");
+  OwnerRvous *idbuf = (OwnerRvous *)
+    memory->smalloc((bigint) nlocal*sizeof(OwnerRvous),"comm:idbuf");
+
+  // one datum for each owned atom: my proc ID, atom ID
+  // callback stores owning procs in data.owners, nothing is sent back
+
+  for (i = 0; i < nlocal; i++) {
+    proclist[i] = tag[i] % nprocs;
+    idbuf[i].proc = me;
+    idbuf[i].atomID = tag[i];
+  }
+
+  char *buf;
+  rendezvous(nlocal,(char *) idbuf,sizeof(OwnerRvous),proclist,
+             rendezvous_owners,buf,0,(void *) &data);
+
+  memory->sfree(idbuf);
+
+  // send each datum to rendezvous proc of its atom ID
+  // callback returns it to owning proc of the atom
+
+  tagint atomID;
+  for (i = 0; i < n; i++) {
+    memcpy(&atomID,&inbuf[(bigint) i*nbytes],sizeof(tagint));
+    proclist[i] = atomID % nprocs;
+  }
+
+  int nout = rendezvous(n,inbuf,nbytes,proclist,rendezvous_route,
+                        outbuf,nbytes,(void *) &data);
+
+  memory->destroy(proclist);
+  return nout;
+}
+
+/* ----------------------------------------------------------------------
+   rendezvous lookup in a distributed table of key/value pairs
+   keys are atom or molecule IDs > 0, rendezvous proc = key % nprocs
+   inputs:
+     nkey,keys,values = key/value pairs this proc adds to the table
+       a key added by several procs should have the same value
+     nquery,queries = keys this proc looks up, need not be unique
+   outputs:
+     return = # of queried keys found in table
+     result = found keys and their values, 2 tagints per key,
+       allocated here, caller must free it via memory->destroy()
+------------------------------------------------------------------------- */
+
+int Comm::rendezvous_lookup(int nkey, tagint *keys, tagint *values,
+                            int nquery, tagint *queries, tagint *&result)
+{
+  int i,m;
+
+  int n = nkey + nquery;
+
+  int *proclist;
+  memory->create(proclist,n,"comm:proclist");
+  LookupRvous *inbuf = (LookupRvous *)
+    memory->smalloc((bigint) n*sizeof(LookupRvous),"comm:inbuf");
+
+  // flag = 1 for table entry, 0 for query
+
+  m = 0;
+  for (i = 0; i < nkey; i++) {
+    proclist[m] = keys[i] % nprocs;
+    inbuf[m].proc = me;
+    inbuf[m].flag = 1;
+    inbuf[m].key = keys[i];
+    inbuf[m].value = values[i];
+    m++;
+  }
+
+  for (i = 0; i < nquery; i++) {
+    proclist[m] = queries[i] % nprocs;
+    inbuf[m].proc = me;
+    inbuf[m].flag = 0;
+    inbuf[m].key = queries[i];
+    inbuf[m].value = 0;
+    m++;
+  }
+
+  char *buf;
+  int nout = rendezvous(n,(char *) inbuf,sizeof(LookupRvous),proclist,
+                        rendezvous_match,buf,sizeof(LookupRvous),
+                        (void *) this);
+  LookupRvous *outbuf = (LookupRvous *) buf;
+
+  memory->destroy(proclist);
+  memory->sfree(inbuf);
+
+  memory->create(result,2*nout,"comm:result");
+  for (i = 0; i < nout; i++) {
+    result[2*i] = outbuf[i].key;
+    result[2*i+1] = outbuf[i].value;
+  }
+
+  memory->sfree(outbuf);
+  return nout;
+}
+
+/* ----------------------------------------------------------------------
+   callback from rendezvous() in rendezvous_atoms()
+   store owning proc of each atom ID I receive
+   no datums are returned
+------------------------------------------------------------------------- */
+
+int Comm::rendezvous_owners(int n, char *inbuf,
+                            int &flag, int *&proclist, char *&outbuf,
+                            void *ptr)
+{
+  RouteData *data = (RouteData *) ptr;
+  OwnerRvous *in = (OwnerRvous *) inbuf;
+
+  for (int i = 0; i < n; i++)
+    data->owners[in[i].atomID] = in[i].proc;
+
+  flag = 0;
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   callback from rendezvous() in rendezvous_atoms()
+   look up owning proc of atom ID at start of each datum
+   send the datum to that proc, unchanged
+------------------------------------------------------------------------- */
+
+int Comm::rendezvous_route(int n, char *inbuf,
+                           int &flag, int *&proclist, char *&outbuf,
+                           void *ptr)
+{
+  RouteData *data = (RouteData *) ptr;
+  Comm *cptr = data->comm;
+  int nbytes = data->nbytes;
+  std::map<tagint,int>::iterator loc;
+
+  cptr->memory->create(proclist,n,"comm:proclist");
+
+  tagint atomID;
+  for (int i = 0; i < n; i++) {
+    memcpy(&atomID,&inbuf[(bigint) i*nbytes],sizeof(tagint));
+    loc = data->owners.find(atomID);
+    if (loc == data->owners.end())
+      cptr->error->one(FLERR,"Rendezvous atom ID does not exist");
+    proclist[i] = loc->second;
+  }
+
+  outbuf = inbuf;
+  flag = 1;
+  return n;
+}
+
+/* ----------------------------------------------------------------------
+   callback from rendezvous() in rendezvous_lookup()
+   build table from received key/value pairs
+   return each query whose key is in the table, with its value,
+     to the proc that asked for it
+------------------------------------------------------------------------- */
+
+int Comm::rendezvous_match(int n, char *inbuf,
+                           int &flag, int *&proclist, char *&outbuf,
+                           void *ptr)
+{
+  Comm *cptr = (Comm *) ptr;
+  LookupRvous *in = (LookupRvous *) inbuf;
+
+  std::map<tagint,tagint> table;
+  std::map<tagint,tagint>::iterator loc;
+
+  for (int i = 0; i < n; i++)
+    if (in[i].flag) table[in[i].key] = in[i].value;
+
+  // compress found queries to front of inbuf
+
+  cptr->memory->create(proclist,n,"comm:proclist");
+
+  int nout = 0;
+  for (int i = 0; i < n; i++) {
+    if (in[i].flag) continue;
+    loc = table.find(in[i].key);
+    if (loc == table.end()) continue;
+    in[nout] = in[i];
+    in[nout].value = loc->second;
+    proclist[nout] = in[nout].proc;
+    nout++;
+  }
+
+  outbuf = inbuf;
+  flag = 1;
+  return nout;
+}
+
 /* ----------------------------------------------------------------------
    proc 0 reads Nlines from file into buf and bcasts buf to all procs
    caller allocates buf to max size needed
@@ -21,6 +21,7 @@ namespace LAMMPS_NS {
 class Comm : protected Pointers {
  public:
   int style;     // comm pattern: 0 = 6-way stencil, 1 = irregular tiling
+                 // 2 = direct to all procs within cutoff of brick
   int layout;    // LAYOUT_UNIFORM = equal-sized bricks
                  // LAYOUT_NONUNIFORM = logical bricks, but diff sizes via LB
                  // LAYOUT_TILED = general tiling, due to RCB LB
@@ -28,6 +29,10 @@ class Comm : protected Pointers {
 
   int me,nprocs;                    // proc info
   int ghost_velocity;               // 1 if ghost atoms have velocity, 0 if not
+  int overlap;                      // 1 if comm may overlap pair computation
+  int persist;                      // 1 if reuse MPI requests between borders
+  int shm;                          // 1 if exchange ghosts on node via shm
+  int xfloat;                       // 1 if forward coords as float offsets
   double cutghost[3];               // cutoffs used for acquiring ghost atoms
   double cutghostuser;              // user-specified ghost cutoff (mode == 0)
   double *cutusermulti;            // per type user ghost cutoff (mode == 1)
@@ -74,6 +79,15 @@ class Comm : protected Pointers {
   virtual void exchange() = 0;                   // move atoms to new procs
   virtual void borders() = 0;                    // setup list of atoms to comm
 
+  // forward/reverse comm split in two, so that pair computation of
+  // atoms without ghost neighbors can proceed while messages are in flight
+  // default is blocking comm in the start call
+
+  virtual void forward_comm_start() { forward_comm(); }
+  virtual void forward_comm_finish() {}
+  virtual void reverse_comm_start() { reverse_comm(); }
+  virtual void reverse_comm_finish() {}
+
   // forward/reverse comm from a Pair, Fix, Compute, Dump
 
   virtual void forward_comm_pair(class Pair *) = 0;
@@ -107,6 +121,11 @@ class Comm : protected Pointers {
 
   void ring(int, int, void *, int, void (*)(int, char *),
             void *, int self = 1);
+  int rendezvous(int, char *, int, int *,
+                 int (*)(int, char *, int &, int *&, char *&, void *),
+                 char *&, int, void *);
+  int rendezvous_atoms(int, char *, int, char *&);
+  int rendezvous_lookup(int, tagint *, tagint *, int, tagint *, tagint *&);
   int read_lines_from_file(FILE *, int, int, char *);
   int read_lines_from_file_universe(FILE *, int, int, char *);
 
@@ -137,6 +156,13 @@ class Comm : protected Pointers {
   int ncores;                       // # of cores per node
   int coregrid[3];                  // 3d grid of cores within a node
   int user_coregrid[3];             // user request for cores in each dim
+
+ private:
+  // callbacks for rendezvous operations keyed by atom or molecule ID
+
+  static int rendezvous_owners(int, char *, int &, int *&, char *&, void *);
+  static int rendezvous_route(int, char *, int &, int *&, char *&, void *);
+  static int rendezvous_match(int, char *, int &, int *&, char *&, void *);
 };
 
 }
@@ -220,4 +246,10 @@ E: Processor count in z must be 1 for 2d simulation
 
 Self-explanatory.
 
+E: Rendezvous atom ID does not exist
+
+A datum sent to the owner of an atom refers to an atom ID that no
+processor owns.  This likely means something is wrong with the
+topology or partner information of that atom.
+
 */
@@ -75,6 +75,8 @@ CommBrick::~CommBrick()
 
   memory->destroy(buf_send);
   memory->destroy(buf_recv);
+  memory->destroy(buf_overlap);
+  free_persist();
 }
 
 /* ---------------------------------------------------------------------- */
@@ -117,6 +119,13 @@ void CommBrick::init_buffers()
   maxrecv = BUFMIN;
   memory->create(buf_recv,maxrecv,"comm:buf_recv");
 
+  nswap_overlap = nrequest_overlap = 0;
+  buf_overlap = NULL;
+  maxoverlap = 0;
+
+  persist_valid = npersist = 0;
+  request_persist = NULL;
+
   maxswap = 6;
   allocate_swap(maxswap);
 
@@ -453,6 +462,15 @@ int CommBrick::updown(int dim, int dir, int loc,
 ------------------------------------------------------------------------- */
 
 void CommBrick::forward_comm(int dummy)
+{
+  forward_swaps(0);
+}
+
+/* ----------------------------------------------------------------------
+   forward communication of atom coords in swaps first to nswap-1
+------------------------------------------------------------------------- */
+
+void CommBrick::forward_swaps(int first)
 {
   int n;
   MPI_Request request;
@@ -460,13 +478,49 @@ void CommBrick::forward_comm(int dummy)
   double **x = atom->x;
   double *buf;
 
+  // requests are bound to x, f and buffers, renew them if reallocated
+
+  int usefloat = xfloat && comm_x_only;
+  int usepersist = persist && comm_x_only && !usefloat;
+  if (usepersist && persist_stale()) setup_persist();
+
+  // float offsets are relative to the corner of my sub-domain
+
+  double origin[3];
+  if (usefloat) {
+    if (triclinic == 0) {
+      origin[0] = domain->sublo[0];
+      origin[1] = domain->sublo[1];
+      origin[2] = domain->sublo[2];
+    } else domain->lamda2x(domain->sublo_lamda,origin);
+  }
+
   // exchange data with another proc
   // if other proc is self, just copy
   // if comm_x_only set, exchange or copy directly to x, don't unpack
+  // if usefloat set, exchange float offsets, copies to self stay exact
 
-  for (int iswap = 0; iswap < nswap; iswap++) {
+  for (int iswap = first; iswap < nswap; iswap++) {
     if (sendproc[iswap] != me) {
-      if (comm_x_only) {
+      if (usefloat) {
+        if (size_forward_recv[iswap])
+          MPI_Irecv(buf_recv,3+(3*recvnum[iswap]+1)/2,MPI_DOUBLE,
+                    recvproc[iswap],0,world,&request);
+        n = pack_comm_float(sendnum[iswap],sendlist[iswap],
+                            buf_send,pbc_flag[iswap],pbc[iswap],origin);
+        if (n) MPI_Send(buf_send,n,MPI_DOUBLE,sendproc[iswap],0,world);
+        if (size_forward_recv[iswap]) {
+          MPI_Wait(&request,MPI_STATUS_IGNORE);
+          unpack_comm_float(recvnum[iswap],firstrecv[iswap],buf_recv);
+        }
+      } else if (usepersist) {
+        MPI_Request *req = &request_persist[4*iswap];
+        if (size_forward_recv[iswap]) MPI_Start(&req[1]);
+        n = avec->pack_comm(sendnum[iswap],sendlist[iswap],
+                            buf_send,pbc_flag[iswap],pbc[iswap]);
+        if (n) MPI_Start(&req[0]);
+        MPI_Waitall(2,req,MPI_STATUSES_IGNORE);
+      } else if (comm_x_only) {
         if (size_forward_recv[iswap]) {
           if (size_forward_recv[iswap]) buf = x[firstrecv[iswap]];
           else buf = NULL;
@@ -521,6 +575,15 @@ void CommBrick::forward_comm(int dummy)
 ------------------------------------------------------------------------- */
 
 void CommBrick::reverse_comm()
+{
+  reverse_swaps(0);
+}
+
+/* ----------------------------------------------------------------------
+   reverse communication of forces in swaps nswap-1 down to last
+------------------------------------------------------------------------- */
+
+void CommBrick::reverse_swaps(int last)
 {
   int n;
   MPI_Request request;
@@ -528,13 +591,21 @@ void CommBrick::reverse_comm()
   double **f = atom->f;
   double *buf;
 
+  int usepersist = persist && comm_f_only;
+  if (usepersist && persist_stale()) setup_persist();
+
   // exchange data with another proc
   // if other proc is self, just copy
   // if comm_f_only set, exchange or copy directly from f, don't pack
 
-  for (int iswap = nswap-1; iswap >= 0; iswap--) {
+  for (int iswap = nswap-1; iswap >= last; iswap--) {
     if (sendproc[iswap] != me) {
-      if (comm_f_only) {
+      if (usepersist) {
+        MPI_Request *req = &request_persist[4*iswap];
+        if (size_reverse_recv[iswap]) MPI_Start(&req[3]);
+        if (size_reverse_send[iswap]) MPI_Start(&req[2]);
+        MPI_Waitall(2,&req[2],MPI_STATUSES_IGNORE);
+      } else if (comm_f_only) {
         if (size_reverse_recv[iswap])
           MPI_Irecv(buf_recv,size_reverse_recv[iswap],MPI_DOUBLE,
                     sendproc[iswap],0,world,&request);
@@ -568,6 +639,271 @@ void CommBrick::reverse_comm()
   }
 }
 
+/* ----------------------------------------------------------------------
+   start forward comm of atom coords, to overlap with pair computation
+   1st 2 swaps (in x) only send owned atoms, so they are posted at once
+     with recvs directly into x, tagged by swap to keep them apart
+   later swaps send ghosts from earlier ones and are done by finish
+   without comm_x_only or with xfloat, this is a regular forward comm
+------------------------------------------------------------------------- */
+
+void CommBrick::forward_comm_start()
+{
+  int iswap,n;
+  AtomVec *avec = atom->avec;
+  double **x = atom->x;
+
+  nrequest_overlap = 0;
+  if (!comm_x_only || ghost_velocity || xfloat) {
+    forward_swaps(0);
+    nswap_overlap = nswap;
+    return;
+  }
+
+  nswap_overlap = MIN(2,nswap);
+
+  n = 0;
+  for (iswap = 0; iswap < nswap_overlap; iswap++)
+    if (sendproc[iswap] != me) n += size_forward*sendnum[iswap];
+  if (n > maxoverlap) grow_overlap(n);
+
+  double *buf = buf_overlap;
+  for (iswap = 0; iswap < nswap_overlap; iswap++) {
+    if (sendproc[iswap] != me) {
+      if (size_forward_recv[iswap])
+        MPI_Irecv(x[firstrecv[iswap]],size_forward_recv[iswap],MPI_DOUBLE,
+                  recvproc[iswap],iswap,world,
+                  &request_overlap[nrequest_overlap++]);
+      n = avec->pack_comm(sendnum[iswap],sendlist[iswap],
+                          buf,pbc_flag[iswap],pbc[iswap]);
+      if (n) MPI_Isend(buf,n,MPI_DOUBLE,sendproc[iswap],iswap,world,
+                       &request_overlap[nrequest_overlap++]);
+      buf += n;
+    } else if (sendnum[iswap])
+      avec->pack_comm(sendnum[iswap],sendlist[iswap],
+                      x[firstrecv[iswap]],pbc_flag[iswap],pbc[iswap]);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   wait for swaps posted by forward_comm_start(), then do the others
+------------------------------------------------------------------------- */
+
+void CommBrick::forward_comm_finish()
+{
+  if (nrequest_overlap)
+    MPI_Waitall(nrequest_overlap,request_overlap,MPI_STATUSES_IGNORE);
+  nrequest_overlap = 0;
+  forward_swaps(nswap_overlap);
+}
+
+/* ----------------------------------------------------------------------
+   start reverse comm of forces, to overlap with pair computation
+   all swaps but the 1st 2 are done here, as in reverse_comm()
+   1st 2 swaps only return forces to owned atoms, so they are posted
+     at once, sending directly from f, and unpacked by finish
+   caller must not change forces on ghost atoms until finish
+   without comm_f_only, this is a regular reverse comm
+------------------------------------------------------------------------- */
+
+void CommBrick::reverse_comm_start()
+{
+  int iswap,n;
+  double **f = atom->f;
+
+  nrequest_overlap = 0;
+  if (!comm_f_only) {
+    reverse_swaps(0);
+    nswap_overlap = 0;
+    return;
+  }
+
+  nswap_overlap = MIN(2,nswap);
+  reverse_swaps(nswap_overlap);
+
+  n = 0;
+  for (iswap = 0; iswap < nswap_overlap; iswap++)
+    if (sendproc[iswap] != me) n += size_reverse_recv[iswap];
+  if (n > maxoverlap) grow_overlap(n);
+
+  double *buf = buf_overlap;
+  for (iswap = nswap_overlap-1; iswap >= 0; iswap--) {
+    if (sendproc[iswap] == me) continue;
+    if (size_reverse_recv[iswap])
+      MPI_Irecv(buf,size_reverse_recv[iswap],MPI_DOUBLE,
+                sendproc[iswap],iswap,world,
+                &request_overlap[nrequest_overlap++]);
+    if (size_reverse_send[iswap])
+      MPI_Isend(f[firstrecv[iswap]],size_reverse_send[iswap],MPI_DOUBLE,
+                recvproc[iswap],iswap,world,
+                &request_overlap[nrequest_overlap++]);
+    buf += size_reverse_recv[iswap];
+  }
+}
+
+/* ----------------------------------------------------------------------
+   wait for swaps posted by reverse_comm_start() and sum their forces
+------------------------------------------------------------------------- */
+
+void CommBrick::reverse_comm_finish()
+{
+  AtomVec *avec = atom->avec;
+  double **f = atom->f;
+
+  if (nrequest_overlap)
+    MPI_Waitall(nrequest_overlap,request_overlap,MPI_STATUSES_IGNORE);
+  nrequest_overlap = 0;
+
+  double *buf = buf_overlap;
+  for (int iswap = nswap_overlap-1; iswap >= 0; iswap--) {
+    if (sendproc[iswap] != me) {
+      avec->unpack_reverse(sendnum[iswap],sendlist[iswap],buf);
+      buf += size_reverse_recv[iswap];
+    } else if (sendnum[iswap])
+      avec->unpack_reverse(sendnum[iswap],sendlist[iswap],
+                           f[firstrecv[iswap]]);
+  }
+  nswap_overlap = 0;
+}
+
+/* ----------------------------------------------------------------------
+   create persistent requests for forward and reverse comm of all swaps
+   forward recvs directly into x, sends from buf_send
+   reverse sends directly from f, recvs into buf_recv
+   counts and buffers only change in borders() or when arrays are grown,
+     so the requests are reused until then
+   MPI_REQUEST_NULL for nothing to send or recv, and for swaps with self
+------------------------------------------------------------------------- */
+
+void CommBrick::setup_persist()
+{
+  int n;
+  double **x = atom->x;
+  double **f = atom->f;
+
+  free_persist();
+  npersist = nswap;
+  request_persist = new MPI_Request[4*npersist];
+
+  for (int iswap = 0; iswap < nswap; iswap++) {
+    MPI_Request *req = &request_persist[4*iswap];
+    req[0] = req[1] = req[2] = req[3] = MPI_REQUEST_NULL;
+    if (sendproc[iswap] == me) continue;
+
+    n = size_forward*sendnum[iswap];
+    if (n) MPI_Send_init(buf_send,n,MPI_DOUBLE,sendproc[iswap],0,world,
+                         &req[0]);
+    if (size_forward_recv[iswap])
+      MPI_Recv_init(x[firstrecv[iswap]],size_forward_recv[iswap],MPI_DOUBLE,
+                    recvproc[iswap],0,world,&req[1]);
+    if (size_reverse_send[iswap])
+      MPI_Send_init(f[firstrecv[iswap]],size_reverse_send[iswap],MPI_DOUBLE,
+                    recvproc[iswap],0,world,&req[2]);
+    if (size_reverse_recv[iswap])
+      MPI_Recv_init(buf_recv,size_reverse_recv[iswap],MPI_DOUBLE,
+                    sendproc[iswap],0,world,&req[3]);
+  }
+
+  persist_x = x;
+  persist_x0 = x ? x[0] : NULL;
+  persist_f = f;
+  persist_f0 = f ? f[0] : NULL;
+  persist_send = buf_send;
+  persist_recv = buf_recv;
+  persist_valid = 1;
+}
+
+/* ----------------------------------------------------------------------
+   return 1 if persistent requests do not match current swaps or arrays
+------------------------------------------------------------------------- */
+
+int CommBrick::persist_stale()
+{
+  double **x = atom->x;
+  double **f = atom->f;
+
+  if (!persist_valid) return 1;
+  if (x != persist_x || f != persist_f) return 1;
+  if (x && x[0] != persist_x0) return 1;
+  if (f && f[0] != persist_f0) return 1;
+  if (buf_send != persist_send || buf_recv != persist_recv) return 1;
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   free persistent requests, they are all inactive
+------------------------------------------------------------------------- */
+
+void CommBrick::free_persist()
+{
+  for (int i = 0; i < 4*npersist; i++)
+    if (request_persist[i] != MPI_REQUEST_NULL)
+      MPI_Request_free(&request_persist[i]);
+  delete [] request_persist;
+  request_persist = NULL;
+  npersist = 0;
+  persist_valid = 0;
+}
+
+/* ----------------------------------------------------------------------
+   pack coords of atoms in list as float offsets from origin
+   buf = origin with PBC shift as 3 doubles, then 3 floats per atom
+   the shift stays exact, only offsets within a sub-domain are rounded
+   return # of doubles in buf, always fits since buffers are >= BUFMIN
+------------------------------------------------------------------------- */
+
+int CommBrick::pack_comm_float(int n, int *list, double *buf,
+                               int pbc_flag, int *pbc, double *origin)
+{
+  int i,j,m;
+  double dx,dy,dz;
+  double **x = atom->x;
+
+  if (pbc_flag == 0) dx = dy = dz = 0.0;
+  else if (triclinic == 0) {
+    dx = pbc[0]*domain->xprd;
+    dy = pbc[1]*domain->yprd;
+    dz = pbc[2]*domain->zprd;
+  } else {
+    dx = pbc[0]*domain->xprd + pbc[5]*domain->xy + pbc[4]*domain->xz;
+    dy = pbc[1]*domain->yprd + pbc[3]*domain->yz;
+    dz = pbc[2]*domain->zprd;
+  }
+
+  buf[0] = origin[0] + dx;
+  buf[1] = origin[1] + dy;
+  buf[2] = origin[2] + dz;
+
+  float *fbuf = (float *) &buf[3];
+  m = 0;
+  for (i = 0; i < n; i++) {
+    j = list[i];
+    fbuf[m++] = static_cast<float> (x[j][0] - origin[0]);
+    fbuf[m++] = static_cast<float> (x[j][1] - origin[1]);
+    fbuf[m++] = static_cast<float> (x[j][2] - origin[2]);
+  }
+  return 3 + (m+1)/2;
+}
+
+/* ----------------------------------------------------------------------
+   unpack coords packed by pack_comm_float() into x, starting at first
+------------------------------------------------------------------------- */
+
+void CommBrick::unpack_comm_float(int n, int first, double *buf)
+{
+  int i,m,last;
+  double **x = atom->x;
+
+  float *fbuf = (float *) &buf[3];
+  m = 0;
+  last = first + n;
+  for (i = first; i < last; i++) {
+    x[i][0] = buf[0] + fbuf[m++];
+    x[i][1] = buf[1] + fbuf[m++];
+    x[i][2] = buf[2] + fbuf[m++];
+  }
+}
+
 /* ----------------------------------------------------------------------
    exchange: move atoms to correct processors
    atoms exchanged with all 6 stencil neighbors
@@ -868,6 +1204,10 @@ void CommBrick::borders()
   max = MAX(maxforward*rmax,maxreverse*smax);
   if (max > maxrecv) grow_recv(max);
 
+  // swap counts changed, persistent requests are renewed on next use
+
+  persist_valid = 0;
+
   // reset global->local map
 
   if (map_style) atom->map_set();
@@ -1372,6 +1712,17 @@ void CommBrick::grow_recv(int n)
   memory->create(buf_recv,maxrecv,"comm:buf_recv");
 }
 
+/* ----------------------------------------------------------------------
+   free/malloc the size of the overlap buffer as needed with BUFFACTOR
+------------------------------------------------------------------------- */
+
+void CommBrick::grow_overlap(int n)
+{
+  maxoverlap = static_cast<int> (BUFFACTOR * n);
+  memory->destroy(buf_overlap);
+  memory->create(buf_overlap,maxoverlap,"comm:buf_overlap");
+}
+
 /* ----------------------------------------------------------------------
    realloc the size of the iswap sendlist as needed with BUFFACTOR
 ------------------------------------------------------------------------- */
@@ -1478,5 +1829,6 @@ bigint CommBrick::memory_usage()
     bytes += memory->usage(sendlist[i],maxsendlist[i]);
   bytes += memory->usage(buf_send,maxsend+bufextra);
   bytes += memory->usage(buf_recv,maxrecv);
+  if (maxoverlap) bytes += memory->usage(buf_overlap,maxoverlap);
   return bytes;
 }
@@ -30,6 +30,10 @@ class CommBrick : public Comm {
   virtual void reverse_comm();                 // reverse comm of forces
   virtual void exchange();                     // move atoms to new procs
   virtual void borders();                      // setup list of atoms to comm
+  virtual void forward_comm_start();           // post 1st swaps of forward
+  virtual void forward_comm_finish();          // wait, do remaining swaps
+  virtual void reverse_comm_start();           // do swaps, post last ones
+  virtual void reverse_comm_finish();          // wait and unpack last swaps
 
   virtual void forward_comm_pair(class Pair *);    // forward comm from a Pair
   virtual void reverse_comm_pair(class Pair *);    // reverse comm from a Pair
@@ -75,11 +79,33 @@ class CommBrick : public Comm {
   int bufextra;                     // extra space beyond maxsend in send buffer
   int smax,rmax;             // max size in atoms of single borders send/recv
 
+  int nswap_overlap;                // # of swaps in flight during overlap
+  int nrequest_overlap;             // # of posted sends/recvs of these swaps
+  MPI_Request request_overlap[4];   // their requests
+  double *buf_overlap;              // send or recv buffer of these swaps
+  int maxoverlap;                   // size of buf_overlap
+
+  int persist_valid;                // 1 if persistent requests match swaps
+  int npersist;                     // # of swaps requests were made for
+  MPI_Request *request_persist;     // 4 per swap: fwd send/recv, rev send/recv
+  double **persist_x,**persist_f;   // arrays and buffers the requests use
+  double *persist_x0,*persist_f0;
+  double *persist_send,*persist_recv;
+
   // NOTE: init_buffers is called from a constructor and must not be made virtual
   void init_buffers();
 
   int updown(int, int, int, double, int, double *);
                                             // compare cutoff to procs
+  void forward_swaps(int);                  // forward comm from a swap on
+  void reverse_swaps(int);                  // reverse comm down to a swap
+  void grow_overlap(int);                   // reallocate overlap buffer
+  void setup_persist();                     // create persistent requests
+  void free_persist();                      // free persistent requests
+  int persist_stale();                      // 1 if requests must be renewed
+  int pack_comm_float(int, int *, double *, int, int *, double *);
+                                            // pack coords as float offsets
+  void unpack_comm_float(int, int, double *);  // unpack them to x
   virtual void grow_send(int, int);         // reallocate send buffer
   virtual void grow_recv(int);              // free/allocate recv buffer
   virtual void grow_list(int, int);         // reallocate one sendlist
@@ -0,0 +1,1098 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include <mpi.h>
+#include <string.h>
+#if !defined(_WIN32)
+#include <sched.h>
+#endif
+#include "comm_brick_direct.h"
+#include "atom.h"
+#include "atom_vec.h"
+#include "domain.h"
+#include "pair.h"
+#include "fix.h"
+#include "compute.h"
+#include "memory.h"
+#include "error.h"
+
+using namespace LAMMPS_NS;
+
+#define BIG 1.0e20
+
+enum{SINGLE,MULTI};               // same as in Comm
+enum{FORWARD,REVERSE};            // direction of a shm slot
+
+// header of shm buffer, SHMHEADER ints per swap:
+//   ready and done seq # of forward slot, same for reverse slot,
+//   offset in doubles of forward and reverse slot in buffer
+
+#define SHMHEADER 6
+#define BUFFACTOR 1.5
+
+/* ---------------------------------------------------------------------- */
+
+CommBrickDirect::CommBrickDirect(LAMMPS *lmp) : CommBrick(lmp)
+{
+  style = 2;
+  allocate_direct(maxswap);
+  maxband = 0;
+  bandlo = bandhi = NULL;
+
+  nodecomm = MPI_COMM_NULL;
+  nodeme = 0;
+  nodesize = 1;
+  shmactive = 0;
+  shmbase = NULL;
+  maxshm = maxshmswap = 0;
+  shmlast = NULL;
+  shmseq = 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+CommBrickDirect::CommBrickDirect(LAMMPS *lmp, Comm *oldcomm) :
+  CommBrick(lmp,oldcomm)
+{
+  style = 2;
+  allocate_direct(maxswap);
+  maxband = 0;
+  bandlo = bandhi = NULL;
+
+  nodecomm = MPI_COMM_NULL;
+  nodeme = 0;
+  nodesize = 1;
+  shmactive = 0;
+  shmbase = NULL;
+  maxshm = maxshmswap = 0;
+  shmlast = NULL;
+  shmseq = 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+CommBrickDirect::~CommBrickDirect()
+{
+  free_direct();
+  free_shm();
+  memory->destroy(bandlo);
+  memory->destroy(bandhi);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void CommBrickDirect::init()
+{
+  CommBrick::init();
+
+  if (mode == MULTI)
+    error->all(FLERR,"Cannot yet use comm_style brick/direct "
+               "with multi-mode comm");
+}
+
+/* ----------------------------------------------------------------------
+   setup direct communication with all procs within the ghost cutoff
+   cutghost and maxneed[] are set by the brick setup, as for 6-way swaps
+   one swap for each offset in the stencil of
+     (2*maxneed[0]+1) x (2*maxneed[1]+1) x (2*maxneed[2]+1) procs,
+     except myself, so 26 swaps if cutghost < sub-domain size in 3d
+   swap for offset O sends owned atoms to the proc at myloc+O
+     and recvs ghost atoms from the proc at myloc-O
+   sendproc/recvproc = MPI_PROC_NULL across non-PBC boundaries
+   a proc can be the partner of several swaps, via different PBC images,
+     messages are tagged by swap to keep them apart
+   bandlo/bandhi = bounds of receiver sub-domains K procs away in each dim,
+     extended by cutghost, in my frame of PBC images
+     use +/- BIG for receivers across non-PBC boundaries
+   for triclinic, bounds and pbc are in lamda (0-1) coords
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::setup()
+{
+  int i,k,dim,loc,ix,iy,iz;
+  int image[3];
+  double *prd,*boxlo;
+
+  CommBrick::setup();
+
+  if (triclinic == 0) {
+    prd = domain->prd;
+    boxlo = domain->boxlo;
+  } else {
+    prd = domain->prd_lamda;
+    boxlo = domain->boxlo_lamda;
+  }
+
+  int *periodicity = domain->periodicity;
+  double *split[3];
+  split[0] = xsplit;
+  split[1] = ysplit;
+  split[2] = zsplit;
+
+  // bands of atoms sent to procs up to maxneed away in each dim
+  // bandlo[dim][K] increases with K, bandhi[dim][K] decreases
+
+  int maxneedall = MAX(maxneed[0],MAX(maxneed[1],maxneed[2]));
+  if (maxneedall > maxband) {
+    maxband = maxneedall;
+    memory->destroy(bandlo);
+    memory->destroy(bandhi);
+    memory->create(bandlo,3,maxband+1,"comm:bandlo");
+    memory->create(bandhi,3,maxband+1,"comm:bandhi");
+  }
+
+  for (dim = 0; dim < 3; dim++)
+    for (k = 1; k <= maxneed[dim]; k++) {
+      loc = myloc[dim] + k;
+      i = loc / procgrid[dim];
+      if (i && !periodicity[dim]) bandlo[dim][k] = BIG;
+      else bandlo[dim][k] = boxlo[dim] +
+             prd[dim]*(split[dim][loc-i*procgrid[dim]] + i) - cutghost[dim];
+
+      loc = myloc[dim] - k;
+      i = (loc - procgrid[dim] + 1) / procgrid[dim];
+      if (i && !periodicity[dim]) bandhi[dim][k] = -BIG;
+      else bandhi[dim][k] = boxlo[dim] +
+             prd[dim]*(split[dim][loc-i*procgrid[dim]+1] + i) + cutghost[dim];
+    }
+
+  // allocate comm memory
+
+  nswap = (2*maxneed[0]+1) * (2*maxneed[1]+1) * (2*maxneed[2]+1) - 1;
+  if (nswap > maxswap) grow_swap(nswap);
+
+  // setup parameters for each swap, in same order as swap_index()
+  // pbc = -1/0/1 for PBC factor in each of 3/6 orthogonal/triclinic dirs
+  //   = minus the image of the receiver relative to me
+
+  int iswap = 0;
+  for (iz = -maxneed[2]; iz <= maxneed[2]; iz++)
+    for (iy = -maxneed[1]; iy <= maxneed[1]; iy++)
+      for (ix = -maxneed[0]; ix <= maxneed[0]; ix++) {
+        if (ix == 0 && iy == 0 && iz == 0) continue;
+
+        recvproc[iswap] = proc_at(-ix,-iy,-iz,image);
+        sendproc[iswap] = proc_at(ix,iy,iz,image);
+
+        pbc_flag[iswap] = 0;
+        for (dim = 0; dim < 3; dim++) {
+          pbc[iswap][dim] = -image[dim];
+          if (image[dim]) pbc_flag[iswap] = 1;
+        }
+        pbc[iswap][3] = pbc[iswap][4] = pbc[iswap][5] = 0;
+        if (triclinic) {
+          pbc[iswap][5] = pbc[iswap][1];
+          pbc[iswap][4] = pbc[iswap][3] = pbc[iswap][2];
+        }
+        iswap++;
+      }
+
+  setup_shm();
+}
+
+/* ----------------------------------------------------------------------
+   find swaps whose send or recv proc is another proc on my node
+   their atoms are exchanged via shm buffers, not messages
+   nodecomm is created the first time shm is used
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::setup_shm()
+{
+  int iswap,rank;
+
+  for (iswap = 0; iswap < nswap; iswap++) shmsend[iswap] = shmrecv[iswap] = -1;
+  if (!shm) return;
+
+  if (nodecomm == MPI_COMM_NULL) {
+    MPI_Comm_split_type(world,MPI_COMM_TYPE_SHARED,me,MPI_INFO_NULL,&nodecomm);
+    MPI_Comm_rank(nodecomm,&nodeme);
+    MPI_Comm_size(nodecomm,&nodesize);
+    shmbase = new char*[nodesize];
+  }
+  if (nodesize == 1) return;
+
+  MPI_Group worldgroup,nodegroup;
+  MPI_Comm_group(world,&worldgroup);
+  MPI_Comm_group(nodecomm,&nodegroup);
+
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (sendproc[iswap] != me && sendproc[iswap] != MPI_PROC_NULL) {
+      MPI_Group_translate_ranks(worldgroup,1,&sendproc[iswap],nodegroup,&rank);
+      if (rank != MPI_UNDEFINED) shmsend[iswap] = rank;
+    }
+    if (recvproc[iswap] != me && recvproc[iswap] != MPI_PROC_NULL) {
+      MPI_Group_translate_ranks(worldgroup,1,&recvproc[iswap],nodegroup,&rank);
+      if (rank != MPI_UNDEFINED) shmrecv[iswap] = rank;
+    }
+  }
+
+  MPI_Group_free(&worldgroup);
+  MPI_Group_free(&nodegroup);
+}
+
+/* ----------------------------------------------------------------------
+   return proc at offset ix,iy,iz from me in proc grid
+   image = which periodic image of the box that proc is in, relative to me
+   return MPI_PROC_NULL if offset crosses a non-PBC boundary
+------------------------------------------------------------------------- */
+
+int CommBrickDirect::proc_at(int ix, int iy, int iz, int *image)
+{
+  int dim,loc[3];
+  int offset[3] = {ix,iy,iz};
+  int *periodicity = domain->periodicity;
+
+  for (dim = 0; dim < 3; dim++) {
+    loc[dim] = myloc[dim] + offset[dim];
+    image[dim] = 0;
+    while (loc[dim] < 0) {
+      loc[dim] += procgrid[dim];
+      image[dim]--;
+    }
+    while (loc[dim] >= procgrid[dim]) {
+      loc[dim] -= procgrid[dim];
+      image[dim]++;
+    }
+    if (image[dim] && !periodicity[dim]) return MPI_PROC_NULL;
+  }
+
+  return grid2proc[loc[0]][loc[1]][loc[2]];
+}
+
+/* ----------------------------------------------------------------------
+   return swap for offset ix,iy,iz in stencil, stencil center is skipped
+------------------------------------------------------------------------- */
+
+int CommBrickDirect::swap_index(int ix, int iy, int iz)
+{
+  int n = ((iz+maxneed[2])*(2*maxneed[1]+1) + iy+maxneed[1]) *
+    (2*maxneed[0]+1) + ix+maxneed[0];
+  if (n > nswap/2) n--;
+  return n;
+}
+
+/* ----------------------------------------------------------------------
+   forward communication of atom coords every timestep
+   other per-atom attributes may also be sent via pack/unpack routines
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::forward_comm(int dummy)
+{
+  forward_comm_start();
+  forward_comm_finish();
+}
+
+/* ----------------------------------------------------------------------
+   post recvs and sends of all swaps at once
+   all swaps only send owned atoms, so they do not depend on each other
+   if comm_x_only set, recv or copy directly to x, don't unpack
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::forward_comm_start()
+{
+  int iswap,n;
+  double *buf;
+  AtomVec *avec = atom->avec;
+  double **x = atom->x;
+  int nlocal = atom->nlocal;
+
+  shmseq++;
+
+  nrequest = 0;
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (sendproc[iswap] == me || !recvnum[iswap] || shmrecv[iswap] >= 0)
+      continue;
+    if (comm_x_only) buf = x[firstrecv[iswap]];
+    else buf = &buf_recv[size_forward*(firstrecv[iswap]-nlocal)];
+    MPI_Irecv(buf,size_forward_recv[iswap],MPI_DOUBLE,
+              recvproc[iswap],iswap,world,&requests[nrequest++]);
+  }
+
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (!sendnum[iswap]) continue;
+    if (sendproc[iswap] == me && comm_x_only) {
+      avec->pack_comm(sendnum[iswap],sendlist[iswap],
+                      x[firstrecv[iswap]],pbc_flag[iswap],pbc[iswap]);
+      continue;
+    }
+    if (shmsend[iswap] >= 0) buf = shm_send_buf(iswap,FORWARD);
+    else buf = &buf_send[size_forward*firstsend[iswap]];
+    if (ghost_velocity)
+      n = avec->pack_comm_vel(sendnum[iswap],sendlist[iswap],
+                              buf,pbc_flag[iswap],pbc[iswap]);
+    else
+      n = avec->pack_comm(sendnum[iswap],sendlist[iswap],
+                          buf,pbc_flag[iswap],pbc[iswap]);
+    if (shmsend[iswap] >= 0) shm_post(iswap,FORWARD);
+    else if (sendproc[iswap] != me)
+      MPI_Isend(buf,n,MPI_DOUBLE,sendproc[iswap],iswap,world,
+                &requests[nrequest++]);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   wait for all swaps of forward comm and unpack them
+   swaps with self are unpacked from the send buffer
+   swaps with procs on my node are unpacked from their shm buffer
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::forward_comm_finish()
+{
+  double *buf;
+  AtomVec *avec = atom->avec;
+  double **x = atom->x;
+  int nlocal = atom->nlocal;
+
+  if (nrequest) MPI_Waitall(nrequest,requests,MPI_STATUSES_IGNORE);
+  nrequest = 0;
+
+  for (int iswap = 0; iswap < nswap; iswap++) {
+    if (!recvnum[iswap]) continue;
+    if (shmrecv[iswap] >= 0) {
+      buf = shm_recv_buf(iswap,FORWARD);
+      if (comm_x_only)
+        memcpy(x[firstrecv[iswap]],buf,size_forward_recv[iswap]*sizeof(double));
+      else if (ghost_velocity)
+        avec->unpack_comm_vel(recvnum[iswap],firstrecv[iswap],buf);
+      else avec->unpack_comm(recvnum[iswap],firstrecv[iswap],buf);
+      shm_release(iswap,FORWARD);
+      continue;
+    }
+    if (comm_x_only) continue;
+    if (sendproc[iswap] == me) buf = &buf_send[size_forward*firstsend[iswap]];
+    else buf = &buf_recv[size_forward*(firstrecv[iswap]-nlocal)];
+    if (ghost_velocity)
+      avec->unpack_comm_vel(recvnum[iswap],firstrecv[iswap],buf);
+    else avec->unpack_comm(recvnum[iswap],firstrecv[iswap],buf);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   reverse communication of forces on atoms every timestep
+   other per-atom attributes may also be sent via pack/unpack routines
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::reverse_comm()
+{
+  reverse_comm_start();
+  reverse_comm_finish();
+}
+
+/* ----------------------------------------------------------------------
+   post recvs and sends of all swaps at once
+   if comm_f_only set, send directly from f, don't pack
+   forces for procs on my node are copied to my shm buffer right away
+   caller must not change forces on ghost atoms until finish
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::reverse_comm_start()
+{
+  int iswap,n;
+  double *buf;
+  AtomVec *avec = atom->avec;
+  double **f = atom->f;
+  int nlocal = atom->nlocal;
+
+  shmseq++;
+
+  nrequest = 0;
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (sendproc[iswap] == me || !sendnum[iswap] || shmsend[iswap] >= 0)
+      continue;
+    MPI_Irecv(&buf_recv[size_reverse*firstsend[iswap]],
+              size_reverse_recv[iswap],MPI_DOUBLE,
+              sendproc[iswap],iswap,world,&requests[nrequest++]);
+  }
+
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (!recvnum[iswap]) continue;
+    if (shmrecv[iswap] >= 0) {
+      buf = shm_send_buf(iswap,REVERSE);
+      avec->pack_reverse(recvnum[iswap],firstrecv[iswap],buf);
+      shm_post(iswap,REVERSE);
+      continue;
+    }
+    if (comm_f_only) {
+      if (sendproc[iswap] != me)
+        MPI_Isend(f[firstrecv[iswap]],size_reverse_send[iswap],MPI_DOUBLE,
+                  recvproc[iswap],iswap,world,&requests[nrequest++]);
+      continue;
+    }
+    buf = &buf_send[size_reverse*(firstrecv[iswap]-nlocal)];
+    n = avec->pack_reverse(recvnum[iswap],firstrecv[iswap],buf);
+    if (sendproc[iswap] != me)
+      MPI_Isend(buf,n,MPI_DOUBLE,recvproc[iswap],iswap,world,
+                &requests[nrequest++]);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   wait for all swaps of reverse comm and sum their forces
+   unpack in swap order, so the sum does not depend on message arrival
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::reverse_comm_finish()
+{
+  double *buf;
+  AtomVec *avec = atom->avec;
+  double **f = atom->f;
+  int nlocal = atom->nlocal;
+
+  if (nrequest) MPI_Waitall(nrequest,requests,MPI_STATUSES_IGNORE);
+  nrequest = 0;
+
+  for (int iswap = 0; iswap < nswap; iswap++) {
+    if (!sendnum[iswap]) continue;
+    if (shmsend[iswap] >= 0) {
+      buf = shm_recv_buf(iswap,REVERSE);
+      avec->unpack_reverse(sendnum[iswap],sendlist[iswap],buf);
+      shm_release(iswap,REVERSE);
+      continue;
+    }
+    if (sendproc[iswap] != me)
+      buf = &buf_recv[size_reverse*firstsend[iswap]];
+    else if (comm_f_only) buf = f[firstrecv[iswap]];
+    else buf = &buf_send[size_reverse*(firstrecv[iswap]-nlocal)];
+    avec->unpack_reverse(sendnum[iswap],sendlist[iswap],buf);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   borders: list nearby atoms to send to neighboring procs at every timestep
+   one list is created for every swap that will be made
+   only owned atoms are sent, in a single pass over them
+   atom is sent to all swaps whose offset in each dim is within its bands
+   counts are exchanged first, so ghosts of each swap are stored
+     contiguously in swap order, then all swaps are made at once
+   this does equivalent of a forward_comm(), so don't need to explicitly
+     call forward_comm() on reneighboring timestep
+   this routine is called before every reneighboring
+   for triclinic, atoms must be in lamda coords (0-1) before borders is called
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::borders()
+{
+  int i,k,n,dim,iswap,ix,iy,iz;
+  int up[3],down[3];
+  double *buf;
+  AtomVec *avec = atom->avec;
+  double **x = atom->x;
+  int nlocal = atom->nlocal;
+
+  // find owned atoms to send in each swap
+  // only atoms in bordergroup if set
+  // up/down = # of procs away atom is within cutghost of, in each dim
+
+  int ngroup = nlocal;
+  if (bordergroup) ngroup = atom->nfirst;
+
+  for (iswap = 0; iswap < nswap; iswap++) sendnum[iswap] = 0;
+
+  for (i = 0; i < ngroup; i++) {
+    for (dim = 0; dim < 3; dim++) {
+      for (k = 1; k <= maxneed[dim]; k++)
+        if (x[i][dim] < bandlo[dim][k]) break;
+      up[dim] = k-1;
+      for (k = 1; k <= maxneed[dim]; k++)
+        if (x[i][dim] > bandhi[dim][k]) break;
+      down[dim] = k-1;
+    }
+    if (!up[0] && !down[0] && !up[1] && !down[1] && !up[2] && !down[2])
+      continue;
+
+    for (iz = -down[2]; iz <= up[2]; iz++)
+      for (iy = -down[1]; iy <= up[1]; iy++)
+        for (ix = -down[0]; ix <= up[0]; ix++) {
+          if (ix == 0 && iy == 0 && iz == 0) continue;
+          iswap = swap_index(ix,iy,iz);
+          n = sendnum[iswap];
+          if (n == maxsendlist[iswap]) grow_list(iswap,n);
+          sendlist[iswap][n] = i;
+          sendnum[iswap] = n+1;
+        }
+  }
+
+  // exchange counts with all procs I swap with
+  // none across non-PBC boundaries
+
+  nrequest = 0;
+  for (iswap = 0; iswap < nswap; iswap++) {
+    recvnum[iswap] = 0;
+    if (sendproc[iswap] == me) recvnum[iswap] = sendnum[iswap];
+    else if (recvproc[iswap] != MPI_PROC_NULL)
+      MPI_Irecv(&recvnum[iswap],1,MPI_INT,recvproc[iswap],iswap,world,
+                &requests[nrequest++]);
+  }
+  for (iswap = 0; iswap < nswap; iswap++)
+    if (sendproc[iswap] != me && sendproc[iswap] != MPI_PROC_NULL)
+      MPI_Isend(&sendnum[iswap],1,MPI_INT,sendproc[iswap],iswap,world,
+                &requests[nrequest++]);
+  if (nrequest) MPI_Waitall(nrequest,requests,MPI_STATUSES_IGNORE);
+  nrequest = 0;
+
+  // set all pointers & counters
+
+  smax = rmax = 0;
+  nsendall = nrecvall = 0;
+  for (iswap = 0; iswap < nswap; iswap++) {
+    smax = MAX(smax,sendnum[iswap]);
+    rmax = MAX(rmax,recvnum[iswap]);
+    firstsend[iswap] = nsendall;
+    firstrecv[iswap] = nlocal + nrecvall;
+    nsendall += sendnum[iswap];
+    nrecvall += recvnum[iswap];
+    size_forward_recv[iswap] = recvnum[iswap]*size_forward;
+    size_reverse_send[iswap] = recvnum[iswap]*size_reverse;
+    size_reverse_recv[iswap] = sendnum[iswap]*size_reverse;
+  }
+
+  // pack all swaps into send buffer, post recvs of all into recv buffer
+  // size_border is max per atom, actual messages can be shorter
+
+  if (nsendall*size_border > maxsend) grow_send(nsendall*size_border,0);
+  if (nrecvall*size_border > maxrecv) grow_recv(nrecvall*size_border);
+
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (sendproc[iswap] == me || !recvnum[iswap]) continue;
+    MPI_Irecv(&buf_recv[size_border*(firstrecv[iswap]-nlocal)],
+              recvnum[iswap]*size_border,MPI_DOUBLE,
+              recvproc[iswap],iswap,world,&requests[nrequest++]);
+  }
+
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (!sendnum[iswap]) continue;
+    buf = &buf_send[size_border*firstsend[iswap]];
+    if (ghost_velocity)
+      n = avec->pack_border_vel(sendnum[iswap],sendlist[iswap],buf,
+                                pbc_flag[iswap],pbc[iswap]);
+    else
+      n = avec->pack_border(sendnum[iswap],sendlist[iswap],buf,
+                            pbc_flag[iswap],pbc[iswap]);
+    if (sendproc[iswap] != me)
+      MPI_Isend(buf,n,MPI_DOUBLE,sendproc[iswap],iswap,world,
+                &requests[nrequest++]);
+  }
+
+  if (nrequest) MPI_Waitall(nrequest,requests,MPI_STATUSES_IGNORE);
+  nrequest = 0;
+
+  // unpack in swap order, so ghosts are appended at end of my atom arrays
+  // swaps with self are unpacked from the send buffer
+
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (!recvnum[iswap]) continue;
+    if (sendproc[iswap] == me) buf = &buf_send[size_border*firstsend[iswap]];
+    else buf = &buf_recv[size_border*(firstrecv[iswap]-nlocal)];
+    if (ghost_velocity)
+      avec->unpack_border_vel(recvnum[iswap],firstrecv[iswap],buf);
+    else
+      avec->unpack_border(recvnum[iswap],firstrecv[iswap],buf);
+  }
+  atom->nghost = nrecvall;
+
+  // insure send/recv buffers are long enough for all forward & reverse comm
+  // all swaps are in flight at once, so sized by totals over swaps
+
+  int max = MAX(maxforward*nsendall,maxreverse*nrecvall);
+  if (max > maxsend) grow_send(max,0);
+  max = MAX(maxforward*nrecvall,maxreverse*nsendall);
+  if (max > maxrecv) grow_recv(max);
+
+  // size and lay out shm buffers for swaps with procs on my node
+
+  if (shm && nodesize > 1) borders_shm();
+
+  // reset global->local map
+
+  if (map_style) atom->map_set();
+}
+
+/* ----------------------------------------------------------------------
+   forward communication invoked by a Pair
+   all swaps in flight at once, each with its own part of the buffers
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::forward_comm_pair(Pair *pair)
+{
+  int iswap,n;
+  double *buf;
+  int nlocal = atom->nlocal;
+
+  int nsize = pair->comm_forward;
+
+  shmseq++;
+
+  nrequest = 0;
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (sendproc[iswap] == me || !recvnum[iswap] || shmrecv[iswap] >= 0)
+      continue;
+    MPI_Irecv(&buf_recv[nsize*(firstrecv[iswap]-nlocal)],
+              nsize*recvnum[iswap],MPI_DOUBLE,recvproc[iswap],iswap,world,
+              &requests[nrequest++]);
+  }
+
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (!sendnum[iswap]) continue;
+    if (shmsend[iswap] >= 0) buf = shm_send_buf(iswap,FORWARD);
+    else buf = &buf_send[nsize*firstsend[iswap]];
+    n = pair->pack_forward_comm(sendnum[iswap],sendlist[iswap],
+                                buf,pbc_flag[iswap],pbc[iswap]);
+    if (shmsend[iswap] >= 0) shm_post(iswap,FORWARD);
+    else if (sendproc[iswap] != me)
+      MPI_Isend(buf,n,MPI_DOUBLE,sendproc[iswap],iswap,world,
+                &requests[nrequest++]);
+  }
+
+  if (nrequest) MPI_Waitall(nrequest,requests,MPI_STATUSES_IGNORE);
+  nrequest = 0;
+
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (!recvnum[iswap]) continue;
+    if (shmrecv[iswap] >= 0) buf = shm_recv_buf(iswap,FORWARD);
+    else if (sendproc[iswap] == me) buf = &buf_send[nsize*firstsend[iswap]];
+    else buf = &buf_recv[nsize*(firstrecv[iswap]-nlocal)];
+    pair->unpack_forward_comm(recvnum[iswap],firstrecv[iswap],buf);
+    if (shmrecv[iswap] >= 0) shm_release(iswap,FORWARD);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   reverse communication invoked by a Pair
+   all swaps in flight at once, unpacked in swap order
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::reverse_comm_pair(Pair *pair)
+{
+  int iswap,n;
+  double *buf;
+  int nlocal = atom->nlocal;
+
+  int nsize = MAX(pair->comm_reverse,pair->comm_reverse_off);
+
+  shmseq++;
+
+  nrequest = 0;
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (sendproc[iswap] == me || !sendnum[iswap] || shmsend[iswap] >= 0)
+      continue;
+    MPI_Irecv(&buf_recv[nsize*firstsend[iswap]],nsize*sendnum[iswap],
+              MPI_DOUBLE,sendproc[iswap],iswap,world,&requests[nrequest++]);
+  }
+
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (!recvnum[iswap]) continue;
+    if (shmrecv[iswap] >= 0) buf = shm_send_buf(iswap,REVERSE);
+    else buf = &buf_send[nsize*(firstrecv[iswap]-nlocal)];
+    n = pair->pack_reverse_comm(recvnum[iswap],firstrecv[iswap],buf);
+    if (shmrecv[iswap] >= 0) shm_post(iswap,REVERSE);
+    else if (sendproc[iswap] != me)
+      MPI_Isend(buf,n,MPI_DOUBLE,recvproc[iswap],iswap,world,
+                &requests[nrequest++]);
+  }
+
+  if (nrequest) MPI_Waitall(nrequest,requests,MPI_STATUSES_IGNORE);
+  nrequest = 0;
+
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (!sendnum[iswap]) continue;
+    if (shmsend[iswap] >= 0) buf = shm_recv_buf(iswap,REVERSE);
+    else if (sendproc[iswap] == me)
+      buf = &buf_send[nsize*(firstrecv[iswap]-nlocal)];
+    else buf = &buf_recv[nsize*firstsend[iswap]];
+    pair->unpack_reverse_comm(sendnum[iswap],sendlist[iswap],buf);
+    if (shmsend[iswap] >= 0) shm_release(iswap,REVERSE);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   forward communication invoked by a Fix
+   size = 0 (default) -> use comm_forward from Fix
+   size > 0 -> Fix passes max size per atom
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::forward_comm_fix(Fix *fix, int size)
+{
+  int iswap,n,nsize;
+  double *buf;
+  int nlocal = atom->nlocal;
+
+  if (size) nsize = size;
+  else nsize = fix->comm_forward;
+
+  shmseq++;
+
+  nrequest = 0;
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (sendproc[iswap] == me || !recvnum[iswap] || shmrecv[iswap] >= 0)
+      continue;
+    MPI_Irecv(&buf_recv[nsize*(firstrecv[iswap]-nlocal)],
+              nsize*recvnum[iswap],MPI_DOUBLE,recvproc[iswap],iswap,world,
+              &requests[nrequest++]);
+  }
+
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (!sendnum[iswap]) continue;
+    if (shmsend[iswap] >= 0) buf = shm_send_buf(iswap,FORWARD);
+    else buf = &buf_send[nsize*firstsend[iswap]];
+    n = fix->pack_forward_comm(sendnum[iswap],sendlist[iswap],
+                               buf,pbc_flag[iswap],pbc[iswap]);
+    if (shmsend[iswap] >= 0) shm_post(iswap,FORWARD);
+    else if (sendproc[iswap] != me)
+      MPI_Isend(buf,n,MPI_DOUBLE,sendproc[iswap],iswap,world,
+                &requests[nrequest++]);
+  }
+
+  if (nrequest) MPI_Waitall(nrequest,requests,MPI_STATUSES_IGNORE);
+  nrequest = 0;
+
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (!recvnum[iswap]) continue;
+    if (shmrecv[iswap] >= 0) buf = shm_recv_buf(iswap,FORWARD);
+    else if (sendproc[iswap] == me) buf = &buf_send[nsize*firstsend[iswap]];
+    else buf = &buf_recv[nsize*(firstrecv[iswap]-nlocal)];
+    fix->unpack_forward_comm(recvnum[iswap],firstrecv[iswap],buf);
+    if (shmrecv[iswap] >= 0) shm_release(iswap,FORWARD);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   reverse communication invoked by a Fix
+   size = 0 (default) -> use comm_reverse from Fix
+   size > 0 -> Fix passes max size per atom
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::reverse_comm_fix(Fix *fix, int size)
+{
+  int iswap,n,nsize;
+  double *buf;
+  int nlocal = atom->nlocal;
+
+  if (size) nsize = size;
+  else nsize = fix->comm_reverse;
+
+  shmseq++;
+
+  nrequest = 0;
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (sendproc[iswap] == me || !sendnum[iswap] || shmsend[iswap] >= 0)
+      continue;
+    MPI_Irecv(&buf_recv[nsize*firstsend[iswap]],nsize*sendnum[iswap],
+              MPI_DOUBLE,sendproc[iswap],iswap,world,&requests[nrequest++]);
+  }
+
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (!recvnum[iswap]) continue;
+    if (shmrecv[iswap] >= 0) buf = shm_send_buf(iswap,REVERSE);
+    else buf = &buf_send[nsize*(firstrecv[iswap]-nlocal)];
+    n = fix->pack_reverse_comm(recvnum[iswap],firstrecv[iswap],buf);
+    if (shmrecv[iswap] >= 0) shm_post(iswap,REVERSE);
+    else if (sendproc[iswap] != me)
+      MPI_Isend(buf,n,MPI_DOUBLE,recvproc[iswap],iswap,world,
+                &requests[nrequest++]);
+  }
+
+  if (nrequest) MPI_Waitall(nrequest,requests,MPI_STATUSES_IGNORE);
+  nrequest = 0;
+
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (!sendnum[iswap]) continue;
+    if (shmsend[iswap] >= 0) buf = shm_recv_buf(iswap,REVERSE);
+    else if (sendproc[iswap] == me)
+      buf = &buf_send[nsize*(firstrecv[iswap]-nlocal)];
+    else buf = &buf_recv[nsize*firstsend[iswap]];
+    fix->unpack_reverse_comm(sendnum[iswap],sendlist[iswap],buf);
+    if (shmsend[iswap] >= 0) shm_release(iswap,REVERSE);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   forward communication invoked by a Compute
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::forward_comm_compute(Compute *compute)
+{
+  int iswap,n;
+  double *buf;
+  int nlocal = atom->nlocal;
+
+  int nsize = compute->comm_forward;
+
+  shmseq++;
+
+  nrequest = 0;
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (sendproc[iswap] == me || !recvnum[iswap] || shmrecv[iswap] >= 0)
+      continue;
+    MPI_Irecv(&buf_recv[nsize*(firstrecv[iswap]-nlocal)],
+              nsize*recvnum[iswap],MPI_DOUBLE,recvproc[iswap],iswap,world,
+              &requests[nrequest++]);
+  }
+
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (!sendnum[iswap]) continue;
+    if (shmsend[iswap] >= 0) buf = shm_send_buf(iswap,FORWARD);
+    else buf = &buf_send[nsize*firstsend[iswap]];
+    n = compute->pack_forward_comm(sendnum[iswap],sendlist[iswap],
+                                   buf,pbc_flag[iswap],pbc[iswap]);
+    if (shmsend[iswap] >= 0) shm_post(iswap,FORWARD);
+    else if (sendproc[iswap] != me)
+      MPI_Isend(buf,n,MPI_DOUBLE,sendproc[iswap],iswap,world,
+                &requests[nrequest++]);
+  }
+
+  if (nrequest) MPI_Waitall(nrequest,requests,MPI_STATUSES_IGNORE);
+  nrequest = 0;
+
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (!recvnum[iswap]) continue;
+    if (shmrecv[iswap] >= 0) buf = shm_recv_buf(iswap,FORWARD);
+    else if (sendproc[iswap] == me) buf = &buf_send[nsize*firstsend[iswap]];
+    else buf = &buf_recv[nsize*(firstrecv[iswap]-nlocal)];
+    compute->unpack_forward_comm(recvnum[iswap],firstrecv[iswap],buf);
+    if (shmrecv[iswap] >= 0) shm_release(iswap,FORWARD);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   reverse communication invoked by a Compute
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::reverse_comm_compute(Compute *compute)
+{
+  int iswap,n;
+  double *buf;
+  int nlocal = atom->nlocal;
+
+  int nsize = compute->comm_reverse;
+
+  shmseq++;
+
+  nrequest = 0;
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (sendproc[iswap] == me || !sendnum[iswap] || shmsend[iswap] >= 0)
+      continue;
+    MPI_Irecv(&buf_recv[nsize*firstsend[iswap]],nsize*sendnum[iswap],
+              MPI_DOUBLE,sendproc[iswap],iswap,world,&requests[nrequest++]);
+  }
+
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (!recvnum[iswap]) continue;
+    if (shmrecv[iswap] >= 0) buf = shm_send_buf(iswap,REVERSE);
+    else buf = &buf_send[nsize*(firstrecv[iswap]-nlocal)];
+    n = compute->pack_reverse_comm(recvnum[iswap],firstrecv[iswap],buf);
+    if (shmrecv[iswap] >= 0) shm_post(iswap,REVERSE);
+    else if (sendproc[iswap] != me)
+      MPI_Isend(buf,n,MPI_DOUBLE,recvproc[iswap],iswap,world,
+                &requests[nrequest++]);
+  }
+
+  if (nrequest) MPI_Waitall(nrequest,requests,MPI_STATUSES_IGNORE);
+  nrequest = 0;
+
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (!sendnum[iswap]) continue;
+    if (shmsend[iswap] >= 0) buf = shm_recv_buf(iswap,REVERSE);
+    else if (sendproc[iswap] == me)
+      buf = &buf_send[nsize*(firstrecv[iswap]-nlocal)];
+    else buf = &buf_recv[nsize*firstsend[iswap]];
+    compute->unpack_reverse_comm(sendnum[iswap],sendlist[iswap],buf);
+    if (shmsend[iswap] >= 0) shm_release(iswap,REVERSE);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   realloc the swap arrays, and the direct ones with them
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::grow_swap(int n)
+{
+  CommBrick::grow_swap(n);
+  free_direct();
+  allocate_direct(n);
+}
+
+/* ----------------------------------------------------------------------
+   allocation of direct swap info
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::allocate_direct(int n)
+{
+  memory->create(firstsend,n,"comm:firstsend");
+  memory->create(shmsend,n,"comm:shmsend");
+  memory->create(shmrecv,n,"comm:shmrecv");
+  for (int i = 0; i < n; i++) shmsend[i] = shmrecv[i] = -1;
+  requests = new MPI_Request[2*n];
+  nrequest = 0;
+}
+
+/* ----------------------------------------------------------------------
+   free memory for direct swaps
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::free_direct()
+{
+  memory->destroy(firstsend);
+  memory->destroy(shmsend);
+  memory->destroy(shmrecv);
+  delete [] requests;
+  requests = NULL;
+}
+
+/* ----------------------------------------------------------------------
+   size and lay out my shm buffer for swaps with procs on my node
+   buffer = header, then forward slot of each swap I send to a node proc,
+     reverse slot of each swap I recv from one, sized by maxforward/reverse
+   window is reallocated on all node procs if any of them needs more room
+   barrier so all offsets are published before the next comm
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::borders_shm()
+{
+  int iswap,n;
+
+  int nheader = MAX(nswap,maxshmswap);
+  int m = (SHMHEADER*nheader+1)/2;
+  n = m;
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (shmsend[iswap] >= 0) n += maxforward*sendnum[iswap];
+    if (shmrecv[iswap] >= 0) n += maxreverse*recvnum[iswap];
+  }
+
+  int flag = (n > maxshm || nswap > maxshmswap);
+  int flagall;
+  MPI_Allreduce(&flag,&flagall,1,MPI_INT,MPI_MAX,nodecomm);
+
+  if (flagall) {
+    if (shmactive) {
+      MPI_Win_unlock_all(shmwin);
+      MPI_Win_free(&shmwin);
+    }
+    maxshmswap = nheader;
+    maxshm = MAX(maxshm,static_cast<int> (BUFFACTOR * n));
+
+    char *base;
+    MPI_Win_allocate_shared((MPI_Aint) maxshm*sizeof(double),1,
+                            MPI_INFO_NULL,nodecomm,&base,&shmwin);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK,shmwin);
+    shmactive = 1;
+
+    MPI_Aint size;
+    int disp;
+    for (int i = 0; i < nodesize; i++)
+      MPI_Win_shared_query(shmwin,i,&size,&disp,&shmbase[i]);
+
+    memory->destroy(shmlast);
+    memory->create(shmlast,2*maxshmswap,"comm:shmlast");
+  }
+
+  // no node proc is in a comm operation after the Allreduce
+  // so seq #s can start over, they then never overflow
+
+  MPI_Win_sync(shmwin);
+  int *header = (int *) shmbase[nodeme];
+  memset(header,0,SHMHEADER*maxshmswap*sizeof(int));
+  for (iswap = 0; iswap < 2*maxshmswap; iswap++) shmlast[iswap] = 0;
+  shmseq = 0;
+
+  for (iswap = 0; iswap < nswap; iswap++) {
+    header[SHMHEADER*iswap+4] = m;
+    if (shmsend[iswap] >= 0) m += maxforward*sendnum[iswap];
+    header[SHMHEADER*iswap+5] = m;
+    if (shmrecv[iswap] >= 0) m += maxreverse*recvnum[iswap];
+  }
+
+  MPI_Win_sync(shmwin);
+  MPI_Barrier(nodecomm);
+  MPI_Win_sync(shmwin);
+}
+
+/* ----------------------------------------------------------------------
+   wait until a flag in a shm header, written by another proc, has value
+   yield the core while spinning, in case procs outnumber cores
+------------------------------------------------------------------------- */
+
+static void shm_wait(volatile int *flag, int value, MPI_Win win)
+{
+  while (*flag != value) {
+    MPI_Win_sync(win);
+#if !defined(_WIN32)
+    sched_yield();
+#endif
+  }
+}
+
+/* ----------------------------------------------------------------------
+   return my shm slot of a swap in direction dir, to pack into
+   wait until the node proc reading it is done with the previous post
+------------------------------------------------------------------------- */
+
+double *CommBrickDirect::shm_send_buf(int iswap, int dir)
+{
+  int *header = (int *) shmbase[nodeme] + SHMHEADER*iswap;
+  shm_wait(&header[2*dir+1],shmlast[2*iswap+dir],shmwin);
+  return (double *) shmbase[nodeme] + header[4+dir];
+}
+
+/* ----------------------------------------------------------------------
+   mark my shm slot as written for the current comm operation
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::shm_post(int iswap, int dir)
+{
+  volatile int *header = (int *) shmbase[nodeme] + SHMHEADER*iswap;
+  MPI_Win_sync(shmwin);
+  header[2*dir] = shmseq;
+  shmlast[2*iswap+dir] = shmseq;
+}
+
+/* ----------------------------------------------------------------------
+   return shm slot of the node proc a swap recvs from in direction dir
+   forward recvs from recvproc, reverse from sendproc, same swap index
+   wait until that proc posted it for the current comm operation
+------------------------------------------------------------------------- */
+
+double *CommBrickDirect::shm_recv_buf(int iswap, int dir)
+{
+  int rank = (dir == FORWARD) ? shmrecv[iswap] : shmsend[iswap];
+  int *header = (int *) shmbase[rank] + SHMHEADER*iswap;
+  shm_wait(&header[2*dir],shmseq,shmwin);
+  return (double *) shmbase[rank] + header[4+dir];
+}
+
+/* ----------------------------------------------------------------------
+   mark shm slot of a node proc as read, so it can post again
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::shm_release(int iswap, int dir)
+{
+  int rank = (dir == FORWARD) ? shmrecv[iswap] : shmsend[iswap];
+  volatile int *header = (int *) shmbase[rank] + SHMHEADER*iswap;
+  MPI_Win_sync(shmwin);
+  header[2*dir+1] = shmseq;
+}
+
+/* ----------------------------------------------------------------------
+   free shm window and node communicator
+------------------------------------------------------------------------- */
+
+void CommBrickDirect::free_shm()
+{
+  if (shmactive) {
+    MPI_Win_unlock_all(shmwin);
+    MPI_Win_free(&shmwin);
+  }
+  shmactive = 0;
+  if (nodecomm != MPI_COMM_NULL) MPI_Comm_free(&nodecomm);
+  delete [] shmbase;
+  memory->destroy(shmlast);
+}
@@ -0,0 +1,91 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifndef LMP_COMM_BRICK_DIRECT_H
+#define LMP_COMM_BRICK_DIRECT_H
+
+#include "comm_brick.h"
+
+namespace LAMMPS_NS {
+
+class CommBrickDirect : public CommBrick {
+ public:
+  CommBrickDirect(class LAMMPS *);
+  CommBrickDirect(class LAMMPS *, class Comm *);
+  virtual ~CommBrickDirect();
+
+  virtual void init();
+  virtual void setup();                        // setup direct comm pattern
+  virtual void forward_comm(int dummy = 0);    // forward comm of atom coords
+  virtual void reverse_comm();                 // reverse comm of forces
+  virtual void borders();                      // setup list of atoms to comm
+  virtual void forward_comm_start();           // post all swaps of forward
+  virtual void forward_comm_finish();          // wait and unpack them
+  virtual void reverse_comm_start();           // post all swaps of reverse
+  virtual void reverse_comm_finish();          // wait and sum them
+
+  virtual void forward_comm_pair(class Pair *);    // forward comm from a Pair
+  virtual void reverse_comm_pair(class Pair *);    // reverse comm from a Pair
+  virtual void forward_comm_fix(class Fix *, int size=0);
+                                                   // forward comm from a Fix
+  virtual void reverse_comm_fix(class Fix *, int size=0);
+                                                   // reverse comm from a Fix
+  virtual void forward_comm_compute(class Compute *);  // forward from a Compute
+  virtual void reverse_comm_compute(class Compute *);  // reverse from a Compute
+
+ protected:
+  int nsendall,nrecvall;            // # of atoms sent/recvd over all swaps
+  int *firstsend;                   // offset of each swap in send buffer
+  int maxband;                      // max offset bandlo/bandhi are sized for
+  double **bandlo,**bandhi;         // per dim, atom is sent K procs up/down
+                                    //   if x >= bandlo[dim][K] / <= bandhi
+  MPI_Request *requests;            // 2 per swap, all in flight at once
+  int nrequest;                     // # of posted requests
+
+  int *shmsend,*shmrecv;            // rank in nodecomm of send/recv proc
+                                    //   of each swap if on my node, else -1
+  MPI_Comm nodecomm;                // procs on my node, when shm is used
+  int nodeme,nodesize;              // my rank and # of procs in nodecomm
+  MPI_Win shmwin;                   // window with one buffer per node proc
+  int shmactive;                    // 1 if shmwin is allocated
+  char **shmbase;                   // base of buffer of each node proc
+  int maxshm;                       // size of my shm buffer in doubles
+  int maxshmswap;                   // # of swaps its header is sized for
+  int *shmlast;                     // seq # of last post to each of my slots
+  int shmseq;                       // seq # of current comm operation
+
+  void allocate_direct(int);                // allocate direct swap arrays
+  void free_direct();                       // free direct swap arrays
+  virtual void grow_swap(int);              // grow swap and direct arrays
+  int proc_at(int, int, int, int *);        // proc at offset, PBC image
+  int swap_index(int, int, int);            // swap at offset in stencil
+  void setup_shm();                         // find swaps on my node
+  void borders_shm();                       // size and layout shm buffers
+  double *shm_send_buf(int, int);           // my slot, once it was read
+  void shm_post(int, int);                  // mark my slot as written
+  double *shm_recv_buf(int, int);           // partner slot, once written
+  void shm_release(int, int);               // mark partner slot as read
+  void free_shm();                          // free window and nodecomm
+};
+
+}
+
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Cannot yet use comm_style brick/direct with multi-mode comm
+
+Self-explanatory.
+
+*/
@@ -33,10 +33,6 @@
 
 using namespace LAMMPS_NS;
 
-// allocate space for static class variable
-
-DeleteAtoms *DeleteAtoms::cptr;
-
 /* ---------------------------------------------------------------------- */
 
 DeleteAtoms::DeleteAtoms(LAMMPS *lmp) : Pointers(lmp) {}
@@ -425,33 +421,82 @@ void DeleteAtoms::delete_porosity(int narg, char **arg)
 
 void DeleteAtoms::delete_bond()
 {
-  // hash = for atom IDs being deleted by one processor
-  // list of these IDs is sent around ring
-  // at each stage of ring pass, hash is re-populated with received IDs
+  int i,m;
+
+  tagint *tag = atom->tag;
+  int nlocal = atom->nlocal;
+
+  int *num_bond = atom->num_bond;
+  int *num_angle = atom->num_angle;
+  int *num_dihedral = atom->num_dihedral;
+  int *num_improper = atom->num_improper;
+
+  // hash = unique atom IDs referenced in my topology lists
 
   hash = new std::map<tagint,int>();
 
-  // list = set of unique molecule IDs from which I deleted atoms
-  // pass list to all other procs via comm->ring()
+  for (i = 0; i < nlocal; i++) {
+    if (num_bond)
+      for (m = 0; m < num_bond[i]; m++)
+        (*hash)[atom->bond_atom[i][m]] = 1;
+    if (num_angle)
+      for (m = 0; m < num_angle[i]; m++) {
+        (*hash)[atom->angle_atom1[i][m]] = 1;
+        (*hash)[atom->angle_atom2[i][m]] = 1;
+        (*hash)[atom->angle_atom3[i][m]] = 1;
+      }
+    if (num_dihedral)
+      for (m = 0; m < num_dihedral[i]; m++) {
+        (*hash)[atom->dihedral_atom1[i][m]] = 1;
+        (*hash)[atom->dihedral_atom2[i][m]] = 1;
+        (*hash)[atom->dihedral_atom3[i][m]] = 1;
+        (*hash)[atom->dihedral_atom4[i][m]] = 1;
+      }
+    if (num_improper)
+      for (m = 0; m < num_improper[i]; m++) {
+        (*hash)[atom->improper_atom1[i][m]] = 1;
+        (*hash)[atom->improper_atom2[i][m]] = 1;
+        (*hash)[atom->improper_atom3[i][m]] = 1;
+        (*hash)[atom->improper_atom4[i][m]] = 1;
+      }
+  }
 
-  tagint *tag = atom->tag;
-  int nlocal = atom->nlocal;
+  // keys = IDs of atoms I delete, queries = IDs in my topology lists
+  // rendezvous lookup returns queried IDs that are being deleted
 
-  int n = 0;
-  for (int i = 0; i < nlocal; i++)
-    if (dlist[i]) n++;
-  tagint *list;
-  memory->create(list,n,"delete_atoms:list");
+  int nkey = 0;
+  for (i = 0; i < nlocal; i++)
+    if (dlist[i]) nkey++;
+  int nquery = hash->size();
 
-  n = 0;
-  for (int i = 0; i < nlocal; i++)
-    if (dlist[i]) list[n++] = tag[i];
+  tagint *keys,*queries;
+  memory->create(keys,nkey,"delete_atoms:keys");
+  memory->create(queries,nquery,"delete_atoms:queries");
+
+  nkey = 0;
+  for (i = 0; i < nlocal; i++)
+    if (dlist[i]) keys[nkey++] = tag[i];
+
+  nquery = 0;
+  std::map<tagint,int>::iterator pos;
+  for (pos = hash->begin(); pos != hash->end(); ++pos)
+    queries[nquery++] = pos->first;
+
+  tagint *result;
+  int nfound = comm->rendezvous_lookup(nkey,keys,keys,nquery,queries,result);
+
+  memory->destroy(keys);
+  memory->destroy(queries);
+
+  // hash = deleted atom IDs that appear in my topology lists
 
-  cptr = this;
-  comm->ring(n,sizeof(tagint),list,1,bondring,NULL);
+  hash->clear();
+  for (i = 0; i < nfound; i++) (*hash)[result[2*i]] = 1;
+  memory->destroy(result);
+
+  delete_topology();
 
   delete hash;
-  memory->destroy(list);
 }
 
 /* ----------------------------------------------------------------------
@@ -475,22 +520,44 @@ void DeleteAtoms::delete_molecule()
       (*hash)[molecule[i]] = 1;
   }
 
-  // list = set of unique molecule IDs from which I deleted atoms
-  // pass list to all other procs via comm->ring()
+  // keys = unique molecule IDs from which I deleted atoms
+  // queries = molecule IDs of all my atoms not yet deleted
+  // rendezvous lookup returns queried IDs of molecules with deletions
+
+  int nkey = hash->size();
+  int nquery = 0;
+  for (int i = 0; i < nlocal; i++)
+    if (!dlist[i] && molecule[i]) nquery++;
 
-  int n = hash->size();
-  tagint *list;
-  memory->create(list,n,"delete_atoms:list");
+  tagint *keys,*queries;
+  memory->create(keys,nkey,"delete_atoms:keys");
+  memory->create(queries,nquery,"delete_atoms:queries");
 
-  n = 0;
+  nkey = 0;
   std::map<tagint,int>::iterator pos;
-  for (pos = hash->begin(); pos != hash->end(); ++pos) list[n++] = pos->first;
+  for (pos = hash->begin(); pos != hash->end(); ++pos)
+    keys[nkey++] = pos->first;
+
+  nquery = 0;
+  for (int i = 0; i < nlocal; i++)
+    if (!dlist[i] && molecule[i]) queries[nquery++] = molecule[i];
+
+  tagint *result;
+  int nfound = comm->rendezvous_lookup(nkey,keys,keys,nquery,queries,result);
 
-  cptr = this;
-  comm->ring(n,sizeof(tagint),list,1,molring,NULL);
+  memory->destroy(keys);
+  memory->destroy(queries);
+
+  // loop over my atoms, if molecule ID was returned, delete that atom
+
+  hash->clear();
+  for (int i = 0; i < nfound; i++) (*hash)[result[2*i]] = 1;
+  memory->destroy(result);
+
+  for (int i = 0; i < nlocal; i++)
+    if (hash->find(molecule[i]) != hash->end()) dlist[i] = 1;
 
   delete hash;
-  memory->destroy(list);
 }
 
 /* ----------------------------------------------------------------------
@@ -556,45 +623,37 @@ void DeleteAtoms::recount_topology()
 }
 
 /* ----------------------------------------------------------------------
-   callback from comm->ring() in delete_bond()
+   delete interactions of my atoms that include an atom ID in hash
 ------------------------------------------------------------------------- */
 
-void DeleteAtoms::bondring(int nbuf, char *cbuf)
+void DeleteAtoms::delete_topology()
 {
-  tagint *list = (tagint *) cbuf;
-  std::map<tagint,int> *hash = cptr->hash;
-
-  int *num_bond = cptr->atom->num_bond;
-  int *num_angle = cptr->atom->num_angle;
-  int *num_dihedral = cptr->atom->num_dihedral;
-  int *num_improper = cptr->atom->num_improper;
+  int *num_bond = atom->num_bond;
+  int *num_angle = atom->num_angle;
+  int *num_dihedral = atom->num_dihedral;
+  int *num_improper = atom->num_improper;
+
+  int **bond_type = atom->bond_type;
+  tagint **bond_atom = atom->bond_atom;
+
+  int **angle_type = atom->angle_type;
+  tagint **angle_atom1 = atom->angle_atom1;
+  tagint **angle_atom2 = atom->angle_atom2;
+  tagint **angle_atom3 = atom->angle_atom3;
+
+  int **dihedral_type = atom->dihedral_type;
+  tagint **dihedral_atom1 = atom->dihedral_atom1;
+  tagint **dihedral_atom2 = atom->dihedral_atom2;
+  tagint **dihedral_atom3 = atom->dihedral_atom3;
+  tagint **dihedral_atom4 = atom->dihedral_atom4;
+
+  int **improper_type = atom->improper_type;
+  tagint **improper_atom1 = atom->improper_atom1;
+  tagint **improper_atom2 = atom->improper_atom2;
+  tagint **improper_atom3 = atom->improper_atom3;
+  tagint **improper_atom4 = atom->improper_atom4;
 
-  int **bond_type = cptr->atom->bond_type;
-  tagint **bond_atom = cptr->atom->bond_atom;
-
-  int **angle_type = cptr->atom->angle_type;
-  tagint **angle_atom1 = cptr->atom->angle_atom1;
-  tagint **angle_atom2 = cptr->atom->angle_atom2;
-  tagint **angle_atom3 = cptr->atom->angle_atom3;
-
-  int **dihedral_type = cptr->atom->dihedral_type;
-  tagint **dihedral_atom1 = cptr->atom->dihedral_atom1;
-  tagint **dihedral_atom2 = cptr->atom->dihedral_atom2;
-  tagint **dihedral_atom3 = cptr->atom->dihedral_atom3;
-  tagint **dihedral_atom4 = cptr->atom->dihedral_atom4;
-
-  int **improper_type = cptr->atom->improper_type;
-  tagint **improper_atom1 = cptr->atom->improper_atom1;
-  tagint **improper_atom2 = cptr->atom->improper_atom2;
-  tagint **improper_atom3 = cptr->atom->improper_atom3;
-  tagint **improper_atom4 = cptr->atom->improper_atom4;
-
-  int nlocal = cptr->atom->nlocal;
-
-  // cbuf = list of N deleted atom IDs from other proc, put them in hash
-
-  hash->clear();
-  for (int i = 0; i < nbuf; i++) (*hash)[list[i]] = 1;
+  int nlocal = atom->nlocal;
 
   // loop over my atoms and their bond topology lists
   // if any atom in an interaction matches atom ID in hash, delete interaction
@@ -671,29 +730,6 @@ void DeleteAtoms::bondring(int nbuf, char *cbuf)
   }
 }
 
-/* ----------------------------------------------------------------------
-   callback from comm->ring() in delete_molecule()
-------------------------------------------------------------------------- */
-
-void DeleteAtoms::molring(int n, char *cbuf)
-{
-  tagint *list = (tagint *) cbuf;
-  int *dlist = cptr->dlist;
-  std::map<tagint,int> *hash = cptr->hash;
-  int nlocal = cptr->atom->nlocal;
-  tagint *molecule = cptr->atom->molecule;
-
-  // cbuf = list of N molecule IDs from other proc, put them in hash
-
-  hash->clear();
-  for (int i = 0; i < n; i++) (*hash)[list[i]] = 1;
-
-  // loop over my atoms, if matches molecule ID in hash, delete that atom
-
-  for (int i = 0; i < nlocal; i++)
-    if (hash->find(molecule[i]) != hash->end()) dlist[i] = 1;
-}
-
 /* ----------------------------------------------------------------------
    process command options
 ------------------------------------------------------------------------- */
@@ -42,19 +42,13 @@ class DeleteAtoms : protected Pointers {
 
   void delete_bond();
   void delete_molecule();
+  void delete_topology();
   void recount_topology();
   void options(int, char **);
 
   inline int sbmask(int j) {
     return j >> SBBITS & 3;
   }
-
-  // static variable for ring communication callback to access class data
-  // callback functions for ring communication
-
-  static DeleteAtoms *cptr;
-  static void bondring(int, char *);
-  static void molring(int, char *);
 };
 
 }
@@ -30,12 +30,10 @@
 
 using namespace LAMMPS_NS;
 
-// allocate space for static class variable
-
-Dump *Dump::dumpptr;
-
 #define BIG 1.0e20
 #define EPSILON 1.0e-6
+#define MAXASYNC 2            // # of snapshots queued for writer thread
+#define NSAMPLE 32            // avg # of sort keys per proc sampled for splitters
 
 enum{ASCEND,DESCEND};
 
@@ -80,6 +78,8 @@ Dump::Dump(LAMMPS *lmp, int narg, char **arg) : Pointers(lmp)
   append_flag = 0;
   buffer_allow = 0;
   buffer_flag = 0;
+  async_allow = 0;
+  async_flag = 0;
   padflag = 0;
   pbcflag = 0;
   
@@ -87,6 +87,8 @@ Dump::Dump(LAMMPS *lmp, int narg, char **arg) : Pointers(lmp)
   buf = bufsort = NULL;
   ids = idsort = NULL;
   index = proclist = NULL;
+  keys = keytmp = NULL;
+  indextmp = NULL;
   irregular = NULL;
 
   maxsbuf = 0;
@@ -96,6 +98,11 @@ Dump::Dump(LAMMPS *lmp, int narg, char **arg) : Pointers(lmp)
   xpbc = vpbc = NULL;
   imagepbc = NULL;
 
+  async_running = 0;
+  fpstage = NULL;
+  stagetext = NULL;
+  stagebytes = 0;
+
   // parse filename for special syntax
   // if contains '%', write one file per proc and replace % with proc-ID
   // if contains '*', write one file per timestep and replace * with timestep
@@ -145,6 +152,10 @@ Dump::Dump(LAMMPS *lmp, int narg, char **arg) : Pointers(lmp)
 
 Dump::~Dump()
 {
+  // writer thread must finish pending snapshots before file is closed
+
+  async_stop();
+
   delete [] id;
   delete [] style;
   delete [] filename;
@@ -165,6 +176,9 @@ Dump::~Dump()
   memory->destroy(idsort);
   memory->destroy(index);
   memory->destroy(proclist);
+  memory->destroy(keys);
+  memory->destroy(keytmp);
+  memory->destroy(indextmp);
   delete irregular;
 
   memory->destroy(sbuf);
@@ -201,12 +215,17 @@ void Dump::init()
     memory->destroy(idsort);
     memory->destroy(index);
     memory->destroy(proclist);
+    memory->destroy(keys);
+    memory->destroy(keytmp);
+    memory->destroy(indextmp);
     delete irregular;
 
     maxids = maxsort = maxproc = 0;
     bufsort = NULL;
     ids = idsort = NULL;
     index = proclist = NULL;
+    keys = keytmp = NULL;
+    indextmp = NULL;
     irregular = NULL;
   }
 
@@ -305,6 +324,10 @@ void Dump::write()
 
   if (multifile) openfile();
 
+  // if async, filewriter formats this snapshot into memory via fp
+
+  if (async_flag && filewriter) async_stage();
+
   // simulation box bounds
 
   if (domain->triclinic == 0) {
@@ -438,7 +461,7 @@ void Dump::write()
 
         write_data(nlines,buf);
       }
-      if (flush_flag && fp) fflush(fp);
+      if (flush_flag && fp && !async_flag) fflush(fp);
 
     } else {
       MPI_Recv(&tmp,0,MPI_INT,fileproc,0,world,MPI_STATUS_IGNORE);
@@ -459,7 +482,7 @@ void Dump::write()
 
         write_data(nchars,(double *) sbuf);
       }
-      if (flush_flag && fp) fflush(fp);
+      if (flush_flag && fp && !async_flag) fflush(fp);
 
     } else {
       MPI_Recv(&tmp,0,MPI_INT,fileproc,0,world,MPI_STATUS_IGNORE);
@@ -475,6 +498,14 @@ void Dump::write()
     atom->image = imagehold;
   }
 
+  // if async, queue formatted snapshot for writer thread
+  // it also closes the file if one file per timestep
+
+  if (async_flag && filewriter) {
+    async_push();
+    return;
+  }
+
   // if file per timestep, close file if I am filewriter
 
   if (multifile) {
@@ -560,23 +591,12 @@ void Dump::openfile()
 
 void Dump::sort()
 {
-  int i,iproc;
-  double value;
+  int i;
 
   // if single proc, swap ptrs to buf,ids <-> bufsort,idsort
 
   if (nprocs == 1) {
-    if (nme > maxsort) {
-      maxsort = nme;
-      memory->destroy(bufsort);
-      memory->create(bufsort,maxsort*size_one,"dump:bufsort");
-      memory->destroy(index);
-      memory->create(index,maxsort,"dump:index");
-      if (sortcol == 0) {
-        memory->destroy(idsort);
-        memory->create(idsort,maxsort,"dump:idsort");
-      }
-    }
+    if (nme > maxsort) sort_allocate(nme);
 
     double *dptr = buf;
     buf = bufsort;
@@ -592,17 +612,20 @@ void Dump::sort()
 
   } else {
 
-    // grow proclist if necessary
+    // grow proclist and keys if necessary
 
     if (nme > maxproc) {
       maxproc = nme;
       memory->destroy(proclist);
       memory->create(proclist,maxproc,"dump:proclist");
     }
+    if (nme > maxsort) sort_allocate(nme);
 
     // proclist[i] = which proc Ith datum will be sent to
+    // if reordering on consecutive IDs, split ID range evenly across procs
+    // else sample sort: split by key values sampled from all datums
 
-    if (sortcol == 0) {
+    if (sortcol == 0 && reorderflag) {
       tagint min = MAXTAGINT;
       tagint max = 0;
       for (i = 0; i < nme; i++) {
@@ -618,29 +641,29 @@ void Dump::sort()
       // then iproc == nprocs for largest ID, causing irregular to crash
 
       double range = maxall-minall + 0.5;
-      for (i = 0; i < nme; i++) {
-        iproc = static_cast<int> ((ids[i]-minall)/range * nprocs);
-        proclist[i] = iproc;
-      }
+      for (i = 0; i < nme; i++)
+        proclist[i] = static_cast<int> ((ids[i]-minall)/range * nprocs);
 
     } else {
-      double min = BIG;
-      double max = -BIG;
-      for (i = 0; i < nme; i++) {
-        value = buf[i*size_one + sortcolm1];
-        min = MIN(min,value);
-        max = MAX(max,value);
-      }
-      double minall,maxall;
-      MPI_Allreduce(&min,&minall,1,MPI_DOUBLE,MPI_MIN,world);
-      MPI_Allreduce(&max,&maxall,1,MPI_DOUBLE,MPI_MAX,world);
-      double range = maxall-minall + EPSILON*(maxall-minall);
-      if (range == 0.0) range = EPSILON;
+      uint64_t *splitters = new uint64_t[nprocs];
+      sort_keys(nme,buf,ids,keys);
+      sort_splitters(splitters);
+
+      // datum goes to first proc whose upper splitter exceeds its key
+      // equal keys always go to the same proc
+
       for (i = 0; i < nme; i++) {
-        value = buf[i*size_one + sortcolm1];
-        iproc = static_cast<int> ((value-minall)/range * nprocs);
-        proclist[i] = iproc;
+        int lo = 0;
+        int hi = nprocs-1;
+        while (lo < hi) {
+          int mid = (lo+hi)/2;
+          if (keys[i] < splitters[mid]) hi = mid;
+          else lo = mid+1;
+        }
+        proclist[i] = lo;
       }
+
+      delete [] splitters;
     }
 
     // create comm plan, grow recv bufs if necessary,
@@ -648,18 +671,7 @@ void Dump::sort()
     // if sorting on atom IDs, exchange IDs also
 
     nme = irregular->create_data(nme,proclist);
-
-    if (nme > maxsort) {
-      maxsort = nme;
-      memory->destroy(bufsort);
-      memory->create(bufsort,maxsort*size_one,"dump:bufsort");
-      memory->destroy(index);
-      memory->create(index,maxsort,"dump:index");
-      if (sortcol == 0) {
-        memory->destroy(idsort);
-        memory->create(idsort,maxsort,"dump:idsort");
-      }
-    }
+    if (nme > maxsort) sort_allocate(nme);
 
     irregular->exchange_data((char *) buf,size_one*sizeof(double),
                              (char *) bufsort);
@@ -670,7 +682,7 @@ void Dump::sort()
 
   // if reorder flag is set & total/per-proc counts match pre-computed values,
   // then create index directly from idsort
-  // else quicksort of index using IDs or buf column as comparator
+  // else radix sort of index using IDs or buf column as keys
 
   if (reorderflag) {
     if (ntotal != ntotal_reorder) reorderflag = 0;
@@ -686,11 +698,8 @@ void Dump::sort()
   }
 
   if (!reorderflag) {
-    dumpptr = this;
-    for (i = 0; i < nme; i++) index[i] = i;
-    if (sortcol == 0) qsort(index,nme,sizeof(int),idcompare);
-    else if (sortorder == ASCEND) qsort(index,nme,sizeof(int),bufcompare);
-    else qsort(index,nme,sizeof(int),bufcompare_reverse);
+    sort_keys(nme,bufsort,idsort,keys);
+    radix_sort(nme,keys,keytmp,index,indextmp);
   }
 
   // reset buf size and maxbuf to largest of any post-sort nme values
@@ -713,63 +722,182 @@ void Dump::sort()
 }
 
 /* ----------------------------------------------------------------------
-   compare two atom IDs
-   called via qsort() in sort() method
-   is a static method so access data via dumpptr
+   grow arrays used to sort N datums
+------------------------------------------------------------------------- */
+
+void Dump::sort_allocate(int n)
+{
+  maxsort = n;
+  memory->destroy(bufsort);
+  memory->create(bufsort,maxsort*size_one,"dump:bufsort");
+  memory->destroy(index);
+  memory->create(index,maxsort,"dump:index");
+  memory->destroy(indextmp);
+  memory->create(indextmp,maxsort,"dump:indextmp");
+  memory->destroy(keys);
+  memory->create(keys,maxsort,"dump:keys");
+  memory->destroy(keytmp);
+  memory->create(keytmp,maxsort,"dump:keytmp");
+  if (sortcol == 0) {
+    memory->destroy(idsort);
+    memory->create(idsort,maxsort,"dump:idsort");
+  }
+}
+
+/* ----------------------------------------------------------------------
+   convert N sort values to unsigned keys whose order is the sort order
+   atom IDs are used as is
+   column values are doubles: flip sign bit of positive values and all
+     bits of negative values, so unsigned order = numeric order,
+     then flip all bits for DESCEND
 ------------------------------------------------------------------------- */
 
-int Dump::idcompare(const void *pi, const void *pj)
+void Dump::sort_keys(int n, double *data, tagint *idlist, uint64_t *key)
 {
-  tagint *idsort = dumpptr->idsort;
+  int i;
+
+  if (sortcol == 0) {
+    for (i = 0; i < n; i++) key[i] = idlist[i];
+    return;
+  }
 
-  int i = *((int *) pi);
-  int j = *((int *) pj);
+  const uint64_t signbit = ((uint64_t) 1) << 63;
+  uint64_t flip = 0;
+  if (sortorder == DESCEND) flip = ~flip;
 
-  if (idsort[i] < idsort[j]) return -1;
-  if (idsort[i] > idsort[j]) return 1;
-  return 0;
+  uint64_t bits;
+  for (i = 0; i < n; i++) {
+    memcpy(&bits,&data[i*size_one + sortcolm1],sizeof(uint64_t));
+    if (bits & signbit) bits = ~bits;
+    else bits |= signbit;
+    key[i] = bits ^ flip;
+  }
 }
 
 /* ----------------------------------------------------------------------
-   compare two buffer values with size_one stride
-   called via qsort() in sort() method
-   is a static method so access data via dumpptr
-   sort in ASCENDing order
+   choose nprocs-1 splitters from keys of all datums
+   each proc samples its keys in proportion to its share of ntotal
+   proc 0 sorts the samples and picks evenly spaced ones
+   splitters[i] = upper bound on keys sent to proc i
 ------------------------------------------------------------------------- */
 
-int Dump::bufcompare(const void *pi, const void *pj)
+void Dump::sort_splitters(uint64_t *splitters)
 {
-  double *bufsort = dumpptr->bufsort;
-  int size_one = dumpptr->size_one;
-  int sortcolm1 = dumpptr->sortcolm1;
+  int i;
+
+  int nsample = 0;
+  if (ntotal) nsample = static_cast<int> ((bigint) nme*NSAMPLE*nprocs/ntotal);
+  nsample = MIN(nsample,nme);
+  if (nme && nsample == 0) nsample = 1;
+
+  uint64_t *sample = new uint64_t[nsample];
+  for (i = 0; i < nsample; i++)
+    sample[i] = keys[(bigint) i*nme/nsample];
+
+  int *recvcounts = NULL;
+  int *displs = NULL;
+  uint64_t *allsample = NULL;
+  uint64_t *alltmp = NULL;
+  int *order = NULL;
+  int *ordertmp = NULL;
+  int nall = 0;
+
+  int nbytes = nsample*sizeof(uint64_t);
+  if (me == 0) {
+    memory->create(recvcounts,nprocs,"dump:recvcounts");
+    memory->create(displs,nprocs,"dump:displs");
+  }
+  MPI_Gather(&nbytes,1,MPI_INT,recvcounts,1,MPI_INT,0,world);
+  if (me == 0) {
+    for (i = 0; i < nprocs; i++) {
+      displs[i] = nall*sizeof(uint64_t);
+      nall += recvcounts[i]/sizeof(uint64_t);
+    }
+    memory->create(allsample,nall,"dump:allsample");
+  }
+  MPI_Gatherv(sample,nbytes,MPI_BYTE,allsample,recvcounts,displs,MPI_BYTE,
+              0,world);
+
+  if (me == 0) {
+    memory->create(alltmp,nall,"dump:alltmp");
+    memory->create(order,nall,"dump:order");
+    memory->create(ordertmp,nall,"dump:ordertmp");
+    radix_sort(nall,allsample,alltmp,order,ordertmp);
+
+    for (i = 0; i < nprocs-1; i++) {
+      if (nall) splitters[i] = allsample[(bigint) (i+1)*nall/nprocs];
+      else splitters[i] = 0;
+    }
 
-  int i = *((int *) pi)*size_one + sortcolm1;
-  int j = *((int *) pj)*size_one + sortcolm1;
+    memory->destroy(recvcounts);
+    memory->destroy(displs);
+    memory->destroy(allsample);
+    memory->destroy(alltmp);
+    memory->destroy(order);
+    memory->destroy(ordertmp);
+  }
 
-  if (bufsort[i] < bufsort[j]) return -1;
-  if (bufsort[i] > bufsort[j]) return 1;
-  return 0;
+  MPI_Bcast(splitters,(nprocs-1)*sizeof(uint64_t),MPI_BYTE,0,world);
+  delete [] sample;
 }
 
 /* ----------------------------------------------------------------------
-   compare two buffer values with size_one stride
-   called via qsort() in sort() method
-   is a static method so access data via dumpptr
-   sort in DESCENDing order
+   LSD radix sort of N keys, one byte per pass
+   returns key sorted in ascending order and
+     order = original indices of sorted keys
+   keytmp and ordertmp are scratch buffers of length N
+   passes where all keys have the same byte are skipped
 ------------------------------------------------------------------------- */
 
-int Dump::bufcompare_reverse(const void *pi, const void *pj)
+void Dump::radix_sort(int n, uint64_t *key, uint64_t *keytmp,
+                      int *order, int *ordertmp)
 {
-  double *bufsort = dumpptr->bufsort;
-  int size_one = dumpptr->size_one;
-  int sortcolm1 = dumpptr->sortcolm1;
+  int i,count[256];
+
+  for (i = 0; i < n; i++) order[i] = i;
+  if (n < 2) return;
 
-  int i = *((int *) pi)*size_one + sortcolm1;
-  int j = *((int *) pj)*size_one + sortcolm1;
+  // bits = bits that differ between any key and the first one
 
-  if (bufsort[i] > bufsort[j]) return -1;
-  if (bufsort[i] < bufsort[j]) return 1;
-  return 0;
+  uint64_t bits = 0;
+  for (i = 1; i < n; i++) bits |= key[i] ^ key[0];
+
+  uint64_t *kin = key;
+  uint64_t *kout = keytmp;
+  int *oin = order;
+  int *oout = ordertmp;
+
+  for (int shift = 0; shift < 64; shift += 8) {
+    if (((bits >> shift) & 0xff) == 0) continue;
+
+    for (i = 0; i < 256; i++) count[i] = 0;
+    for (i = 0; i < n; i++) count[(kin[i] >> shift) & 0xff]++;
+
+    int m,sum = 0;
+    for (i = 0; i < 256; i++) {
+      m = count[i];
+      count[i] = sum;
+      sum += m;
+    }
+
+    for (i = 0; i < n; i++) {
+      m = count[(kin[i] >> shift) & 0xff]++;
+      kout[m] = kin[i];
+      oout[m] = oin[i];
+    }
+
+    uint64_t *kswap = kin;
+    kin = kout;
+    kout = kswap;
+    int *oswap = oin;
+    oin = oout;
+    oout = oswap;
+  }
+
+  if (kin != key) {
+    memcpy(key,kin,n*sizeof(uint64_t));
+    memcpy(order,oin,n*sizeof(int));
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -790,6 +918,21 @@ void Dump::modify_params(int narg, char **arg)
       else error->all(FLERR,"Illegal dump_modify command");
       iarg += 2;
 
+    } else if (strcmp(arg[iarg],"async") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal dump_modify command");
+      if (strcmp(arg[iarg+1],"yes") == 0) async_flag = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) async_flag = 0;
+      else error->all(FLERR,"Illegal dump_modify command");
+      if (async_flag && (async_allow == 0 || strstr(style,"mpiio")))
+        error->all(FLERR,"Dump_modify async yes not allowed for this style");
+#if !defined(LAMMPS_ASYNC_DUMP)
+      if (async_flag)
+        error->all(FLERR,"Dump_modify async yes requires LAMMPS "
+                   "be built with -DLAMMPS_ASYNC_DUMP");
+#endif
+      if (!async_flag) async_stop();
+      iarg += 2;
+
     } else if (strcmp(arg[iarg],"buffer") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal dump_modify command");
       if (strcmp(arg[iarg+1],"yes") == 0) buffer_flag = 1;
@@ -967,6 +1110,166 @@ void Dump::modify_params(int narg, char **arg)
   }
 }
 
+/* ----------------------------------------------------------------------
+   start writer thread with empty queue of snapshots
+   only called on filewriter procs
+------------------------------------------------------------------------- */
+
+void Dump::async_start()
+{
+#if defined(LAMMPS_ASYNC_DUMP)
+  frames = (AsyncFrame *)
+    memory->smalloc(MAXASYNC*sizeof(AsyncFrame),"dump:frames");
+  nframes = iframe = 0;
+  async_exit = 0;
+
+  pthread_mutex_init(&async_mutex,NULL);
+  pthread_cond_init(&async_cond,NULL);
+  if (pthread_create(&writer,NULL,&async_loop,this))
+    error->one(FLERR,"Could not create dump writer thread");
+  async_running = 1;
+#endif
+}
+
+/* ----------------------------------------------------------------------
+   wait for writer thread to drain queue of snapshots, then stop it
+   OK to call if thread was never started
+------------------------------------------------------------------------- */
+
+void Dump::async_stop()
+{
+#if defined(LAMMPS_ASYNC_DUMP)
+  if (!async_running) return;
+
+  pthread_mutex_lock(&async_mutex);
+  async_exit = 1;
+  pthread_cond_broadcast(&async_cond);
+  pthread_mutex_unlock(&async_mutex);
+  pthread_join(writer,NULL);
+
+  pthread_mutex_destroy(&async_mutex);
+  pthread_cond_destroy(&async_cond);
+  memory->sfree(frames);
+  frames = NULL;
+  async_running = 0;
+#endif
+}
+
+/* ----------------------------------------------------------------------
+   redirect fp to a memory stream so write_header() and write_data()
+   format the snapshot into memory instead of the file
+------------------------------------------------------------------------- */
+
+void Dump::async_stage()
+{
+#if defined(LAMMPS_ASYNC_DUMP)
+  if (!async_running) async_start();
+
+  fpstage = fp;
+  fp = open_memstream(&stagetext,&stagebytes);
+  if (fp == NULL) error->one(FLERR,"Could not open dump staging stream");
+#endif
+}
+
+/* ----------------------------------------------------------------------
+   hand snapshot formatted by async_stage() to writer thread
+   block while queue is full, so simulation only waits on a slow file
+   for one file per timestep, file is now owned by writer thread
+------------------------------------------------------------------------- */
+
+void Dump::async_push()
+{
+#if defined(LAMMPS_ASYNC_DUMP)
+  fclose(fp);
+  fp = fpstage;
+  fpstage = NULL;
+
+  AsyncFrame frame;
+  frame.text = stagetext;
+  frame.nbytes = stagebytes;
+  frame.handle = async_handle();
+  frame.flush = flush_flag;
+  frame.close = multifile;
+  stagetext = NULL;
+  stagebytes = 0;
+  if (multifile) fp = NULL;
+
+  pthread_mutex_lock(&async_mutex);
+  while (nframes == MAXASYNC) pthread_cond_wait(&async_cond,&async_mutex);
+  frames[(iframe+nframes) % MAXASYNC] = frame;
+  nframes++;
+  pthread_cond_broadcast(&async_cond);
+  pthread_mutex_unlock(&async_mutex);
+#endif
+}
+
+/* ----------------------------------------------------------------------
+   writer thread: write queued snapshots in order until told to exit
+   is a static method so access data via ptr to Dump
+   does no MPI and calls no error methods
+------------------------------------------------------------------------- */
+
+#if defined(LAMMPS_ASYNC_DUMP)
+
+void *Dump::async_loop(void *ptr)
+{
+  Dump *dump = (Dump *) ptr;
+  AsyncFrame frame;
+
+  pthread_mutex_lock(&dump->async_mutex);
+  while (1) {
+    while (dump->nframes == 0 && !dump->async_exit)
+      pthread_cond_wait(&dump->async_cond,&dump->async_mutex);
+    if (dump->nframes == 0) break;
+    frame = dump->frames[dump->iframe];
+    pthread_mutex_unlock(&dump->async_mutex);
+
+    if (frame.nbytes) dump->async_write(frame.handle,frame.text,frame.nbytes);
+    if (frame.close) dump->async_close(frame.handle);
+    else if (frame.flush) dump->async_flush(frame.handle);
+    free(frame.text);
+
+    // frame is only released once written, so queue depth bounds
+    // the # of snapshots held in memory
+
+    pthread_mutex_lock(&dump->async_mutex);
+    dump->iframe = (dump->iframe+1) % MAXASYNC;
+    dump->nframes--;
+    pthread_cond_broadcast(&dump->async_cond);
+  }
+  pthread_mutex_unlock(&dump->async_mutex);
+
+  return NULL;
+}
+
+#endif
+
+/* ----------------------------------------------------------------------
+   output of queued snapshots by writer thread
+   default is file opened by Dump::openfile()
+   styles which write via another file handle override these
+------------------------------------------------------------------------- */
+
+void Dump::async_write(void *handle, char *text, size_t nbytes)
+{
+  fwrite(text,sizeof(char),nbytes,(FILE *) handle);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Dump::async_flush(void *handle)
+{
+  fflush((FILE *) handle);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Dump::async_close(void *handle)
+{
+  if (compressed) pclose((FILE *) handle);
+  else fclose((FILE *) handle);
+}
+
 /* ----------------------------------------------------------------------
    return # of bytes of allocated memory
 ------------------------------------------------------------------------- */
@@ -995,6 +1298,8 @@ bigint Dump::memory_usage()
     bytes += memory->usage(bufsort,size_one*maxsort);
     if (sortcol == 0) bytes += memory->usage(idsort,maxsort);
     bytes += memory->usage(index,maxsort);
+    bytes += memory->usage(indextmp,maxsort);
+    bytes += 2*maxsort * sizeof(uint64_t);
     bytes += memory->usage(proclist,maxproc);
     if (irregular) bytes += irregular->memory_usage();
   }
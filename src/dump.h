@@ -18,6 +18,10 @@
 #include <stdio.h>
 #include "pointers.h"
 
+#if defined(LAMMPS_ASYNC_DUMP)
+#include <pthread.h>
+#endif
+
 namespace LAMMPS_NS {
 
 class Dump : protected Pointers {
@@ -33,10 +37,6 @@ class Dump : protected Pointers {
   int comm_forward;          // size of forward communication (0 if none)
   int comm_reverse;          // size of reverse communication (0 if none)
 
-  // static variable across all Dump objects
-
-  static Dump *dumpptr;         // holds a ptr to Dump currently being used
-
   Dump(class LAMMPS *, int, char **);
   virtual ~Dump();
   void init();
@@ -70,6 +70,8 @@ class Dump : protected Pointers {
   int append_flag;           // 1 if open file in append mode, 0 if not
   int buffer_allow;          // 1 if style allows for buffer_flag, 0 if not
   int buffer_flag;           // 1 if buffer output as one big string, 0 if not
+  int async_allow;           // 1 if style allows for async_flag, 0 if not
+  int async_flag;            // 1 if file output is done by writer thread
   int padflag;               // timestep padding in filename
   int pbcflag;               // 1 if remap dumped atoms via PBC, 0 if not
   int singlefile_opened;     // 1 = one big file, already opened, else 0
@@ -110,12 +112,14 @@ class Dump : protected Pointers {
   char *sbuf;                // memory for atom quantities in string format
 
   int maxids;                // size of ids
-  int maxsort;               // size of bufsort, idsort, index
+  int maxsort;               // size of bufsort, idsort, index, sort keys
   int maxproc;               // size of proclist
   tagint *ids;               // list of atom IDs, if sorting on IDs
   double *bufsort;
   tagint *idsort;
   int *index,*proclist;
+  uint64_t *keys,*keytmp;    // radix sort keys of datums, scratch copy
+  int *indextmp;             // scratch copy of index for radix sort
 
   double **xpbc,**vpbc;
   imageint *imagepbc;
@@ -123,6 +127,41 @@ class Dump : protected Pointers {
 
   class Irregular *irregular;
 
+  // async output: filewriter formats each snapshot into memory,
+  // writer thread drains a bounded queue of snapshots to the file
+
+  struct AsyncFrame {
+    char *text;              // formatted snapshot, malloc() by open_memstream
+    size_t nbytes;           // # of bytes in text
+    void *handle;            // open file to write it to
+    int flush;               // 1 to flush file after write
+    int close;               // 1 to close file after write
+  };
+
+  int async_running;         // 1 if writer thread has been started
+  FILE *fpstage;             // fp of open file while fp is staging stream
+  char *stagetext;           // staging stream buffer and size
+  size_t stagebytes;
+
+#if defined(LAMMPS_ASYNC_DUMP)
+  AsyncFrame *frames;        // circular queue of pending snapshots
+  int nframes,iframe;        // # of pending snapshots, index of oldest
+  int async_exit;            // 1 if writer thread should exit when drained
+  pthread_t writer;
+  pthread_mutex_t async_mutex;
+  pthread_cond_t async_cond;
+  static void *async_loop(void *);
+#endif
+
+  void async_start();
+  void async_stop();
+  void async_stage();
+  void async_push();
+  virtual void *async_handle() {return fp;}
+  virtual void async_write(void *, char *, size_t);
+  virtual void async_flush(void *);
+  virtual void async_close(void *);
+
   virtual void init_style() = 0;
   virtual void openfile();
   virtual int modify_param(int, char **) {return 0;}
@@ -134,9 +173,10 @@ class Dump : protected Pointers {
   void pbc_allocate();
     
   void sort();
-  static int idcompare(const void *, const void *);
-  static int bufcompare(const void *, const void *);
-  static int bufcompare_reverse(const void *, const void *);
+  void sort_allocate(int);
+  void sort_keys(int, double *, tagint *, uint64_t *);
+  void sort_splitters(uint64_t *);
+  static void radix_sort(int, uint64_t *, uint64_t *, int *, int *);
 };
 
 }
@@ -196,6 +236,24 @@ E: Dump_modify buffer yes not allowed for this style
 
 Self-explanatory.
 
+E: Dump_modify async yes not allowed for this style
+
+Self-explanatory.
+
+E: Dump_modify async yes requires LAMMPS be built with -DLAMMPS_ASYNC_DUMP
+
+The writer thread used by asynchronous dump output is only
+compiled in with this setting.
+
+E: Could not create dump writer thread
+
+The pthread_create() call failed.
+
+E: Could not open dump staging stream
+
+The open_memstream() call used to format a snapshot in memory
+failed.
+
 E: Cannot use dump_modify fileper without % in dump file name
 
 Self-explanatory.
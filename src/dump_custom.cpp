@@ -80,6 +80,7 @@ DumpCustom::DumpCustom(LAMMPS *lmp, int narg, char **arg) :
 
   buffer_allow = 1;
   buffer_flag = 1;
+  async_allow = 1;
   iregion = -1;
   idregion = NULL;
   nthresh = 0;
@@ -53,6 +53,10 @@ DumpImage::DumpImage(LAMMPS *lmp, int narg, char **arg) :
 {
   if (binary || multiproc) error->all(FLERR,"Invalid dump image filename");
 
+  // images are written by write() of this style, not by a writer thread
+
+  async_allow = 0;
+
   // force binary flag on to avoid corrupted output on Windows
 
   binary = 1;
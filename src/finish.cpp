@@ -769,6 +769,18 @@ void Finish::end(int flag)
           fprintf(screen,"Dangerous builds = " BIGINT_FORMAT "\n",
                   neighbor->ndanger);
         else fprintf(screen,"Dangerous builds not checked\n");
+        if (neighbor->dist_check && neighbor->predict)
+          fprintf(screen,"Skipped distance checks = " BIGINT_FORMAT "\n",
+                  neighbor->nskip);
+        if (neighbor->tune) {
+          fprintf(screen,"Neighbor skin tuning: skin %g -> %g, "
+                  "delay %d -> %d, %d adjustments\n",
+                  neighbor->tune_skin0,neighbor->skin,
+                  neighbor->tune_delay0,neighbor->delay,neighbor->ntune);
+          if (neighbor->tune_revert)
+            fprintf(screen,"Neighbor skin tuning stopped after "
+                    "a slower step time\n");
+        }
       }
       if (logfile) {
         if (nall < 2.0e9)
@@ -786,6 +798,18 @@ void Finish::end(int flag)
           fprintf(logfile,"Dangerous builds = " BIGINT_FORMAT "\n",
                   neighbor->ndanger);
         else fprintf(logfile,"Dangerous builds not checked\n");
+        if (neighbor->dist_check && neighbor->predict)
+          fprintf(logfile,"Skipped distance checks = " BIGINT_FORMAT "\n",
+                  neighbor->nskip);
+        if (neighbor->tune) {
+          fprintf(logfile,"Neighbor skin tuning: skin %g -> %g, "
+                  "delay %d -> %d, %d adjustments\n",
+                  neighbor->tune_skin0,neighbor->skin,
+                  neighbor->tune_delay0,neighbor->delay,neighbor->ntune);
+          if (neighbor->tune_revert)
+            fprintf(logfile,"Neighbor skin tuning stopped after "
+                    "a slower step time\n");
+        }
       }
     }
   }
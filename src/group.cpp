@@ -45,10 +45,6 @@ enum{LT,LE,GT,GE,EQ,NEQ,BETWEEN};
 
 #define BIG 1.0e20
 
-// allocate space for static class variable
-
-Group *Group::cptr;
-
 /* ----------------------------------------------------------------------
    initialize group memory
 ------------------------------------------------------------------------- */
@@ -643,46 +639,44 @@ void Group::add_molecules(int igroup, int bit)
       if (hash->find(molecule[i]) == hash->end()) (*hash)[molecule[i]] = 1;
     }
 
-  // list = set of unique molecule IDs for atoms to add
-  // pass list to all other procs via comm->ring()
+  // keys = unique molecule IDs of atoms already in group
+  // queries = molecule IDs of my atoms not yet in group
+  // rendezvous lookup returns queried IDs of molecules in group
 
-  int n = hash->size();
-  tagint *list;
-  memory->create(list,n,"group:list");
+  int nkey = hash->size();
+  int nquery = 0;
+  for (int i = 0; i < nlocal; i++)
+    if (!(mask[i] & bit) && molecule[i]) nquery++;
 
-  n = 0;
+  tagint *keys,*queries;
+  memory->create(keys,nkey,"group:keys");
+  memory->create(queries,nquery,"group:queries");
+
+  nkey = 0;
   std::map<tagint,int>::iterator pos;
-  for (pos = hash->begin(); pos != hash->end(); ++pos) list[n++] = pos->first;
+  for (pos = hash->begin(); pos != hash->end(); ++pos)
+    keys[nkey++] = pos->first;
 
-  cptr = this;
-  molbit = bit;
-  comm->ring(n,sizeof(tagint),list,1,molring,NULL);
+  nquery = 0;
+  for (int i = 0; i < nlocal; i++)
+    if (!(mask[i] & bit) && molecule[i]) queries[nquery++] = molecule[i];
 
-  delete hash;
-  memory->destroy(list);
-}
+  tagint *result;
+  int nfound = comm->rendezvous_lookup(nkey,keys,keys,nquery,queries,result);
 
-/* ----------------------------------------------------------------------
-   callback from comm->ring()
-   cbuf = list of N molecule IDs, put them in hash
-   loop over my atoms, if matches molecule ID in hash,
-     add atom to group flagged by molbit
-------------------------------------------------------------------------- */
+  memory->destroy(keys);
+  memory->destroy(queries);
 
-void Group::molring(int n, char *cbuf)
-{
-  tagint *list = (tagint *) cbuf;
-  std::map<tagint,int> *hash = cptr->hash;
-  int nlocal = cptr->atom->nlocal;
-  tagint *molecule = cptr->atom->molecule;
-  int *mask = cptr->atom->mask;
-  int molbit = cptr->molbit;
+  // loop over my atoms, if molecule ID was returned, add atom to group
 
   hash->clear();
-  for (int i = 0; i < n; i++) (*hash)[list[i]] = 1;
+  for (int i = 0; i < nfound; i++) (*hash)[result[2*i]] = 1;
+  memory->destroy(result);
 
   for (int i = 0; i < nlocal; i++)
-    if (hash->find(molecule[i]) != hash->end()) mask[i] |= molbit;
+    if (hash->find(molecule[i]) != hash->end()) mask[i] |= bit;
+
+  delete hash;
 }
 
 /* ----------------------------------------------------------------------
@@ -69,13 +69,6 @@ class Group : protected Pointers {
 
   int find_unused();
   void add_molecules(int, int);
-
-  // static variable for ring communication callback to access class data
-  // callback functions for ring communication
-
-  static Group *cptr;
-  static void molring(int, char *);
-  int molbit;
 };
 
 }
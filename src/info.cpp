@@ -104,7 +104,7 @@ static const char *varstyles[] = {
 
 static const char *mapstyles[] = { "none", "array", "hash" };
 
-static const char *commstyles[] = { "brick", "tiled" };
+static const char *commstyles[] = { "brick", "tiled", "brick/direct" };
 static const char *commlayout[] = { "uniform", "nonuniform", "irregular" };
 
 static const char bstyles[] = "pfsm";
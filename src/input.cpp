@@ -26,6 +26,7 @@
 #include "atom_vec.h"
 #include "comm.h"
 #include "comm_brick.h"
+#include "comm_brick_direct.h"
 #include "comm_tiled.h"
 #include "group.h"
 #include "domain.h"
@@ -1461,6 +1462,11 @@ void Input::comm_style()
     Comm *oldcomm = comm;
     comm = new CommBrick(lmp,oldcomm);
     delete oldcomm;
+  } else if (strcmp(arg[0],"brick/direct") == 0) {
+    if (comm->style == 2) return;
+    Comm *oldcomm = comm;
+    comm = new CommBrickDirect(lmp,oldcomm);
+    delete oldcomm;
   } else if (strcmp(arg[0],"tiled") == 0) {
     if (comm->style == 1) return;
     Comm *oldcomm = comm;
@@ -12,6 +12,7 @@
 ------------------------------------------------------------------------- */
 
 #include <stdlib.h>
+#include <string.h>
 #include "integrate.h"
 #include "update.h"
 #include "force.h"
@@ -19,6 +20,7 @@
 #include "kspace.h"
 #include "modify.h"
 #include "compute.h"
+#include "error.h"
 
 using namespace LAMMPS_NS;
 
@@ -54,6 +56,12 @@ void Integrate::init()
   if (force->kspace && force->kspace->compute_flag) kspace_compute_flag = 1;
   else kspace_compute_flag = 0;
 
+  // only Verlet applies kspace forces on every Nth step
+
+  if (kspace_compute_flag && force->kspace->every > 1 &&
+      strcmp(update->integrate_style,"verlet") != 0)
+    error->all(FLERR,"Kspace_modify every requires run_style verlet");
+
   // should add checks:
   // for any acceleration package that has its own integrate/minimize
   // in case input script has reset the run or minimize style explicitly
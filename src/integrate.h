@@ -55,4 +55,9 @@ class Integrate : protected Pointers {
 
 /* ERROR/WARNING messages:
 
+E: Kspace_modify every requires run_style verlet
+
+Applying KSpace forces every N timesteps is only implemented by the
+standard run_style verlet.
+
 */
@@ -38,6 +38,7 @@ KSpace::KSpace(LAMMPS *lmp, int narg, char **arg) : Pointers(lmp)
   triclinic_support = 1;
   ewaldflag = pppmflag = msmflag = dispersionflag = tip4pflag = dipoleflag = 0;
   compute_flag = 1;
+  every = 1;
   group_group_enable = 0;
   stagger_flag = 0;
 
@@ -506,6 +507,11 @@ void KSpace::modify_params(int narg, char **arg)
       else if (strcmp(arg[iarg+1],"no") == 0) compute_flag = 0;
       else error->all(FLERR,"Illegal kspace_modify command");
       iarg += 2;
+    } else if (strcmp(arg[iarg],"every") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal kspace_modify command");
+      every = force->inumeric(FLERR,arg[iarg+1]);
+      if (every <= 0) error->all(FLERR,"Illegal kspace_modify command");
+      iarg += 2;
     } else if (strcmp(arg[iarg],"fftbench") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal kspace_modify command");
       if (strcmp(arg[iarg+1],"yes") == 0) fftbench = 1;
@@ -516,6 +522,7 @@ void KSpace::modify_params(int narg, char **arg)
       if (iarg+2 > narg) error->all(FLERR,"Illegal kspace_modify command");
       if (strcmp(arg[iarg+1],"yes") == 0) collective_flag = 1;
       else if (strcmp(arg[iarg+1],"no") == 0) collective_flag = 0;
+      else if (strcmp(arg[iarg+1],"pencil") == 0) collective_flag = 2;
       else error->all(FLERR,"Illegal kspace_modify command");
       iarg += 2;
     } else if (strcmp(arg[iarg],"diff") == 0) {
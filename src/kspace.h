@@ -87,8 +87,10 @@ class KSpace : protected Pointers {
   int copymode;
 
   int compute_flag;               // 0 if skip compute()
+  int every;                      // apply forces every this many steps
   int fftbench;                   // 0 if skip FFT timing
   int collective_flag;            // 1 if use MPI collectives for FFT/remap
+                                  // 2 if Alltoallv in rows/cols of FFT procs
   int stagger_flag;               // 1 if using staggered PPPM grids
 
   double splittol;                // tolerance for when to truncate splitting
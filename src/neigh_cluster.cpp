@@ -0,0 +1,311 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "neighbor.h"
+#include "neigh_list.h"
+#include "atom.h"
+#include "atom_vec.h"
+#include "molecule.h"
+#include "domain.h"
+#include "my_page.h"
+#include "memory.h"
+#include "error.h"
+
+using namespace LAMMPS_NS;
+
+#define MAX(a,b) ((a) > (b) ? (a) : (b))
+#define MIN(a,b) ((a) < (b) ? (a) : (b))
+
+/* ----------------------------------------------------------------------
+   binned cluster-pair neighbor list construction with Newton's 3rd law
+------------------------------------------------------------------------- */
+
+void Neighbor::half_bin_cluster_newton(NeighList *list)
+{
+  half_bin_cluster(list,1);
+}
+
+/* ----------------------------------------------------------------------
+   binned cluster-pair neighbor list construction with partial Newton's 3rd law
+------------------------------------------------------------------------- */
+
+void Neighbor::half_bin_cluster_no_newton(NeighList *list)
+{
+  half_bin_cluster(list,0);
+}
+
+/* ----------------------------------------------------------------------
+   binned cluster-pair neighbor list construction
+   atoms are packed into clusters of NCLUSTER atoms
+     walking each row of bins along x, owned and ghost atoms separately,
+     a cluster spans at most 2 bins in x
+   each owned cluster stores (J cluster, mask) pairs for all clusters
+     whose bounding box is within cutneighmax of its own
+   bit a*NCLUSTER+b of mask is set if atom a of the I cluster
+     interacts with atom b of the J cluster as a regular half list would:
+     pair of owned atoms stored once,
+     pair with ghost stored if newton off or j is "above and to the right",
+     within cutneighsq, not excluded, and not a special pair
+   special pairs are stored in ilist/numneigh/firstneigh with their
+     special bits, so pair styles can loop over them as a regular list
+------------------------------------------------------------------------- */
+
+void Neighbor::half_bin_cluster(NeighList *list, int newton)
+{
+  int i,j,k,m,n,a,b,c,ci,cj,ix,iy,iz,jx,jy,jz,ibin,ixfirst;
+  int itype,jtype,which,imol,iatom,moltemplate,bits;
+  tagint tagprev;
+  double xtmp,ytmp,ztmp,delx,dely,delz,rsq;
+  int *neighptr;
+
+  // bin local & ghost atoms
+
+  if (binatomflag) bin_atoms();
+
+  double **x = atom->x;
+  int *type = atom->type;
+  int *mask = atom->mask;
+  tagint *tag = atom->tag;
+  tagint *molecule = atom->molecule;
+  tagint **special = atom->special;
+  int **nspecial = atom->nspecial;
+  int nlocal = atom->nlocal;
+  int nall = nlocal + atom->nghost;
+
+  int *molindex = atom->molindex;
+  int *molatom = atom->molatom;
+  Molecule **onemols = atom->avec->onemols;
+  int molecular = atom->molecular;
+  if (molecular == 2) moltemplate = 1;
+  else moltemplate = 0;
+
+  // pack owned atoms into clusters, then ghost atoms
+  // owned atoms precede ghost atoms in each bin's linked list
+
+  list->grow_cluster(2*nall/NCLUSTER + 1);
+  int *catom = list->catom;
+  double *cbox = list->cbox;
+
+  int ncluster = 0;
+  c = 0;
+  double *box = NULL;
+
+  for (int ghost = 0; ghost <= 1; ghost++) {
+    for (iz = 0; iz < mbinz; iz++)
+      for (iy = 0; iy < mbiny; iy++) {
+        m = NCLUSTER;
+        ixfirst = 0;
+        for (ix = 0; ix < mbinx; ix++) {
+          ibin = iz*mbiny*mbinx + iy*mbinx + ix;
+          for (i = binhead[ibin]; i >= 0; i = bins[i]) {
+            if (i < nlocal) {
+              if (ghost) continue;
+            } else if (!ghost) break;
+
+            if (m == NCLUSTER || ix-ixfirst > 1) {
+              if (ncluster == list->maxcluster) {
+                list->grow_cluster(2*list->maxcluster);
+                catom = list->catom;
+                cbox = list->cbox;
+              }
+              c = ncluster++;
+              for (k = 0; k < NCLUSTER; k++) catom[c*NCLUSTER+k] = -1;
+              box = &cbox[6*c];
+              box[0] = box[3] = x[i][0];
+              box[1] = box[4] = x[i][1];
+              box[2] = box[5] = x[i][2];
+              ixfirst = ix;
+              m = 0;
+            }
+
+            catom[c*NCLUSTER+m++] = i;
+            box[0] = MIN(box[0],x[i][0]);
+            box[1] = MIN(box[1],x[i][1]);
+            box[2] = MIN(box[2],x[i][2]);
+            box[3] = MAX(box[3],x[i][0]);
+            box[4] = MAX(box[4],x[i][1]);
+            box[5] = MAX(box[5],x[i][2]);
+          }
+        }
+      }
+    if (!ghost) list->nclusterlocal = ncluster;
+  }
+
+  list->ncluster = ncluster;
+  int nclusterlocal = list->nclusterlocal;
+
+  // bin clusters by the center of their bounding box
+  // bin in reverse order so linked list will be in forward order
+  // extent = largest half width of any cluster in each dim
+
+  if (mbins > list->maxhead_cluster) {
+    list->maxhead_cluster = mbins;
+    memory->destroy(list->cbinhead);
+    memory->create(list->cbinhead,mbins,"neighlist:cbinhead");
+  }
+  int *cbinhead = list->cbinhead;
+  int *cbins = list->cbins;
+
+  for (i = 0; i < mbins; i++) cbinhead[i] = -1;
+
+  double center[3];
+  double extent[3] = {0.0,0.0,0.0};
+
+  for (c = ncluster-1; c >= 0; c--) {
+    box = &cbox[6*c];
+    for (k = 0; k < 3; k++) {
+      center[k] = 0.5*(box[k]+box[k+3]);
+      extent[k] = MAX(extent[k],0.5*(box[k+3]-box[k]));
+    }
+    ibin = coord2bin(center);
+    cbins[c] = cbinhead[ibin];
+    cbinhead[ibin] = c;
+  }
+
+  // # of bins to search in each dim so no J cluster within cutoff is missed
+
+  int sx = static_cast<int> ((cutneighmax + 2.0*extent[0])*bininvx) + 1;
+  int sy = static_cast<int> ((cutneighmax + 2.0*extent[1])*bininvy) + 1;
+  int sz = static_cast<int> ((cutneighmax + 2.0*extent[2])*bininvz) + 1;
+  if (domain->dimension == 2) sz = 0;
+
+  int *ilist = list->ilist;
+  int *numneigh = list->numneigh;
+  int **firstneigh = list->firstneigh;
+  MyPage<int> *ipage = list->ipage;
+  int *cnumneigh = list->cnumneigh;
+  int **cfirstneigh = list->cfirstneigh;
+  MyPage<int> *cpage = list->cpage;
+  int *cspecial = list->cspecial;
+  int oneatom = list->oneatom;
+  int nsp[NCLUSTER];
+
+  int inum = 0;
+  ipage->reset();
+  cpage->reset();
+
+  // loop over each owned cluster, storing neighbor clusters
+
+  for (ci = 0; ci < nclusterlocal; ci++) {
+    n = 0;
+    neighptr = cpage->vget();
+    for (a = 0; a < NCLUSTER; a++) nsp[a] = 0;
+
+    double *ibox = &cbox[6*ci];
+    for (k = 0; k < 3; k++) center[k] = 0.5*(ibox[k]+ibox[k+3]);
+    coord2bin(center,ix,iy,iz);
+
+    for (jz = MAX(iz-sz,0); jz <= MIN(iz+sz,mbinz-1); jz++)
+      for (jy = MAX(iy-sy,0); jy <= MIN(iy+sy,mbiny-1); jy++)
+        for (jx = MAX(ix-sx,0); jx <= MIN(ix+sx,mbinx-1); jx++) {
+          ibin = jz*mbiny*mbinx + jy*mbinx + jx;
+          for (cj = cbinhead[ibin]; cj >= 0; cj = cbins[cj]) {
+            if (cj < ci) continue;
+
+            // distance between bounding boxes
+
+            double *jbox = &cbox[6*cj];
+            delx = MAX(0.0,MAX(jbox[0]-ibox[3],ibox[0]-jbox[3]));
+            dely = MAX(0.0,MAX(jbox[1]-ibox[4],ibox[1]-jbox[4]));
+            delz = MAX(0.0,MAX(jbox[2]-ibox[5],ibox[2]-jbox[5]));
+            if (delx*delx + dely*dely + delz*delz > cutneighmaxsq) continue;
+
+            bits = 0;
+
+            for (a = 0; a < NCLUSTER; a++) {
+              i = catom[ci*NCLUSTER+a];
+              if (i < 0) break;
+              itype = type[i];
+              xtmp = x[i][0];
+              ytmp = x[i][1];
+              ztmp = x[i][2];
+              if (moltemplate) {
+                imol = molindex[i];
+                iatom = molatom[i];
+                tagprev = tag[i] - iatom - 1;
+              }
+
+              for (b = (cj == ci) ? a+1 : 0; b < NCLUSTER; b++) {
+                j = catom[cj*NCLUSTER+b];
+                if (j < 0) break;
+
+                if (newton && j >= nlocal) {
+                  if (x[j][2] < ztmp) continue;
+                  if (x[j][2] == ztmp) {
+                    if (x[j][1] < ytmp) continue;
+                    if (x[j][1] == ytmp && x[j][0] < xtmp) continue;
+                  }
+                }
+
+                jtype = type[j];
+                if (exclude && exclusion(i,j,itype,jtype,mask,molecule))
+                  continue;
+
+                delx = xtmp - x[j][0];
+                dely = ytmp - x[j][1];
+                delz = ztmp - x[j][2];
+                rsq = delx*delx + dely*dely + delz*delz;
+                if (rsq > cutneighsq[itype][jtype]) continue;
+
+                if (molecular) {
+                  if (!moltemplate)
+                    which = find_special(special[i],nspecial[i],tag[j]);
+                  else if (imol >= 0)
+                    which = find_special(onemols[imol]->special[iatom],
+                                         onemols[imol]->nspecial[iatom],
+                                         tag[j]-tagprev);
+                  else which = 0;
+                  if (which == 0) bits |= 1 << (a*NCLUSTER+b);
+                  else if (domain->minimum_image_check(delx,dely,delz))
+                    bits |= 1 << (a*NCLUSTER+b);
+                  else if (which > 0) {
+                    if (nsp[a] == oneatom)
+                      error->one(FLERR,"Neighbor list overflow, "
+                                 "boost neigh_modify one");
+                    cspecial[a*oneatom+nsp[a]++] = j ^ (which << SBBITS);
+                  }
+                } else bits |= 1 << (a*NCLUSTER+b);
+              }
+            }
+
+            if (bits) {
+              neighptr[n++] = cj;
+              neighptr[n++] = bits;
+            }
+          }
+        }
+
+    cfirstneigh[ci] = neighptr;
+    cnumneigh[ci] = n;
+    cpage->vgot(n);
+    if (cpage->status())
+      error->one(FLERR,"Neighbor list overflow, boost neigh_modify one");
+
+    // store special pairs of each atom in I cluster as a regular list
+
+    for (a = 0; a < NCLUSTER; a++) {
+      if (nsp[a] == 0) continue;
+      i = catom[ci*NCLUSTER+a];
+      neighptr = ipage->vget();
+      for (k = 0; k < nsp[a]; k++) neighptr[k] = cspecial[a*oneatom+k];
+      ilist[inum++] = i;
+      firstneigh[i] = neighptr;
+      numneigh[i] = nsp[a];
+      ipage->vgot(nsp[a]);
+      if (ipage->status())
+        error->one(FLERR,"Neighbor list overflow, boost neigh_modify one");
+    }
+  }
+
+  list->inum = inum;
+}
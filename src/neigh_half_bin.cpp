@@ -17,6 +17,7 @@
 #include "atom_vec.h"
 #include "molecule.h"
 #include "domain.h"
+#include "comm.h"
 #include "my_page.h"
 #include "error.h"
 
@@ -62,74 +63,85 @@ void Neighbor::half_bin_no_newton(NeighList *list)
   int **firstneigh = list->firstneigh;
   int nstencil = list->nstencil;
   int *stencil = list->stencil;
-  MyPage<int> *ipage = list->ipage;
-
-  int inum = 0;
-  ipage->reset();
-
-  // loop over each atom, storing neighbors
-
-  for (i = 0; i < nlocal; i++) {
-    n = 0;
-    neighptr = ipage->vget();
 
-    itype = type[i];
-    xtmp = x[i][0];
-    ytmp = x[i][1];
-    ztmp = x[i][2];
-    if (moltemplate) {
-      imol = molindex[i];
-      iatom = molatom[i];
-      tagprev = tag[i] - iatom - 1;
-    }
+  // each thread loops over a contiguous chunk of atoms
+  // and stores neighbors in its own page pool
+
+#if defined(_OPENMP)
+#pragma omp parallel private(i,j,k,n,itype,jtype,ibin,which,imol,iatom, \
+  tagprev,xtmp,ytmp,ztmp,delx,dely,delz,rsq,neighptr) \
+  num_threads(comm->nthreads)
+#endif
+  {
+    int tid,ifrom,ito;
+    thread_chunk(nlocal,tid,ifrom,ito);
+    MyPage<int> *ipage = &list->ipage[tid];
+    ipage->reset();
+
+    // loop over each atom, storing neighbors
+
+    for (i = ifrom; i < ito; i++) {
+      n = 0;
+      neighptr = ipage->vget();
+
+      itype = type[i];
+      xtmp = x[i][0];
+      ytmp = x[i][1];
+      ztmp = x[i][2];
+      if (moltemplate) {
+        imol = molindex[i];
+        iatom = molatom[i];
+        tagprev = tag[i] - iatom - 1;
+      }
 
-    // loop over all atoms in other bins in stencil including self
-    // only store pair if i < j
-    // stores own/own pairs only once
-    // stores own/ghost pairs on both procs
+      // loop over all atoms in other bins in stencil including self
+      // only store pair if i < j
+      // stores own/own pairs only once
+      // stores own/ghost pairs on both procs
 
-    ibin = coord2bin(x[i]);
+      ibin = coord2bin(x[i]);
 
-    for (k = 0; k < nstencil; k++) {
-      for (j = binhead[ibin+stencil[k]]; j >= 0; j = bins[j]) {
-        if (j <= i) continue;
+      for (k = 0; k < nstencil; k++) {
+        for (j = binhead[ibin+stencil[k]]; j >= 0; j = bins[j]) {
+          if (j <= i) continue;
 
-        jtype = type[j];
-        if (exclude && exclusion(i,j,itype,jtype,mask,molecule)) continue;
+          jtype = type[j];
+          if (exclude && exclusion(i,j,itype,jtype,mask,molecule)) continue;
 
-        delx = xtmp - x[j][0];
-        dely = ytmp - x[j][1];
-        delz = ztmp - x[j][2];
-        rsq = delx*delx + dely*dely + delz*delz;
+          delx = xtmp - x[j][0];
+          dely = ytmp - x[j][1];
+          delz = ztmp - x[j][2];
+          rsq = delx*delx + dely*dely + delz*delz;
 
-        if (rsq <= cutneighsq[itype][jtype]) {
-          if (molecular) {
-            if (!moltemplate)
-              which = find_special(special[i],nspecial[i],tag[j]);
-            else if (imol >= 0)
-              which = find_special(onemols[imol]->special[iatom],
-                                   onemols[imol]->nspecial[iatom],
-                                   tag[j]-tagprev);
-            else which = 0;
-            if (which == 0) neighptr[n++] = j;
-            else if (domain->minimum_image_check(delx,dely,delz))
-              neighptr[n++] = j;
-            else if (which > 0) neighptr[n++] = j ^ (which << SBBITS);
-            // OLD: if (which >= 0) neighptr[n++] = j ^ (which << SBBITS);
-          } else neighptr[n++] = j;
+          if (rsq <= cutneighsq[itype][jtype]) {
+            if (molecular) {
+              if (!moltemplate)
+                which = find_special(special[i],nspecial[i],tag[j]);
+              else if (imol >= 0)
+                which = find_special(onemols[imol]->special[iatom],
+                                     onemols[imol]->nspecial[iatom],
+                                     tag[j]-tagprev);
+              else which = 0;
+              if (which == 0) neighptr[n++] = j;
+              else if (domain->minimum_image_check(delx,dely,delz))
+                neighptr[n++] = j;
+              else if (which > 0) neighptr[n++] = j ^ (which << SBBITS);
+              // OLD: if (which >= 0) neighptr[n++] = j ^ (which << SBBITS);
+            } else neighptr[n++] = j;
+          }
         }
       }
-    }
 
-    ilist[inum++] = i;
-    firstneigh[i] = neighptr;
-    numneigh[i] = n;
-    ipage->vgot(n);
-    if (ipage->status())
-      error->one(FLERR,"Neighbor list overflow, boost neigh_modify one");
+      ilist[i] = i;
+      firstneigh[i] = neighptr;
+      numneigh[i] = n;
+      ipage->vgot(n);
+      if (ipage->status())
+        error->one(FLERR,"Neighbor list overflow, boost neigh_modify one");
+    }
   }
 
-  list->inum = inum;
+  list->inum = nlocal;
 }
 
 /* ----------------------------------------------------------------------
@@ -315,71 +327,50 @@ void Neighbor::half_bin_newton(NeighList *list)
   int **firstneigh = list->firstneigh;
   int nstencil = list->nstencil;
   int *stencil = list->stencil;
-  MyPage<int> *ipage = list->ipage;
-
-  int inum = 0;
-  ipage->reset();
-
-  // loop over each atom, storing neighbors
-
-  for (i = 0; i < nlocal; i++) {
-    n = 0;
-    neighptr = ipage->vget();
-
-    itype = type[i];
-    xtmp = x[i][0];
-    ytmp = x[i][1];
-    ztmp = x[i][2];
-    if (moltemplate) {
-      imol = molindex[i];
-      iatom = molatom[i];
-      tagprev = tag[i] - iatom - 1;
-    }
-
-    // loop over rest of atoms in i's bin, ghosts are at end of linked list
-    // if j is owned atom, store it, since j is beyond i in linked list
-    // if j is ghost, only store if j coords are "above and to the right" of i
 
-    for (j = bins[i]; j >= 0; j = bins[j]) {
-      if (j >= nlocal) {
-        if (x[j][2] < ztmp) continue;
-        if (x[j][2] == ztmp) {
-          if (x[j][1] < ytmp) continue;
-          if (x[j][1] == ytmp && x[j][0] < xtmp) continue;
-        }
+  // each thread loops over a contiguous chunk of atoms
+  // and stores neighbors in its own page pool
+
+#if defined(_OPENMP)
+#pragma omp parallel private(i,j,k,n,itype,jtype,ibin,which,imol,iatom, \
+  tagprev,xtmp,ytmp,ztmp,delx,dely,delz,rsq,neighptr) \
+  num_threads(comm->nthreads)
+#endif
+  {
+    int tid,ifrom,ito;
+    thread_chunk(nlocal,tid,ifrom,ito);
+    MyPage<int> *ipage = &list->ipage[tid];
+    ipage->reset();
+
+    // loop over each atom, storing neighbors
+
+    for (i = ifrom; i < ito; i++) {
+      n = 0;
+      neighptr = ipage->vget();
+
+      itype = type[i];
+      xtmp = x[i][0];
+      ytmp = x[i][1];
+      ztmp = x[i][2];
+      if (moltemplate) {
+        imol = molindex[i];
+        iatom = molatom[i];
+        tagprev = tag[i] - iatom - 1;
       }
 
-      jtype = type[j];
-      if (exclude && exclusion(i,j,itype,jtype,mask,molecule)) continue;
-
-      delx = xtmp - x[j][0];
-      dely = ytmp - x[j][1];
-      delz = ztmp - x[j][2];
-      rsq = delx*delx + dely*dely + delz*delz;
-
-      if (rsq <= cutneighsq[itype][jtype]) {
-        if (molecular) {
-          if (!moltemplate)
-            which = find_special(special[i],nspecial[i],tag[j]);
-          else if (imol >= 0)
-            which = find_special(onemols[imol]->special[iatom],
-                                 onemols[imol]->nspecial[iatom],
-                                 tag[j]-tagprev);
-          else which = 0;
-          if (which == 0) neighptr[n++] = j;
-          else if (domain->minimum_image_check(delx,dely,delz))
-            neighptr[n++] = j;
-          else if (which > 0) neighptr[n++] = j ^ (which << SBBITS);
-          // OLD: if (which >= 0) neighptr[n++] = j ^ (which << SBBITS);
-        } else neighptr[n++] = j;
-      }
-    }
+      // loop over rest of atoms in i's bin, ghosts are at end of linked list
+      // if j is owned atom, store it, since j is beyond i in linked list
+      // if j is ghost, only store if j coords are "above and to the right" of i
 
-    // loop over all atoms in other bins in stencil, store every pair
+      for (j = bins[i]; j >= 0; j = bins[j]) {
+        if (j >= nlocal) {
+          if (x[j][2] < ztmp) continue;
+          if (x[j][2] == ztmp) {
+            if (x[j][1] < ytmp) continue;
+            if (x[j][1] == ytmp && x[j][0] < xtmp) continue;
+          }
+        }
 
-    ibin = coord2bin(x[i]);
-    for (k = 0; k < nstencil; k++) {
-      for (j = binhead[ibin+stencil[k]]; j >= 0; j = bins[j]) {
         jtype = type[j];
         if (exclude && exclusion(i,j,itype,jtype,mask,molecule)) continue;
 
@@ -405,17 +396,49 @@ void Neighbor::half_bin_newton(NeighList *list)
           } else neighptr[n++] = j;
         }
       }
-    }
 
-    ilist[inum++] = i;
-    firstneigh[i] = neighptr;
-    numneigh[i] = n;
-    ipage->vgot(n);
-    if (ipage->status())
-      error->one(FLERR,"Neighbor list overflow, boost neigh_modify one");
+      // loop over all atoms in other bins in stencil, store every pair
+
+      ibin = coord2bin(x[i]);
+      for (k = 0; k < nstencil; k++) {
+        for (j = binhead[ibin+stencil[k]]; j >= 0; j = bins[j]) {
+          jtype = type[j];
+          if (exclude && exclusion(i,j,itype,jtype,mask,molecule)) continue;
+
+          delx = xtmp - x[j][0];
+          dely = ytmp - x[j][1];
+          delz = ztmp - x[j][2];
+          rsq = delx*delx + dely*dely + delz*delz;
+
+          if (rsq <= cutneighsq[itype][jtype]) {
+            if (molecular) {
+              if (!moltemplate)
+                which = find_special(special[i],nspecial[i],tag[j]);
+              else if (imol >= 0)
+                which = find_special(onemols[imol]->special[iatom],
+                                     onemols[imol]->nspecial[iatom],
+                                     tag[j]-tagprev);
+              else which = 0;
+              if (which == 0) neighptr[n++] = j;
+              else if (domain->minimum_image_check(delx,dely,delz))
+                neighptr[n++] = j;
+              else if (which > 0) neighptr[n++] = j ^ (which << SBBITS);
+              // OLD: if (which >= 0) neighptr[n++] = j ^ (which << SBBITS);
+            } else neighptr[n++] = j;
+          }
+        }
+      }
+
+      ilist[i] = i;
+      firstneigh[i] = neighptr;
+      numneigh[i] = n;
+      ipage->vgot(n);
+      if (ipage->status())
+        error->one(FLERR,"Neighbor list overflow, boost neigh_modify one");
+    }
   }
 
-  list->inum = inum;
+  list->inum = nlocal;
 }
 
 /* ----------------------------------------------------------------------
@@ -457,78 +480,89 @@ void Neighbor::half_bin_newton_tri(NeighList *list)
   int **firstneigh = list->firstneigh;
   int nstencil = list->nstencil;
   int *stencil = list->stencil;
-  MyPage<int> *ipage = list->ipage;
-
-  int inum = 0;
-  ipage->reset();
-
-  // loop over each atom, storing neighbors
 
-  for (i = 0; i < nlocal; i++) {
-    n = 0;
-    neighptr = ipage->vget();
+  // each thread loops over a contiguous chunk of atoms
+  // and stores neighbors in its own page pool
+
+#if defined(_OPENMP)
+#pragma omp parallel private(i,j,k,n,itype,jtype,ibin,which,imol,iatom, \
+  tagprev,xtmp,ytmp,ztmp,delx,dely,delz,rsq,neighptr) \
+  num_threads(comm->nthreads)
+#endif
+  {
+    int tid,ifrom,ito;
+    thread_chunk(nlocal,tid,ifrom,ito);
+    MyPage<int> *ipage = &list->ipage[tid];
+    ipage->reset();
+
+    // loop over each atom, storing neighbors
+
+    for (i = ifrom; i < ito; i++) {
+      n = 0;
+      neighptr = ipage->vget();
+
+      itype = type[i];
+      xtmp = x[i][0];
+      ytmp = x[i][1];
+      ztmp = x[i][2];
+      if (moltemplate) {
+        imol = molindex[i];
+        iatom = molatom[i];
+        tagprev = tag[i] - iatom - 1;
+      }
 
-    itype = type[i];
-    xtmp = x[i][0];
-    ytmp = x[i][1];
-    ztmp = x[i][2];
-    if (moltemplate) {
-      imol = molindex[i];
-      iatom = molatom[i];
-      tagprev = tag[i] - iatom - 1;
-    }
+      // loop over all atoms in bins in stencil
+      // pairs for atoms j "below" i are excluded
+      // below = lower z or (equal z and lower y) or (equal zy and lower x)
+      //         (equal zyx and j <= i)
+      // latter excludes self-self interaction but allows superposed atoms
 
-    // loop over all atoms in bins in stencil
-    // pairs for atoms j "below" i are excluded
-    // below = lower z or (equal z and lower y) or (equal zy and lower x)
-    //         (equal zyx and j <= i)
-    // latter excludes self-self interaction but allows superposed atoms
-
-    ibin = coord2bin(x[i]);
-    for (k = 0; k < nstencil; k++) {
-      for (j = binhead[ibin+stencil[k]]; j >= 0; j = bins[j]) {
-        if (x[j][2] < ztmp) continue;
-        if (x[j][2] == ztmp) {
-          if (x[j][1] < ytmp) continue;
-          if (x[j][1] == ytmp) {
-            if (x[j][0] < xtmp) continue;
-            if (x[j][0] == xtmp && j <= i) continue;
+      ibin = coord2bin(x[i]);
+      for (k = 0; k < nstencil; k++) {
+        for (j = binhead[ibin+stencil[k]]; j >= 0; j = bins[j]) {
+          if (x[j][2] < ztmp) continue;
+          if (x[j][2] == ztmp) {
+            if (x[j][1] < ytmp) continue;
+            if (x[j][1] == ytmp) {
+              if (x[j][0] < xtmp) continue;
+              if (x[j][0] == xtmp && j <= i) continue;
+            }
           }
-        }
 
-        jtype = type[j];
-        if (exclude && exclusion(i,j,itype,jtype,mask,molecule)) continue;
+          jtype = type[j];
+          if (exclude && exclusion(i,j,itype,jtype,mask,molecule)) continue;
 
-        delx = xtmp - x[j][0];
-        dely = ytmp - x[j][1];
-        delz = ztmp - x[j][2];
-        rsq = delx*delx + dely*dely + delz*delz;
+          delx = xtmp - x[j][0];
+          dely = ytmp - x[j][1];
+          delz = ztmp - x[j][2];
+          rsq = delx*delx + dely*dely + delz*delz;
 
-        if (rsq <= cutneighsq[itype][jtype]) {
-          if (molecular) {
-            if (!moltemplate)
-              which = find_special(special[i],nspecial[i],tag[j]);
-            else if (imol >= 0)
-              which = find_special(onemols[imol]->special[iatom],
-                                   onemols[imol]->nspecial[iatom],
-                                   tag[j]-tagprev);
-            else which = 0;
-            if (which == 0) neighptr[n++] = j;
-            else if (domain->minimum_image_check(delx,dely,delz))
-              neighptr[n++] = j;
-            else if (which > 0) neighptr[n++] = j ^ (which << SBBITS);
-          } else neighptr[n++] = j;
+          if (rsq <= cutneighsq[itype][jtype]) {
+            if (molecular) {
+              if (!moltemplate)
+                which = find_special(special[i],nspecial[i],tag[j]);
+              else if (imol >= 0)
+                which = find_special(onemols[imol]->special[iatom],
+                                     onemols[imol]->nspecial[iatom],
+                                     tag[j]-tagprev);
+              else which = 0;
+              if (which == 0) neighptr[n++] = j;
+              else if (domain->minimum_image_check(delx,dely,delz))
+                neighptr[n++] = j;
+              else if (which > 0) neighptr[n++] = j ^ (which << SBBITS);
+            } else neighptr[n++] = j;
+          }
         }
       }
-    }
 
-    ilist[inum++] = i;
-    firstneigh[i] = neighptr;
-    numneigh[i] = n;
-    ipage->vgot(n);
-    if (ipage->status())
-      error->one(FLERR,"Neighbor list overflow, boost neigh_modify one");
+      ilist[i] = i;
+      firstneigh[i] = neighptr;
+      numneigh[i] = n;
+      ipage->vgot(n);
+      if (ipage->status())
+        error->one(FLERR,"Neighbor list overflow, boost neigh_modify one");
+    }
   }
 
-  list->inum = inum;
+  list->inum = nlocal;
 }
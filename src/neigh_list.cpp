@@ -47,6 +47,15 @@ NeighList::NeighList(LAMMPS *lmp) :
   iskip = NULL;
   ijskip = NULL;
 
+  ninterior = 0;
+  iboundary = NULL;
+  maxboundary = 0;
+
+  pruneflag = prunedflag = 0;
+  onumneigh = NULL;
+  ofirstneigh = NULL;
+  ppage = NULL;
+
   listgranhistory = NULL;
   fix_history = NULL;
 
@@ -67,6 +76,18 @@ NeighList::NeighList(LAMMPS *lmp) :
   binhead_ssa = NULL;
   gbinhead_ssa = NULL;
 
+  clusterflag = 0;
+  nclusterlocal = ncluster = maxcluster = 0;
+  catom = NULL;
+  cbox = NULL;
+  cnumneigh = NULL;
+  cfirstneigh = NULL;
+  cpage = NULL;
+  cspecial = NULL;
+  cbins = NULL;
+  cbinhead = NULL;
+  maxhead_cluster = 0;
+
   maxstencil = ghostflag = 0;
   stencil = NULL;
   stencilxyz = NULL;
@@ -94,6 +115,11 @@ NeighList::~NeighList()
     if (dnum) delete [] dpage;
   }
 
+  memory->destroy(iboundary);
+  memory->destroy(onumneigh);
+  memory->sfree(ofirstneigh);
+  delete [] ppage;
+
   delete [] iskip;
   memory->destroy(ijskip);
 
@@ -106,6 +132,17 @@ NeighList::~NeighList()
     memory->destroy(gbinhead_ssa);
   }
 
+  if (maxcluster) {
+    memory->destroy(catom);
+    memory->destroy(cbox);
+    memory->destroy(cnumneigh);
+    memory->sfree(cfirstneigh);
+    memory->destroy(cbins);
+  }
+  if (maxhead_cluster) memory->destroy(cbinhead);
+  delete cpage;
+  memory->destroy(cspecial);
+
   if (maxstencil_multi) {
     for (int i = 1; i <= atom->ntypes; i++) {
       memory->destroy(stencil_multi[i]);
@@ -164,6 +201,13 @@ void NeighList::grow(int nmax)
   if (dnum)
     firstdouble = (double **) memory->smalloc(maxatoms*sizeof(double *),
                                               "neighlist:firstdouble");
+  if (ppage) {
+    memory->destroy(onumneigh);
+    memory->sfree(ofirstneigh);
+    memory->create(onumneigh,maxatoms,"neighlist:onumneigh");
+    ofirstneigh = (int **) memory->smalloc(maxatoms*sizeof(int *),
+                                           "neighlist:ofirstneigh");
+  }
   if (ssaflag) {
     if (ndxAIR_ssa) memory->sfree(ndxAIR_ssa);
     ndxAIR_ssa = (uint16_t (*)[8]) memory->smalloc(sizeof(uint16_t)*8*maxatoms,
@@ -171,6 +215,89 @@ void NeighList::grow(int nmax)
   }
 }
 
+/* ----------------------------------------------------------------------
+   grow cluster arrays to allow for nmax clusters of owned + ghost atoms
+   catom and cbox values are preserved, they are grown while being filled
+   also create cluster pages the first time
+------------------------------------------------------------------------- */
+
+void NeighList::grow_cluster(int nmax)
+{
+  if (cpage == NULL) {
+    cpage = new MyPage<int>;
+    cpage->init(2*oneatom,2*pgsize,PGDELTA);
+    memory->create(cspecial,NCLUSTER*oneatom,"neighlist:cspecial");
+  }
+
+  if (nmax <= maxcluster) return;
+  maxcluster = nmax;
+
+  memory->destroy(cnumneigh);
+  memory->sfree(cfirstneigh);
+  memory->destroy(cbins);
+
+  memory->grow(catom,NCLUSTER*maxcluster,"neighlist:catom");
+  memory->grow(cbox,6*maxcluster,"neighlist:cbox");
+  memory->create(cnumneigh,maxcluster,"neighlist:cnumneigh");
+  cfirstneigh = (int **) memory->smalloc(maxcluster*sizeof(int *),
+                                         "neighlist:cfirstneigh");
+  memory->create(cbins,maxcluster,"neighlist:cbins");
+}
+
+/* ----------------------------------------------------------------------
+   create pages and outer list arrays for pruning the first time
+------------------------------------------------------------------------- */
+
+void NeighList::setup_prune()
+{
+  if (ppage) return;
+
+  int nmypage = comm->nthreads;
+  ppage = new MyPage<int>[nmypage];
+  for (int i = 0; i < nmypage; i++)
+    ppage[i].init(oneatom,pgsize,PGDELTA);
+
+  memory->create(onumneigh,maxatoms,"neighlist:onumneigh");
+  ofirstneigh = (int **) memory->smalloc(maxatoms*sizeof(int *),
+                                         "neighlist:ofirstneigh");
+}
+
+/* ----------------------------------------------------------------------
+   reorder ilist so I atoms with no ghost neighbors come first
+   their forces can be computed before ghost coords are updated,
+     see Verlet::run()
+   order of interior and of boundary atoms is preserved
+------------------------------------------------------------------------- */
+
+void NeighList::split_interior()
+{
+  int i,ii,jj,jnum;
+  int *jlist;
+
+  int nlocal = atom->nlocal;
+  if (inum > maxboundary) {
+    maxboundary = atom->nmax;
+    memory->destroy(iboundary);
+    memory->create(iboundary,maxboundary,"neighlist:iboundary");
+  }
+
+  int ni = 0;
+  int nb = 0;
+
+  for (ii = 0; ii < inum; ii++) {
+    i = ilist[ii];
+    jlist = firstneigh[i];
+    jnum = numneigh[i];
+    for (jj = 0; jj < jnum; jj++)
+      if ((jlist[jj] & NEIGHMASK) >= nlocal) break;
+    if (jj == jnum) ilist[ni++] = i;
+    else iboundary[nb++] = i;
+  }
+
+  for (ii = 0; ii < nb; ii++) ilist[ni+ii] = iboundary[ii];
+  ninterior = ni;
+}
+
 /* ----------------------------------------------------------------------
    insure stencils are large enough for smax bins
    style = BIN or MULTI
@@ -251,6 +378,8 @@ void NeighList::print_attributes()
   printf("  %d = stencil flag\n",stencilflag);
   printf("  %d = ghost flag\n",ghostflag);
   printf("  %d = ssa flag\n",ssaflag);
+  printf("  %d = cluster flag\n",clusterflag);
+  printf("  %d = prune flag\n",pruneflag);
   printf("\n");
   printf("  %d = pair\n",rq->pair);
   printf("  %d = fix\n",rq->fix);
@@ -276,6 +405,7 @@ void NeighList::print_attributes()
   printf("  %d = kokkos host\n",rq->kokkos_host);
   printf("  %d = kokkos device\n",rq->kokkos_device);
   printf("  %d = ssa\n",rq->ssa);
+  printf("  %d = cluster\n",rq->cluster);
   printf("  %d = copy\n",rq->copy);
   printf("  %d = skip\n",rq->skip);
   printf("  %d = otherlist\n",rq->otherlist);
@@ -310,6 +440,14 @@ bigint NeighList::memory_usage()
     }
   }
 
+  if (maxboundary) bytes += memory->usage(iboundary,maxboundary);
+  if (ppage) {
+    bytes += memory->usage(onumneigh,maxatoms);
+    bytes += maxatoms * sizeof(int *);
+    for (int i = 0; i < nmypage; i++)
+      bytes += ppage[i].size();
+  }
+
   if (maxstencil) bytes += memory->usage(stencil,maxstencil);
   if (ghostflag) bytes += memory->usage(stencilxyz,maxstencil,3);
   if (ndxAIR_ssa) bytes += sizeof(uint16_t) * 8 * maxatoms;
@@ -319,6 +457,19 @@ bigint NeighList::memory_usage()
     bytes += memory->usage(gbinhead_ssa,maxhead_ssa);
   }
 
+  if (maxcluster) {
+    bytes += memory->usage(catom,NCLUSTER*maxcluster);
+    bytes += memory->usage(cbox,6*maxcluster);
+    bytes += memory->usage(cnumneigh,maxcluster);
+    bytes += maxcluster * sizeof(int *);
+    bytes += memory->usage(cbins,maxcluster);
+  }
+  if (maxhead_cluster) bytes += memory->usage(cbinhead,maxhead_cluster);
+  if (cpage) {
+    bytes += cpage->size();
+    bytes += memory->usage(cspecial,NCLUSTER*oneatom);
+  }
+
   if (maxstencil_multi) {
     bytes += memory->usage(stencil_multi,atom->ntypes,maxstencil_multi);
     bytes += memory->usage(distsq_multi,atom->ntypes,maxstencil_multi);
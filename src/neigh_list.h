@@ -17,6 +17,10 @@
 #include "pointers.h"
 #include "my_page.h"
 
+// # of atoms in one cluster of a cluster-pair list
+
+#define NCLUSTER 4
+
 namespace LAMMPS_NS {
 
 class NeighList : protected Pointers {
@@ -53,6 +57,20 @@ class NeighList : protected Pointers {
   int *iskip;         // iskip[i] = 1 if atoms of type I are not in list
   int **ijskip;       // ijskip[i][j] = 1 if pairs of type I,J are not in list
 
+  // I atoms without ghost neighbors, see split_interior()
+
+  int ninterior;                   // # of such atoms, first in ilist
+  int *iboundary;                  // other I atoms during split
+  int maxboundary;                 // size of iboundary
+
+  // pair list pruned to a smaller skin between builds, see Neighbor::prune()
+
+  int pruneflag;                   // 1 if the list is pruned
+  int prunedflag;                  // 1 if numneigh/firstneigh hold pruned list
+  int *onumneigh;                  // # of J neighbors in list as built
+  int **ofirstneigh;               // ptr to 1st J of list as built
+  MyPage<int> *ppage;              // pages of pruned neighbor indices
+
   // settings and pointers for related neighbor lists and fixes
 
   NeighList *listgranhistory;          // point at list storing shear history
@@ -75,6 +93,23 @@ class NeighList : protected Pointers {
   int *gbinhead_ssa;         // index of 1st ghost atom in each bin
   int maxhead_ssa;           // size of binhead_ssa and gbinhead_ssa arrays
 
+  // cluster-pair list, see Neighbor::half_bin_cluster()
+  // ilist/numneigh/firstneigh then only store pairs with special bonds
+
+  int clusterflag;           // 1 if the list stores cluster pairs
+  int nclusterlocal;         // # of clusters of owned atoms, stored first
+  int ncluster;              // # of clusters of owned + ghost atoms
+  int maxcluster;            // size of cluster arrays
+  int *catom;                // NCLUSTER atom indices per cluster, -1 if none
+  double *cbox;              // bounding box of each cluster, lo/hi in xyz
+  int *cnumneigh;            // # of J clusters for each I cluster
+  int **cfirstneigh;         // ptr to 1st J cluster and its pair mask
+  MyPage<int> *cpage;        // pages of J cluster indices and pair masks
+  int *cspecial;             // special neighbors of one I cluster during build
+  int *cbins;                // index of next cluster in each bin
+  int *cbinhead;             // index of 1st cluster in each bin
+  int maxhead_cluster;       // size of cbinhead array
+
   // stencils of bin indices for neighbor finding
 
   int maxstencil;                  // max size of stencil
@@ -91,6 +126,9 @@ class NeighList : protected Pointers {
   virtual ~NeighList();
   void setup_pages(int, int, int);      // setup page data structures
   void grow(int);                       // grow maxlocal
+  void grow_cluster(int);               // grow maxcluster
+  void setup_prune();                   // setup pruned list pages and arrays
+  void split_interior();                // put interior atoms first in ilist
   void stencil_allocate(int, int);      // allocate stencil arrays
   void copy_skip_info(int *, int **);   // copy skip info from a neigh request
   void print_attributes();              // debug routine
@@ -0,0 +1,107 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   http://lammps.sandia.gov, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "neighbor.h"
+#include "neigh_list.h"
+#include "atom.h"
+#include "comm.h"
+#include "my_page.h"
+#include "error.h"
+
+using namespace LAMMPS_NS;
+
+/* ----------------------------------------------------------------------
+   prune pair lists every prune_every steps, including the build step
+   called after the lists are built or ghost atoms are communicated
+------------------------------------------------------------------------- */
+
+void Neighbor::prune()
+{
+  if (ago % prune_every) return;
+  for (int m = 0; m < nplist; m++) prune_list(lists[plist[m]]);
+}
+
+/* ----------------------------------------------------------------------
+   store neighbors of each I atom within force cutoff + prune_skin
+   from the list as built with force cutoff + skin
+   first pruning after a build saves the built list as the outer list,
+     pruned neighbors go into separate pages
+   special bits of J are kept
+------------------------------------------------------------------------- */
+
+void Neighbor::prune_list(NeighList *list)
+{
+  int i,j,ii,jj,n,jnum,itype;
+  double xtmp,ytmp,ztmp,delx,dely,delz,rsq;
+  int *jlist,*neighptr;
+
+  double **x = atom->x;
+  int *type = atom->type;
+
+  int inum = list->inum;
+  int *ilist = list->ilist;
+  int *numneigh = list->numneigh;
+  int **firstneigh = list->firstneigh;
+  int *onumneigh = list->onumneigh;
+  int **ofirstneigh = list->ofirstneigh;
+
+  if (!list->prunedflag) {
+    for (ii = 0; ii < inum; ii++) {
+      i = ilist[ii];
+      onumneigh[i] = numneigh[i];
+      ofirstneigh[i] = firstneigh[i];
+    }
+    list->prunedflag = 1;
+  }
+
+#if defined(_OPENMP)
+#pragma omp parallel private(i,j,ii,jj,n,jnum,itype,xtmp,ytmp,ztmp, \
+  delx,dely,delz,rsq,jlist,neighptr) num_threads(comm->nthreads)
+#endif
+  {
+    int tid,ifrom,ito;
+    thread_chunk(inum,tid,ifrom,ito);
+
+    MyPage<int> *ppage = &list->ppage[tid];
+    ppage->reset();
+
+    for (ii = ifrom; ii < ito; ii++) {
+      i = ilist[ii];
+      itype = type[i];
+      xtmp = x[i][0];
+      ytmp = x[i][1];
+      ztmp = x[i][2];
+      double *cutsq = cutprunesq[itype];
+      jlist = ofirstneigh[i];
+      jnum = onumneigh[i];
+
+      n = 0;
+      neighptr = ppage->vget();
+
+      for (jj = 0; jj < jnum; jj++) {
+        j = jlist[jj] & NEIGHMASK;
+        delx = xtmp - x[j][0];
+        dely = ytmp - x[j][1];
+        delz = ztmp - x[j][2];
+        rsq = delx*delx + dely*dely + delz*delz;
+        if (rsq <= cutsq[type[j]]) neighptr[n++] = jlist[jj];
+      }
+
+      firstneigh[i] = neighptr;
+      numneigh[i] = n;
+      ppage->vgot(n);
+      if (ppage->status())
+        error->one(FLERR,"Neighbor list overflow, boost neigh_modify one");
+    }
+  }
+}
@@ -53,6 +53,7 @@ NeighRequest::NeighRequest(LAMMPS *lmp) : Pointers(lmp)
   // default is no multi-threaded neighbor list build
   // default is no Kokkos neighbor list build
   // default is no Shardlow Splitting Algorithm (SSA) neighbor list build
+  // default is no cluster-pair neighbor list build
 
   occasional = 0;
   newton = 0;
@@ -65,6 +66,7 @@ NeighRequest::NeighRequest(LAMMPS *lmp) : Pointers(lmp)
   intel = 0;
   kokkos_host = kokkos_device = 0;
   ssa = 0;
+  cluster = 0;
 
   // copy/skip/derive info, default is no copy or skip
   // none or only one option is set
@@ -142,6 +144,7 @@ int NeighRequest::identical(NeighRequest *other)
   if (omp != other->omp) same = 0;
   if (intel != other->intel) same = 0;
   if (ssa != other->ssa) same = 0;
+  if (cluster != other->cluster) same = 0;
 
   if (copy != other->copy_original) same = 0;
   if (same_skip(other) == 0) same = 0;
@@ -182,6 +185,7 @@ int NeighRequest::same_kind(NeighRequest *other)
   if (kokkos_host != other->kokkos_host) same = 0;
   if (kokkos_device != other->kokkos_device) same = 0;
   if (ssa != other->ssa) same = 0;
+  if (cluster != other->cluster) same = 0;
 
   // copy/skip/derive info does not need to be the same
 
@@ -237,4 +241,5 @@ void NeighRequest::copy_request(NeighRequest *other)
   kokkos_host = other->kokkos_host;
   kokkos_device = other->kokkos_device;
   ssa = other->ssa;
+  cluster = other->cluster;
 }
@@ -97,6 +97,11 @@ class NeighRequest : protected Pointers {
   
   int ssa;
   
+  // 1 if pair style can use a cluster-pair list of NCLUSTER-atom tiles
+  // only honored for plain half lists, else a regular half list is built
+
+  int cluster;
+
   // set by neighbor and pair_hybrid after all requests are made
   // these settings do not change kind value
 
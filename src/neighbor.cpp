@@ -36,9 +36,14 @@
 #include "respa.h"
 #include "output.h"
 #include "citeme.h"
+#include "timer.h"
 #include "memory.h"
 #include "error.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace LAMMPS_NS;
 
 #define RQDELTA 1
@@ -48,6 +53,8 @@ using namespace LAMMPS_NS;
 #define SMALL 1.0e-6
 #define BIG 1.0e20
 #define CUT2BIN_RATIO 100
+#define PREDICT_SAFETY 2.0
+#define TUNE_TOL 0.05
 
 enum{NSQ,BIN,MULTI};     // also in neigh_list.cpp
 
@@ -77,17 +84,28 @@ Neighbor::Neighbor(LAMMPS *lmp) : Pointers(lmp)
   every = 1;
   delay = 10;
   dist_check = 1;
+  predict = 0;
+  agocheck = 0;
+  skipflag = 0;
+  tune = 0;
+  prune_every = 0;
+  prune_skin = 0.0;
+  ntune = 0;
+  tune_revert = 0;
+  tune_active = 0;
   pgsize = 100000;
   oneatom = 2000;
   binsizeflag = 0;
   build_once = 0;
   cluster_check = 0;
+  clusterpair = 0;
   binatomflag = 1;
   ago = -1;
 
   cutneighmax = 0.0;
   cutneighsq = NULL;
   cutneighghostsq = NULL;
+  cutprunesq = NULL;
   cuttype = NULL;
   cuttypesq = NULL;
   fixchecklist = NULL;
@@ -123,6 +141,8 @@ Neighbor::Neighbor(LAMMPS *lmp) : Pointers(lmp)
 
   maxatom = 0;
   nblist = nglist = nslist = 0;
+  nplist = 0;
+  plist = NULL;
 
   nlist = 0;
   lists = NULL;
@@ -170,6 +190,7 @@ Neighbor::~Neighbor()
 
   memory->destroy(cutneighsq);
   memory->destroy(cutneighghostsq);
+  memory->destroy(cutprunesq);
   delete [] cuttype;
   delete [] cuttypesq;
   delete [] fixchecklist;
@@ -198,6 +219,7 @@ Neighbor::~Neighbor()
   delete [] blist;
   delete [] glist;
   delete [] slist;
+  delete [] plist;
 
   for (int i = 0; i < nrequest; i++) delete requests[i];
   memory->sfree(requests);
@@ -218,7 +240,7 @@ void Neighbor::init()
 {
   int i,j,m,n;
 
-  ncalls = ndanger = 0;
+  ncalls = ndanger = nskip = 0;
   dimension = domain->dimension;
   triclinic = domain->triclinic;
   newton_pair = force->newton_pair;
@@ -231,6 +253,31 @@ void Neighbor::init()
   if (pgsize < 10*oneatom)
     error->all(FLERR,"Neighbor page size must be >= 10x the one atom setting");
 
+  if (tune) {
+    if (dist_check == 0)
+      error->all(FLERR,"Neigh_modify tune requires check yes");
+    if (strstr(update->integrate_style,"respa") || lmp->kokkos)
+      error->all(FLERR,"Neigh_modify tune not allowed with rRESPA or KOKKOS");
+    if (!timer->has_normal())
+      error->all(FLERR,"Neigh_modify tune requires timer normal or full");
+  }
+
+  if (prune_every) {
+    if (prune_skin >= skin)
+      error->all(FLERR,"Neigh_modify prune skin must be < neighbor skin");
+    if (strstr(update->integrate_style,"respa"))
+      error->all(FLERR,"Neigh_modify prune not allowed with rRESPA");
+  }
+
+  // skin and delay tuning restarts with every run
+
+  tune_active = tune;
+  tune_skin0 = skin;
+  tune_delay0 = delay;
+  ntune = tune_revert = 0;
+  tune_nbuild = 0;
+  tune_cost = 0.0;
+
   // ------------------------------------------------------------------
   // settings
 
@@ -262,36 +309,12 @@ void Neighbor::init()
     if (lmp->kokkos) init_cutneighsq_kokkos(n);
     else memory->create(cutneighsq,n+1,n+1,"neigh:cutneighsq");
     memory->create(cutneighghostsq,n+1,n+1,"neigh:cutneighghostsq");
+    memory->create(cutprunesq,n+1,n+1,"neigh:cutprunesq");
     cuttype = new double[n+1];
     cuttypesq = new double[n+1];
   }
 
-  double cutoff,delta,cut;
-  cutneighmin = BIG;
-  cutneighmax = 0.0;
-
-  for (i = 1; i <= n; i++) {
-    cuttype[i] = cuttypesq[i] = 0.0;
-    for (j = 1; j <= n; j++) {
-      if (force->pair) cutoff = sqrt(force->pair->cutsq[i][j]);
-      else cutoff = 0.0;
-      if (cutoff > 0.0) delta = skin;
-      else delta = 0.0;
-      cut = cutoff + delta;
-
-      cutneighsq[i][j] = cut*cut;
-      cuttype[i] = MAX(cuttype[i],cut);
-      cuttypesq[i] = MAX(cuttypesq[i],cut*cut);
-      cutneighmin = MIN(cutneighmin,cut);
-      cutneighmax = MAX(cutneighmax,cut);
-
-      if (force->pair && force->pair->ghostneigh) {
-        cut = force->pair->cutghost[i][j] + skin;
-        cutneighghostsq[i][j] = cut*cut;
-      } else cutneighghostsq[i][j] = cut*cut;
-    }
-  }
-  cutneighmaxsq = cutneighmax * cutneighmax;
+  set_cutoffs();
 
   // check other classes that can induce reneighboring in decide()
 
@@ -387,7 +410,7 @@ void Neighbor::init()
   if (dist_check) {
     if (maxhold == 0) {
       maxhold = atom->nmax;
-      memory->create(xhold,maxhold,3,"neigh:xhold");
+      memory->create(xhold,3*maxhold,"neigh:xhold");
     }
   }
 
@@ -612,7 +635,7 @@ void Neighbor::init()
 
       // fix/compute requests:
       // whether request is occasional or not doesn't matter
-      // if request = half and non-skip pair half/respaouter exists,
+      // if request = half and non-skip non-cluster pair half/respaouter exists,
       // if request = full and non-skip pair full exists,
       // if request = half and non-skip pair full exists,
       // if no matches, do nothing
@@ -623,7 +646,8 @@ void Neighbor::init()
         for (j = 0; j < nrequest; j++) {
           if (!lists[j]) continue;
           if (requests[i]->half && requests[j]->pair &&
-              requests[j]->skip == 0 && requests[j]->half) break;
+              requests[j]->skip == 0 && requests[j]->half &&
+              (requests[j]->cluster == 0 || clusterpair == 0)) break;
           if (requests[i]->full && requests[j]->pair &&
               requests[j]->skip == 0 && requests[j]->full) break;
           if (requests[i]->gran && requests[j]->pair &&
@@ -682,6 +706,7 @@ void Neighbor::init()
     // growflag = 1 if it stores atom-based arrays and pages
     // stencilflag = 1 if it stores stencil arrays
     // ghostflag = 1 if it stores neighbors of ghosts
+    // clusterflag = 1 if it stores cluster pairs
     // anyghostlist = 1 if any non-occasional list stores neighbors of ghosts
 
     anyghostlist = 0;
@@ -707,6 +732,11 @@ void Neighbor::init()
 
         lists[i]->ssaflag = 0;
         if (requests[i]->ssa) lists[i]->ssaflag = 1;
+
+        lists[i]->clusterflag = 0;
+        if (pair_build[i] == &Neighbor::half_bin_cluster_newton ||
+            pair_build[i] == &Neighbor::half_bin_cluster_no_newton)
+          lists[i]->clusterflag = 1;
       } else init_list_flags1_kokkos(i);
     }
 
@@ -812,6 +842,32 @@ void Neighbor::init()
 #endif
   }
 
+  // pair lists pruned between builds
+  // only plain half/full lists of pair styles are pruned
+  // lists with per-neighbor data, granular history, rRESPA levels,
+  //   neighbors of ghosts, cluster pairs or a package-specific layout
+  //   are used as built
+
+  delete [] plist;
+  plist = new int[nrequest];
+  nplist = 0;
+
+  for (i = 0; i < nrequest; i++) {
+    if (!lists[i]) continue;
+    lists[i]->pruneflag = lists[i]->prunedflag = 0;
+    if (!prune_every) continue;
+    NeighRequest *rq = requests[i];
+    if (!lists[i]->buildflag || !lists[i]->growflag) continue;
+    if (!rq->pair || rq->occasional || rq->dnum || rq->ghost) continue;
+    if (rq->gran || rq->granhistory || lists[i]->listgranhistory) continue;
+    if (rq->respainner || rq->respamiddle || rq->respaouter) continue;
+    if (rq->ssa || rq->intel || lists[i]->clusterflag) continue;
+    if (rq->half == 0 && rq->full == 0) continue;
+    lists[i]->pruneflag = 1;
+    lists[i]->setup_prune();
+    plist[nplist++] = i;
+  }
+
   // output neighbor list info, only first time or when info changes
 
   if (!same || every != old_every || delay != old_delay ||
@@ -1030,6 +1086,9 @@ int Neighbor::request(void *requestor, int instance)
            respa function if respaouter,
            skip_from function for everything else
    ssa -> special case for USER-DPD pair styles
+   cluster -> cluster-pair half list if enabled by neigh_modify,
+              style BIN, orthogonal box, and no include group,
+              else a regular half list
    half_from_full, half, full, gran, respaouter ->
      choose by newton and rq->newton and triclinic settings
      style NSQ options = newton off, newton on
@@ -1068,6 +1127,17 @@ void Neighbor::choose_build(int index, NeighRequest *rq)
       if (rq->half_from_full) pb = &Neighbor::half_from_full_newton_ssa;
       else pb = &Neighbor::half_bin_newton_ssa;
 
+    } else if (clusterpair && rq->cluster && rq->half && rq->ghost == 0 &&
+               style == BIN && triclinic == 0 && includegroup == 0) {
+      if (rq->newton == 0) {
+        if (newton_pair == 0) pb = &Neighbor::half_bin_cluster_no_newton;
+        else if (newton_pair == 1) pb = &Neighbor::half_bin_cluster_newton;
+      } else if (rq->newton == 1) {
+        pb = &Neighbor::half_bin_cluster_newton;
+      } else if (rq->newton == 2) {
+        pb = &Neighbor::half_bin_cluster_no_newton;
+      }
+
     } else if (rq->half_from_full) {
       if (rq->newton == 0) {
         if (newton_pair == 0) pb = &Neighbor::half_from_full_no_newton;
@@ -1484,10 +1554,58 @@ int Neighbor::decide()
   if (ago >= delay && ago % every == 0) {
     if (build_once) return 0;
     if (dist_check == 0) return 1;
-    return check_distance();
+    if (ago < agocheck) {
+      skipflag = 1;
+      nskip++;
+      return 0;
+    }
+    if (check_distance() == 0) return 0;
+    if (tune_active && update->whichflag == 1) tune_skin();
+    return 1;
   } else return 0;
 }
 
+/* ----------------------------------------------------------------------
+   set neighbor cutoffs from pair cutoffs and current skin
+------------------------------------------------------------------------- */
+
+void Neighbor::set_cutoffs()
+{
+  int i,j;
+  int n = atom->ntypes;
+
+  double cutoff,delta,cut;
+  cutneighmin = BIG;
+  cutneighmax = 0.0;
+
+  for (i = 1; i <= n; i++) {
+    cuttype[i] = cuttypesq[i] = 0.0;
+    for (j = 1; j <= n; j++) {
+      if (force->pair) cutoff = sqrt(force->pair->cutsq[i][j]);
+      else cutoff = 0.0;
+      if (cutoff > 0.0) delta = skin;
+      else delta = 0.0;
+      cut = cutoff + delta;
+
+      cutneighsq[i][j] = cut*cut;
+      cuttype[i] = MAX(cuttype[i],cut);
+      cuttypesq[i] = MAX(cuttypesq[i],cut*cut);
+      cutneighmin = MIN(cutneighmin,cut);
+      cutneighmax = MAX(cutneighmax,cut);
+
+      if (force->pair && force->pair->ghostneigh) {
+        cut = force->pair->cutghost[i][j] + skin;
+        cutneighghostsq[i][j] = cut*cut;
+      } else cutneighghostsq[i][j] = cut*cut;
+
+      if (cutoff > 0.0) cut = cutoff + prune_skin;
+      else cut = 0.0;
+      cutprunesq[i][j] = cut*cut;
+    }
+  }
+  cutneighmaxsq = cutneighmax * cutneighmax;
+}
+
 /* ----------------------------------------------------------------------
    if any atom moved trigger distance (half of neighbor skin) return 1
    shrink trigger distance if box size has changed
@@ -1532,25 +1650,160 @@ int Neighbor::check_distance()
     }
   } else deltasq = triggersq;
 
-  double **x = atom->x;
+  // flag = 1 if any owned atom moved more than the trigger distance
+  // x and xhold are scanned as flat arrays, no early exit,
+  //   so the loop can vectorize
+  // if predicting, need max displacement and max speed of any atom instead
+
   int nlocal = atom->nlocal;
   if (includegroup) nlocal = atom->nfirst;
+  double *x = nlocal ? atom->x[0] : NULL;
+  double *xh = xhold;
+
+  int i,flag,flagone,flagall;
+  double maxone[2],maxall[2];
 
-  int flag = 0;
-  for (int i = 0; i < nlocal; i++) {
-    delx = x[i][0] - xhold[i][0];
-    dely = x[i][1] - xhold[i][1];
-    delz = x[i][2] - xhold[i][2];
-    rsq = delx*delx + dely*dely + delz*delz;
-    if (rsq > deltasq) flag = 1;
+  if (!predict) {
+    flag = 0;
+#if defined(_OPENMP)
+#pragma omp parallel for private(i,delx,dely,delz,rsq) \
+  reduction(|:flag) num_threads(comm->nthreads)
+#endif
+    for (i = 0; i < nlocal; i++) {
+      delx = x[3*i] - xh[3*i];
+      dely = x[3*i+1] - xh[3*i+1];
+      delz = x[3*i+2] - xh[3*i+2];
+      rsq = delx*delx + dely*dely + delz*delz;
+      if (rsq > deltasq) flag = 1;
+    }
+
+    // pass a copy, taking the address of flag prevents vectorization
+
+    flagone = flag;
+    MPI_Allreduce(&flagone,&flagall,1,MPI_INT,MPI_MAX,world);
+
+  } else {
+    double *v = nlocal ? atom->v[0] : NULL;
+    double rsqmax = 0.0;
+    double vsqmax = 0.0;
+#if defined(_OPENMP)
+#pragma omp parallel for private(i,delx,dely,delz,rsq) \
+  reduction(max:rsqmax,vsqmax) num_threads(comm->nthreads)
+#endif
+    for (i = 0; i < nlocal; i++) {
+      delx = x[3*i] - xh[3*i];
+      dely = x[3*i+1] - xh[3*i+1];
+      delz = x[3*i+2] - xh[3*i+2];
+      rsq = delx*delx + dely*dely + delz*delz;
+      rsqmax = MAX(rsqmax,rsq);
+      rsq = v[3*i]*v[3*i] + v[3*i+1]*v[3*i+1] + v[3*i+2]*v[3*i+2];
+      vsqmax = MAX(vsqmax,rsq);
+    }
+    maxone[0] = rsqmax;
+    maxone[1] = vsqmax;
+    MPI_Allreduce(maxone,maxall,2,MPI_DOUBLE,MPI_MAX,world);
+    flagall = maxall[0] > deltasq ? 1 : 0;
+  }
+
+  // a trigger is dangerous if it could have happened at an earlier step:
+  //   this is the 1st allowed check or previous checks were skipped
+
+  if (flagall && (ago == MAX(every,delay) || skipflag)) ndanger++;
+  skipflag = 0;
+
+  // no atom can reach the trigger distance before ago = agocheck
+  //   if all atoms move at most PREDICT_SAFETY x current max speed
+  // only predict for a fixed box and during dynamics
+
+  if (predict && !flagall && !boxcheck && update->whichflag == 1) {
+    double dmove = PREDICT_SAFETY * sqrt(maxall[1]) * update->dt;
+    double dleft = sqrt(deltasq) - sqrt(maxall[0]);
+    if (dleft < dmove*(MAXSMALLINT-ago))
+      agocheck = ago + static_cast<int> (dleft/dmove);
   }
 
-  int flagall;
-  MPI_Allreduce(&flag,&flagall,1,MPI_INT,MPI_MAX,world);
-  if (flagall && ago == MAX(every,delay)) ndanger++;
   return flagall;
 }
 
+/* ----------------------------------------------------------------------
+   adjust skin and delay to minimize time per step, called on each build
+     triggered by the distance check
+   after every tune builds, measure per step pair+comm time P,
+     neigh time per build B, steps per build N
+   model of time per step for skin s, with max force cutoff rc:
+     (rc+s)^3/(rc+s0)^3 * (P + B/N * s0/s)
+     both list size and ghost count scale with volume of cutoff sphere,
+     steps between builds scale with s (ballistic motion)
+   its minimum is at 3P s^2 + 2K s - K rc = 0, with K = B s0/N
+   new skin is limited to 1/2 to 2x the old one, and the change is undone
+     if the next window is slower than the one before the change
+   delay = 1/2 of fewest steps between builds, 0 if a build was dangerous
+------------------------------------------------------------------------- */
+
+void Neighbor::tune_skin()
+{
+  tune_nbuild++;
+  if (tune_nbuild == 1) {
+    tune_nmin = ago;
+    tune_step = update->ntimestep;
+    tune_ndanger = ndanger;
+    tune_time[0] = timer->get_wall(Timer::PAIR) + timer->get_wall(Timer::COMM);
+    tune_time[1] = timer->get_wall(Timer::NEIGH);
+    return;
+  }
+  tune_nmin = MIN(tune_nmin,ago);
+  if (tune_nbuild <= tune) return;
+
+  // time of slowest proc, window spans tune builds after the 1st one
+
+  double one[2],all[2];
+  one[0] = timer->get_wall(Timer::PAIR) + timer->get_wall(Timer::COMM) -
+    tune_time[0];
+  one[1] = timer->get_wall(Timer::NEIGH) - tune_time[1];
+  MPI_Allreduce(one,all,2,MPI_DOUBLE,MPI_MAX,world);
+
+  double nsteps = update->ntimestep - tune_step;
+  double pstep = all[0]/nsteps;
+  double bbuild = all[1]/tune;
+  double cost = (all[0]+all[1])/nsteps;
+  double stepsper = nsteps/tune;
+  double rc = cutneighmax - skin;
+  double newskin = skin;
+
+  if (tune_cost > 0.0 && cost > tune_cost) {
+    newskin = tune_skinprev;
+    tune_revert = 1;
+    tune_active = 0;
+  } else if (pstep > 0.0 && rc > 0.0) {
+    double k = bbuild*skin/stepsper;
+    newskin = (sqrt(k*k + 3.0*pstep*k*rc) - k) / (3.0*pstep);
+    newskin = MAX(newskin,0.5*skin);
+    newskin = MIN(newskin,2.0*skin);
+    if (fabs(newskin-skin) < TUNE_TOL*skin) newskin = skin;
+  }
+
+  // delay scales with skin like steps between builds
+
+  if (ndanger > tune_ndanger) delay = 0;
+  else {
+    int nmin = static_cast<int> (0.5*tune_nmin*newskin/skin);
+    delay = every*(nmin/every);
+  }
+
+  if (newskin != skin) {
+    tune_cost = tune_active ? cost : 0.0;
+    tune_skinprev = skin;
+    skin = newskin;
+    triggersq = 0.25*skin*skin;
+    set_cutoffs();
+    comm->setup();
+    if (style) setup_bins();
+    ntune++;
+  } else tune_cost = 0.0;
+
+  tune_nbuild = 0;
+}
+
 /* ----------------------------------------------------------------------
    build perpetual neighbor lists
    called at setup and every few timesteps during run or minimization
@@ -1562,6 +1815,8 @@ void Neighbor::build(int topoflag)
   int i;
 
   ago = 0;
+  agocheck = 0;
+  skipflag = 0;
   ncalls++;
   lastcall = update->ntimestep;
 
@@ -1574,12 +1829,11 @@ void Neighbor::build(int topoflag)
     if (atom->nmax > maxhold) {
       maxhold = atom->nmax;
       memory->destroy(xhold);
-      memory->create(xhold,maxhold,3,"neigh:xhold");
+      memory->create(xhold,3*maxhold,"neigh:xhold");
     }
-    for (i = 0; i < nlocal; i++) {
-      xhold[i][0] = x[i][0];
-      xhold[i][1] = x[i][1];
-      xhold[i][2] = x[i][2];
+    if (nlocal) {
+      double *x0 = x[0];
+      for (i = 0; i < 3*nlocal; i++) xhold[i] = x0[i];
     }
     if (boxcheck) {
       if (triclinic == 0) {
@@ -1630,6 +1884,9 @@ void Neighbor::build(int topoflag)
   // invoke building of pair and molecular topology neighbor lists
   // only for pairwise lists with buildflag set
   // blist is for standard neigh lists, otherwise is a Kokkos list
+  // lists are built unpruned, prune() is invoked after the build
+
+  for (i = 0; i < nplist; i++) lists[plist[i]]->prunedflag = 0;
 
   for (i = 0; i < nblist; i++)
     (this->*pair_build[blist[i]])(lists[blist[i]]);
@@ -1967,6 +2224,24 @@ void Neighbor::modify_params(int narg, char **arg)
       else if (strcmp(arg[iarg+1],"no") == 0) dist_check = 0;
       else error->all(FLERR,"Illegal neigh_modify command");
       iarg += 2;
+    } else if (strcmp(arg[iarg],"tune") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal neigh_modify command");
+      tune = force->inumeric(FLERR,arg[iarg+1]);
+      if (tune < 0) error->all(FLERR,"Illegal neigh_modify command");
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"prune") == 0) {
+      if (iarg+3 > narg) error->all(FLERR,"Illegal neigh_modify command");
+      prune_every = force->inumeric(FLERR,arg[iarg+1]);
+      prune_skin = force->numeric(FLERR,arg[iarg+2]);
+      if (prune_every < 0 || prune_skin < 0.0)
+        error->all(FLERR,"Illegal neigh_modify command");
+      iarg += 3;
+    } else if (strcmp(arg[iarg],"predict") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal neigh_modify command");
+      if (strcmp(arg[iarg+1],"yes") == 0) predict = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) predict = 0;
+      else error->all(FLERR,"Illegal neigh_modify command");
+      iarg += 2;
     } else if (strcmp(arg[iarg],"once") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal neigh_modify command");
       if (strcmp(arg[iarg+1],"yes") == 0) build_once = 1;
@@ -1995,6 +2270,12 @@ void Neighbor::modify_params(int narg, char **arg)
       else if (strcmp(arg[iarg+1],"no") == 0) cluster_check = 0;
       else error->all(FLERR,"Illegal neigh_modify command");
       iarg += 2;
+    } else if (strcmp(arg[iarg],"pair/cluster") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal neigh_modify command");
+      if (strcmp(arg[iarg+1],"yes") == 0) clusterpair = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) clusterpair = 0;
+      else error->all(FLERR,"Illegal neigh_modify command");
+      iarg += 2;
 
     } else if (strcmp(arg[iarg],"include") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal neigh_modify command");
@@ -2073,36 +2354,64 @@ void Neighbor::bin_atoms()
 
   // bin in reverse order so linked list will be in forward order
   // also puts ghost atoms at end of list, which is necessary
+  // bin of each atom is computed by all threads and stored in bins,
+  //   linking then replaces it with the next atom in the bin
 
   double **x = atom->x;
   int *mask = atom->mask;
   int nlocal = atom->nlocal;
   int nall = nlocal + atom->nghost;
 
+#if defined(_OPENMP)
+#pragma omp parallel for private(i) num_threads(comm->nthreads)
+#endif
+  for (i = 0; i < nall; i++) bins[i] = coord2bin(x[i]);
+
   if (includegroup) {
     int bitmask = group->bitmask[includegroup];
     for (i = nall-1; i >= nlocal; i--) {
       if (mask[i] & bitmask) {
-        ibin = coord2bin(x[i]);
+        ibin = bins[i];
         bins[i] = binhead[ibin];
         binhead[ibin] = i;
       }
     }
     for (i = atom->nfirst-1; i >= 0; i--) {
-      ibin = coord2bin(x[i]);
+      ibin = bins[i];
       bins[i] = binhead[ibin];
       binhead[ibin] = i;
     }
 
   } else {
     for (i = nall-1; i >= 0; i--) {
-      ibin = coord2bin(x[i]);
+      ibin = bins[i];
       bins[i] = binhead[ibin];
       binhead[ibin] = i;
     }
   }
 }
 
+/* ----------------------------------------------------------------------
+   assign the calling thread a contiguous chunk of num atoms to build
+   tid = thread ID, which selects the page pool of the list it writes to
+   outside of a parallel region, the one chunk is all atoms
+------------------------------------------------------------------------- */
+
+void Neighbor::thread_chunk(int num, int &tid, int &ifrom, int &ito)
+{
+#if defined(_OPENMP)
+  tid = omp_get_thread_num();
+  int nthreads = omp_get_num_threads();
+#else
+  tid = 0;
+  int nthreads = 1;
+#endif
+
+  int idelta = num/nthreads + 1;
+  ifrom = MIN(tid*idelta,num);
+  ito = MIN(ifrom+idelta,num);
+}
+
 /* ----------------------------------------------------------------------
    convert atom coords into local bin #
    for orthogonal, only ghost atoms will have coord >= bboxhi or coord < bboxlo
@@ -2247,7 +2556,7 @@ void Neighbor::exclusion_group_group_delete(int group1, int group2)
 bigint Neighbor::memory_usage()
 {
   bigint bytes = 0;
-  bytes += memory->usage(xhold,maxhold,3);
+  bytes += memory->usage(xhold,3*maxhold);
 
   if (style != NSQ) {
     bytes += memory->usage(bins,maxbin);
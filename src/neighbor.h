@@ -26,6 +26,10 @@ class Neighbor : protected Pointers {
   int every;                       // build every this many steps
   int delay;                       // delay build for this many steps
   int dist_check;                  // 0 = always build, 1 = only if 1/2 dist
+  int predict;                     // 1 if skip checks that cannot trigger
+  int tune;                        // adjust skin/delay every this many builds
+  int prune_every;                 // prune pair lists every this many steps
+  double prune_skin;               // skin of pruned pair lists
   int ago;                         // how many steps ago neighboring occurred
   int pgsize;                      // size of neighbor page
   int oneatom;                     // max # of neighbors for one atom
@@ -43,6 +47,12 @@ class Neighbor : protected Pointers {
 
   bigint ncalls;                   // # of times build has been called
   bigint ndanger;                  // # of dangerous builds
+  bigint nskip;                    // # of distance checks skipped
+
+  double tune_skin0;               // skin and delay at start of run
+  int tune_delay0;
+  int ntune;                       // # of skin/delay adjustments in run
+  int tune_revert;                 // 1 if last skin change was reverted
   bigint lastcall;                 // timestep of last neighbor::build() call
 
   int nrequest;                    // requests for pairwise neighbor lists
@@ -70,6 +80,7 @@ class Neighbor : protected Pointers {
   int **improperlist;
 
   int cluster_check;               // 1 if check bond/angle/etc satisfies minimg
+  int clusterpair;                 // 1 if pair styles may use cluster-pair lists
 
   // methods
 
@@ -83,6 +94,7 @@ class Neighbor : protected Pointers {
   void setup_bins();                // setup bins based on box and cutoff
   virtual void build(int topoflag=1);  // create all neighbor lists (pair,bond)
   virtual void build_topology();    // create all topology neighbor lists
+  void prune();                     // prune pair lists to smaller skin
   void build_one(class NeighList *list,
                  int preflag=0);    // create a single one-time neigh list
   void set(int, char **);           // set neighbor style and skin distance
@@ -106,16 +118,29 @@ class Neighbor : protected Pointers {
 
   double **cutneighsq;             // neighbor cutneigh sq for each type pair
   double **cutneighghostsq;        // neighbor cutnsq for each ghost type pair
+  double **cutprunesq;             // pruned list cutoff sq for each type pair
   double cutneighmaxsq;            // cutneighmax squared
   double *cuttypesq;               // cuttype squared
 
   double triggersq;                // trigger = build when atom moves this dist
 
-  double **xhold;                      // atom coords at last neighbor build
+  double *xhold;                       // atom coords at last neighbor build,
+                                       //   laid out as x[0]
   int maxhold;                         // size of xhold array
   int boxcheck;                        // 1 if need to store box size
   double boxlo_hold[3],boxhi_hold[3];  // box size at last neighbor build
   double corners_hold[8][3];           // box corners at last neighbor build
+  int agocheck;                        // skip distance checks until this ago
+  int skipflag;                        // 1 if a check was skipped since last
+
+  int tune_active;                     // 1 while tuning skin in this run
+  int tune_nbuild;                     // builds in current tuning window
+  int tune_nmin;                       // fewest steps between these builds
+  bigint tune_step;                    // timestep at start of window
+  bigint tune_ndanger;                 // ndanger at start of window
+  double tune_time[2];                 // pair+comm, neigh time at start
+  double tune_cost;                    // time/step before last skin change
+  double tune_skinprev;                // skin before last skin change
 
   int binatomflag;                 // bin atoms or not when build neigh list
                                    // turned off by build_one()
@@ -174,15 +199,21 @@ class Neighbor : protected Pointers {
   int *blist;                  // lists to build every reneighboring
   int *glist;                  // lists to grow atom arrays every reneigh
   int *slist;                  // lists to grow stencil arrays every reneigh
+  int nplist;                  // # of pair lists pruned between builds
+  int *plist;                  // lists to prune
 
   double *zeroes;              // vector of zeroes for shear history init
 
   // methods
 
+  void set_cutoffs();                   // neighbor cutoffs from skin
+  void tune_skin();                     // adjust skin/delay from timings
   void bin_atoms();                     // bin all atoms
   double bin_distance(int, int, int);   // distance between binx
   int coord2bin(double *);              // mapping atom coord to a bin
   int coord2bin(double *, int &, int &, int&); // ditto
+  void thread_chunk(int, int &, int &, int &);  // atoms built by a thread
+  void prune_list(class NeighList *);   // prune one list from its outer list
 
   int exclusion(int, int, int,
                 int, int *, tagint *) const;    // test for pair exclusion
@@ -220,6 +251,9 @@ class Neighbor : protected Pointers {
   void half_bin_no_newton_ghost(class NeighList *);
   void half_bin_newton(class NeighList *);
   void half_bin_newton_tri(class NeighList *);
+  void half_bin_cluster_no_newton(class NeighList *);
+  void half_bin_cluster_newton(class NeighList *);
+  void half_bin_cluster(class NeighList *, int);
 
   void half_multi_no_newton(class NeighList *);
   void half_multi_newton(class NeighList *);
@@ -370,6 +404,30 @@ The delay and every parameters set via the neigh_modify command are
 inconsistent.  If the delay setting is non-zero, then it must be a
 multiple of the every setting.
 
+E: Neigh_modify tune requires check yes
+
+The skin and delay are only tuned when builds are triggered by the
+distance check.
+
+E: Neigh_modify tune not allowed with rRESPA or KOKKOS
+
+These set up inner cutoffs or device copies of the neighbor cutoffs
+once per run, so the skin cannot change during the run.
+
+E: Neigh_modify tune requires timer normal or full
+
+The tuning uses the Pair, Comm, and Neigh timings of the "timer"
+command, which are not collected at timer level off or loop.
+
+E: Neigh_modify prune skin must be < neighbor skin
+
+The pruned lists are taken from the lists built with the skin of
+the neighbor command, so a pruned list can only use a smaller skin.
+
+E: Neigh_modify prune not allowed with rRESPA
+
+The rRESPA inner, middle, and outer lists are not pruned.
+
 E: Neighbor page size must be >= 10x the one atom setting
 
 This is required to prevent wasting too much memory.
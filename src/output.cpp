@@ -774,7 +774,7 @@ void Output::create_restart(int narg, char **arg)
     strcpy(restart2b,arg[2]);
   }
 
-  // check for multiproc output and an MPI-IO filename
+  // check for multiproc output, an MPI-IO filename, and a snapshot filename
   // if 2 filenames, must be consistent
 
   int multiproc;
@@ -797,12 +797,23 @@ void Output::create_restart(int narg, char **arg)
       error->all(FLERR,"Both restart files must use MPI-IO or neither");
   }
 
+  int snapflag;
+  if (strstr(arg[1],".snap")) snapflag = 1;
+  else snapflag = 0;
+  if (nfile == 2) {
+    if (snapflag && !strstr(arg[2],".snap"))
+      error->all(FLERR,"Both restart files must be snapshots or neither");
+    if (!snapflag && strstr(arg[2],".snap"))
+      error->all(FLERR,"Both restart files must be snapshots or neither");
+  }
+
   // setup output style and process optional args
 
   delete restart;
   restart = new WriteRestart(lmp);
   int iarg = nfile+1;
-  restart->multiproc_options(multiproc,mpiioflag,narg-iarg,&arg[iarg]);
+  restart->multiproc_options(multiproc,mpiioflag,snapflag,
+                             narg-iarg,&arg[iarg]);
 }
 
 /* ----------------------------------------------------------------------
@@ -184,4 +184,8 @@ E: Both restart files must use MPI-IO or neither
 
 Self-explanatory.
 
+E: Both restart files must be snapshots or neither
+
+Self-explanatory.
+
 */
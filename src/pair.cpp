@@ -304,6 +304,40 @@ void Pair::init_list(int which, NeighList *ptr)
   list = ptr;
 }
 
+/* ----------------------------------------------------------------------
+   compute forces of n I atoms of the neighbor list starting at ilist[first]
+   used to split compute() around comm, see Verlet::run()
+   if sum = 1, add back global energy and explicit virial tallied
+     before this call, by previous calls or other classes via ev_tally()
+   a virial via fdotr is from all forces so far and is not added back
+------------------------------------------------------------------------- */
+
+void Pair::compute_partial(int eflag, int vflag, int first, int n, int sum)
+{
+  int i;
+  double eng[2],vir[6];
+
+  eng[0] = eng_vdwl;
+  eng[1] = eng_coul;
+  for (i = 0; i < 6; i++) vir[i] = virial[i];
+
+  int inum = list->inum;
+  int *ilist = list->ilist;
+  list->inum = n;
+  list->ilist = ilist + first;
+  compute(eflag,vflag);
+  list->inum = inum;
+  list->ilist = ilist;
+
+  if (!sum) return;
+  if (eflag_global) {
+    eng_vdwl += eng[0];
+    eng_coul += eng[1];
+  }
+  if (vflag_global)
+    for (i = 0; i < 6; i++) virial[i] += vir[i];
+}
+
 /* ----------------------------------------------------------------------
    setup Coulomb force tables used in compute routines
 ------------------------------------------------------------------------- */
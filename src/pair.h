@@ -153,6 +153,7 @@ class Pair : protected Pointers {
 
   virtual void init_style();
   virtual void init_list(int, class NeighList *);
+  void compute_partial(int, int, int, int, int);
   virtual double init_one(int, int) {return 0.0;}
 
   virtual void init_tables(double, double *);
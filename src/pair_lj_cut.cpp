@@ -36,18 +36,29 @@
 using namespace LAMMPS_NS;
 using namespace MathConst;
 
+#define NPAIR (NCLUSTER*NCLUSTER)
+
 /* ---------------------------------------------------------------------- */
 
 PairLJCut::PairLJCut(LAMMPS *lmp) : Pair(lmp)
 {
   respa_enable = 1;
   writedata = 1;
+
+  maxcluster = 0;
+  xcluster = NULL;
+  fcluster = NULL;
+  tcluster = NULL;
 }
 
 /* ---------------------------------------------------------------------- */
 
 PairLJCut::~PairLJCut()
 {
+  memory->destroy(xcluster);
+  memory->destroy(fcluster);
+  memory->destroy(tcluster);
+
   if (allocated) {
     memory->destroy(setflag);
     memory->destroy(cutsq);
@@ -83,6 +94,13 @@ void PairLJCut::compute(int eflag, int vflag)
   double *special_lj = force->special_lj;
   int newton_pair = force->newton_pair;
 
+  // cluster-pair list: regular list below only stores special pairs
+
+  if (list->clusterflag) {
+    if (evflag) eval_cluster<1>(eflag);
+    else eval_cluster<0>(eflag);
+  }
+
   inum = list->inum;
   ilist = list->ilist;
   numneigh = list->numneigh;
@@ -140,6 +158,177 @@ void PairLJCut::compute(int eflag, int vflag)
   if (vflag_fdotr) virial_fdotr_compute();
 }
 
+/* ----------------------------------------------------------------------
+   compute all non-special pairs of a cluster-pair list
+   coords and types are gathered into cluster order once per step,
+     so the loop over the atoms of a J cluster has no indirection
+     and is written so the compiler can vectorize it
+   pairs outside the mask or cutoff get fpair = 0.0
+------------------------------------------------------------------------- */
+
+template <int EVFLAG>
+void PairLJCut::eval_cluster(int eflag)
+{
+  int a,b,c,i,k,ci,cj,jj,jnum,itype,jtype,bits,incut;
+  double evdwl,rsq,r2inv,r6inv,forcelj;
+  double xi[NPAIR],yi[NPAIR],zi[NPAIR],fxi[NPAIR],fyi[NPAIR],fzi[NPAIR];
+  double delx[NPAIR],dely[NPAIR],delz[NPAIR],fpair[NPAIR];
+  double cutsqij[NPAIR],lj1ij[NPAIR],lj2ij[NPAIR];
+  const double *cutsqi[NCLUSTER],*lj1i[NCLUSTER],*lj2i[NCLUSTER];
+  int *jlist;
+
+  double **x = atom->x;
+  double **f = atom->f;
+  int *type = atom->type;
+  int nlocal = atom->nlocal;
+  int newton_pair = force->newton_pair;
+
+  int ncluster = list->ncluster;
+  int nclusterlocal = list->nclusterlocal;
+  int *catom = list->catom;
+  int *cnumneigh = list->cnumneigh;
+  int **cfirstneigh = list->cfirstneigh;
+
+  // gather coords and types, empty slots are never in a pair mask
+  // forces are accumulated per cluster and scattered to f at the end
+
+  if (ncluster > maxcluster) {
+    maxcluster = list->maxcluster;
+    memory->destroy(xcluster);
+    memory->destroy(fcluster);
+    memory->destroy(tcluster);
+    memory->create(xcluster,3*NCLUSTER*maxcluster,"pair:xcluster");
+    memory->create(fcluster,3*NCLUSTER*maxcluster,"pair:fcluster");
+    memory->create(tcluster,NCLUSTER*maxcluster,"pair:tcluster");
+  }
+
+  for (c = 0; c < ncluster; c++) {
+    double *xc = &xcluster[3*NCLUSTER*c];
+    for (a = 0; a < NCLUSTER; a++) {
+      i = catom[c*NCLUSTER+a];
+      if (i >= 0) {
+        xc[a] = x[i][0];
+        xc[NCLUSTER+a] = x[i][1];
+        xc[2*NCLUSTER+a] = x[i][2];
+        tcluster[c*NCLUSTER+a] = type[i];
+      } else {
+        xc[a] = xc[NCLUSTER+a] = xc[2*NCLUSTER+a] = 0.0;
+        tcluster[c*NCLUSTER+a] = 1;
+      }
+    }
+  }
+
+  for (k = 0; k < 3*NCLUSTER*ncluster; k++) fcluster[k] = 0.0;
+
+  evdwl = 0.0;
+
+  // loop over J clusters of my clusters
+  // pair k of a cluster pair = atom k/NCLUSTER of I, atom k%NCLUSTER of J
+
+  for (ci = 0; ci < nclusterlocal; ci++) {
+    const double *xci = &xcluster[3*NCLUSTER*ci];
+    const int *tci = &tcluster[NCLUSTER*ci];
+    jlist = cfirstneigh[ci];
+    jnum = cnumneigh[ci];
+
+    for (a = 0; a < NCLUSTER; a++) {
+      itype = tci[a];
+      cutsqi[a] = cutsq[itype];
+      lj1i[a] = lj1[itype];
+      lj2i[a] = lj2[itype];
+    }
+    for (k = 0; k < NPAIR; k++) {
+      xi[k] = xci[k/NCLUSTER];
+      yi[k] = xci[NCLUSTER+k/NCLUSTER];
+      zi[k] = xci[2*NCLUSTER+k/NCLUSTER];
+      fxi[k] = fyi[k] = fzi[k] = 0.0;
+    }
+
+    for (jj = 0; jj < jnum; jj += 2) {
+      cj = jlist[jj];
+      bits = jlist[jj+1];
+      const double *xcj = &xcluster[3*NCLUSTER*cj];
+      const int *tcj = &tcluster[NCLUSTER*cj];
+      double *fcj = &fcluster[3*NCLUSTER*cj];
+
+      // per-pair coeffs, pairs not in mask get a cutoff of 0.0
+
+      for (k = 0; k < NPAIR; k++) {
+        jtype = tcj[k%NCLUSTER];
+        cutsqij[k] = ((bits >> k) & 1) ? cutsqi[k/NCLUSTER][jtype] : 0.0;
+        lj1ij[k] = lj1i[k/NCLUSTER][jtype];
+        lj2ij[k] = lj2i[k/NCLUSTER][jtype];
+      }
+
+      for (k = 0; k < NPAIR; k++) {
+        delx[k] = xi[k] - xcj[k%NCLUSTER];
+        dely[k] = yi[k] - xcj[NCLUSTER+k%NCLUSTER];
+        delz[k] = zi[k] - xcj[2*NCLUSTER+k%NCLUSTER];
+        rsq = delx[k]*delx[k] + dely[k]*dely[k] + delz[k]*delz[k];
+        incut = rsq < cutsqij[k];
+        r2inv = 1.0/(incut ? rsq : 1.0);
+        r6inv = r2inv*r2inv*r2inv;
+        forcelj = r6inv * (lj1ij[k]*r6inv - lj2ij[k]);
+        fpair[k] = incut ? forcelj*r2inv : 0.0;
+        fxi[k] += delx[k]*fpair[k];
+        fyi[k] += dely[k]*fpair[k];
+        fzi[k] += delz[k]*fpair[k];
+      }
+
+      for (a = 0; a < NCLUSTER; a++)
+        for (b = 0; b < NCLUSTER; b++) {
+          k = a*NCLUSTER + b;
+          fcj[b] -= delx[k]*fpair[k];
+          fcj[NCLUSTER+b] -= dely[k]*fpair[k];
+          fcj[2*NCLUSTER+b] -= delz[k]*fpair[k];
+        }
+
+      if (EVFLAG) {
+        for (k = 0; k < NPAIR; k++) {
+          rsq = delx[k]*delx[k] + dely[k]*dely[k] + delz[k]*delz[k];
+          if (rsq >= cutsqij[k]) continue;
+          a = k/NCLUSTER;
+          b = k%NCLUSTER;
+          if (eflag) {
+            itype = tci[a];
+            jtype = tcj[b];
+            r2inv = 1.0/rsq;
+            r6inv = r2inv*r2inv*r2inv;
+            evdwl = r6inv*(lj3[itype][jtype]*r6inv-lj4[itype][jtype]) -
+              offset[itype][jtype];
+          }
+          ev_tally(catom[ci*NCLUSTER+a],catom[cj*NCLUSTER+b],nlocal,
+                   newton_pair,evdwl,0.0,fpair[k],delx[k],dely[k],delz[k]);
+        }
+      }
+    }
+
+    double *fci = &fcluster[3*NCLUSTER*ci];
+    for (a = 0; a < NCLUSTER; a++)
+      for (b = 0; b < NCLUSTER; b++) {
+        k = a*NCLUSTER + b;
+        fci[a] += fxi[k];
+        fci[NCLUSTER+a] += fyi[k];
+        fci[2*NCLUSTER+a] += fzi[k];
+      }
+  }
+
+  // add cluster forces to atoms, ghost atoms only if newton is on
+
+  if (newton_pair == 0) ncluster = nclusterlocal;
+
+  for (c = 0; c < ncluster; c++) {
+    double *fc = &fcluster[3*NCLUSTER*c];
+    for (a = 0; a < NCLUSTER; a++) {
+      i = catom[c*NCLUSTER+a];
+      if (i < 0) break;
+      f[i][0] += fc[a];
+      f[i][1] += fc[NCLUSTER+a];
+      f[i][2] += fc[2*NCLUSTER+a];
+    }
+  }
+}
+
 /* ---------------------------------------------------------------------- */
 
 void PairLJCut::compute_inner()
@@ -515,7 +704,14 @@ void PairLJCut::init_style()
       neighbor->requests[irequest]->respaouter = 1;
     }
 
-  } else irequest = neighbor->request(this,instance_me);
+  } else {
+    irequest = neighbor->request(this,instance_me);
+
+    // cluster-pair list only if compute() is not overridden by a derived style
+
+    if (strcmp(force->pair_style,"lj/cut") == 0)
+      neighbor->requests[irequest]->cluster = 1;
+  }
 
   // set rRESPA cutoffs
 
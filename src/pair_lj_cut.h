@@ -54,7 +54,13 @@ class PairLJCut : public Pair {
   double **lj1,**lj2,**lj3,**lj4,**offset;
   double *cut_respa;
 
+  int maxcluster;                // size of cluster-pair list gather arrays
+  double *xcluster;              // coords of atoms in each cluster
+  double *fcluster;              // forces on atoms in each cluster
+  int *tcluster;                 // types of atoms in each cluster
+
   virtual void allocate();
+  template <int EVFLAG> void eval_cluster(int);
 };
 
 }
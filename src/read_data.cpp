@@ -58,6 +58,17 @@ using namespace LAMMPS_NS;
 #define NSECTIONS 25       // change when add to header::section_keywords
 
 enum{NONE,APPEND,VALUE,MERGE};
+enum{VELOCITIES,BONDS,ANGLES,DIHEDRALS,IMPROPERS};   // routed sections
+
+// one line of a section routed from a reader proc to the owning proc
+// text of line follows the struct in the datum
+
+struct LineRvous {
+  tagint atomID;       // atom whose owner processes the line
+  bigint offset;       // file offset of line, orders and uniquifies lines
+};
+
+static int compare_offset(const void *, const void *);
 
 // pair style suffixes to ignore
 // when matching Pair Coeffs comment to currently-defined pair style
@@ -80,6 +91,7 @@ ReadData::ReadData(LAMMPS *lmp) : Pointers(lmp)
   narg = maxarg = 0;
   arg = NULL;
   fp = NULL;
+  fpslice = NULL;
 
   // customize for new sections
   // pointers to atom styles that store extra info
@@ -132,6 +144,7 @@ void ReadData::command(int narg, char **arg)
     extra_dihedral_types = extra_improper_types = 0;
 
   groupbit = 0;
+  nreaders = 0;
 
   nfix = 0;
   fix_index = NULL;
@@ -176,6 +189,12 @@ void ReadData::command(int narg, char **arg)
     } else if (strcmp(arg[iarg],"nocoeff") == 0) {
       coeffflag = 0;
       iarg ++;
+    } else if (strcmp(arg[iarg],"readers") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal read_data command");
+      nreaders = force->inumeric(FLERR,arg[iarg+1]);
+      if (nreaders <= 0) error->all(FLERR,"Illegal read_data command");
+      nreaders = MIN(nreaders,comm->nprocs);
+      iarg += 2;
     } else if (strcmp(arg[iarg],"extra/atom/types") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal read_data command");
       extra_atom_types = force->inumeric(FLERR,arg[iarg+1]);
@@ -265,6 +284,21 @@ void ReadData::command(int narg, char **arg)
        extra_dihedral_types || extra_improper_types))
     error->all(FLERR,"Cannot use read_data extra with add flag");
 
+  // setup parallel reading of large sections
+  // reader procs are spread evenly across all procs
+
+  if (nreaders) {
+    if (addflag != NONE)
+      error->all(FLERR,"Cannot use read_data readers with add keyword");
+    char *suffix = arg[0] + strlen(arg[0]) - 3;
+    if (suffix > arg[0] && strcmp(suffix,".gz") == 0)
+      error->all(FLERR,"Cannot use read_data readers with a gzipped data file");
+    datafile = arg[0];
+    ireader = -1;
+    for (int i = 0; i < nreaders; i++)
+      if (static_cast<bigint> (i) * comm->nprocs / nreaders == me) ireader = i;
+  }
+
   // first time system initialization
 
   if (addflag == NONE) {
@@ -1078,14 +1112,54 @@ void ReadData::atoms()
     if (logfile) fprintf(logfile,"  reading atoms ...\n");
   }
 
-  bigint nread = 0;
+  // if parallel read, each reader parses its slice of the section
+  //   and keeps all atoms, then atoms are migrated to owning procs
+  // preassign owning procs so triclinic x is not converted to lamda and back
+  // first do map_init() since irregular->migrate_atoms() will do map_clear()
+  // else proc 0 reads chunks and bcasts them, each proc keeps its atoms
 
-  while (nread < natoms) {
-    nchunk = MIN(natoms-nread,CHUNK);
-    eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
-    if (eof) error->all(FLERR,"Unexpected end of data file");
-    atom->data_atoms(nchunk,buffer,id_offset,toffset,shiftflag,shift);
-    nread += nchunk;
+  if (nreaders) {
+    bigint bounds[2];
+    section_bounds(natoms,bounds);
+    slice_open(bounds);
+    while ((nchunk = slice_lines(CHUNK,buffer)))
+      atom->data_atoms(nchunk,buffer,id_offset,toffset,shiftflag,shift,1);
+    slice_close();
+
+    double **x = atom->x;
+    int nlocal = atom->nlocal;
+    int igx,igy,igz;
+    double lamda[3];
+    int *procassign;
+    memory->create(procassign,nlocal,"read_data:procassign");
+
+    comm->coord2proc_setup();
+    for (int i = 0; i < nlocal; i++) {
+      if (domain->triclinic) {
+        domain->x2lamda(x[i],lamda);
+        procassign[i] = comm->coord2proc(lamda,igx,igy,igz);
+      } else procassign[i] = comm->coord2proc(x[i],igx,igy,igz);
+    }
+
+    if (atom->map_style) {
+      atom->map_init();
+      atom->map_set();
+    }
+    Irregular *irregular = new Irregular(lmp);
+    irregular->migrate_atoms(1,1,procassign);
+    delete irregular;
+    memory->destroy(procassign);
+
+  } else {
+    bigint nread = 0;
+
+    while (nread < natoms) {
+      nchunk = MIN(natoms-nread,CHUNK);
+      eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
+      if (eof) error->all(FLERR,"Unexpected end of data file");
+      atom->data_atoms(nchunk,buffer,id_offset,toffset,shiftflag,shift,0);
+      nread += nchunk;
+    }
   }
 
   // check that all atoms were assigned correctly
@@ -1136,14 +1210,17 @@ void ReadData::velocities()
     atom->map_set();
   }
 
-  bigint nread = 0;
-
-  while (nread < natoms) {
-    nchunk = MIN(natoms-nread,CHUNK);
-    eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
-    if (eof) error->all(FLERR,"Unexpected end of data file");
-    atom->data_vels(nchunk,buffer,id_offset);
-    nread += nchunk;
+  if (nreaders) route_lines(natoms,VELOCITIES,NULL);
+  else {
+    bigint nread = 0;
+
+    while (nread < natoms) {
+      nchunk = MIN(natoms-nread,CHUNK);
+      eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
+      if (eof) error->all(FLERR,"Unexpected end of data file");
+      atom->data_vels(nchunk,buffer,id_offset);
+      nread += nchunk;
+    }
   }
 
   if (mapflag) {
@@ -1186,14 +1263,17 @@ void ReadData::bonds(int firstpass)
 
   // read and process bonds
 
-  bigint nread = 0;
-
-  while (nread < nbonds) {
-    nchunk = MIN(nbonds-nread,CHUNK);
-    eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
-    if (eof) error->all(FLERR,"Unexpected end of data file");
-    atom->data_bonds(nchunk,buffer,count,id_offset,boffset);
-    nread += nchunk;
+  if (nreaders) route_lines(nbonds,BONDS,count);
+  else {
+    bigint nread = 0;
+
+    while (nread < nbonds) {
+      nchunk = MIN(nbonds-nread,CHUNK);
+      eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
+      if (eof) error->all(FLERR,"Unexpected end of data file");
+      atom->data_bonds(nchunk,buffer,count,id_offset,boffset);
+      nread += nchunk;
+    }
   }
 
   // if firstpass: tally max bond/atom and return
@@ -1269,14 +1349,17 @@ void ReadData::angles(int firstpass)
 
   // read and process angles
 
-  bigint nread = 0;
-
-  while (nread < nangles) {
-    nchunk = MIN(nangles-nread,CHUNK);
-    eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
-    if (eof) error->all(FLERR,"Unexpected end of data file");
-    atom->data_angles(nchunk,buffer,count,id_offset,aoffset);
-    nread += nchunk;
+  if (nreaders) route_lines(nangles,ANGLES,count);
+  else {
+    bigint nread = 0;
+
+    while (nread < nangles) {
+      nchunk = MIN(nangles-nread,CHUNK);
+      eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
+      if (eof) error->all(FLERR,"Unexpected end of data file");
+      atom->data_angles(nchunk,buffer,count,id_offset,aoffset);
+      nread += nchunk;
+    }
   }
 
   // if firstpass: tally max angle/atom and return
@@ -1352,14 +1435,17 @@ void ReadData::dihedrals(int firstpass)
 
   // read and process dihedrals
 
-  bigint nread = 0;
-
-  while (nread < ndihedrals) {
-    nchunk = MIN(ndihedrals-nread,CHUNK);
-    eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
-    if (eof) error->all(FLERR,"Unexpected end of data file");
-    atom->data_dihedrals(nchunk,buffer,count,id_offset,doffset);
-    nread += nchunk;
+  if (nreaders) route_lines(ndihedrals,DIHEDRALS,count);
+  else {
+    bigint nread = 0;
+
+    while (nread < ndihedrals) {
+      nchunk = MIN(ndihedrals-nread,CHUNK);
+      eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
+      if (eof) error->all(FLERR,"Unexpected end of data file");
+      atom->data_dihedrals(nchunk,buffer,count,id_offset,doffset);
+      nread += nchunk;
+    }
   }
 
   // if firstpass: tally max dihedral/atom and return
@@ -1435,14 +1521,17 @@ void ReadData::impropers(int firstpass)
 
   // read and process impropers
 
-  bigint nread = 0;
-
-  while (nread < nimpropers) {
-    nchunk = MIN(nimpropers-nread,CHUNK);
-    eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
-    if (eof) error->all(FLERR,"Unexpected end of data file");
-    atom->data_impropers(nchunk,buffer,count,id_offset,ioffset);
-    nread += nchunk;
+  if (nreaders) route_lines(nimpropers,IMPROPERS,count);
+  else {
+    bigint nread = 0;
+
+    while (nread < nimpropers) {
+      nchunk = MIN(nimpropers-nread,CHUNK);
+      eof = comm->read_lines_from_file(fp,nchunk,MAXLINE,buffer);
+      if (eof) error->all(FLERR,"Unexpected end of data file");
+      atom->data_impropers(nchunk,buffer,count,id_offset,ioffset);
+      nread += nchunk;
+    }
   }
 
   // if firstpass: tally max improper/atom and return
@@ -1958,6 +2047,279 @@ void ReadData::skip_lines(bigint n)
   if (eof == NULL) error->one(FLERR,"Unexpected end of data file");
 }
 
+/* ----------------------------------------------------------------------
+   find file offsets of a section of N lines starting at current position
+   proc 0 skips the section by scanning for newlines, without parsing it
+   bounds = offset of first line and of first byte after section
+------------------------------------------------------------------------- */
+
+void ReadData::section_bounds(bigint n, bigint *bounds)
+{
+  if (me == 0) {
+    bounds[0] = ftell(fp);
+    bigint offset = bounds[0];
+    bigint nskip = 0;
+    while (nskip < n) {
+      int nbuf = fread(buffer,1,CHUNK*MAXLINE,fp);
+      if (nbuf == 0) error->one(FLERR,"Unexpected end of data file");
+      char *ptr = buffer;
+      char *end = buffer + nbuf;
+      while (nskip < n && (ptr = (char *) memchr(ptr,'\n',end-ptr))) {
+        ptr++;
+        nskip++;
+      }
+      if (nskip == n) offset += ptr - buffer;
+      else offset += nbuf;
+    }
+    fseek(fp,offset,SEEK_SET);
+    bounds[1] = offset;
+  }
+
+  MPI_Bcast(bounds,2,MPI_LMP_BIGINT,0,world);
+}
+
+/* ----------------------------------------------------------------------
+   reader procs open data file at start of their slice of a section
+   section is split into equal byte ranges, one per reader
+   a reader owns all lines that start within its byte range
+------------------------------------------------------------------------- */
+
+void ReadData::slice_open(bigint *bounds)
+{
+  slicepos = slicehi = 0;
+  if (ireader < 0) return;
+
+  bigint nbytes = bounds[1] - bounds[0];
+  slicepos = bounds[0] + ireader*nbytes/nreaders;
+  slicehi = bounds[0] + (ireader+1)*nbytes/nreaders;
+  if (slicepos == slicehi) return;
+
+  fpslice = fopen(datafile,"r");
+  if (fpslice == NULL) {
+    char str[128];
+    sprintf(str,"Cannot open file %s",datafile);
+    error->one(FLERR,str);
+  }
+
+  // skip partial line that started in previous reader's byte range
+
+  if (ireader == 0) fseek(fpslice,slicepos,SEEK_SET);
+  else {
+    fseek(fpslice,slicepos-1,SEEK_SET);
+    do {
+      if (fgets(line,MAXLINE,fpslice) == NULL) {
+        line[0] = '\n';
+        break;
+      }
+    } while (line[strlen(line)-1] != '\n');
+    slicepos = ftell(fpslice);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   read up to N lines from my slice into buf
+   return # of lines read, 0 when slice is exhausted or not a reader
+------------------------------------------------------------------------- */
+
+int ReadData::slice_lines(int n, char *buf)
+{
+  int m = 0;
+  int nread = 0;
+
+  while (nread < n && slicepos < slicehi) {
+    if (fgets(&buf[m],MAXLINE,fpslice) == NULL)
+      error->one(FLERR,"Unexpected end of data file");
+    int len = strlen(&buf[m]);
+    m += len;
+    slicepos += len;
+    nread++;
+  }
+
+  return nread;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void ReadData::slice_close()
+{
+  if (fpslice) fclose(fpslice);
+  fpslice = NULL;
+}
+
+/* ----------------------------------------------------------------------
+   parallel read of N lines of Velocities or topology section
+   each reader sends every line of its slice to the owning proc of each
+     atom that stores the velocity or interaction, via rendezvous comm
+   receiving procs process lines in file order via Atom::data_*()
+   which = VELOCITIES,BONDS,ANGLES,DIHEDRALS,IMPROPERS
+   count = per-atom tally if 1st pass of topology section, else NULL
+------------------------------------------------------------------------- */
+
+void ReadData::route_lines(bigint n, int which, int *count)
+{
+  const char *names[] = {"Velocities","Bonds","Angles",
+                         "Dihedrals","Impropers"};
+
+  // read my slice of section into text, one line after another
+
+  bigint bounds[2];
+  section_bounds(n,bounds);
+  slice_open(bounds);
+
+  bigint slicelo = slicepos;
+  bigint ntext = 0;
+  bigint maxtext = 0;
+  char *text = NULL;
+
+  while (1) {
+    if (ntext + CHUNK*MAXLINE > maxtext) {
+      maxtext = 2*maxtext + CHUNK*MAXLINE;
+      text = (char *) memory->srealloc(text,maxtext,"read_data:text");
+    }
+    bigint previous = slicepos;
+    if (slice_lines(CHUNK,&text[ntext]) == 0) break;
+    ntext += slicepos - previous;
+  }
+
+  slice_close();
+
+  if (ntext && text[ntext-1] != '\n') text[ntext++] = '\n';
+
+  // first = index of first word in line that is an atom ID to route by
+  // nid = # of atom IDs to route by
+  // if newton_bond, only atom that stores interaction receives it
+  //   else all atoms in interaction do
+
+  int newton_bond = force->newton_bond;
+  int first,nid;
+
+  if (which == VELOCITIES) {
+    first = 0;
+    nid = 1;
+  } else if (which == BONDS) {
+    first = 2;
+    nid = newton_bond ? 1 : 2;
+  } else if (which == ANGLES) {
+    first = newton_bond ? 3 : 2;
+    nid = newton_bond ? 1 : 3;
+  } else {
+    first = newton_bond ? 3 : 2;
+    nid = newton_bond ? 1 : 4;
+  }
+
+  // datum size is set by longest line in section
+
+  int nline = 0;
+  int maxlen = 0;
+  char *ptr = text;
+  char *end = text + ntext;
+  char *next;
+
+  while (ptr < end) {
+    next = (char *) memchr(ptr,'\n',end-ptr);
+    maxlen = MAX(maxlen,next-ptr+1);
+    nline++;
+    ptr = next + 1;
+  }
+
+  int maxall;
+  MPI_Allreduce(&maxlen,&maxall,1,MPI_INT,MPI_MAX,world);
+  int nbytes = sizeof(LineRvous) + maxall + 1;
+  nbytes = (nbytes + sizeof(bigint) - 1) / sizeof(bigint) * sizeof(bigint);
+
+  // pack one datum per line per routing atom ID
+
+  char *inbuf = (char *)
+    memory->smalloc((bigint) nline*nid*nbytes,"read_data:inbuf");
+
+  int nsend = 0;
+  char *word;
+  LineRvous *datum;
+  ptr = text;
+
+  while (ptr < end) {
+    next = (char *) memchr(ptr,'\n',end-ptr);
+    int len = next - ptr + 1;
+    memcpy(copy,ptr,len);
+    copy[len] = '\0';
+
+    word = strtok(copy," \t\n\r\f");
+    for (int i = 0; i < first && word; i++) word = strtok(NULL," \t\n\r\f");
+
+    for (int i = 0; i < nid; i++) {
+      if (word == NULL) {
+        char str[128];
+        sprintf(str,"Invalid atom ID in %s section of data file",names[which]);
+        error->one(FLERR,str);
+      }
+      tagint atomID = ATOTAGINT(word) + id_offset;
+      if (atomID <= 0 || atomID > atom->map_tag_max) {
+        char str[128];
+        sprintf(str,"Invalid atom ID in %s section of data file",names[which]);
+        error->one(FLERR,str);
+      }
+
+      datum = (LineRvous *) &inbuf[(bigint) nsend*nbytes];
+      datum->atomID = atomID;
+      datum->offset = slicelo + (ptr - text);
+      memcpy(&inbuf[(bigint) nsend*nbytes + sizeof(LineRvous)],ptr,len);
+      inbuf[(bigint) nsend*nbytes + sizeof(LineRvous) + len] = '\0';
+      nsend++;
+
+      word = strtok(NULL," \t\n\r\f");
+    }
+
+    ptr = next + 1;
+  }
+
+  memory->sfree(text);
+
+  // send each line to owner of its routing atom(s)
+
+  char *outbuf;
+  int nout = comm->rendezvous_atoms(nsend,inbuf,nbytes,outbuf);
+  memory->sfree(inbuf);
+
+  // sort received lines by file offset, so are processed in file order
+  // line can be received twice if 2 of its atoms are owned by this proc
+
+  qsort(outbuf,nout,nbytes,compare_offset);
+
+  char *lines = (char *)
+    memory->smalloc((bigint) nout*(maxall+1),"read_data:lines");
+
+  int nrecv = 0;
+  bigint m = 0;
+  bigint previous = -1;
+  for (int i = 0; i < nout; i++) {
+    datum = (LineRvous *) &outbuf[(bigint) i*nbytes];
+    if (datum->offset == previous) continue;
+    previous = datum->offset;
+    strcpy(&lines[m],&outbuf[(bigint) i*nbytes + sizeof(LineRvous)]);
+    m += strlen(&lines[m]);
+    nrecv++;
+  }
+
+  memory->sfree(outbuf);
+
+  // process received lines as if read serially
+
+  if (nrecv) {
+    if (which == VELOCITIES)
+      atom->data_vels(nrecv,lines,id_offset);
+    else if (which == BONDS)
+      atom->data_bonds(nrecv,lines,count,id_offset,boffset);
+    else if (which == ANGLES)
+      atom->data_angles(nrecv,lines,count,id_offset,aoffset);
+    else if (which == DIHEDRALS)
+      atom->data_dihedrals(nrecv,lines,count,id_offset,doffset);
+    else if (which == IMPROPERS)
+      atom->data_impropers(nrecv,lines,count,id_offset,ioffset);
+  }
+
+  memory->sfree(lines);
+}
+
 /* ----------------------------------------------------------------------
    parse a line of coeffs into words, storing them in narg,arg
    trim anything from '#' onward
@@ -2028,3 +2390,17 @@ int ReadData::style_match(const char *one, const char *two)
   if ((len1 == 0) || (len1 == len2) || (strncmp(one,two,len1) == 0)) return 1;
   return 0;
 }
+
+/* ----------------------------------------------------------------------
+   comparison function invoked by qsort()
+   order routed lines by their offset in data file
+------------------------------------------------------------------------- */
+
+int compare_offset(const void *iptr, const void *jptr)
+{
+  bigint ioffset = ((LineRvous *) iptr)->offset;
+  bigint joffset = ((LineRvous *) jptr)->offset;
+  if (ioffset < joffset) return -1;
+  if (ioffset > joffset) return 1;
+  return 0;
+}
@@ -77,6 +77,14 @@ class ReadData : protected Pointers {
   char **fix_header;
   char **fix_section;
 
+  // parallel reading of large sections by multiple procs
+
+  int nreaders;             // # of reader procs, 0 = proc 0 reads all
+  int ireader;              // my reader index, -1 if not a reader
+  char *datafile;           // name of data file for readers to open
+  FILE *fpslice;            // reader's own handle on data file
+  bigint slicepos,slicehi;  // current and end offset of my slice of section
+
   // methods
 
   void open(char *);
@@ -85,6 +93,11 @@ class ReadData : protected Pointers {
   void header(int);
   void parse_keyword(int);
   void skip_lines(bigint);
+  void section_bounds(bigint, bigint *);
+  void slice_open(bigint *);
+  int slice_lines(int, char *);
+  void slice_close();
+  void route_lines(bigint, int, int *);
   void parse_coeffs(char *, const char *, int, int, int);
   int style_match(const char *, const char *);
 
@@ -124,6 +137,16 @@ Self-explanatory.  Check the input script syntax and compare to the
 documentation for the command.  You can use -echo screen as a
 command-line option when running LAMMPS to see the offending line.
 
+E: Cannot use read_data readers with add keyword
+
+Parallel reading of a data file is only supported for the first
+data file read.
+
+E: Cannot use read_data readers with a gzipped data file
+
+Each reader proc must seek to its own portion of the file, which is
+not possible with a compressed file.
+
 E: Read data add offset is too big
 
 It cannot be larger than the size of atom IDs, e.g. the maximum 32-bit
@@ -62,7 +62,28 @@ enum{VERSION,SMALLINT,TAGINT,BIGINT,
      MULTIPROC,MPIIO,PROCSPERFILE,PERPROC,
      IMAGEINT,BOUNDMIN,TIMESTEP,
      ATOM_ID,ATOM_MAP_STYLE,ATOM_MAP_USER,ATOM_SORTFREQ,ATOM_SORTBIN,
-     COMM_MODE,COMM_CUTOFF,COMM_VEL};
+     COMM_MODE,COMM_CUTOFF,COMM_VEL,SNAPSHOT};
+
+// snapshot format, same as write_restart.cpp
+
+#define SNAP_VERSION 1
+#define SNAP_ALIGN 4096           // per-field arrays start on page boundary
+#define SNAP_NAME 16
+
+enum{SNAP_INT,SNAP_TAGINT,SNAP_IMAGEINT,SNAP_BIGINT,SNAP_DOUBLE};
+
+struct SnapField {
+  char name[SNAP_NAME];           // field name, e.g. "x"
+  int datatype;                   // SNAP_INT, SNAP_DOUBLE, etc
+  int width;                      // values per atom, 0 = variable
+  bigint offset;                  // file offset of array for all atoms
+};
+
+struct SnapSection {
+  bigint firstatom,natom;         // atoms written by one proc
+  bigint firstrecord,nrecord;     // their restart records, in doubles
+  double bbox[6];                 // bounding box of atoms, lamda if triclinic
+};
 
 #define LB_FACTOR 1.1
 
@@ -109,10 +130,15 @@ void ReadRestart::command(int narg, char **arg)
   else multiproc = 0;
   if (strstr(arg[0],".mpiio")) mpiioflag = 1;
   else mpiioflag = 0;
+  if (strstr(arg[0],".snap")) snapflag = 1;
+  else snapflag = 0;
 
   if (multiproc && mpiioflag)
     error->all(FLERR,
                "Read restart MPI-IO input not allowed with % in filename");
+  if (snapflag && (multiproc || mpiioflag))
+    error->all(FLERR,"Read restart snapshot input not allowed "
+               "with % in filename or MPI-IO");
 
   if (mpiioflag) {
     mpiio = new RestartMPIIO(lmp);
@@ -212,6 +238,11 @@ void ReadRestart::command(int narg, char **arg)
     while (m < assignedChunkSize) m += avec->unpack_restart(&buf[m]);
   }
 
+  // snapshot input from single file
+  // each proc reads only the atoms in its sub-domain
+
+  else if (snapflag) read_snapshot(file,remapflag);
+
   // input of single native file
   // nprocs_file = # of chunks in file
   // proc 0 reads a chunk and bcasts it to other procs
@@ -979,6 +1010,8 @@ void ReadRestart::force_fields()
 
 void ReadRestart::file_layout()
 {
+  int snapflag_file = 0;
+
   int flag = read_int();
   while (flag >= 0) {
 
@@ -1058,11 +1091,19 @@ void ReadRestart::file_layout()
         memory->destroy(nproc_chunk_sizes);
         memory->destroy(nproc_chunk_offsets);
       }
+
+    } else if (flag == SNAPSHOT) {
+      snapflag_file = read_int();
+      if (snapflag == 0 && snapflag_file)
+        error->all(FLERR,"Restart file is a snapshot file");
     }
 
     flag = read_int();
   }
 
+  if (snapflag && snapflag_file == 0)
+    error->all(FLERR,"Restart file is not a snapshot file");
+
   // if MPI-IO file, broadcast the end of the header offste
   // this allows all ranks to compute offset to their data
 
@@ -1072,6 +1113,186 @@ void ReadRestart::file_layout()
   }
 }
 
+/* ----------------------------------------------------------------------
+   read per-atom info from a snapshot file
+   proc 0 reads table of contents which follows header, bcasts it
+   each proc opens file and, for each section whose bounding box overlaps
+     its sub-domain, reads coords of section's atoms, then reads and
+     unpacks only restart records of atoms in its sub-domain
+   if remapflag set, every section is checked, atoms are remapped to box
+     before checking sub-domain, same as for a native file
+------------------------------------------------------------------------- */
+
+void ReadRestart::read_snapshot(char *file, int remapflag)
+{
+  int i,j;
+
+  // table of contents
+
+  int header[3];
+  bigint counts[2];
+  if (me == 0) {
+    fread(header,sizeof(int),3,fp);
+    fread(counts,sizeof(bigint),2,fp);
+  }
+  MPI_Bcast(header,3,MPI_INT,0,world);
+  MPI_Bcast(counts,2,MPI_LMP_BIGINT,0,world);
+
+  if (header[0] != SNAP_VERSION)
+    error->all(FLERR,"Unsupported restart snapshot version");
+  int nfield = header[1];
+  int nsection = header[2];
+
+  SnapField *fields = new SnapField[nfield];
+  SnapSection *sections = new SnapSection[nsection];
+  if (me == 0) {
+    fread(fields,sizeof(SnapField),nfield,fp);
+    fread(sections,sizeof(SnapSection),nsection,fp);
+    fclose(fp);
+    fp = NULL;
+  }
+  MPI_Bcast(fields,nfield*sizeof(SnapField),MPI_CHAR,0,world);
+  MPI_Bcast(sections,nsection*sizeof(SnapSection),MPI_CHAR,0,world);
+
+  // file offsets of fields needed to select and unpack atoms
+
+  const char *needed[4] = {"x","image","roffset","restart"};
+  bigint offsets[4];
+  for (j = 0; j < 4; j++) {
+    for (i = 0; i < nfield; i++)
+      if (strcmp(fields[i].name,needed[j]) == 0) break;
+    if (i == nfield) {
+      char str[128];
+      sprintf(str,"Restart snapshot is missing per-atom field %s",needed[j]);
+      error->all(FLERR,str);
+    }
+    offsets[j] = fields[i].offset;
+  }
+
+  FILE *fpsnap = fopen(file,"rb");
+  if (fpsnap == NULL) {
+    char str[128];
+    sprintf(str,"Cannot open restart file %s",file);
+    error->one(FLERR,str);
+  }
+
+  int triclinic = domain->triclinic;
+  double *sublo,*subhi;
+  if (triclinic == 0) {
+    sublo = domain->sublo;
+    subhi = domain->subhi;
+  } else {
+    sublo = domain->sublo_lamda;
+    subhi = domain->subhi_lamda;
+  }
+
+  AtomVec *avec = atom->avec;
+  int maxatom = 0;
+  int maxbuf = 0;
+  double **x = NULL;
+  imageint *image = NULL;
+  bigint *roffset = NULL;
+  int *select = NULL;
+  double *buf = NULL;
+  double lamda[3],*coord;
+
+  for (int isection = 0; isection < nsection; isection++) {
+    SnapSection *section = &sections[isection];
+    if (section->natom == 0) continue;
+
+    // skip section if its atoms cannot be in my sub-domain
+
+    if (!remapflag) {
+      double *bbox = section->bbox;
+      if (bbox[1] < sublo[0] || bbox[0] >= subhi[0] ||
+          bbox[3] < sublo[1] || bbox[2] >= subhi[1] ||
+          bbox[5] < sublo[2] || bbox[4] >= subhi[2]) continue;
+    }
+
+    int n = section->natom;
+    if (n > maxatom) {
+      maxatom = n;
+      memory->destroy(x);
+      memory->destroy(image);
+      memory->destroy(roffset);
+      memory->destroy(select);
+      memory->create(x,maxatom,3,"read_restart:x");
+      memory->create(image,maxatom,"read_restart:image");
+      memory->create(roffset,maxatom+1,"read_restart:roffset");
+      memory->create(select,maxatom,"read_restart:select");
+    }
+
+    int nread = 0;
+    fseek(fpsnap,offsets[0] + section->firstatom*3*sizeof(double),SEEK_SET);
+    nread += fread(&x[0][0],3*sizeof(double),n,fpsnap);
+    fseek(fpsnap,offsets[1] + section->firstatom*sizeof(imageint),SEEK_SET);
+    nread += fread(image,sizeof(imageint),n,fpsnap);
+    fseek(fpsnap,offsets[2] + section->firstatom*sizeof(bigint),SEEK_SET);
+    nread += fread(roffset,sizeof(bigint),n,fpsnap);
+    if (nread != 3*n)
+      error->one(FLERR,"Unexpected end of restart snapshot file");
+    roffset[n] = section->firstrecord + section->nrecord;
+
+    // select atoms in my sub-domain
+
+    int first = -1;
+    int last = -1;
+    for (i = 0; i < n; i++) {
+      if (remapflag) domain->remap(x[i],image[i]);
+      if (triclinic) {
+        domain->x2lamda(x[i],lamda);
+        coord = lamda;
+      } else coord = x[i];
+
+      if (coord[0] >= sublo[0] && coord[0] < subhi[0] &&
+          coord[1] >= sublo[1] && coord[1] < subhi[1] &&
+          coord[2] >= sublo[2] && coord[2] < subhi[2]) {
+        select[i] = 1;
+        if (first < 0) first = i;
+        last = i;
+      } else select[i] = 0;
+    }
+
+    if (first < 0) continue;
+
+    // read contiguous span of restart records from first to last selected
+    // unpack selected atoms, with coords remapped as above
+
+    int nrecord = roffset[last+1] - roffset[first];
+    if (nrecord > maxbuf) {
+      maxbuf = nrecord;
+      memory->destroy(buf);
+      memory->create(buf,maxbuf,"read_restart:buf");
+    }
+
+    fseek(fpsnap,offsets[3] + roffset[first]*sizeof(double),SEEK_SET);
+    if (fread(buf,sizeof(double),nrecord,fpsnap) != nrecord)
+      error->one(FLERR,"Unexpected end of restart snapshot file");
+
+    for (i = first; i <= last; i++) {
+      if (!select[i]) continue;
+      double *record = &buf[roffset[i]-roffset[first]];
+      if (remapflag) {
+        record[1] = x[i][0];
+        record[2] = x[i][1];
+        record[3] = x[i][2];
+        *((imageint *) &record[7]) = image[i];
+      }
+      avec->unpack_restart(record);
+    }
+  }
+
+  fclose(fpsnap);
+
+  delete [] fields;
+  delete [] sections;
+  memory->destroy(x);
+  memory->destroy(image);
+  memory->destroy(roffset);
+  memory->destroy(select);
+  memory->destroy(buf);
+}
+
 // ----------------------------------------------------------------------
 // ----------------------------------------------------------------------
 // low-level fread methods
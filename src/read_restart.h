@@ -44,6 +44,10 @@ class ReadRestart : protected Pointers {
   bigint assignedChunkSize;
   MPI_Offset assignedChunkOffset,headerOffset;
 
+  // snapshot values
+
+  int snapflag;                // 1 for snapshot input, else 0
+
   void file_search(char *, char *);
   void header(int);
   void type_arrays();
@@ -53,6 +57,7 @@ class ReadRestart : protected Pointers {
   void endian();
   int version_numeric();
   void file_layout();
+  void read_snapshot(char *, int);
 
   int read_int();
   bigint read_bigint();
@@ -85,6 +90,11 @@ E: Read restart MPI-IO input not allowed with % in filename
 This is because a % signifies one file per processor and MPI-IO
 creates one large file for all processors.
 
+E: Read restart snapshot input not allowed with % in filename or MPI-IO
+
+A snapshot file is a single file with its own per-processor layout,
+so it cannot also be a multi-file or MPI-IO restart file.
+
 E: Reading from MPI-IO filename when MPIIO package is not installed
 
 Self-explanatory.
@@ -204,6 +214,29 @@ E: Restart file is not a MPI-IO file
 
 The file is inconsistent with the filename you specified for it.
 
+E: Restart file is a snapshot file
+
+The file is inconsistent with the filename you specified for it.
+
+E: Restart file is not a snapshot file
+
+The file is inconsistent with the filename you specified for it.
+
+E: Unsupported restart snapshot version
+
+The snapshot file was written by a version of LAMMPS with a newer
+snapshot layout than this version can read.
+
+E: Restart snapshot is missing per-atom field %s
+
+The table of contents of the snapshot file does not list a field
+needed to read the atoms back in.  The file is likely corrupted.
+
+E: Unexpected end of restart snapshot file
+
+The snapshot file is shorter than its table of contents says.
+The file is likely truncated.
+
 E: Invalid LAMMPS restart file
 
 The file does not appear to be a LAMMPS restart file since
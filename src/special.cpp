@@ -27,10 +27,6 @@
 
 using namespace LAMMPS_NS;
 
-// allocate space for static class variable
-
-Special *Special::sptr;
-
 /* ---------------------------------------------------------------------- */
 
 Special::Special(LAMMPS *lmp) : Pointers(lmp)
@@ -54,22 +50,14 @@ Special::~Special()
    create 1-2, 1-3, 1-4 lists of topology neighbors
    store in onetwo, onethree, onefour for each atom
    store 3 counters in nspecial[i]
+   info for atoms owned by other procs is exchanged via rendezvous comm,
+     see Comm::rendezvous_atoms()
 ------------------------------------------------------------------------- */
 
 void Special::build()
 {
-  int i,j,k,size;
-  int max,maxall,nbuf;
-  tagint *buf;
-
   MPI_Barrier(world);
-
-  int nlocal = atom->nlocal;
-
-  tagint *tag = atom->tag;
-  int *num_bond = atom->num_bond;
-  tagint **bond_atom = atom->bond_atom;
-  int **nspecial = atom->nspecial;
+  double time1 = MPI_Wtime();
 
   if (me == 0 && screen) {
     const double * const special_lj   = force->special_lj;
@@ -83,56 +71,131 @@ void Special::build()
 
   // initialize nspecial counters to 0
 
-  for (i = 0; i < nlocal; i++) {
+  int **nspecial = atom->nspecial;
+  int nlocal = atom->nlocal;
+
+  for (int i = 0; i < nlocal; i++) {
     nspecial[i][0] = 0;
     nspecial[i][1] = 0;
     nspecial[i][2] = 0;
   }
 
-  // -----------------------------------------------------
-  // compute nspecial[i][0] = # of 1-2 neighbors of atom i
-  // -----------------------------------------------------
+  // tally nspecial[i][0] = # of 1-2 neighbors of atom i
+  // create onetwo[i] = list of 1-2 neighbors for atom i
 
-  // bond partners stored by atom itself
+  if (force->newton_bond) onetwo_build_newton();
+  else onetwo_build_newton_off();
 
-  for (i = 0; i < nlocal; i++) nspecial[i][0] = num_bond[i];
+  // done if special_bond weights for 1-3, 1-4 are set to 1.0
 
-  // if newton_bond off, then done
-  // else only counted 1/2 of all bonds, so count other half
+  if (force->special_lj[2] == 1.0 && force->special_coul[2] == 1.0 &&
+      force->special_lj[3] == 1.0 && force->special_coul[3] == 1.0) {
+    dedup();
+    combine();
+    fix_alteration();
+    timer_output(time1);
+    return;
+  }
 
-  if (force->newton_bond) {
+  // tally nspecial[i][1] = # of 1-3 neighbors of atom i
+  // create onethree[i] = list of 1-3 neighbors for atom i
 
-    // nbufmax = largest buffer needed to hold info from any proc
-    // info for each atom = global tag of 2nd atom in each bond
+  onethree_build();
 
-    nbuf = 0;
-    for (i = 0; i < nlocal; i++) nbuf += num_bond[i];
-    memory->create(buf,nbuf,"special:buf");
+  // done if special_bond weights for 1-4 are set to 1.0
 
-    // fill buffer with global tags of bond partners of my atoms
+  if (force->special_lj[3] == 1.0 && force->special_coul[3] == 1.0) {
+    dedup();
+    if (force->special_angle) angle_trim();
+    combine();
+    fix_alteration();
+    timer_output(time1);
+    return;
+  }
 
-    size = 0;
-    for (i = 0; i < nlocal; i++)
-      for (j = 0; j < num_bond[i]; j++)
-        buf[size++] = bond_atom[i][j];
+  // tally nspecial[i][2] = # of 1-4 neighbors of atom i
+  // create onefour[i] = list of 1-4 neighbors for atom i
 
-    // cycle buffer around ring of procs back to self
-    // when receive buffer, scan tags for atoms I own
-    // when find one, increment nspecial count for that atom
+  onefour_build();
 
-    sptr = this;
-    comm->ring(size,sizeof(tagint),buf,1,ring_one,NULL);
+  dedup();
+  if (force->special_angle) angle_trim();
+  if (force->special_dihedral) dihedral_trim();
+  combine();
+  fix_alteration();
+  timer_output(time1);
+}
+
+/* ----------------------------------------------------------------------
+   onetwo build when newton_bond flag on
+   uses rendezvous comm
+------------------------------------------------------------------------- */
+
+void Special::onetwo_build_newton()
+{
+  int i,j,m;
+
+  int nlocal = atom->nlocal;
+  tagint *tag = atom->tag;
+  int *num_bond = atom->num_bond;
+  tagint **bond_atom = atom->bond_atom;
+  int **nspecial = atom->nspecial;
+
+  // nsend = # of my datums to send
+
+  int nsend = 0;
+  for (i = 0; i < nlocal; i++)
+    for (j = 0; j < num_bond[i]; j++) {
+      m = atom->map(bond_atom[i][j]);
+      if (m < 0 || m >= nlocal) nsend++;
+    }
+
+  PairRvous *inbuf = (PairRvous *)
+    memory->smalloc((bigint) nsend*sizeof(PairRvous),"special:inbuf");
+
+  // setup input buf to rendezvous comm
+  // one datum for each unowned bond partner: bond partner ID, atomID
+
+  nsend = 0;
+  for (i = 0; i < nlocal; i++)
+    for (j = 0; j < num_bond[i]; j++) {
+      m = atom->map(bond_atom[i][j]);
+      if (m >= 0 && m < nlocal) continue;
+      inbuf[nsend].atomID = bond_atom[i][j];
+      inbuf[nsend].partnerID = tag[i];
+      nsend++;
+    }
+
+  // perform rendezvous operation
+  // each datum is returned to proc that owns its atomID
+
+  char *buf;
+  int nreturn = comm->rendezvous_atoms(nsend,(char *) inbuf,
+                                       sizeof(PairRvous),buf);
+  PairRvous *outbuf = (PairRvous *) buf;
+
+  memory->sfree(inbuf);
 
-    memory->destroy(buf);
+  // set nspecial[0] and onetwo for all owned atoms
+  // based on owned info plus rendezvous output info
+  // output datums = pairs of atoms that are 1-2 neighbors
+
+  for (i = 0; i < nlocal; i++) {
+    nspecial[i][0] += num_bond[i];
+    for (j = 0; j < num_bond[i]; j++) {
+      m = atom->map(bond_atom[i][j]);
+      if (m >= 0 && m < nlocal) nspecial[m][0]++;
+    }
   }
 
-  // ----------------------------------------------------
-  // create onetwo[i] = list of 1-2 neighbors for atom i
-  // ----------------------------------------------------
+  for (m = 0; m < nreturn; m++) {
+    i = atom->map(outbuf[m].atomID);
+    nspecial[i][0]++;
+  }
 
-  max = 0;
+  int max = 0;
   for (i = 0; i < nlocal; i++) max = MAX(max,nspecial[i][0]);
-
+  int maxall;
   MPI_Allreduce(&max,&maxall,1,MPI_INT,MPI_MAX,world);
 
   if (me == 0) {
@@ -142,110 +205,127 @@ void Special::build()
 
   memory->create(onetwo,nlocal,maxall,"special:onetwo");
 
-  // count = accumulating counter
-
-  memory->create(count,nlocal,"special:count");
-  for (i = 0; i < nlocal; i++) count[i] = 0;
-
-  // add bond partners stored by atom to onetwo list
+  for (i = 0; i < nlocal; i++) nspecial[i][0] = 0;
 
-  for (i = 0; i < nlocal; i++)
-    for (j = 0; j < num_bond[i]; j++)
-      onetwo[i][count[i]++] = bond_atom[i][j];
+  for (i = 0; i < nlocal; i++) {
+    for (j = 0; j < num_bond[i]; j++) {
+      onetwo[i][nspecial[i][0]++] = bond_atom[i][j];
+      m = atom->map(bond_atom[i][j]);
+      if (m >= 0 && m < nlocal) onetwo[m][nspecial[m][0]++] = tag[i];
+    }
+  }
 
-  // if newton_bond off, then done
-  // else only stored 1/2 of all bonds, so store other half
+  for (m = 0; m < nreturn; m++) {
+    i = atom->map(outbuf[m].atomID);
+    onetwo[i][nspecial[i][0]++] = outbuf[m].partnerID;
+  }
 
-  if (force->newton_bond) {
+  memory->sfree(outbuf);
+}
 
-    // nbufmax = largest buffer needed to hold info from any proc
-    // info for each atom = 2 global tags in each bond
+/* ----------------------------------------------------------------------
+   onetwo build when newton_bond flag off
+   no need for rendezvous comm, since each atom stores all its bonds
+------------------------------------------------------------------------- */
 
-    nbuf = 0;
-    for (i = 0; i < nlocal; i++) nbuf += 2*num_bond[i];
-    memory->create(buf,nbuf,"special:buf");
+void Special::onetwo_build_newton_off()
+{
+  int i,j;
 
-    // fill buffer with global tags of both atoms in bond
+  int nlocal = atom->nlocal;
+  int *num_bond = atom->num_bond;
+  tagint **bond_atom = atom->bond_atom;
+  int **nspecial = atom->nspecial;
 
-    size = 0;
-    for (i = 0; i < nlocal; i++)
-      for (j = 0; j < num_bond[i]; j++) {
-        buf[size++] = tag[i];
-        buf[size++] = bond_atom[i][j];
-      }
+  int max = 0;
+  for (i = 0; i < nlocal; i++) max = MAX(max,num_bond[i]);
+  int maxall;
+  MPI_Allreduce(&max,&maxall,1,MPI_INT,MPI_MAX,world);
 
-    // cycle buffer around ring of procs back to self
-    // when receive buffer, scan 2nd-atom tags for atoms I own
-    // when find one, add 1st-atom tag to onetwo list for 2nd atom
+  if (me == 0) {
+    if (screen) fprintf(screen,"  %d = max # of 1-2 neighbors\n",maxall);
+    if (logfile) fprintf(logfile,"  %d = max # of 1-2 neighbors\n",maxall);
+  }
 
-    sptr = this;
-    comm->ring(size,sizeof(tagint),buf,2,ring_two,NULL);
+  memory->create(onetwo,nlocal,maxall,"special:onetwo");
 
-    memory->destroy(buf);
+  for (i = 0; i < nlocal; i++) {
+    nspecial[i][0] = num_bond[i];
+    for (j = 0; j < num_bond[i]; j++) onetwo[i][j] = bond_atom[i][j];
   }
+}
 
-  memory->destroy(count);
+/* ----------------------------------------------------------------------
+   onethree build
+   uses rendezvous comm
+   each pair of distinct 1-2 neighbors of an atom are 1-3 neighbors,
+     may include duplicates but they will be culled later
+------------------------------------------------------------------------- */
 
-  // -----------------------------------------------------
-  // done if special_bond weights for 1-3, 1-4 are set to 1.0
-  // -----------------------------------------------------
+void Special::onethree_build()
+{
+  int i,j,k,m;
 
-  if (force->special_lj[2] == 1.0 && force->special_coul[2] == 1.0 &&
-      force->special_lj[3] == 1.0 && force->special_coul[3] == 1.0) {
-    dedup();
-    combine();
-    fix_alteration();
-    return;
-  }
+  int nlocal = atom->nlocal;
+  int **nspecial = atom->nspecial;
 
-  // -----------------------------------------------------
-  // compute nspecial[i][1] = # of 1-3 neighbors of atom i
-  // -----------------------------------------------------
+  // nsend = # of my datums to send
 
-  // nbufmax = largest buffer needed to hold info from any proc
-  // info for each atom = 2 scalars + list of 1-2 neighbors
+  int nsend = 0;
+  for (i = 0; i < nlocal; i++)
+    for (j = 0; j < nspecial[i][0]; j++) {
+      m = atom->map(onetwo[i][j]);
+      if (m < 0 || m >= nlocal) nsend += nspecial[i][0]-1;
+    }
 
-  nbuf = 0;
-  for (i = 0; i < nlocal; i++) nbuf += 2 + nspecial[i][0];
-  memory->create(buf,nbuf,"special:buf");
+  PairRvous *inbuf = (PairRvous *)
+    memory->smalloc((bigint) nsend*sizeof(PairRvous),"special:inbuf");
 
-  // fill buffer with:
-  // (1) = counter for 1-3 neighbors, initialized to 0
-  // (2) = # of 1-2 neighbors
-  // (3:N) = list of 1-2 neighbors
+  // setup input buf to rendezvous comm
+  // datums = pairs of onetwo partners where first is unowned
+  // datum = onetwo ID, onetwo ID
 
-  size = 0;
-  for (i = 0; i < nlocal; i++) {
-    buf[size++] = 0;
-    buf[size++] = nspecial[i][0];
-    for (j = 0; j < nspecial[i][0]; j++) buf[size++] = onetwo[i][j];
-  }
+  nsend = 0;
+  for (i = 0; i < nlocal; i++)
+    for (j = 0; j < nspecial[i][0]; j++) {
+      m = atom->map(onetwo[i][j]);
+      if (m >= 0 && m < nlocal) continue;
+      for (k = 0; k < nspecial[i][0]; k++) {
+        if (j == k) continue;
+        inbuf[nsend].atomID = onetwo[i][j];
+        inbuf[nsend].partnerID = onetwo[i][k];
+        nsend++;
+      }
+    }
 
-  // cycle buffer around ring of procs back to self
-  // when receive buffer, scan list of 1-2 neighbors for atoms I own
-  // when find one, increment 1-3 count by # of 1-2 neighbors of my atom,
-  //   subtracting one since my list will contain original atom
+  // perform rendezvous operation
+  // each datum is returned to proc that owns its atomID
 
-  sptr = this;
-  comm->ring(size,sizeof(tagint),buf,3,ring_three,buf);
+  char *buf;
+  int nreturn = comm->rendezvous_atoms(nsend,(char *) inbuf,
+                                       sizeof(PairRvous),buf);
+  PairRvous *outbuf = (PairRvous *) buf;
 
-  // extract count from buffer that has cycled back to me
-  // nspecial[i][1] = # of 1-3 neighbors of atom i
+  memory->sfree(inbuf);
 
-  j = 0;
-  for (i = 0; i < nlocal; i++) {
-    nspecial[i][1] = buf[j];
-    j += 2 + nspecial[i][0];
-  }
+  // set nspecial[1] and onethree for all owned atoms
+  // based on owned info plus rendezvous output info
+  // output datums = pairs of atoms that are 1-3 neighbors
 
-  memory->destroy(buf);
+  for (i = 0; i < nlocal; i++)
+    for (j = 0; j < nspecial[i][0]; j++) {
+      m = atom->map(onetwo[i][j]);
+      if (m >= 0 && m < nlocal) nspecial[m][1] += nspecial[i][0]-1;
+    }
 
-  // ----------------------------------------------------
-  // create onethree[i] = list of 1-3 neighbors for atom i
-  // ----------------------------------------------------
+  for (m = 0; m < nreturn; m++) {
+    i = atom->map(outbuf[m].atomID);
+    nspecial[i][1]++;
+  }
 
-  max = 0;
+  int max = 0;
   for (i = 0; i < nlocal; i++) max = MAX(max,nspecial[i][1]);
+  int maxall;
   MPI_Allreduce(&max,&maxall,1,MPI_INT,MPI_MAX,world);
 
   if (me == 0) {
@@ -255,114 +335,96 @@ void Special::build()
 
   memory->create(onethree,nlocal,maxall,"special:onethree");
 
-  // nbufmax = largest buffer needed to hold info from any proc
-  // info for each atom = 4 scalars + list of 1-2 neighs + list of 1-3 neighs
-
-  nbuf = 0;
-  for (i = 0; i < nlocal; i++) nbuf += 4 + nspecial[i][0] + nspecial[i][1];
-  memory->create(buf,nbuf,"special:buf");
+  for (i = 0; i < nlocal; i++) nspecial[i][1] = 0;
 
-  // fill buffer with:
-  // (1) = global tag of original atom
-  // (2) = # of 1-2 neighbors
-  // (3) = # of 1-3 neighbors
-  // (4) = counter for 1-3 neighbors, initialized to 0
-  // (5:N) = list of 1-2 neighbors
-  // (N+1:2N) space for list of 1-3 neighbors
+  for (i = 0; i < nlocal; i++)
+    for (j = 0; j < nspecial[i][0]; j++) {
+      m = atom->map(onetwo[i][j]);
+      if (m < 0 || m >= nlocal) continue;
+      for (k = 0; k < nspecial[i][0]; k++) {
+        if (j == k) continue;
+        onethree[m][nspecial[m][1]++] = onetwo[i][k];
+      }
+    }
 
-  size = 0;
-  for (i = 0; i < nlocal; i++) {
-    buf[size++] = tag[i];
-    buf[size++] = nspecial[i][0];
-    buf[size++] = nspecial[i][1];
-    buf[size++] = 0;
-    for (j = 0; j < nspecial[i][0]; j++) buf[size++] = onetwo[i][j];
-    size += nspecial[i][1];
+  for (m = 0; m < nreturn; m++) {
+    i = atom->map(outbuf[m].atomID);
+    onethree[i][nspecial[i][1]++] = outbuf[m].partnerID;
   }
 
-  // cycle buffer around ring of procs back to self
-  // when receive buffer, scan list of 1-2 neighbors for atoms I own
-  // when find one, add its neighbors to 1-3 list
-  //   increment the count in buf(i+4)
-  //   exclude the atom whose tag = original
-  //   this process may include duplicates but they will be culled later
-
-  sptr = this;
-  comm->ring(size,sizeof(tagint),buf,4,ring_four,buf);
+  memory->sfree(outbuf);
+}
 
-  // fill onethree with buffer values that have been returned to me
-  // sanity check: accumulated buf[i+3] count should equal
-  //   nspecial[i][1] for each atom
+/* ----------------------------------------------------------------------
+   onefour build
+   uses rendezvous comm
+   each 1-3 neighbor and 1-2 neighbor of an atom are 1-4 neighbors,
+     may include duplicates and original atom but they will be culled later
+------------------------------------------------------------------------- */
 
-  j = 0;
-  for (i = 0; i < nlocal; i++) {
-    if (buf[j+3] != nspecial[i][1])
-      error->one(FLERR,"1-3 bond count is inconsistent");
-    j += 4 + nspecial[i][0];
-    for (k = 0; k < nspecial[i][1]; k++)
-      onethree[i][k] = buf[j++];
-  }
+void Special::onefour_build()
+{
+  int i,j,k,m;
 
-  memory->destroy(buf);
+  int nlocal = atom->nlocal;
+  int **nspecial = atom->nspecial;
 
-  // done if special_bond weights for 1-4 are set to 1.0
+  // nsend = # of my datums to send
 
-  if (force->special_lj[3] == 1.0 && force->special_coul[3] == 1.0) {
-    dedup();
-    if (force->special_angle) angle_trim();
-    combine();
-    fix_alteration();
-    return;
-  }
+  int nsend = 0;
+  for (i = 0; i < nlocal; i++)
+    for (j = 0; j < nspecial[i][1]; j++) {
+      m = atom->map(onethree[i][j]);
+      if (m < 0 || m >= nlocal) nsend += nspecial[i][0];
+    }
 
-  // -----------------------------------------------------
-  // compute nspecial[i][2] = # of 1-4 neighbors of atom i
-  // -----------------------------------------------------
+  PairRvous *inbuf = (PairRvous *)
+    memory->smalloc((bigint) nsend*sizeof(PairRvous),"special:inbuf");
 
-  // nbufmax = largest buffer needed to hold info from any proc
-  // info for each atom = 2 scalars + list of 1-3 neighbors
+  // setup input buf to rendezvous comm
+  // datums = pairs of onethree and onetwo partners where onethree is unowned
+  // datum = onethree ID, onetwo ID
 
-  nbuf = 0;
-  for (i = 0; i < nlocal; i++) nbuf += 2 + nspecial[i][1];
-  memory->create(buf,nbuf,"special:buf");
+  nsend = 0;
+  for (i = 0; i < nlocal; i++)
+    for (j = 0; j < nspecial[i][1]; j++) {
+      m = atom->map(onethree[i][j]);
+      if (m >= 0 && m < nlocal) continue;
+      for (k = 0; k < nspecial[i][0]; k++) {
+        inbuf[nsend].atomID = onethree[i][j];
+        inbuf[nsend].partnerID = onetwo[i][k];
+        nsend++;
+      }
+    }
 
-  // fill buffer with:
-  // (1) = counter for 1-4 neighbors, initialized to 0
-  // (2) = # of 1-3 neighbors
-  // (3:N) = list of 1-3 neighbors
+  // perform rendezvous operation
+  // each datum is returned to proc that owns its atomID
 
-  size = 0;
-  for (i = 0; i < nlocal; i++) {
-    buf[size++] = 0;
-    buf[size++] = nspecial[i][1];
-    for (j = 0; j < nspecial[i][1]; j++) buf[size++] = onethree[i][j];
-  }
+  char *buf;
+  int nreturn = comm->rendezvous_atoms(nsend,(char *) inbuf,
+                                       sizeof(PairRvous),buf);
+  PairRvous *outbuf = (PairRvous *) buf;
 
-  // cycle buffer around ring of procs back to self
-  // when receive buffer, scan list of 1-3 neighbors for atoms I own
-  // when find one, increment 1-4 count by # of 1-2 neighbors of my atom
-  //   may include duplicates and original atom but they will be culled later
+  memory->sfree(inbuf);
 
-  sptr = this;
-  comm->ring(size,sizeof(tagint),buf,5,ring_five,buf);
+  // set nspecial[2] and onefour for all owned atoms
+  // based on owned info plus rendezvous output info
+  // output datums = pairs of atoms that are 1-4 neighbors
 
-  // extract count from buffer that has cycled back to me
-  // nspecial[i][2] = # of 1-4 neighbors of atom i
+  for (i = 0; i < nlocal; i++)
+    for (j = 0; j < nspecial[i][1]; j++) {
+      m = atom->map(onethree[i][j]);
+      if (m >= 0 && m < nlocal) nspecial[m][2] += nspecial[i][0];
+    }
 
-  j = 0;
-  for (i = 0; i < nlocal; i++) {
-    nspecial[i][2] = buf[j];
-    j += 2 + nspecial[i][1];
+  for (m = 0; m < nreturn; m++) {
+    i = atom->map(outbuf[m].atomID);
+    nspecial[i][2]++;
   }
 
-  memory->destroy(buf);
-
-  // ----------------------------------------------------
-  // create onefour[i] = list of 1-4 neighbors for atom i
-  // ----------------------------------------------------
-
-  max = 0;
+  int max = 0;
   for (i = 0; i < nlocal; i++) max = MAX(max,nspecial[i][2]);
+  int maxall;
   MPI_Allreduce(&max,&maxall,1,MPI_INT,MPI_MAX,world);
 
   if (me == 0) {
@@ -372,59 +434,22 @@ void Special::build()
 
   memory->create(onefour,nlocal,maxall,"special:onefour");
 
-  // nbufmax = largest buffer needed to hold info from any proc
-  // info for each atom = 3 scalars + list of 1-3 neighs + list of 1-4 neighs
+  for (i = 0; i < nlocal; i++) nspecial[i][2] = 0;
 
-  nbuf = 0;
   for (i = 0; i < nlocal; i++)
-    nbuf += 3 + nspecial[i][1] + nspecial[i][2];
-  memory->create(buf,nbuf,"special:buf");
-
-  // fill buffer with:
-  // (1) = # of 1-3 neighbors
-  // (2) = # of 1-4 neighbors
-  // (3) = counter for 1-4 neighbors, initialized to 0
-  // (4:N) = list of 1-3 neighbors
-  // (N+1:2N) space for list of 1-4 neighbors
-
-  size = 0;
-  for (i = 0; i < nlocal; i++) {
-    buf[size++] = nspecial[i][1];
-    buf[size++] = nspecial[i][2];
-    buf[size++] = 0;
-    for (j = 0; j < nspecial[i][1]; j++) buf[size++] = onethree[i][j];
-    size += nspecial[i][2];
-  }
-
-  // cycle buffer around ring of procs back to self
-  // when receive buffer, scan list of 1-3 neighbors for atoms I own
-  // when find one, add its neighbors to 1-4 list
-  //   incrementing the count in buf(i+4)
-  //   this process may include duplicates but they will be culled later
-
-  sptr = this;
-  comm->ring(size,sizeof(tagint),buf,6,ring_six,buf);
-
-  // fill onefour with buffer values that have been returned to me
-  // sanity check: accumulated buf[i+2] count should equal
-  //  nspecial[i][2] for each atom
+    for (j = 0; j < nspecial[i][1]; j++) {
+      m = atom->map(onethree[i][j]);
+      if (m < 0 || m >= nlocal) continue;
+      for (k = 0; k < nspecial[i][0]; k++)
+        onefour[m][nspecial[m][2]++] = onetwo[i][k];
+    }
 
-  j = 0;
-  for (i = 0; i < nlocal; i++) {
-    if (buf[j+2] != nspecial[i][2])
-      error->one(FLERR,"1-4 bond count is inconsistent");
-    j += 3 + nspecial[i][1];
-    for (k = 0; k < nspecial[i][2]; k++)
-      onefour[i][k] = buf[j++];
+  for (m = 0; m < nreturn; m++) {
+    i = atom->map(outbuf[m].atomID);
+    onefour[i][nspecial[i][2]++] = outbuf[m].partnerID;
   }
 
-  memory->destroy(buf);
-
-  dedup();
-  if (force->special_angle) angle_trim();
-  if (force->special_dihedral) dihedral_trim();
-  combine();
-  fix_alteration();
+  memory->sfree(outbuf);
 }
 
 /* ----------------------------------------------------------------------
@@ -653,6 +678,7 @@ void Special::combine()
   atom->map_set();
 }
 
+
 /* ----------------------------------------------------------------------
    trim list of 1-3 neighbors by checking defined angles
    delete a 1-3 neigh if they are not end atoms of a defined angle
@@ -661,7 +687,7 @@ void Special::combine()
 
 void Special::angle_trim()
 {
-  int i,j,m,n;
+  int i,j,k,m;
 
   int *num_angle = atom->num_angle;
   int *num_dihedral = atom->num_dihedral;
@@ -702,48 +728,84 @@ void Special::angle_trim()
     memory->create(dflag,nlocal,maxcount,"special::dflag");
 
     for (i = 0; i < nlocal; i++) {
-      n = nspecial[i][1];
-      for (j = 0; j < n; j++) dflag[i][j] = 0;
+      k = nspecial[i][1];
+      for (j = 0; j < k; j++) dflag[i][j] = 0;
     }
 
-    // nbufmax = largest buffer needed to hold info from any proc
-    // info for each atom = list of 1,3 atoms in each angle stored by atom
-    //   and list of 1,3 and 2,4 atoms in each dihedral stored by atom
+    // npair = # of 1,3 atom pairs in each angle stored by atom
+    //   and 1,3 and 2,4 atom pairs in each dihedral stored by atom
+    //   each pair is stored in both orderings
 
-    int nbuf = 0;
+    int npair = 0;
     for (i = 0; i < nlocal; i++) {
-      if (num_angle && atom->nangles) nbuf += 2*num_angle[i];
-      if (num_dihedral && atom->ndihedrals) nbuf += 2*2*num_dihedral[i];
+      if (num_angle && atom->nangles) npair += 2*num_angle[i];
+      if (num_dihedral && atom->ndihedrals) npair += 2*2*num_dihedral[i];
     }
-    int *buf;
-    memory->create(buf,nbuf,"special:buf");
 
-    // fill buffer with list of 1,3 atoms in each angle
-    // and with list of 1,3 and 2,4 atoms in each dihedral
+    PairRvous *inbuf = (PairRvous *)
+      memory->smalloc((bigint) npair*sizeof(PairRvous),"special:inbuf");
 
-    int size = 0;
+    npair = 0;
     if (num_angle && atom->nangles)
       for (i = 0; i < nlocal; i++)
         for (j = 0; j < num_angle[i]; j++) {
-          buf[size++] = angle_atom1[i][j];
-          buf[size++] = angle_atom3[i][j];
+          inbuf[npair].atomID = angle_atom1[i][j];
+          inbuf[npair++].partnerID = angle_atom3[i][j];
+          inbuf[npair].atomID = angle_atom3[i][j];
+          inbuf[npair++].partnerID = angle_atom1[i][j];
         }
 
     if (num_dihedral && atom->ndihedrals)
       for (i = 0; i < nlocal; i++)
         for (j = 0; j < num_dihedral[i]; j++) {
-          buf[size++] = dihedral_atom1[i][j];
-          buf[size++] = dihedral_atom3[i][j];
-          buf[size++] = dihedral_atom2[i][j];
-          buf[size++] = dihedral_atom4[i][j];
+          inbuf[npair].atomID = dihedral_atom1[i][j];
+          inbuf[npair++].partnerID = dihedral_atom3[i][j];
+          inbuf[npair].atomID = dihedral_atom3[i][j];
+          inbuf[npair++].partnerID = dihedral_atom1[i][j];
+          inbuf[npair].atomID = dihedral_atom2[i][j];
+          inbuf[npair++].partnerID = dihedral_atom4[i][j];
+          inbuf[npair].atomID = dihedral_atom4[i][j];
+          inbuf[npair++].partnerID = dihedral_atom2[i][j];
         }
 
-    // cycle buffer around ring of procs back to self
-    // when receive buffer, scan list of 1,3 atoms looking for atoms I own
-    // when find one, scan its 1-3 neigh list and mark I,J as in an angle
+    // flag pairs whose 1st atom I own, compress the rest into send list
+    // with newton_bond off, the owner of every atom stores each angle and
+    //   dihedral the atom is part of, so unowned pairs need not be sent
+
+    int nsend = 0;
+    for (m = 0; m < npair; m++) {
+      i = atom->map(inbuf[m].atomID);
+      if (i >= 0 && i < nlocal) {
+        for (k = 0; k < nspecial[i][1]; k++)
+          if (onethree[i][k] == inbuf[m].partnerID) {
+            dflag[i][k] = 1;
+            break;
+          }
+      } else if (force->newton_bond) {
+        inbuf[nsend++] = inbuf[m];
+      }
+    }
 
-    sptr = this;
-    comm->ring(size,sizeof(tagint),buf,7,ring_seven,NULL);
+    // perform rendezvous operation
+    // each datum is returned to proc that owns its 1st atom ID
+
+    char *buf;
+    int nreturn = comm->rendezvous_atoms(nsend,(char *) inbuf,
+                                         sizeof(PairRvous),buf);
+    PairRvous *outbuf = (PairRvous *) buf;
+
+    memory->sfree(inbuf);
+
+    for (m = 0; m < nreturn; m++) {
+      i = atom->map(outbuf[m].atomID);
+      for (k = 0; k < nspecial[i][1]; k++)
+        if (onethree[i][k] == outbuf[m].partnerID) {
+          dflag[i][k] = 1;
+          break;
+        }
+    }
+
+    memory->sfree(outbuf);
 
     // delete 1-3 neighbors if they are not flagged in dflag
 
@@ -757,7 +819,6 @@ void Special::angle_trim()
     // clean up
 
     memory->destroy(dflag);
-    memory->destroy(buf);
 
   // if no angles or dihedrals are defined, delete all 1-3 neighs
 
@@ -788,7 +849,7 @@ void Special::angle_trim()
 
 void Special::dihedral_trim()
 {
-  int i,j,m,n;
+  int i,j,k,m;
 
   int *num_dihedral = atom->num_dihedral;
   tagint **dihedral_atom1 = atom->dihedral_atom1;
@@ -823,33 +884,65 @@ void Special::dihedral_trim()
     memory->create(dflag,nlocal,maxcount,"special::dflag");
 
     for (i = 0; i < nlocal; i++) {
-      n = nspecial[i][2];
-      for (j = 0; j < n; j++) dflag[i][j] = 0;
+      k = nspecial[i][2];
+      for (j = 0; j < k; j++) dflag[i][j] = 0;
     }
 
-    // nbufmax = largest buffer needed to hold info from any proc
-    // info for each atom = list of 1,4 atoms in each dihedral stored by atom
+    // npair = # of 1,4 atom pairs in each dihedral stored by atom
+    //   each pair is stored in both orderings
 
-    int nbuf = 0;
-    for (i = 0; i < nlocal; i++) nbuf += 2*num_dihedral[i];
-    int *buf;
-    memory->create(buf,nbuf,"special:buf");
+    int npair = 0;
+    for (i = 0; i < nlocal; i++) npair += 2*num_dihedral[i];
 
-    // fill buffer with list of 1,4 atoms in each dihedral
+    PairRvous *inbuf = (PairRvous *)
+      memory->smalloc((bigint) npair*sizeof(PairRvous),"special:inbuf");
 
-    int size = 0;
+    npair = 0;
     for (i = 0; i < nlocal; i++)
       for (j = 0; j < num_dihedral[i]; j++) {
-        buf[size++] = dihedral_atom1[i][j];
-        buf[size++] = dihedral_atom4[i][j];
+        inbuf[npair].atomID = dihedral_atom1[i][j];
+        inbuf[npair++].partnerID = dihedral_atom4[i][j];
+        inbuf[npair].atomID = dihedral_atom4[i][j];
+        inbuf[npair++].partnerID = dihedral_atom1[i][j];
+      }
+
+    // flag pairs whose 1st atom I own, compress the rest into send list
+    // with newton_bond off, unowned pairs are flagged by their owner
+
+    int nsend = 0;
+    for (m = 0; m < npair; m++) {
+      i = atom->map(inbuf[m].atomID);
+      if (i >= 0 && i < nlocal) {
+        for (k = 0; k < nspecial[i][2]; k++)
+          if (onefour[i][k] == inbuf[m].partnerID) {
+            dflag[i][k] = 1;
+            break;
+          }
+      } else if (force->newton_bond) {
+        inbuf[nsend++] = inbuf[m];
       }
+    }
+
+    // perform rendezvous operation
+    // each datum is returned to proc that owns its 1st atom ID
 
-    // cycle buffer around ring of procs back to self
-    // when receive buffer, scan list of 1,4 atoms looking for atoms I own
-    // when find one, scan its 1-4 neigh list and mark I,J as in a dihedral
+    char *buf;
+    int nreturn = comm->rendezvous_atoms(nsend,(char *) inbuf,
+                                         sizeof(PairRvous),buf);
+    PairRvous *outbuf = (PairRvous *) buf;
 
-    sptr = this;
-    comm->ring(size,sizeof(tagint),buf,8,ring_eight,NULL);
+    memory->sfree(inbuf);
+
+    for (m = 0; m < nreturn; m++) {
+      i = atom->map(outbuf[m].atomID);
+      for (k = 0; k < nspecial[i][2]; k++)
+        if (onefour[i][k] == outbuf[m].partnerID) {
+          dflag[i][k] = 1;
+          break;
+        }
+    }
+
+    memory->sfree(outbuf);
 
     // delete 1-4 neighbors if they are not flagged in dflag
 
@@ -863,7 +956,6 @@ void Special::dihedral_trim()
     // clean up
 
     memory->destroy(dflag);
-    memory->destroy(buf);
 
   // if no dihedrals are defined, delete all 1-4 neighs
 
@@ -887,257 +979,6 @@ void Special::dihedral_trim()
   }
 }
 
-/* ----------------------------------------------------------------------
-   when receive buffer, scan tags for atoms I own
-   when find one, increment nspecial count for that atom
-------------------------------------------------------------------------- */
-
-void Special::ring_one(int ndatum, char *cbuf)
-{
-  Atom *atom = sptr->atom;
-  int **nspecial = atom->nspecial;
-  int nlocal = atom->nlocal;
-
-  tagint *buf = (tagint *) cbuf;
-  int m;
-
-  for (int i = 0; i < ndatum; i++) {
-    m = atom->map(buf[i]);
-    if (m >= 0 && m < nlocal) nspecial[m][0]++;
-  }
-}
-
-/* ----------------------------------------------------------------------
-   when receive buffer, scan 2nd-atom tags for atoms I own
-   when find one, add 1st-atom tag to onetwo list for 2nd atom
-------------------------------------------------------------------------- */
-
-void Special::ring_two(int ndatum, char *cbuf)
-{
-  Atom *atom = sptr->atom;
-  int nlocal = atom->nlocal;
-
-  tagint **onetwo = sptr->onetwo;
-  int *count = sptr->count;
-
-  tagint *buf = (tagint *) cbuf;
-  int m;
-
-  for (int i = 1; i < ndatum; i += 2) {
-    m = atom->map(buf[i]);
-    if (m >= 0 && m < nlocal) onetwo[m][count[m]++] = buf[i-1];
-  }
-}
-
-/* ----------------------------------------------------------------------
-   when receive buffer, scan list of 1-2 neighbors for atoms I own
-   when find one, increment 1-3 count by # of 1-2 neighbors of my atom,
-     subtracting one since my list will contain original atom
-------------------------------------------------------------------------- */
-
-void Special::ring_three(int ndatum, char *cbuf)
-{
-  Atom *atom = sptr->atom;
-  int **nspecial = atom->nspecial;
-  int nlocal = atom->nlocal;
-
-  tagint *buf = (tagint *) cbuf;
-  int i,j,m,n,num12;
-
-  i = 0;
-  while (i < ndatum) {
-    n = buf[i];
-    num12 = buf[i+1];
-    for (j = 0; j < num12; j++) {
-      m = atom->map(buf[i+2+j]);
-      if (m >= 0 && m < nlocal)
-        n += nspecial[m][0] - 1;
-    }
-    buf[i] = n;
-    i += 2 + num12;
-  }
-}
-
-/* ----------------------------------------------------------------------
-  when receive buffer, scan list of 1-2 neighbors for atoms I own
-  when find one, add its neighbors to 1-3 list
-    increment the count in buf(i+4)
-    exclude the atom whose tag = original
-    this process may include duplicates but they will be culled later
-------------------------------------------------------------------------- */
-
-void Special::ring_four(int ndatum, char *cbuf)
-{
-  Atom *atom = sptr->atom;
-  int **nspecial = atom->nspecial;
-  int nlocal = atom->nlocal;
-
-  tagint **onetwo = sptr->onetwo;
-
-  tagint *buf = (tagint *) cbuf;
-  tagint original;
-  int i,j,k,m,n,num12,num13;
-
-  i = 0;
-  while (i < ndatum) {
-    original = buf[i];
-    num12 = buf[i+1];
-    num13 = buf[i+2];
-    n = buf[i+3];
-    for (j = 0; j < num12; j++) {
-      m = atom->map(buf[i+4+j]);
-      if (m >= 0 && m < nlocal)
-        for (k = 0; k < nspecial[m][0]; k++)
-          if (onetwo[m][k] != original)
-            buf[i+4+num12+(n++)] = onetwo[m][k];
-    }
-    buf[i+3] = n;
-    i += 4 + num12 + num13;
-  }
-}
-
-/* ----------------------------------------------------------------------
-   when receive buffer, scan list of 1-3 neighbors for atoms I own
-   when find one, increment 1-4 count by # of 1-2 neighbors of my atom
-     may include duplicates and original atom but they will be culled later
-------------------------------------------------------------------------- */
-
-void Special::ring_five(int ndatum, char *cbuf)
-{
-  Atom *atom = sptr->atom;
-  int **nspecial = atom->nspecial;
-  int nlocal = atom->nlocal;
-
-  tagint *buf = (tagint *) cbuf;
-  int i,j,m,n,num13;
-
-  i = 0;
-  while (i < ndatum) {
-    n = buf[i];
-    num13 = buf[i+1];
-    for (j = 0; j < num13; j++) {
-      m = atom->map(buf[i+2+j]);
-      if (m >= 0 && m < nlocal) n += nspecial[m][0];
-    }
-      buf[i] = n;
-      i += 2 + num13;
-  }
-}
-
-/* ----------------------------------------------------------------------
-   when receive buffer, scan list of 1-3 neighbors for atoms I own
-   when find one, add its neighbors to 1-4 list
-     incrementing the count in buf(i+4)
-     this process may include duplicates but they will be culled later
-------------------------------------------------------------------------- */
-
-void Special::ring_six(int ndatum, char *cbuf)
-{
-  Atom *atom = sptr->atom;
-  int **nspecial = atom->nspecial;
-  int nlocal = atom->nlocal;
-
-  tagint **onetwo = sptr->onetwo;
-
-  tagint *buf = (tagint *) cbuf;
-  int i,j,k,m,n,num13,num14;
-
-  i = 0;
-  while (i < ndatum) {
-    num13 = buf[i];
-    num14 = buf[i+1];
-    n = buf[i+2];
-    for (j = 0; j < num13; j++) {
-      m = atom->map(buf[i+3+j]);
-      if (m >= 0 && m < nlocal)
-        for (k = 0; k < nspecial[m][0]; k++)
-          buf[i+3+num13+(n++)] = onetwo[m][k];
-    }
-    buf[i+2] = n;
-    i += 3 + num13 + num14;
-  }
-}
-
-/* ----------------------------------------------------------------------
-   when receive buffer, scan list of 1,3 atoms looking for atoms I own
-   when find one, scan its 1-3 neigh list and mark I,J as in an angle
-------------------------------------------------------------------------- */
-
-void Special::ring_seven(int ndatum, char *cbuf)
-{
-  Atom *atom = sptr->atom;
-  int **nspecial = atom->nspecial;
-  int nlocal = atom->nlocal;
-
-  tagint **onethree = sptr->onethree;
-  int **dflag = sptr->dflag;
-
-  tagint *buf = (tagint *) cbuf;
-  tagint iglobal,jglobal;
-  int i,m,ilocal,jlocal;
-
-  i = 0;
-  while (i < ndatum) {
-    iglobal = buf[i];
-    jglobal = buf[i+1];
-    ilocal = atom->map(iglobal);
-    jlocal = atom->map(jglobal);
-    if (ilocal >= 0 && ilocal < nlocal)
-      for (m = 0; m < nspecial[ilocal][1]; m++)
-        if (jglobal == onethree[ilocal][m]) {
-          dflag[ilocal][m] = 1;
-          break;
-        }
-    if (jlocal >= 0 && jlocal < nlocal)
-      for (m = 0; m < nspecial[jlocal][1]; m++)
-        if (iglobal == onethree[jlocal][m]) {
-          dflag[jlocal][m] = 1;
-          break;
-        }
-    i += 2;
-  }
-}
-
-/* ----------------------------------------------------------------------
-   when receive buffer, scan list of 1,4 atoms looking for atoms I own
-   when find one, scan its 1-4 neigh list and mark I,J as in a dihedral
-------------------------------------------------------------------------- */
-
-void Special::ring_eight(int ndatum, char *cbuf)
-{
-  Atom *atom = sptr->atom;
-  int **nspecial = atom->nspecial;
-  int nlocal = atom->nlocal;
-
-  tagint **onefour = sptr->onefour;
-  int **dflag = sptr->dflag;
-
-  tagint *buf = (tagint *) cbuf;
-  tagint iglobal,jglobal;
-  int i,m,ilocal,jlocal;
-
-  i = 0;
-  while (i < ndatum) {
-    iglobal = buf[i];
-    jglobal = buf[i+1];
-    ilocal = atom->map(iglobal);
-    jlocal = atom->map(jglobal);
-    if (ilocal >= 0 && ilocal < nlocal)
-      for (m = 0; m < nspecial[ilocal][2]; m++)
-        if (jglobal == onefour[ilocal][m]) {
-          dflag[ilocal][m] = 1;
-          break;
-        }
-    if (jlocal >= 0 && jlocal < nlocal)
-      for (m = 0; m < nspecial[jlocal][2]; m++)
-        if (iglobal == onefour[jlocal][m]) {
-          dflag[jlocal][m] = 1;
-          break;
-        }
-    i += 2;
-  }
-}
-
 /* ----------------------------------------------------------------------
    allow fixes to alter special list
    currently, only fix drude does this
@@ -1151,3 +992,15 @@ void Special::fix_alteration()
       modify->fix[ifix]->rebuild_special();
 }
 
+/* ----------------------------------------------------------------------
+   print timing output
+------------------------------------------------------------------------- */
+
+void Special::timer_output(double time1)
+{
+  double time2 = MPI_Wtime();
+  if (comm->me == 0) {
+    if (screen) fprintf(screen,"  special bonds CPU = %g secs\n",time2-time1);
+    if (logfile) fprintf(logfile,"  special bonds CPU = %g secs\n",time2-time1);
+  }
+}
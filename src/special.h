@@ -28,29 +28,25 @@ class Special : protected Pointers {
   int me,nprocs;
   tagint **onetwo,**onethree,**onefour;
 
-  // data used by ring callback methods
-
-  int *count;
   int **dflag;
 
+  void onetwo_build_newton();
+  void onetwo_build_newton_off();
+  void onethree_build();
+  void onefour_build();
+
   void dedup();
   void angle_trim();
   void dihedral_trim();
   void combine();
   void fix_alteration();
+  void timer_output(double);
 
-  // static variable for ring communication callback to access class data
-  // callback functions for ring communication
-
-  static Special *sptr;
-  static void ring_one(int, char *);
-  static void ring_two(int, char *);
-  static void ring_three(int, char *);
-  static void ring_four(int, char *);
-  static void ring_five(int, char *);
-  static void ring_six(int, char *);
-  static void ring_seven(int, char *);
-  static void ring_eight(int, char *);
+  // datum for rendezvous communication, sent to owner of atomID
+
+  struct PairRvous {
+    tagint atomID,partnerID;
+  };
 };
 
 }
@@ -59,16 +55,4 @@ class Special : protected Pointers {
 
 /* ERROR/WARNING messages:
 
-E: 1-3 bond count is inconsistent
-
-An inconsistency was detected when computing the number of 1-3
-neighbors for each atom.  This likely means something is wrong with
-the bond topologies you have defined.
-
-E: 1-4 bond count is inconsistent
-
-An inconsistency was detected when computing the number of 1-4
-neighbors for each atom.  This likely means something is wrong with
-the bond topologies you have defined.
-
 */
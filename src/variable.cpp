@@ -39,6 +39,10 @@
 #include "info.h"
 #include "error.h"
 
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 using namespace LAMMPS_NS;
 using namespace MathConst;
 
@@ -48,6 +52,7 @@ using namespace MathConst;
 #define CHUNK 1024
 #define VALUELENGTH 64               // also in python.cpp
 #define MAXFUNCARG 6
+#define NBLOCK 256                   // # of atoms per compiled eval block
 
 #define MYROUND(a) (( a-floor(a) ) >= .5) ? ceil(a) : floor(a)
 
@@ -65,7 +70,8 @@ enum{DONE,ADD,SUBTRACT,MULTIPLY,DIVIDE,CARAT,MODULO,UNARY,
      RANDOM,NORMAL,CEIL,FLOOR,ROUND,RAMP,STAGGER,LOGFREQ,LOGFREQ2,
      STRIDE,STRIDE2,VDISPLACE,SWIGGLE,CWIGGLE,GMASK,RMASK,GRMASK,
      IS_ACTIVE,IS_DEFINED,IS_AVAILABLE,
-     VALUE,ATOMARRAY,TYPEARRAY,INTARRAY,BIGINTARRAY,VECTORARRAY};
+     VALUE,ATOMARRAY,TYPEARRAY,INTARRAY,BIGINTARRAY,VECTORARRAY,INTERPRET,
+     COMPUTEREF,FIXREF,VARREF,THERMOWORD,ITEM};
 
 // customize by adding a special function
 
@@ -100,6 +106,14 @@ Variable::Variable(LAMMPS *lmp) : Pointers(lmp)
   randomequal = NULL;
   randomatom = NULL;
 
+  program = NULL;
+  ninstr = maxinstr = 0;
+  scratch = NULL;
+  maxscratch = 0;
+
+  eqcode = NULL;
+  compvar = -1;
+
   // customize by assigning a precedence level
 
   precedence[DONE] = 0;
@@ -128,6 +142,7 @@ Variable::~Variable()
     else for (int j = 0; j < num[i]; j++) delete [] data[i][j];
     delete [] data[i];
     if (style[i] == VECTOR) memory->destroy(vecs[i].values);
+    free_code(i);
   }
   memory->sfree(names);
   memory->destroy(style);
@@ -138,12 +153,16 @@ Variable::~Variable()
   memory->sfree(data);
   memory->sfree(dvalue);
   memory->sfree(vecs);
+  memory->sfree(eqcode);
 
   memory->destroy(eval_in_progress);
 
   delete randomequal;
   delete randomatom;
 
+  memory->sfree(program);
+  memory->destroy(scratch);
+
   delete python;
 }
 
@@ -396,6 +415,7 @@ void Variable::set(int narg, char **arg)
         error->all(FLERR,"Cannot redefine variable as a different style");
       delete [] data[ivar][0];
       copy(1,&arg[2],data[ivar]);
+      free_code(ivar);
       replaceflag = 1;
     } else {
       if (nvar == maxvar) grow();
@@ -849,7 +869,7 @@ char *Variable::retrieve(char *name)
     strcpy(data[ivar][0],result);
     str = data[ivar][0];
   } else if (style[ivar] == EQUAL) {
-    double answer = evaluate(data[ivar][0],NULL);
+    double answer = evaluate_equal(ivar);
     sprintf(data[ivar][1],"%.15g",answer);
     str = data[ivar][1];
   } else if (style[ivar] == FORMAT) {
@@ -900,7 +920,7 @@ double Variable::compute_equal(int ivar)
   eval_in_progress[ivar] = 1;
 
   double value = 0.0;
-  if (style[ivar] == EQUAL) value = evaluate(data[ivar][0],NULL);
+  if (style[ivar] == EQUAL) value = evaluate_equal(ivar);
   else if (style[ivar] == INTERNAL) value = dvalue[ivar];
   else if (style[ivar] == PYTHON) {
     int ifunc = python->find(data[ivar][0]);
@@ -921,7 +941,7 @@ double Variable::compute_equal(int ivar)
 
 double Variable::compute_equal(char *str)
 {
-  return evaluate(str,NULL);
+  return eval_item(str);
 }
 
 /* ----------------------------------------------------------------------
@@ -956,7 +976,13 @@ void Variable::compute_atom(int ivar, int igroup,
   int *mask = atom->mask;
   int nlocal = atom->nlocal;
 
-  if (style[ivar] == ATOM) {
+  // evaluate compiled tree over blocks of atoms if possible
+  // else interpret tree one atom at a time
+
+  if (style[ivar] == ATOM && compile_tree(tree))
+    eval_program(nlocal,groupbit,result,stride,sumflag);
+
+  else if (style[ivar] == ATOM) {
     if (sumflag == 0) {
       int m = 0;
       for (int i = 0; i < nlocal; i++) {
@@ -1034,8 +1060,10 @@ int Variable::compute_vector(int ivar, double **result)
   vecs[ivar].n = nlen;
   vecs[ivar].currentstep = update->ntimestep;
   double *vec = vecs[ivar].values;
-  for (int i = 0; i < nlen; i++)
-    vec[i] = eval_tree(tree,i);
+  if (compile_tree(tree)) eval_program(nlen,0,vec,1,0);
+  else
+    for (int i = 0; i < nlen; i++)
+      vec[i] = eval_tree(tree,i);
 
   free_tree(tree);
   eval_in_progress[ivar] = 0;
@@ -1065,6 +1093,7 @@ void Variable::remove(int n)
   else for (int i = 0; i < num[n]; i++) delete [] data[n][i];
   delete [] data[n];
   delete reader[n];
+  free_code(n);
 
   for (int i = n+1; i < nvar; i++) {
     names[i-1] = names[i];
@@ -1074,8 +1103,13 @@ void Variable::remove(int n)
     pad[i-1] = pad[i];
     reader[i-1] = reader[i];
     data[i-1] = data[i];
+    eqcode[i-1] = eqcode[i];
   }
   nvar--;
+
+  eqcode[nvar].compiled = eqcode[nvar].n = eqcode[nvar].nmax = 0;
+  eqcode[nvar].steps = NULL;
+  eqcode[nvar].stack = NULL;
 }
 
 /* ----------------------------------------------------------------------
@@ -1106,6 +1140,14 @@ void Variable::grow()
     vecs[i].values = NULL;
   }
 
+  eqcode = (EqualCode *)
+    memory->srealloc(eqcode,maxvar*sizeof(EqualCode),"var:eqcode");
+  for (int i = old; i < maxvar; i++) {
+    eqcode[i].compiled = eqcode[i].n = eqcode[i].nmax = 0;
+    eqcode[i].steps = NULL;
+    eqcode[i].stack = NULL;
+  }
+
   memory->grow(eval_in_progress,maxvar,"var:eval_in_progress");
   for (int i = 0; i < maxvar; i++) eval_in_progress[i] = 0;
 }
@@ -1144,6 +1186,7 @@ void Variable::copy(int narg, char **from, char **to)
      variable = v_name, v_name[i]
    equal-style variables passes in tree = NULL:
      evaluate the formula, return result as a double
+     if compvar >= 0, also compile formula into steps of variable compvar
    atom-style and vector-style variables pass in tree = non-NULL:
      parse the formula but do not evaluate it
      create a parse tree and return it
@@ -1163,6 +1206,10 @@ double Variable::evaluate(char *str, Tree **tree)
   int ntreestack = 0;
   int nopstack = 0;
 
+  // also append postfix steps to compiled formula of variable compvar
+
+  int compiling = (tree == NULL && compvar >= 0);
+
   int i = 0;
   int expect = ARG;
 
@@ -1228,6 +1275,8 @@ double Variable::evaluate(char *str, Tree **tree)
         treestack[ntreestack++] = newtree;
       } else argstack[nargstack++] = atof(number);
 
+      if (compiling) add_step(VALUE,0,NULL,NULL,0)->value = atof(number);
+
       delete [] number;
 
     // ----------------
@@ -1251,6 +1300,18 @@ double Variable::evaluate(char *str, Tree **tree)
       strncpy(word,&str[istart],n);
       word[n] = '\0';
 
+      // steptype = how compiled formula obtains the value of this word
+      // mark = steps and stack depth of compiled formula before this word
+
+      int nbracket = 0;
+      tagint index1 = 0,index2 = 0;
+      int steptype = ITEM;
+      int mark = 0,markdepth = 0;
+      if (compiling) {
+        mark = eqcode[compvar].n;
+        markdepth = eqcode[compvar].depth;
+      }
+
       // ----------------
       // compute
       // ----------------
@@ -1276,8 +1337,6 @@ double Variable::evaluate(char *str, Tree **tree)
         // nbracket = # of bracket pairs
         // index1,index2 = int inside each bracket pair, possibly an atom ID
 
-        int nbracket;
-        tagint index1,index2;
         if (str[i] != '[') nbracket = 0;
         else {
           nbracket = 1;
@@ -1296,16 +1355,7 @@ double Variable::evaluate(char *str, Tree **tree)
 
         if (nbracket == 0 && compute->scalar_flag && lowercase) {
 
-          if (update->whichflag == 0) {
-            if (compute->invoked_scalar != update->ntimestep)
-              error->all(FLERR,"Compute used in variable between runs "
-                         "is not current");
-          } else if (!(compute->invoked_flag & INVOKED_SCALAR)) {
-            compute->compute_scalar();
-            compute->invoked_flag |= INVOKED_SCALAR;
-          }
-
-          value1 = compute->scalar;
+          value1 = compute_global(compute,nbracket,index1,index2);
           if (tree) {
             Tree *newtree = new Tree();
             newtree->type = VALUE;
@@ -1319,22 +1369,7 @@ double Variable::evaluate(char *str, Tree **tree)
 
         } else if (nbracket == 1 && compute->vector_flag && lowercase) {
 
-          if (index1 > compute->size_vector &&
-              compute->size_vector_variable == 0)
-            error->all(FLERR,"Variable formula compute vector "
-                       "is accessed out-of-range");
-          if (update->whichflag == 0) {
-            if (compute->invoked_vector != update->ntimestep)
-              error->all(FLERR,"Compute used in variable between runs "
-                         "is not current");
-          } else if (!(compute->invoked_flag & INVOKED_VECTOR)) {
-            compute->compute_vector();
-            compute->invoked_flag |= INVOKED_VECTOR;
-          }
-
-          if (compute->size_vector_variable &&
-              index1 > compute->size_vector) value1 = 0.0;
-          else value1 = compute->vector[index1-1];
+          value1 = compute_global(compute,nbracket,index1,index2);
           if (tree) {
             Tree *newtree = new Tree();
             newtree->type = VALUE;
@@ -1348,25 +1383,7 @@ double Variable::evaluate(char *str, Tree **tree)
 
         } else if (nbracket == 2 && compute->array_flag && lowercase) {
 
-          if (index1 > compute->size_array_rows &&
-              compute->size_array_rows_variable == 0)
-            error->all(FLERR,"Variable formula compute array "
-                       "is accessed out-of-range");
-          if (index2 > compute->size_array_cols)
-            error->all(FLERR,"Variable formula compute array "
-                       "is accessed out-of-range");
-          if (update->whichflag == 0) {
-            if (compute->invoked_array != update->ntimestep)
-              error->all(FLERR,"Compute used in variable between runs "
-                         "is not current");
-          } else if (!(compute->invoked_flag & INVOKED_ARRAY)) {
-            compute->compute_array();
-            compute->invoked_flag |= INVOKED_ARRAY;
-          }
-
-          if (compute->size_array_rows_variable &&
-              index1 > compute->size_array_rows) value1 = 0.0;
-          else value1 = compute->array[index1-1][index2-1];
+          value1 = compute_global(compute,nbracket,index1,index2);
           if (tree) {
             Tree *newtree = new Tree();
             newtree->type = VALUE;
@@ -1547,6 +1564,8 @@ double Variable::evaluate(char *str, Tree **tree)
 
         } else error->all(FLERR,"Mismatched compute in variable formula");
 
+        steptype = COMPUTEREF;
+
       // ----------------
       // fix
       // ----------------
@@ -1571,8 +1590,6 @@ double Variable::evaluate(char *str, Tree **tree)
         // nbracket = # of bracket pairs
         // index1,index2 = int inside each bracket pair, possibly an atom ID
 
-        int nbracket;
-        tagint index1,index2;
         if (str[i] != '[') nbracket = 0;
         else {
           nbracket = 1;
@@ -1591,10 +1608,7 @@ double Variable::evaluate(char *str, Tree **tree)
 
         if (nbracket == 0 && fix->scalar_flag && lowercase) {
 
-          if (update->whichflag > 0 && update->ntimestep % fix->global_freq)
-            error->all(FLERR,"Fix in variable not computed at compatible time");
-
-          value1 = fix->compute_scalar();
+          value1 = fix_global(fix,nbracket,index1,index2);
           if (tree) {
             Tree *newtree = new Tree();
             newtree->type = VALUE;
@@ -1608,14 +1622,7 @@ double Variable::evaluate(char *str, Tree **tree)
 
         } else if (nbracket == 1 && fix->vector_flag && lowercase) {
 
-          if (index1 > fix->size_vector &&
-              fix->size_vector_variable == 0)
-            error->all(FLERR,"Variable formula fix vector is "
-                       "accessed out-of-range");
-          if (update->whichflag > 0 && update->ntimestep % fix->global_freq)
-            error->all(FLERR,"Fix in variable not computed at compatible time");
-
-          value1 = fix->compute_vector(index1-1);
+          value1 = fix_global(fix,nbracket,index1,index2);
           if (tree) {
             Tree *newtree = new Tree();
             newtree->type = VALUE;
@@ -1629,17 +1636,7 @@ double Variable::evaluate(char *str, Tree **tree)
 
         } else if (nbracket == 2 && fix->array_flag && lowercase) {
 
-          if (index1 > fix->size_array_rows &&
-              fix->size_array_rows_variable == 0)
-            error->all(FLERR,
-                       "Variable formula fix array is accessed out-of-range");
-          if (index2 > fix->size_array_cols)
-            error->all(FLERR,
-                       "Variable formula fix array is accessed out-of-range");
-          if (update->whichflag > 0 && update->ntimestep % fix->global_freq)
-            error->all(FLERR,"Fix in variable not computed at compatible time");
-
-          value1 = fix->compute_array(index1-1,index2-1);
+          value1 = fix_global(fix,nbracket,index1,index2);
           if (tree) {
             Tree *newtree = new Tree();
             newtree->type = VALUE;
@@ -1793,6 +1790,8 @@ double Variable::evaluate(char *str, Tree **tree)
 
         } else error->all(FLERR,"Mismatched fix in variable formula");
 
+        steptype = FIXREF;
+
       // ----------------
       // variable
       // ----------------
@@ -1810,7 +1809,6 @@ double Variable::evaluate(char *str, Tree **tree)
         // nbracket = # of bracket pairs
         // index = int inside bracket, possibly an atom ID
 
-        int nbracket;
         tagint index;
         if (str[i] != '[') nbracket = 0;
         else {
@@ -1956,6 +1954,8 @@ double Variable::evaluate(char *str, Tree **tree)
 
         } else error->all(FLERR,"Mismatched variable in variable formula");
 
+        if (nbracket == 0) steptype = VARREF;
+
       // ----------------
       // math/group/special function or atom value/vector or
       // constant or thermo keyword
@@ -1973,7 +1973,8 @@ double Variable::evaluate(char *str, Tree **tree)
           i++;
 
           if (math_function(word,contents,tree,
-                            treestack,ntreestack,argstack,nargstack));
+                            treestack,ntreestack,argstack,nargstack))
+            steptype = math_step(word);
           else if (group_function(word,contents,tree,
                                   treestack,ntreestack,argstack,nargstack));
           else if (special_function(word,contents,tree,
@@ -2015,6 +2016,7 @@ double Variable::evaluate(char *str, Tree **tree)
 
         } else if (is_constant(word)) {
           value1 = constant(word);
+          steptype = VALUE;
           if (tree) {
             Tree *newtree = new Tree();
             newtree->type = VALUE;
@@ -2036,6 +2038,7 @@ double Variable::evaluate(char *str, Tree **tree)
           int flag = output->thermo->evaluate_keyword(word,&value1);
           if (flag)
             error->all(FLERR,"Invalid thermo keyword in variable formula");
+          steptype = THERMOWORD;
           if (tree) {
             Tree *newtree = new Tree();
             newtree->type = VALUE;
@@ -2047,6 +2050,32 @@ double Variable::evaluate(char *str, Tree **tree)
         }
       }
 
+      // append step for this word to compiled formula
+      // a math function operates on the steps of its args
+      // any other word replaces steps appended while evaluating it
+      // a compute or fix with a variable index in brackets becomes an ITEM
+
+      if (compiling) {
+        if (steptype == COMPUTEREF || steptype == FIXREF)
+          for (int m = istop+1; m < i; m++)
+            if (str[m] == '[' && str[m+1] == 'v') steptype = ITEM;
+
+        if (steptype >= SQRT && steptype <= CWIGGLE)
+          add_step(steptype,eqcode[compvar].depth-markdepth,NULL,NULL,0);
+        else {
+          eqcode[compvar].n = mark;
+          eqcode[compvar].depth = markdepth;
+          char *id = NULL;
+          if (steptype == THERMOWORD) id = word;
+          else if (steptype != ITEM && steptype != VALUE) id = word+2;
+          Step *step = add_step(steptype,0,id,&str[istart],i-istart);
+          step->nbracket = nbracket;
+          step->index1 = index1;
+          step->index2 = index2;
+          if (steptype == VALUE) step->value = value1;
+        }
+      }
+
       delete [] word;
 
     // ----------------
@@ -2129,6 +2158,12 @@ double Variable::evaluate(char *str, Tree **tree)
           treestack[ntreestack++] = newtree;
 
         } else {
+          if (compiling) {
+            if (opprevious == UNARY || opprevious == NOT)
+              add_step(opprevious,1,NULL,NULL,0);
+            else add_step(opprevious,2,NULL,NULL,0);
+          }
+
           value2 = argstack[--nargstack];
           if (opprevious != UNARY && opprevious != NOT)
             value1 = argstack[--nargstack];
@@ -2214,6 +2249,501 @@ double Variable::evaluate(char *str, Tree **tree)
   }
 }
 
+/* ----------------------------------------------------------------------
+   return value of compute global scalar, vector or array element
+   nbracket = 0,1,2 selects scalar, vector, array
+   invoke compute if needed, index1,index2 are 1-based
+------------------------------------------------------------------------- */
+
+double Variable::compute_global(Compute *compute, int nbracket,
+                                tagint index1, tagint index2)
+{
+  if (nbracket == 0) {
+    if (update->whichflag == 0) {
+      if (compute->invoked_scalar != update->ntimestep)
+        error->all(FLERR,"Compute used in variable between runs "
+                   "is not current");
+    } else if (!(compute->invoked_flag & INVOKED_SCALAR)) {
+      compute->compute_scalar();
+      compute->invoked_flag |= INVOKED_SCALAR;
+    }
+    return compute->scalar;
+  }
+
+  if (nbracket == 1) {
+    if (index1 > compute->size_vector &&
+        compute->size_vector_variable == 0)
+      error->all(FLERR,"Variable formula compute vector "
+                 "is accessed out-of-range");
+    if (update->whichflag == 0) {
+      if (compute->invoked_vector != update->ntimestep)
+        error->all(FLERR,"Compute used in variable between runs "
+                   "is not current");
+    } else if (!(compute->invoked_flag & INVOKED_VECTOR)) {
+      compute->compute_vector();
+      compute->invoked_flag |= INVOKED_VECTOR;
+    }
+
+    if (compute->size_vector_variable &&
+        index1 > compute->size_vector) return 0.0;
+    return compute->vector[index1-1];
+  }
+
+  if (index1 > compute->size_array_rows &&
+      compute->size_array_rows_variable == 0)
+    error->all(FLERR,"Variable formula compute array "
+               "is accessed out-of-range");
+  if (index2 > compute->size_array_cols)
+    error->all(FLERR,"Variable formula compute array "
+               "is accessed out-of-range");
+  if (update->whichflag == 0) {
+    if (compute->invoked_array != update->ntimestep)
+      error->all(FLERR,"Compute used in variable between runs "
+                 "is not current");
+  } else if (!(compute->invoked_flag & INVOKED_ARRAY)) {
+    compute->compute_array();
+    compute->invoked_flag |= INVOKED_ARRAY;
+  }
+
+  if (compute->size_array_rows_variable &&
+      index1 > compute->size_array_rows) return 0.0;
+  return compute->array[index1-1][index2-1];
+}
+
+/* ----------------------------------------------------------------------
+   return value of fix global scalar, vector or array element
+   nbracket = 0,1,2 selects scalar, vector, array
+   index1,index2 are 1-based
+------------------------------------------------------------------------- */
+
+double Variable::fix_global(Fix *fix, int nbracket,
+                            tagint index1, tagint index2)
+{
+  if (nbracket == 0) {
+    if (update->whichflag > 0 && update->ntimestep % fix->global_freq)
+      error->all(FLERR,"Fix in variable not computed at compatible time");
+    return fix->compute_scalar();
+  }
+
+  if (nbracket == 1) {
+    if (index1 > fix->size_vector &&
+        fix->size_vector_variable == 0)
+      error->all(FLERR,"Variable formula fix vector is "
+                 "accessed out-of-range");
+    if (update->whichflag > 0 && update->ntimestep % fix->global_freq)
+      error->all(FLERR,"Fix in variable not computed at compatible time");
+    return fix->compute_vector(index1-1);
+  }
+
+  if (index1 > fix->size_array_rows &&
+      fix->size_array_rows_variable == 0)
+    error->all(FLERR,
+               "Variable formula fix array is accessed out-of-range");
+  if (index2 > fix->size_array_cols)
+    error->all(FLERR,
+               "Variable formula fix array is accessed out-of-range");
+  if (update->whichflag > 0 && update->ntimestep % fix->global_freq)
+    error->all(FLERR,"Fix in variable not computed at compatible time");
+  return fix->compute_array(index1-1,index2-1);
+}
+
+/* ----------------------------------------------------------------------
+   evaluate formula of equal-style variable ivar
+   first evaluation parses the formula string via evaluate()
+     and compiles it into postfix steps as a side effect
+   later evaluations run the steps via eval_code() without parsing
+   only numbers and constants are stored as values,
+     computes, fixes, variables, thermo keywords are looked up by name
+     on each evaluation, so they follow changes to what they refer to
+   compiled steps are discarded when the formula is redefined
+------------------------------------------------------------------------- */
+
+double Variable::evaluate_equal(int ivar)
+{
+  EqualCode *code = &eqcode[ivar];
+  if (code->compiled) return eval_code(ivar);
+
+  code->n = code->depth = code->maxdepth = 0;
+
+  int savevar = compvar;
+  compvar = ivar;
+  double value = evaluate(data[ivar][0],NULL);
+  compvar = savevar;
+
+  memory->destroy(code->stack);
+  memory->create(code->stack,MAX(code->maxdepth,1),"var:stack");
+  code->compiled = 1;
+
+  return value;
+}
+
+/* ----------------------------------------------------------------------
+   evaluate compiled formula of equal-style variable ivar
+   performs the same operations in the same order as evaluate(),
+     so result and error checks are identical
+   an operand that is no longer what it was when compiled,
+     e.g. a compute that was redefined as per-atom, is evaluated
+     from its text via evaluate()
+------------------------------------------------------------------------- */
+
+double Variable::eval_code(int ivar)
+{
+  Step *steps = eqcode[ivar].steps;
+  double *stack = eqcode[ivar].stack;
+  int nsteps = eqcode[ivar].n;
+  int n = 0;
+  double arg,arg2;
+
+  for (int m = 0; m < nsteps; m++) {
+    Step *step = &steps[m];
+
+    switch (step->type) {
+    case VALUE:
+      stack[n++] = step->value;
+      break;
+
+    case COMPUTEREF: {
+      if (domain->box_exist == 0)
+        error->all(FLERR,
+                   "Variable evaluation before simulation box is defined");
+      int icompute = modify->find_compute(step->id);
+      Compute *compute = NULL;
+      if (icompute >= 0 && step->item[0] == 'c')
+        compute = modify->compute[icompute];
+      if (compute && ((step->nbracket == 0 && compute->scalar_flag) ||
+                      (step->nbracket == 1 && compute->vector_flag) ||
+                      (step->nbracket == 2 && compute->array_flag)))
+        stack[n++] = compute_global(compute,step->nbracket,
+                                    step->index1,step->index2);
+      else stack[n++] = eval_item(step->item);
+      break;
+    }
+
+    case FIXREF: {
+      if (domain->box_exist == 0)
+        error->all(FLERR,
+                   "Variable evaluation before simulation box is defined");
+      int ifix = modify->find_fix(step->id);
+      Fix *fix = NULL;
+      if (ifix >= 0 && step->item[0] == 'f') fix = modify->fix[ifix];
+      if (fix && ((step->nbracket == 0 && fix->scalar_flag) ||
+                  (step->nbracket == 1 && fix->vector_flag) ||
+                  (step->nbracket == 2 && fix->array_flag)))
+        stack[n++] = fix_global(fix,step->nbracket,
+                                step->index1,step->index2);
+      else stack[n++] = eval_item(step->item);
+      break;
+    }
+
+    case VARREF: {
+      int jvar = find(step->id);
+      if (jvar >= 0 && eval_in_progress[jvar])
+        error->all(FLERR,"Variable has circular dependency");
+      if (jvar >= 0 && style[jvar] == INTERNAL) stack[n++] = dvalue[jvar];
+      else if (jvar >= 0 && style[jvar] != ATOM &&
+               style[jvar] != ATOMFILE && style[jvar] != VECTOR) {
+        char *var = retrieve(step->id);
+        if (var == NULL)
+          error->all(FLERR,"Invalid variable evaluation in variable formula");
+        stack[n++] = atof(var);
+      } else stack[n++] = eval_item(step->item);
+      break;
+    }
+
+    case THERMOWORD:
+      if (domain->box_exist == 0)
+        error->all(FLERR,
+                   "Variable evaluation before simulation box is defined");
+      if (output->thermo->evaluate_keyword(step->id,&arg))
+        error->all(FLERR,"Invalid thermo keyword in variable formula");
+      stack[n++] = arg;
+      break;
+
+    case ITEM:
+      stack[n++] = eval_item(step->item);
+      break;
+
+    // operators
+
+    case ADD:
+      n--;
+      stack[n-1] = stack[n-1] + stack[n];
+      break;
+    case SUBTRACT:
+      n--;
+      stack[n-1] = stack[n-1] - stack[n];
+      break;
+    case MULTIPLY:
+      n--;
+      stack[n-1] = stack[n-1] * stack[n];
+      break;
+    case DIVIDE:
+      n--;
+      if (stack[n] == 0.0)
+        error->all(FLERR,"Divide by 0 in variable formula");
+      stack[n-1] = stack[n-1] / stack[n];
+      break;
+    case MODULO:
+      n--;
+      if (stack[n] == 0.0)
+        error->all(FLERR,"Modulo 0 in variable formula");
+      stack[n-1] = fmod(stack[n-1],stack[n]);
+      break;
+    case CARAT:
+      n--;
+      if (stack[n] == 0.0)
+        error->all(FLERR,"Power by 0 in variable formula");
+      stack[n-1] = pow(stack[n-1],stack[n]);
+      break;
+    case UNARY:
+      stack[n-1] = -stack[n-1];
+      break;
+    case NOT:
+      stack[n-1] = (stack[n-1] == 0.0) ? 1.0 : 0.0;
+      break;
+    case EQ:
+      n--;
+      stack[n-1] = (stack[n-1] == stack[n]) ? 1.0 : 0.0;
+      break;
+    case NE:
+      n--;
+      stack[n-1] = (stack[n-1] != stack[n]) ? 1.0 : 0.0;
+      break;
+    case LT:
+      n--;
+      stack[n-1] = (stack[n-1] < stack[n]) ? 1.0 : 0.0;
+      break;
+    case LE:
+      n--;
+      stack[n-1] = (stack[n-1] <= stack[n]) ? 1.0 : 0.0;
+      break;
+    case GT:
+      n--;
+      stack[n-1] = (stack[n-1] > stack[n]) ? 1.0 : 0.0;
+      break;
+    case GE:
+      n--;
+      stack[n-1] = (stack[n-1] >= stack[n]) ? 1.0 : 0.0;
+      break;
+    case AND:
+      n--;
+      stack[n-1] = (stack[n-1] != 0.0 && stack[n] != 0.0) ? 1.0 : 0.0;
+      break;
+    case OR:
+      n--;
+      stack[n-1] = (stack[n-1] != 0.0 || stack[n] != 0.0) ? 1.0 : 0.0;
+      break;
+    case XOR:
+      n--;
+      stack[n-1] = ((stack[n-1] == 0.0 && stack[n] != 0.0) ||
+                    (stack[n-1] != 0.0 && stack[n] == 0.0)) ? 1.0 : 0.0;
+      break;
+
+    // math functions, arg count was checked when compiled
+
+    case SQRT:
+      if (stack[n-1] < 0.0)
+        error->all(FLERR,"Sqrt of negative value in variable formula");
+      stack[n-1] = sqrt(stack[n-1]);
+      break;
+    case EXP:
+      stack[n-1] = exp(stack[n-1]);
+      break;
+    case LN:
+      if (stack[n-1] <= 0.0)
+        error->all(FLERR,"Log of zero/negative value in variable formula");
+      stack[n-1] = log(stack[n-1]);
+      break;
+    case LOG:
+      if (stack[n-1] <= 0.0)
+        error->all(FLERR,"Log of zero/negative value in variable formula");
+      stack[n-1] = log10(stack[n-1]);
+      break;
+    case ABS:
+      stack[n-1] = fabs(stack[n-1]);
+      break;
+    case SIN:
+      stack[n-1] = sin(stack[n-1]);
+      break;
+    case COS:
+      stack[n-1] = cos(stack[n-1]);
+      break;
+    case TAN:
+      stack[n-1] = tan(stack[n-1]);
+      break;
+    case ASIN:
+      if (stack[n-1] < -1.0 || stack[n-1] > 1.0)
+        error->all(FLERR,"Arcsin of invalid value in variable formula");
+      stack[n-1] = asin(stack[n-1]);
+      break;
+    case ACOS:
+      if (stack[n-1] < -1.0 || stack[n-1] > 1.0)
+        error->all(FLERR,"Arccos of invalid value in variable formula");
+      stack[n-1] = acos(stack[n-1]);
+      break;
+    case ATAN:
+      stack[n-1] = atan(stack[n-1]);
+      break;
+    case ATAN2:
+      n--;
+      stack[n-1] = atan2(stack[n-1],stack[n]);
+      break;
+    case CEIL:
+      stack[n-1] = ceil(stack[n-1]);
+      break;
+    case FLOOR:
+      stack[n-1] = floor(stack[n-1]);
+      break;
+    case ROUND:
+      arg = stack[n-1];
+      stack[n-1] = MYROUND(arg);
+      break;
+
+    case RAMP: {
+      n--;
+      if (update->whichflag == 0)
+        error->all(FLERR,"Cannot use ramp in variable formula between runs");
+      double delta = update->ntimestep - update->beginstep;
+      if (delta != 0.0) delta /= update->endstep - update->beginstep;
+      stack[n-1] = stack[n-1] + delta*(stack[n]-stack[n-1]);
+      break;
+    }
+    case VDISPLACE: {
+      n--;
+      if (update->whichflag == 0)
+        error->all(FLERR,
+                   "Cannot use vdisplace in variable formula between runs");
+      double delta = update->ntimestep - update->beginstep;
+      stack[n-1] = stack[n-1] + stack[n]*delta*update->dt;
+      break;
+    }
+    case SWIGGLE: case CWIGGLE: {
+      n -= 2;
+      if (update->whichflag == 0) {
+        if (step->type == SWIGGLE)
+          error->all(FLERR,
+                     "Cannot use swiggle in variable formula between runs");
+        error->all(FLERR,
+                   "Cannot use cwiggle in variable formula between runs");
+      }
+      if (stack[n+1] == 0.0)
+        error->all(FLERR,"Invalid math function in variable formula");
+      double delta = update->ntimestep - update->beginstep;
+      double omega = 2.0*MY_PI/stack[n+1];
+      arg = stack[n-1];
+      arg2 = stack[n];
+      if (step->type == SWIGGLE)
+        stack[n-1] = arg + arg2*sin(omega*delta*update->dt);
+      else stack[n-1] = arg + arg2*(1.0-cos(omega*delta*update->dt));
+      break;
+    }
+    }
+  }
+
+  return stack[0];
+}
+
+/* ----------------------------------------------------------------------
+   evaluate formula str immediately, without compiling it
+------------------------------------------------------------------------- */
+
+double Variable::eval_item(char *str)
+{
+  int savevar = compvar;
+  compvar = -1;
+  double value = evaluate(str,NULL);
+  compvar = savevar;
+  return value;
+}
+
+/* ----------------------------------------------------------------------
+   append a step to compiled formula of variable compvar
+   narg = # of values the step pops from the stack, it pushes one
+   id and item = strings copied into the step, item has length nitem
+------------------------------------------------------------------------- */
+
+Variable::Step *Variable::add_step(int type, int narg, char *id,
+                                   char *item, int nitem)
+{
+  EqualCode *code = &eqcode[compvar];
+  if (code->n == code->nmax) {
+    code->nmax += VARDELTA;
+    code->steps = (Step *)
+      memory->srealloc(code->steps,code->nmax*sizeof(Step),"var:steps");
+  }
+
+  Step *step = &code->steps[code->n++];
+  step->type = type;
+  step->nbracket = 0;
+  step->index1 = step->index2 = 0;
+  step->value = 0.0;
+  step->id = step->item = NULL;
+
+  if (id) {
+    int n = strlen(id) + 1;
+    step->id = new char[n];
+    strcpy(step->id,id);
+  }
+  if (item) {
+    step->item = new char[nitem+1];
+    strncpy(step->item,item,nitem);
+    step->item[nitem] = '\0';
+  }
+
+  code->depth += 1 - narg;
+  code->maxdepth = MAX(code->maxdepth,code->depth);
+  return step;
+}
+
+/* ----------------------------------------------------------------------
+   return step type for math function word in a compiled formula
+   return ITEM if function must be evaluated from its text:
+     random() and normal() initialize randomequal with their seed,
+     stagger() etc are only evaluated when output is scheduled
+------------------------------------------------------------------------- */
+
+int Variable::math_step(char *word)
+{
+  if (strcmp(word,"sqrt") == 0) return SQRT;
+  if (strcmp(word,"exp") == 0) return EXP;
+  if (strcmp(word,"ln") == 0) return LN;
+  if (strcmp(word,"log") == 0) return LOG;
+  if (strcmp(word,"abs") == 0) return ABS;
+  if (strcmp(word,"sin") == 0) return SIN;
+  if (strcmp(word,"cos") == 0) return COS;
+  if (strcmp(word,"tan") == 0) return TAN;
+  if (strcmp(word,"asin") == 0) return ASIN;
+  if (strcmp(word,"acos") == 0) return ACOS;
+  if (strcmp(word,"atan") == 0) return ATAN;
+  if (strcmp(word,"atan2") == 0) return ATAN2;
+  if (strcmp(word,"ceil") == 0) return CEIL;
+  if (strcmp(word,"floor") == 0) return FLOOR;
+  if (strcmp(word,"round") == 0) return ROUND;
+  if (strcmp(word,"ramp") == 0) return RAMP;
+  if (strcmp(word,"vdisplace") == 0) return VDISPLACE;
+  if (strcmp(word,"swiggle") == 0) return SWIGGLE;
+  if (strcmp(word,"cwiggle") == 0) return CWIGGLE;
+  return ITEM;
+}
+
+/* ----------------------------------------------------------------------
+   free compiled formula of variable ivar
+------------------------------------------------------------------------- */
+
+void Variable::free_code(int ivar)
+{
+  EqualCode *code = &eqcode[ivar];
+  for (int m = 0; m < code->n; m++) {
+    delete [] code->steps[m].id;
+    delete [] code->steps[m].item;
+  }
+  memory->sfree(code->steps);
+  memory->destroy(code->stack);
+  code->steps = NULL;
+  code->stack = NULL;
+  code->compiled = code->n = code->nmax = 0;
+}
+
 /* ----------------------------------------------------------------------
    one-time collapse of an atom-style variable parse tree
    tree was created by one-time parsing of formula string via evaluate()
@@ -3075,6 +3605,419 @@ double Variable::eval_tree(Tree *tree, int i)
   return 0.0;
 }
 
+/* ----------------------------------------------------------------------
+   compile a collapsed tree into a flat program for eval_program()
+   each instruction computes one node for a block of atoms at a time
+   nodes without a block version become INTERPRET instructions,
+     which call eval_tree() for each atom in the block
+   return 1 if compiled, 0 if tree must be evaluated by eval_tree()
+     trees with random() or normal() are not compiled,
+     since their random numbers must be drawn atom by atom
+------------------------------------------------------------------------- */
+
+int Variable::compile_tree(Tree *tree)
+{
+  if (tree_random(tree)) return 0;
+
+  ninstr = 0;
+  serialflag = 0;
+  compile_node(tree);
+  return 1;
+}
+
+/* ----------------------------------------------------------------------
+   append instructions for tree and its operands to program
+   return index of instruction which computes tree
+------------------------------------------------------------------------- */
+
+int Variable::compile_node(Tree *tree)
+{
+  int type = tree->type;
+  int first = -1;
+  int second = -1;
+
+  // AND and OR only evaluate 2nd arg if needed,
+  // so interpret them if 2nd arg could trigger an error
+
+  if ((type == AND || type == OR) && tree_checked(tree->second))
+    type = INTERPRET;
+
+  switch (type) {
+  case VALUE: case ATOMARRAY: case TYPEARRAY: case INTARRAY:
+  case BIGINTARRAY: case VECTORARRAY: case GMASK: case RMASK: case GRMASK:
+    break;
+
+  case ADD: case SUBTRACT: case MULTIPLY: case DIVIDE: case MODULO:
+  case CARAT: case EQ: case NE: case LT: case LE: case GT: case GE:
+  case AND: case OR: case XOR: case ATAN2:
+    first = compile_node(tree->first);
+    second = compile_node(tree->second);
+    break;
+
+  case UNARY: case NOT: case SQRT: case EXP: case LN: case LOG: case ABS:
+  case SIN: case COS: case TAN: case ASIN: case ACOS: case ATAN:
+  case CEIL: case FLOOR: case ROUND:
+    first = compile_node(tree->first);
+    break;
+
+  default:
+    type = INTERPRET;
+    break;
+  }
+
+  // eval_tree() may call error->one(), so do not use threads
+
+  if (type == INTERPRET) serialflag = 1;
+
+  if (ninstr == maxinstr) {
+    maxinstr += VARDELTA;
+    program = (Instr *)
+      memory->srealloc(program,maxinstr*sizeof(Instr),"var:program");
+  }
+
+  program[ninstr].type = type;
+  program[ninstr].first = first;
+  program[ninstr].second = second;
+  program[ninstr].tree = tree;
+  return ninstr++;
+}
+
+/* ----------------------------------------------------------------------
+   return 1 if tree uses random() or normal(), else 0
+------------------------------------------------------------------------- */
+
+int Variable::tree_random(Tree *tree)
+{
+  if (tree->type == RANDOM || tree->type == NORMAL) return 1;
+  if (tree->first && tree_random(tree->first)) return 1;
+  if (tree->second && tree_random(tree->second)) return 1;
+  for (int i = 0; i < tree->nextra; i++)
+    if (tree_random(tree->extra[i])) return 1;
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   return 1 if evaluating tree could trigger an error, else 0
+   any operation not listed here is assumed to check its args
+------------------------------------------------------------------------- */
+
+int Variable::tree_checked(Tree *tree)
+{
+  switch (tree->type) {
+  case VALUE: case ATOMARRAY: case TYPEARRAY: case INTARRAY:
+  case BIGINTARRAY: case VECTORARRAY: case GMASK: case RMASK: case GRMASK:
+  case ADD: case SUBTRACT: case MULTIPLY: case UNARY: case NOT:
+  case EQ: case NE: case LT: case LE: case GT: case GE:
+  case AND: case OR: case XOR: case EXP: case ABS: case SIN: case COS:
+  case TAN: case ATAN: case ATAN2: case CEIL: case FLOOR: case ROUND:
+    break;
+  default:
+    return 1;
+  }
+
+  if (tree->first && tree_checked(tree->first)) return 1;
+  if (tree->second && tree_checked(tree->second)) return 1;
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   evaluate compiled program for n atoms or vector elements
+   only atoms in group with groupbit are computed, else result is 0.0
+     groupbit = 0 computes all n values
+   answers are placed every stride locations into result
+   if sumflag, add values to existing result
+   blocks of atoms are spread across threads if OpenMP is enabled,
+     result is identical to calling eval_tree() for each atom
+------------------------------------------------------------------------- */
+
+void Variable::eval_program(int n, int groupbit,
+                            double *result, int stride, int sumflag)
+{
+  int nblocks = (n + NBLOCK-1) / NBLOCK;
+  int nthreads = 1;
+#if defined(_OPENMP)
+  if (!serialflag) nthreads = MIN(comm->nthreads,nblocks);
+  if (nthreads < 1) nthreads = 1;
+#endif
+
+  // per thread: one block of values per instruction + active flags
+
+  int nslot = (ninstr+1) * NBLOCK;
+  if (nthreads*nslot > maxscratch) {
+    memory->destroy(scratch);
+    maxscratch = nthreads*nslot;
+    memory->create(scratch,maxscratch,"var:scratch");
+  }
+
+  int errflag = 0;
+
+#if defined(_OPENMP)
+#pragma omp parallel num_threads(nthreads) reduction(max:errflag)
+#endif
+  {
+    int tid = 0;
+#if defined(_OPENMP)
+    tid = omp_get_thread_num();
+#endif
+    double *work = &scratch[tid*nslot];
+    double *out = &work[(ninstr-1)*NBLOCK];
+    double *active = &work[ninstr*NBLOCK];
+    int firstblock = 1;
+
+    for (int iblock = tid; iblock < nblocks; iblock += nthreads) {
+      int ifirst = iblock*NBLOCK;
+      int nb = MIN(NBLOCK,n-ifirst);
+      int flag = eval_block(work,ifirst,nb,groupbit,firstblock);
+      if (flag > errflag) errflag = flag;
+      firstblock = 0;
+
+      int m = ifirst*stride;
+      if (sumflag == 0) {
+        for (int k = 0; k < nb; k++) {
+          if (active[k] != 0.0) result[m] = out[k];
+          else result[m] = 0.0;
+          m += stride;
+        }
+      } else {
+        for (int k = 0; k < nb; k++) {
+          if (active[k] != 0.0) result[m] += out[k];
+          m += stride;
+        }
+      }
+    }
+  }
+
+  if (errflag == DIVIDE)
+    error->one(FLERR,"Divide by 0 in variable formula");
+  else if (errflag == MODULO)
+    error->one(FLERR,"Modulo 0 in variable formula");
+  else if (errflag == CARAT)
+    error->one(FLERR,"Power by 0 in variable formula");
+  else if (errflag == SQRT)
+    error->one(FLERR,"Sqrt of negative value in variable formula");
+  else if (errflag == LN || errflag == LOG)
+    error->one(FLERR,"Log of zero/negative value in variable formula");
+  else if (errflag == ASIN)
+    error->one(FLERR,"Arcsin of invalid value in variable formula");
+  else if (errflag == ACOS)
+    error->one(FLERR,"Arccos of invalid value in variable formula");
+}
+
+/* ----------------------------------------------------------------------
+   run all instructions of program for nb atoms starting at ifirst
+   work = NBLOCK values for each instruction, followed by active flags
+   constant values only need to be filled in for a thread's first block
+   inactive atoms are computed but cannot trigger errors
+   return type of operation with invalid args, 0 if none
+------------------------------------------------------------------------- */
+
+int Variable::eval_block(double *work, int ifirst, int nb,
+                         int groupbit, int firstblock)
+{
+  int k;
+  int *mask = atom->mask;
+  double *active = &work[ninstr*NBLOCK];
+  int errflag = 0;
+
+  if (groupbit) {
+    for (k = 0; k < nb; k++)
+      active[k] = (mask[ifirst+k] & groupbit) ? 1.0 : 0.0;
+  } else {
+    for (k = 0; k < nb; k++) active[k] = 1.0;
+  }
+
+  for (int j = 0; j < ninstr; j++) {
+    Tree *tree = program[j].tree;
+    double *out = &work[j*NBLOCK];
+    double *a = NULL;
+    double *b = NULL;
+    if (program[j].first >= 0) a = &work[program[j].first*NBLOCK];
+    if (program[j].second >= 0) b = &work[program[j].second*NBLOCK];
+
+    switch (program[j].type) {
+    case VALUE:
+      if (firstblock)
+        for (k = 0; k < NBLOCK; k++) out[k] = tree->value;
+      break;
+    case ATOMARRAY: case VECTORARRAY:
+      for (k = 0; k < nb; k++) out[k] = tree->array[(ifirst+k)*tree->nstride];
+      break;
+    case TYPEARRAY:
+      for (k = 0; k < nb; k++) out[k] = tree->array[atom->type[ifirst+k]];
+      break;
+    case INTARRAY:
+      for (k = 0; k < nb; k++)
+        out[k] = (double) tree->iarray[(ifirst+k)*tree->nstride];
+      break;
+    case BIGINTARRAY:
+      for (k = 0; k < nb; k++)
+        out[k] = (double) tree->barray[(ifirst+k)*tree->nstride];
+      break;
+
+    case ADD:
+      for (k = 0; k < nb; k++) out[k] = a[k] + b[k];
+      break;
+    case SUBTRACT:
+      for (k = 0; k < nb; k++) out[k] = a[k] - b[k];
+      break;
+    case MULTIPLY:
+      for (k = 0; k < nb; k++) out[k] = a[k] * b[k];
+      break;
+    case DIVIDE:
+      for (k = 0; k < nb; k++) {
+        if (b[k] == 0.0 && active[k] != 0.0) errflag = DIVIDE;
+        out[k] = a[k] / b[k];
+      }
+      break;
+    case MODULO:
+      for (k = 0; k < nb; k++) {
+        if (b[k] == 0.0 && active[k] != 0.0) errflag = MODULO;
+        out[k] = fmod(a[k],b[k]);
+      }
+      break;
+    case CARAT:
+      for (k = 0; k < nb; k++) {
+        if (b[k] == 0.0 && active[k] != 0.0) errflag = CARAT;
+        out[k] = pow(a[k],b[k]);
+      }
+      break;
+    case UNARY:
+      for (k = 0; k < nb; k++) out[k] = -a[k];
+      break;
+
+    case NOT:
+      for (k = 0; k < nb; k++) out[k] = (a[k] == 0.0) ? 1.0 : 0.0;
+      break;
+    case EQ:
+      for (k = 0; k < nb; k++) out[k] = (a[k] == b[k]) ? 1.0 : 0.0;
+      break;
+    case NE:
+      for (k = 0; k < nb; k++) out[k] = (a[k] != b[k]) ? 1.0 : 0.0;
+      break;
+    case LT:
+      for (k = 0; k < nb; k++) out[k] = (a[k] < b[k]) ? 1.0 : 0.0;
+      break;
+    case LE:
+      for (k = 0; k < nb; k++) out[k] = (a[k] <= b[k]) ? 1.0 : 0.0;
+      break;
+    case GT:
+      for (k = 0; k < nb; k++) out[k] = (a[k] > b[k]) ? 1.0 : 0.0;
+      break;
+    case GE:
+      for (k = 0; k < nb; k++) out[k] = (a[k] >= b[k]) ? 1.0 : 0.0;
+      break;
+    case AND:
+      for (k = 0; k < nb; k++)
+        out[k] = (a[k] != 0.0 && b[k] != 0.0) ? 1.0 : 0.0;
+      break;
+    case OR:
+      for (k = 0; k < nb; k++)
+        out[k] = (a[k] != 0.0 || b[k] != 0.0) ? 1.0 : 0.0;
+      break;
+    case XOR:
+      for (k = 0; k < nb; k++)
+        out[k] = ((a[k] == 0.0 && b[k] != 0.0) ||
+                  (a[k] != 0.0 && b[k] == 0.0)) ? 1.0 : 0.0;
+      break;
+
+    case SQRT:
+      for (k = 0; k < nb; k++) {
+        if (a[k] < 0.0 && active[k] != 0.0) errflag = SQRT;
+        out[k] = sqrt(a[k]);
+      }
+      break;
+    case EXP:
+      for (k = 0; k < nb; k++) out[k] = exp(a[k]);
+      break;
+    case LN:
+      for (k = 0; k < nb; k++) {
+        if (a[k] <= 0.0 && active[k] != 0.0) errflag = LN;
+        out[k] = log(a[k]);
+      }
+      break;
+    case LOG:
+      for (k = 0; k < nb; k++) {
+        if (a[k] <= 0.0 && active[k] != 0.0) errflag = LOG;
+        out[k] = log10(a[k]);
+      }
+      break;
+    case ABS:
+      for (k = 0; k < nb; k++) out[k] = fabs(a[k]);
+      break;
+    case SIN:
+      for (k = 0; k < nb; k++) out[k] = sin(a[k]);
+      break;
+    case COS:
+      for (k = 0; k < nb; k++) out[k] = cos(a[k]);
+      break;
+    case TAN:
+      for (k = 0; k < nb; k++) out[k] = tan(a[k]);
+      break;
+    case ASIN:
+      for (k = 0; k < nb; k++) {
+        if ((a[k] < -1.0 || a[k] > 1.0) && active[k] != 0.0) errflag = ASIN;
+        out[k] = asin(a[k]);
+      }
+      break;
+    case ACOS:
+      for (k = 0; k < nb; k++) {
+        if ((a[k] < -1.0 || a[k] > 1.0) && active[k] != 0.0) errflag = ACOS;
+        out[k] = acos(a[k]);
+      }
+      break;
+    case ATAN:
+      for (k = 0; k < nb; k++) out[k] = atan(a[k]);
+      break;
+    case ATAN2:
+      for (k = 0; k < nb; k++) out[k] = atan2(a[k],b[k]);
+      break;
+    case CEIL:
+      for (k = 0; k < nb; k++) out[k] = ceil(a[k]);
+      break;
+    case FLOOR:
+      for (k = 0; k < nb; k++) out[k] = floor(a[k]);
+      break;
+    case ROUND:
+      for (k = 0; k < nb; k++) out[k] = MYROUND(a[k]);
+      break;
+
+    case GMASK:
+      for (k = 0; k < nb; k++)
+        out[k] = (mask[ifirst+k] & tree->ivalue1) ? 1.0 : 0.0;
+      break;
+    case RMASK: {
+      Region *region = domain->regions[tree->ivalue1];
+      double **x = atom->x;
+      for (k = 0; k < nb; k++) {
+        double *xi = x[ifirst+k];
+        out[k] = region->match(xi[0],xi[1],xi[2]) ? 1.0 : 0.0;
+      }
+      break;
+    }
+    case GRMASK: {
+      Region *region = domain->regions[tree->ivalue2];
+      double **x = atom->x;
+      for (k = 0; k < nb; k++) {
+        double *xi = x[ifirst+k];
+        if ((mask[ifirst+k] & tree->ivalue1) &&
+            region->match(xi[0],xi[1],xi[2])) out[k] = 1.0;
+        else out[k] = 0.0;
+      }
+      break;
+    }
+
+    case INTERPRET:
+      for (k = 0; k < nb; k++) {
+        if (active[k] != 0.0) out[k] = eval_tree(tree,ifirst+k);
+        else out[k] = 0.0;
+      }
+      break;
+    }
+  }
+
+  return errflag;
+}
+
 /* ----------------------------------------------------------------------
    scan entire tree, find size of vectors for vector-style variable
    return N for consistent vector size
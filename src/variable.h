@@ -95,13 +95,59 @@ class Variable : protected Pointers {
     Tree **extra;          // ptrs further down tree for nextra args
   };
 
+  struct Instr {           // one step of a Tree compiled for block evaluation
+    int type;              // operation, as in Tree, or INTERPRET
+    int first,second;      // instructions which compute the operands
+    Tree *tree;            // node this instruction was compiled from
+  };
+
+  Instr *program;          // compiled Tree, last instruction = result
+  int ninstr,maxinstr;     // # of instructions, size of program
+  int serialflag;          // 1 if program must be run by one thread
+  double *scratch;         // per-thread block of values for each instruction
+  int maxscratch;          // size of scratch
+
+  struct Step {            // one step of a compiled equal-style formula
+    int type;              // operation or operand, see enum{} in variable.cpp
+    int nbracket;          // # of brackets after a compute or fix ID
+    tagint index1,index2;  // ints inside brackets
+    double value;          // constant operand
+    char *id;              // compute/fix ID, variable name, thermo keyword
+    char *item;            // operand text, evaluated by evaluate() if needed
+  };
+
+  struct EqualCode {       // equal-style formula compiled to postfix steps
+    int compiled;          // 1 if steps are complete, 0 if not yet compiled
+    int n,nmax;            // # of steps, allocated length of steps
+    int depth,maxdepth;    // current and max stack depth while compiling
+    Step *steps;
+    double *stack;         // value stack used by eval_code()
+  };
+
+  EqualCode *eqcode;       // compiled formula of each equal-style variable
+  int compvar;             // variable evaluate() is compiling, -1 if none
+
   int compute_python(int);
   void remove(int);
   void grow();
   void copy(int, char **, char **);
   double evaluate(char *, Tree **);
+  double evaluate_equal(int);
+  double eval_code(int);
+  double eval_item(char *);
+  Step *add_step(int, int, char *, char *, int);
+  int math_step(char *);
+  void free_code(int);
+  double compute_global(class Compute *, int, tagint, tagint);
+  double fix_global(class Fix *, int, tagint, tagint);
   double collapse_tree(Tree *);
   double eval_tree(Tree *, int);
+  int compile_tree(Tree *);
+  int compile_node(Tree *);
+  int tree_random(Tree *);
+  int tree_checked(Tree *);
+  void eval_program(int, int, double *, int, int);
+  int eval_block(double *, int, int, int, int);
   int size_tree_vector(Tree *);
   int compare_tree_vector(int, int);
   void free_tree(Tree *);
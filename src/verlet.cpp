@@ -14,6 +14,7 @@
 #include <string.h>
 #include "verlet.h"
 #include "neighbor.h"
+#include "neigh_list.h"
 #include "domain.h"
 #include "comm.h"
 #include "atom.h"
@@ -39,7 +40,20 @@ using namespace LAMMPS_NS;
 /* ---------------------------------------------------------------------- */
 
 Verlet::Verlet(LAMMPS *lmp, int narg, char **arg) :
-  Integrate(lmp, narg, arg) {}
+  Integrate(lmp, narg, arg)
+{
+  kspace_every = 1;
+  maxkspace = 0;
+  fkspace = NULL;
+  driftflag = 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+Verlet::~Verlet()
+{
+  memory->destroy(fkspace);
+}
 
 /* ----------------------------------------------------------------------
    initialization before run
@@ -79,6 +93,20 @@ void Verlet::init()
   // orthogonal vs triclinic simulation box
 
   triclinic = domain->triclinic;
+
+  // kspace forces applied every Nth step
+  // USER-OMP kspace styles reduce per-thread pair forces in their compute()
+  // pe and temperature computes are used to report energy drift
+
+  kspace_every = 1;
+  if (kspace_compute_flag) kspace_every = force->kspace->every;
+  if (kspace_every > 1) {
+    if (strstr(force->kspace_style,"/omp") || force->kspace->dipoleflag)
+      error->all(FLERR,"Kspace_modify every > 1 is not compatible "
+                 "with this kspace style");
+    pe = modify->compute[modify->find_compute("thermo_pe")];
+    temperature = modify->compute[modify->find_compute("thermo_temp")];
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -96,6 +124,7 @@ void Verlet::setup()
   }
 
   update->setupflag = 1;
+  setup_overlap();
 
   // setup domain, communication and neighboring
   // acquire ghosts
@@ -116,11 +145,18 @@ void Verlet::setup()
   domain->box_too_small_check();
   modify->setup_pre_neighbor();
   neighbor->build();
+  if (overlap) force->pair->list->split_interior();
+  if (neighbor->prune_every) neighbor->prune();
   neighbor->ncalls = 0;
 
   // compute all forces
+  // with kspace every > 1, tally energy on 1st and last step for drift
 
   force->setup();
+  if (kspace_every > 1) {
+    pe->addstep(update->ntimestep);
+    pe->addstep(update->laststep);
+  }
   ev_set(update->ntimestep);
   force_clear();
   modify->setup_pre_force(vflag);
@@ -137,7 +173,8 @@ void Verlet::setup()
 
   if (force->kspace) {
     force->kspace->setup();
-    if (kspace_compute_flag) force->kspace->compute(eflag,vflag);
+    if (kspace_every > 1) kspace_compute(update->ntimestep);
+    else if (kspace_compute_flag) force->kspace->compute(eflag,vflag);
     else force->kspace->compute_dummy(eflag,vflag);
   }
 
@@ -147,6 +184,13 @@ void Verlet::setup()
   modify->setup(vflag);
   output->setup();
   update->setupflag = 0;
+
+  driftflag = 0;
+  if (kspace_every > 1) {
+    etotal_start = total_energy();
+    driftstep = update->ntimestep;
+    driftflag = 1;
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -158,6 +202,7 @@ void Verlet::setup()
 void Verlet::setup_minimal(int flag)
 {
   update->setupflag = 1;
+  setup_overlap();
 
   // setup domain, communication and neighboring
   // acquire ghosts
@@ -177,6 +222,7 @@ void Verlet::setup_minimal(int flag)
     domain->box_too_small_check();
     modify->setup_pre_neighbor();
     neighbor->build();
+    if (overlap) force->pair->list->split_interior();
     neighbor->ncalls = 0;
   }
 
@@ -198,7 +244,8 @@ void Verlet::setup_minimal(int flag)
 
   if (force->kspace) {
     force->kspace->setup();
-    if (kspace_compute_flag) force->kspace->compute(eflag,vflag);
+    if (kspace_every > 1) kspace_compute(update->ntimestep);
+    else if (kspace_compute_flag) force->kspace->compute(eflag,vflag);
     else force->kspace->compute_dummy(eflag,vflag);
   }
 
@@ -207,6 +254,7 @@ void Verlet::setup_minimal(int flag)
 
   modify->setup(vflag);
   update->setupflag = 0;
+  driftflag = 0;
 }
 
 /* ----------------------------------------------------------------------
@@ -217,6 +265,7 @@ void Verlet::run(int n)
 {
   bigint ntimestep;
   int nflag,sortflag;
+  int ovlflag,ovlreverse,ninterior,nfirst;
 
   int n_post_integrate = modify->n_post_integrate;
   int n_pre_exchange = modify->n_pre_exchange;
@@ -249,9 +298,21 @@ void Verlet::run(int n)
 
     nflag = neighbor->decide();
 
+    // overlap comm with pair computation on steps without reneighboring
+    // not if per-atom energy/virial or fdotr virial, which use ghosts
+    // interior atoms are split between forward and reverse comm
+
+    ovlflag = ovlreverse = 0;
+    if (overlap && nflag == 0 && eflag < 2 && vflag < 4 &&
+        (vflag != 2 || force->pair->no_virial_fdotr_compute)) {
+      ovlflag = 1;
+      if (force->newton && n_pre_reverse == 0) ovlreverse = 1;
+    }
+
     if (nflag == 0) {
       timer->stamp();
-      comm->forward_comm();
+      if (ovlflag) comm->forward_comm_start();
+      else comm->forward_comm();
       timer->stamp(Timer::COMM);
     } else {
       if (n_pre_exchange) {
@@ -277,6 +338,15 @@ void Verlet::run(int n)
         timer->stamp(Timer::MODIFY);
       }
       neighbor->build();
+      if (overlap) force->pair->list->split_interior();
+      timer->stamp(Timer::NEIGH);
+    }
+
+    // prune pair lists to their smaller skin
+
+    if (neighbor->prune_every) {
+      timer->stamp();
+      neighbor->prune();
       timer->stamp(Timer::NEIGH);
     }
 
@@ -295,7 +365,17 @@ void Verlet::run(int n)
     }
 
     if (pair_compute_flag) {
-      force->pair->compute(eflag,vflag);
+      if (ovlflag) {
+        ninterior = force->pair->list->ninterior;
+        if (ovlreverse) nfirst = ninterior/2;
+        else nfirst = ninterior;
+        force->pair->compute_partial(eflag,vflag,0,nfirst,0);
+        timer->stamp(Timer::PAIR);
+        comm->forward_comm_finish();
+        timer->stamp(Timer::COMM);
+        force->pair->compute_partial(eflag,vflag,ninterior,
+                                     force->pair->list->inum-ninterior,1);
+      } else force->pair->compute(eflag,vflag);
       timer->stamp(Timer::PAIR);
     }
 
@@ -308,7 +388,8 @@ void Verlet::run(int n)
     }
 
     if (kspace_compute_flag) {
-      force->kspace->compute(eflag,vflag);
+      if (kspace_every > 1) kspace_compute(ntimestep);
+      else force->kspace->compute(eflag,vflag);
       timer->stamp(Timer::KSPACE);
     }
 
@@ -320,7 +401,13 @@ void Verlet::run(int n)
     // reverse communication of forces
 
     if (force->newton) {
-      comm->reverse_comm();
+      if (ovlreverse) {
+        comm->reverse_comm_start();
+        timer->stamp(Timer::COMM);
+        force->pair->compute_partial(eflag,vflag,nfirst,ninterior-nfirst,1);
+        timer->stamp(Timer::PAIR);
+        comm->reverse_comm_finish();
+      } else comm->reverse_comm();
       timer->stamp(Timer::COMM);
     }
 
@@ -348,6 +435,51 @@ void Verlet::cleanup()
   modify->post_run();
   domain->box_too_small_check();
   update->update_time();
+
+  // report drift of total energy when kspace forces were applied every Nth step
+  // only if energy was tallied on last step, i.e. run was not cut short
+
+  if (driftflag && update->ntimestep > driftstep &&
+      update->eflag_global == update->ntimestep) {
+    double drift = total_energy() - etotal_start;
+    if (atom->natoms) drift /= atom->natoms;
+    double time = (update->ntimestep - driftstep) * update->dt;
+    if (comm->me == 0) {
+      char str[128];
+      sprintf(str,"KSpace every %d steps: total energy drift = %g "
+              "per atom over %g time units",kspace_every,drift,time);
+      if (screen) fprintf(screen,"%s\n",str);
+      if (logfile) fprintf(logfile,"%s\n",str);
+    }
+  }
+  driftflag = 0;
+}
+
+/* ----------------------------------------------------------------------
+   check if comm can overlap pair computation in this run
+   only for pair styles whose compute() loops over the I atoms of a
+     standard list, without comm of its own or neighbors of ghosts
+   fixes invoked at pre_force may use ghost coords
+------------------------------------------------------------------------- */
+
+void Verlet::setup_overlap()
+{
+  overlap = 0;
+  if (!comm->overlap) return;
+
+  Pair *pair = force->pair;
+  if (pair && pair_compute_flag && pair->list &&
+      !pair->list->clusterflag && !pair->list->ssaflag &&
+      !pair->manybody_flag && !pair->ghostneigh &&
+      !pair->comm_forward && !pair->comm_reverse &&
+      !strstr(force->pair_style,"/gpu") &&
+      !strstr(force->pair_style,"/intel") &&
+      !force->pair_match("hybrid",0) && !lmp->kokkos &&
+      modify->n_pre_force == 0)
+    overlap = 1;
+  else if (comm->me == 0)
+    error->warning(FLERR,"Comm_modify overlap not used with this "
+                   "pair style or fixes");
 }
 
 /* ----------------------------------------------------------------------
@@ -401,3 +533,64 @@ void Verlet::force_clear()
     }
   }
 }
+
+/* ----------------------------------------------------------------------
+   kspace forces as impulses every kspace_every steps (multiple time steps)
+   on those steps forces are scaled by kspace_every
+   on other steps kspace is only computed if energy or virial is tallied,
+     its forces are then discarded
+   kspace->compute() adds to f, so its forces are the change from a copy
+     of f of owned and ghost atoms made before
+------------------------------------------------------------------------- */
+
+void Verlet::kspace_compute(bigint ntimestep)
+{
+  int i;
+
+  int impulse = (ntimestep % kspace_every == 0);
+  if (!impulse && !eflag && !vflag) return;
+
+  int nall = atom->nlocal + atom->nghost;
+  if (nall > maxkspace) {
+    maxkspace = atom->nmax;
+    memory->destroy(fkspace);
+    memory->create(fkspace,maxkspace,3,"verlet:fkspace");
+  }
+
+  double **f = atom->f;
+  for (i = 0; i < nall; i++) {
+    fkspace[i][0] = f[i][0];
+    fkspace[i][1] = f[i][1];
+    fkspace[i][2] = f[i][2];
+  }
+
+  force->kspace->compute(eflag,vflag);
+
+  if (impulse) {
+    const double factor = kspace_every;
+    for (i = 0; i < nall; i++) {
+      f[i][0] = fkspace[i][0] + factor*(f[i][0]-fkspace[i][0]);
+      f[i][1] = fkspace[i][1] + factor*(f[i][1]-fkspace[i][1]);
+      f[i][2] = fkspace[i][2] + factor*(f[i][2]-fkspace[i][2]);
+    }
+  } else {
+    for (i = 0; i < nall; i++) {
+      f[i][0] = fkspace[i][0];
+      f[i][1] = fkspace[i][1];
+      f[i][2] = fkspace[i][2];
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------
+   total energy of the system from thermo pe and temperature computes
+   energy must have been tallied on this timestep
+------------------------------------------------------------------------- */
+
+double Verlet::total_energy()
+{
+  double etotal = pe->compute_scalar();
+  etotal += temperature->compute_scalar() *
+    0.5 * temperature->dof * force->boltz;
+  return etotal;
+}
@@ -27,7 +27,7 @@ namespace LAMMPS_NS {
 class Verlet : public Integrate {
  public:
   Verlet(class LAMMPS *, int, char **);
-  virtual ~Verlet() {}
+  virtual ~Verlet();
   virtual void init();
   virtual void setup();
   virtual void setup_minimal(int);
@@ -37,8 +37,20 @@ class Verlet : public Integrate {
  protected:
   int triclinic;                    // 0 if domain is orthog, 1 if triclinic
   int torqueflag,extraflag;
+  int overlap;                      // 1 if comm overlaps pair computation
+
+  int kspace_every;                 // apply kspace forces every this many steps
+  int maxkspace;                    // size of fkspace
+  double **fkspace;                 // forces before kspace compute
+  int driftflag;                    // 1 if total energy at setup was stored
+  bigint driftstep;                 // timestep it was stored on
+  double etotal_start;              // total energy on that timestep
+  class Compute *pe,*temperature;   // computes for the total energy
 
   virtual void force_clear();
+  void setup_overlap();
+  void kspace_compute(bigint);
+  double total_energy();
 };
 
 }
@@ -48,9 +60,21 @@ class Verlet : public Integrate {
 
 /* ERROR/WARNING messages:
 
+E: Kspace_modify every > 1 is not compatible with this kspace style
+
+KSpace styles of the USER-OMP package and styles that compute
+torques on dipoles cannot apply their forces every N timesteps.
+
 W: No fixes defined, atoms won't move
 
 If you are not using a fix like nve, nvt, npt then atom velocities and
 coordinates will not be updated during timestepping.
 
+W: Comm_modify overlap not used with this pair style or fixes
+
+Overlap of communication with pair computation requires a pairwise
+pair style that uses a single standard neighbor list and does no
+communication of its own, and no fixes that act before the pair
+forces are computed.  The run proceeds without overlap.
+
 */
@@ -61,10 +61,33 @@ enum{VERSION,SMALLINT,TAGINT,BIGINT,
      MULTIPROC,MPIIO,PROCSPERFILE,PERPROC,
      IMAGEINT,BOUNDMIN,TIMESTEP,
      ATOM_ID,ATOM_MAP_STYLE,ATOM_MAP_USER,ATOM_SORTFREQ,ATOM_SORTBIN,
-     COMM_MODE,COMM_CUTOFF,COMM_VEL};
+     COMM_MODE,COMM_CUTOFF,COMM_VEL,SNAPSHOT};
+
+// snapshot format, same as read_restart.cpp
+
+#define SNAP_VERSION 1
+#define SNAP_ALIGN 4096           // per-field arrays start on page boundary
+#define SNAP_NAME 16
+
+enum{SNAP_INT,SNAP_TAGINT,SNAP_IMAGEINT,SNAP_BIGINT,SNAP_DOUBLE};
+
+struct SnapField {
+  char name[SNAP_NAME];           // field name, e.g. "x"
+  int datatype;                   // SNAP_INT, SNAP_DOUBLE, etc
+  int width;                      // values per atom, 0 = variable
+  bigint offset;                  // file offset of array for all atoms
+};
+
+struct SnapSection {
+  bigint firstatom,natom;         // atoms written by one proc
+  bigint firstrecord,nrecord;     // their restart records, in doubles
+  double bbox[6];                 // bounding box of atoms, lamda if triclinic
+};
 
 enum{IGNORE,WARN,ERROR};                    // same as thermo.cpp
 
+#define BIG 1.0e20
+
 /* ---------------------------------------------------------------------- */
 
 WriteRestart::WriteRestart(LAMMPS *lmp) : Pointers(lmp)
@@ -103,11 +126,13 @@ void WriteRestart::command(int narg, char **arg)
   else multiproc = 0;
   if (strstr(arg[0],".mpiio")) mpiioflag = 1;
   else mpiioflag = 0;
+  if (strstr(arg[0],".snap")) snapflag = 1;
+  else snapflag = 0;
 
   // setup output style and process optional args
   // also called by Output class for periodic restart files
 
-  multiproc_options(multiproc,mpiioflag,narg-1,&arg[1]);
+  multiproc_options(multiproc,mpiioflag,snapflag,narg-1,&arg[1]);
 
   // init entire system since comm->exchange is done
   // comm::init needs neighbor::init needs pair::init needs kspace::init, etc
@@ -146,16 +171,20 @@ void WriteRestart::command(int narg, char **arg)
 /* ---------------------------------------------------------------------- */
 
 void WriteRestart::multiproc_options(int multiproc_caller, int mpiioflag_caller,
-                                     int narg, char **arg)
+                                     int snapflag_caller, int narg, char **arg)
 {
   multiproc = multiproc_caller;
   mpiioflag = mpiioflag_caller;
+  snapflag = snapflag_caller;
 
   // error checks
 
   if (multiproc && mpiioflag)
     error->all(FLERR,
                "Restart file MPI-IO output not allowed with % in filename");
+  if (snapflag && (multiproc || mpiioflag))
+    error->all(FLERR,"Restart file snapshot output not allowed "
+               "with % in filename or MPI-IO");
 
   if (mpiioflag) {
     mpiio = new RestartMPIIO(lmp);
@@ -394,9 +423,13 @@ void WriteRestart::write(char *file)
     }
   }
 
+  // snapshot output to single file, each proc writes its own sections
+
+  if (snapflag) write_snapshot(file,send_size,buf);
+
   // MPI-IO output to single file
 
-  if (mpiioflag) {
+  else if (mpiioflag) {
     if (me == 0 && fp) {
       fclose(fp);
       fp = NULL;
@@ -588,6 +621,7 @@ void WriteRestart::file_layout(int send_size)
   if (me == 0) {
     write_int(MULTIPROC,multiproc);
     write_int(MPIIO,mpiioflag);
+    write_int(SNAPSHOT,snapflag);
   }
 
   if (mpiioflag) {
@@ -612,6 +646,222 @@ void WriteRestart::file_layout(int send_size)
     if (me == 0) headerOffset = ftell(fp);
     MPI_Bcast(&headerOffset,1,MPI_LMP_BIGINT,0,world);
   }
+
+  // if snapshot file, table of contents follows the header
+
+  if (snapflag) {
+    if (me == 0) snapOffset = ftell(fp);
+    MPI_Bcast(&snapOffset,1,MPI_LMP_BIGINT,0,world);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   write per-atom info as a snapshot with random-access layout
+   proc 0 writes table of contents = list of fields and list of sections
+   each field is a contiguous array over all atoms, at page-aligned offset
+   one section per proc = its range of atoms in every per-atom array
+     and of restart records, plus bounding box of its atoms
+   restart records are the same as in a native file and are what is read
+     back, other fields allow reading procs and tools to select atoms
+     without parsing records
+   after proc 0 writes table of contents, all procs write their sections
+------------------------------------------------------------------------- */
+
+void WriteRestart::write_snapshot(char *file, int send_size, double *buf)
+{
+  int i,m;
+
+  int nlocal = atom->nlocal;
+  int triclinic = domain->triclinic;
+
+  // x = coords from restart records, may have been remapped via PBC
+  // roffset = offset of each restart record within my section
+
+  double **xsnap;
+  bigint *roffset;
+  memory->create(xsnap,nlocal,3,"write_restart:xsnap");
+  memory->create(roffset,nlocal,"write_restart:roffset");
+
+  double bbox[6];
+  bbox[0] = bbox[2] = bbox[4] = BIG;
+  bbox[1] = bbox[3] = bbox[5] = -BIG;
+  double lamda[3],*coord;
+
+  m = 0;
+  for (i = 0; i < nlocal; i++) {
+    roffset[i] = m;
+    xsnap[i][0] = buf[m+1];
+    xsnap[i][1] = buf[m+2];
+    xsnap[i][2] = buf[m+3];
+    if (triclinic) {
+      domain->x2lamda(xsnap[i],lamda);
+      coord = lamda;
+    } else coord = xsnap[i];
+    bbox[0] = MIN(bbox[0],coord[0]);
+    bbox[1] = MAX(bbox[1],coord[0]);
+    bbox[2] = MIN(bbox[2],coord[1]);
+    bbox[3] = MAX(bbox[3],coord[1]);
+    bbox[4] = MIN(bbox[4],coord[2]);
+    bbox[5] = MAX(bbox[5],coord[2]);
+    m += static_cast<int> (buf[m]);
+  }
+
+  // all procs learn all sections
+
+  SnapSection *sections = new SnapSection[nprocs];
+
+  bigint counts[2],*allcounts;
+  double *allbbox;
+  counts[0] = nlocal;
+  counts[1] = send_size;
+  memory->create(allcounts,2*nprocs,"write_restart:allcounts");
+  memory->create(allbbox,6*nprocs,"write_restart:allbbox");
+  MPI_Allgather(counts,2,MPI_LMP_BIGINT,allcounts,2,MPI_LMP_BIGINT,world);
+  MPI_Allgather(bbox,6,MPI_DOUBLE,allbbox,6,MPI_DOUBLE,world);
+
+  bigint natom = 0;
+  bigint nrecord = 0;
+  for (int iproc = 0; iproc < nprocs; iproc++) {
+    sections[iproc].firstatom = natom;
+    sections[iproc].natom = allcounts[2*iproc];
+    sections[iproc].firstrecord = nrecord;
+    sections[iproc].nrecord = allcounts[2*iproc+1];
+    for (m = 0; m < 6; m++) sections[iproc].bbox[m] = allbbox[6*iproc+m];
+    natom += allcounts[2*iproc];
+    nrecord += allcounts[2*iproc+1];
+  }
+
+  memory->destroy(allcounts);
+  memory->destroy(allbbox);
+
+  for (i = 0; i < nlocal; i++) roffset[i] += sections[me].firstrecord;
+
+  // list of fields and pointers to my data for each
+  // customize by adding a field, reader only requires x,roffset,restart
+
+  int nfield = 0;
+  SnapField fields[10];
+  void *ptrs[10];
+  int sizes[10];
+
+  strcpy(fields[nfield].name,"tag");
+  fields[nfield].datatype = SNAP_TAGINT;
+  fields[nfield].width = 1;
+  sizes[nfield] = sizeof(tagint);
+  ptrs[nfield++] = atom->tag;
+
+  strcpy(fields[nfield].name,"type");
+  fields[nfield].datatype = SNAP_INT;
+  fields[nfield].width = 1;
+  sizes[nfield] = sizeof(int);
+  ptrs[nfield++] = atom->type;
+
+  strcpy(fields[nfield].name,"image");
+  fields[nfield].datatype = SNAP_IMAGEINT;
+  fields[nfield].width = 1;
+  sizes[nfield] = sizeof(imageint);
+  ptrs[nfield++] = atom->image;
+
+  strcpy(fields[nfield].name,"x");
+  fields[nfield].datatype = SNAP_DOUBLE;
+  fields[nfield].width = 3;
+  sizes[nfield] = 3*sizeof(double);
+  ptrs[nfield++] = nlocal ? &xsnap[0][0] : NULL;
+
+  strcpy(fields[nfield].name,"v");
+  fields[nfield].datatype = SNAP_DOUBLE;
+  fields[nfield].width = 3;
+  sizes[nfield] = 3*sizeof(double);
+  ptrs[nfield++] = nlocal ? &atom->v[0][0] : NULL;
+
+  if (atom->q_flag) {
+    strcpy(fields[nfield].name,"q");
+    fields[nfield].datatype = SNAP_DOUBLE;
+    fields[nfield].width = 1;
+    sizes[nfield] = sizeof(double);
+    ptrs[nfield++] = atom->q;
+  }
+
+  if (atom->molecule_flag) {
+    strcpy(fields[nfield].name,"molecule");
+    fields[nfield].datatype = SNAP_TAGINT;
+    fields[nfield].width = 1;
+    sizes[nfield] = sizeof(tagint);
+    ptrs[nfield++] = atom->molecule;
+  }
+
+  strcpy(fields[nfield].name,"roffset");
+  fields[nfield].datatype = SNAP_BIGINT;
+  fields[nfield].width = 1;
+  sizes[nfield] = sizeof(bigint);
+  ptrs[nfield++] = roffset;
+
+  // restart records include topology and any fix info stored with atoms
+
+  strcpy(fields[nfield].name,"restart");
+  fields[nfield].datatype = SNAP_DOUBLE;
+  fields[nfield].width = 0;
+  sizes[nfield] = sizeof(double);
+  ptrs[nfield++] = buf;
+
+  // page-aligned file offset of each field, following table of contents
+
+  bigint offset = snapOffset + 3*sizeof(int) + 2*sizeof(bigint) +
+    nfield*sizeof(SnapField) + nprocs*sizeof(SnapSection);
+
+  for (i = 0; i < nfield; i++) {
+    offset = (offset + SNAP_ALIGN - 1) / SNAP_ALIGN * SNAP_ALIGN;
+    fields[i].offset = offset;
+    if (fields[i].width) offset += natom*sizes[i];
+    else offset += nrecord*sizes[i];
+  }
+
+  // proc 0 writes table of contents and closes file
+
+  if (me == 0) {
+    int header[3];
+    header[0] = SNAP_VERSION;
+    header[1] = nfield;
+    header[2] = nprocs;
+    fwrite(header,sizeof(int),3,fp);
+    fwrite(&natom,sizeof(bigint),1,fp);
+    fwrite(&nrecord,sizeof(bigint),1,fp);
+    fwrite(fields,sizeof(SnapField),nfield,fp);
+    fwrite(sections,sizeof(SnapSection),nprocs,fp);
+    fclose(fp);
+    fp = NULL;
+  }
+
+  MPI_Barrier(world);
+
+  // each proc writes its section of every field
+
+  if (nlocal) {
+    fp = fopen(file,"r+b");
+    if (fp == NULL) {
+      char str[128];
+      sprintf(str,"Cannot open restart file %s",file);
+      error->one(FLERR,str);
+    }
+
+    for (i = 0; i < nfield; i++) {
+      if (fields[i].width) {
+        fseek(fp,fields[i].offset + sections[me].firstatom*sizes[i],SEEK_SET);
+        fwrite(ptrs[i],sizes[i],nlocal,fp);
+      } else {
+        fseek(fp,fields[i].offset + sections[me].firstrecord*sizes[i],
+              SEEK_SET);
+        fwrite(ptrs[i],sizes[i],send_size,fp);
+      }
+    }
+
+    fclose(fp);
+    fp = NULL;
+  }
+
+  delete [] sections;
+  memory->destroy(xsnap);
+  memory->destroy(roffset);
 }
 
 // ----------------------------------------------------------------------
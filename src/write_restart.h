@@ -29,7 +29,7 @@ class WriteRestart : protected Pointers {
  public:
   WriteRestart(class LAMMPS *);
   void command(int, char **);
-  void multiproc_options(int, int, int, char **);
+  void multiproc_options(int, int, int, int, char **);
   void write(char *);
 
  private:
@@ -51,10 +51,16 @@ class WriteRestart : protected Pointers {
   class RestartMPIIO *mpiio;   // MPIIO for restart file output
   MPI_Offset headerOffset;
 
+  // snapshot values
+
+  int snapflag;                // 1 for snapshot output, else 0
+  bigint snapOffset;           // file offset of snapshot table of contents
+
   void header();
   void type_arrays();
   void force_fields();
   void file_layout(int);
+  void write_snapshot(char *, int, double *);
 
   void magic_string();
   void endian();
@@ -95,6 +101,11 @@ E: Writing to MPI-IO filename when MPIIO package is not installed
 
 Self-explanatory.
 
+E: Restart file snapshot output not allowed with % in filename or MPI-IO
+
+A snapshot file is a single file with its own per-processor layout,
+so it cannot also be a multi-file or MPI-IO restart file.
+
 E: Cannot use write_restart fileper without % in restart file name
 
 Self-explanatory.
@@ -0,0 +1,187 @@
+#!/usr/bin/env python
+
+# Script:  dumpcolumn.py
+# Purpose: extract columns and frames from a dump custom/column file
+# Syntax:  dumpcolumn.py file [-f first last] [-c col1 col2 ...] [-o outfile]
+#          file = dump custom/column file written by LAMMPS
+#          -f first last = only frames with first <= timestep <= last
+#          -c col1 col2 ... = only these columns, e.g. id x y z
+#          -o outfile = write native LAMMPS dump text format to outfile
+#                       else print a summary of frames and columns
+# Author:  LAMMPS developers
+
+# file layout, all values in native byte order:
+#   sequence of blocks, each = 8-char magic, int64 # of bytes that follow
+#   LMPCOLHD = version, ncol, ntypes, datatype of each column
+#              (1 = int32, 2 = int64, 3 = float, 4 = double),
+#              column names as one string, element name of each type
+#   LMPCOLFR = timestep, natoms, triclinic, boundary[6], box[9],
+#              ncol, chunksize, nchunk, 0, then a directory entry
+#              (offset from block start, nbytes, natoms, codec) for
+#              each chunk, ordered by column then chunk, then the chunks
+#   LMPCOLIX = nframes, timestep of each frame, offset of each frame,
+#              then offset of this block and "LMPCOLEN" as last 16 bytes
+#   codec bits = 1 delta of integers, 2 byte shuffle, 4 zlib
+#
+# only the requested chunks are read from the file,
+# using the INDEX block at the end of the file if it exists,
+# else by scanning the blocks from the start of the file
+
+import sys, struct, zlib
+
+CODEC_DELTA = 1
+CODEC_SHUFFLE = 2
+CODEC_ZLIB = 4
+
+# datatype code -> (struct char, width)
+
+COLTYPE = {1: ("i", 4), 2: ("q", 8), 3: ("f", 4), 4: ("d", 8)}
+
+class DumpColumn:
+  def __init__(self, filename):
+    self.f = open(filename, "rb")
+    self.header = None
+    self.frames = []                  # list of (timestep, offset)
+    if not self.read_index(): self.scan()
+
+  # read one block header at offset, return (magic, nbytes)
+
+  def block(self, offset):
+    self.f.seek(offset)
+    buf = self.f.read(16)
+    if len(buf) < 16: return None, 0
+    return buf[:8], struct.unpack("q", buf[8:])[0]
+
+  # find INDEX block from END trailer at end of file
+
+  def read_index(self):
+    self.f.seek(0, 2)
+    if self.f.tell() < 16: return False
+    self.f.seek(-16, 2)
+    buf = self.f.read(16)
+    if buf[8:] != b"LMPCOLEN": return False
+    offset = struct.unpack("q", buf[:8])[0]
+    self.f.seek(offset + 16)
+    n = struct.unpack("q", self.f.read(8))[0]
+    steps = struct.unpack("%dq" % n, self.f.read(8*n))
+    offsets = struct.unpack("%dq" % n, self.f.read(8*n))
+    self.frames = list(zip(steps, offsets))
+    self.read_header(0)
+    return True
+
+  # walk all blocks, needed if INDEX block is missing, e.g. after a crash
+
+  def scan(self):
+    offset = 0
+    while True:
+      magic, nbytes = self.block(offset)
+      if magic is None: break
+      if magic == b"LMPCOLHD" and self.header is None: self.read_header(offset)
+      elif magic == b"LMPCOLFR":
+        step = struct.unpack("q", self.f.read(8))[0]
+        self.frames.append((step, offset))
+      offset += 16 + nbytes
+
+  def read_header(self, offset):
+    magic, nbytes = self.block(offset)
+    version, ncol, ntypes = struct.unpack("3i", self.f.read(12))
+    coltype = struct.unpack("%di" % ncol, self.f.read(4*ncol))
+    n = struct.unpack("i", self.f.read(4))[0]
+    names = self.f.read(n).rstrip(b"\0").decode().split()
+    typenames = []
+    for i in range(ntypes):
+      n = struct.unpack("i", self.f.read(4))[0]
+      typenames.append(self.f.read(n).rstrip(b"\0").decode())
+    self.header = dict(version=version, coltype=coltype, names=names,
+                       typenames=typenames)
+
+  # read frame info and requested columns of one frame
+
+  def read_frame(self, offset, columns):
+    self.f.seek(offset + 16)
+    step, natoms = struct.unpack("2q", self.f.read(16))
+    triclinic = struct.unpack("i", self.f.read(4))[0]
+    boundary = struct.unpack("6i", self.f.read(24))
+    box = struct.unpack("9d", self.f.read(72))
+    ncol, chunksize, nchunk, pad = struct.unpack("4i", self.f.read(16))
+    directory = []
+    for i in range(ncol*nchunk):
+      directory.append(struct.unpack("2q2i", self.f.read(24)))
+
+    data = {}
+    for name in columns:
+      icol = self.header["names"].index(name)
+      values = []
+      for ichunk in range(nchunk):
+        off, nbytes, n, codec = directory[icol*nchunk + ichunk]
+        self.f.seek(offset + off)
+        values.extend(self.decode(self.f.read(nbytes), n, codec,
+                                  self.header["coltype"][icol]))
+      data[name] = values
+    return dict(step=step, natoms=natoms, triclinic=triclinic,
+                boundary=boundary, box=box, data=data)
+
+  def decode(self, buf, n, codec, coltype):
+    fmt, width = COLTYPE[coltype]
+    if codec & CODEC_ZLIB: buf = zlib.decompress(buf)
+    if codec & CODEC_SHUFFLE:
+      raw = bytearray(n*width)
+      for j in range(width): raw[j::width] = buf[j*n:(j+1)*n]
+      buf = bytes(raw)
+    values = list(struct.unpack("%d%s" % (n, fmt), buf))
+    if codec & CODEC_DELTA:
+      mask = (1 << (8*width)) - 1
+      half = 1 << (8*width - 1)
+      total = 0
+      for i in range(n):
+        total = (total + values[i]) & mask
+        values[i] = total - (mask + 1) if total >= half else total
+    return values
+
+# write frames in native dump text format
+
+def write_text(out, frame, columns):
+  out.write("ITEM: TIMESTEP\n%d\n" % frame["step"])
+  out.write("ITEM: NUMBER OF ATOMS\n%d\n" % frame["natoms"])
+  box = frame["box"]
+  if frame["triclinic"]:
+    out.write("ITEM: BOX BOUNDS xy xz yz\n")
+    for i in range(3):
+      out.write("%-1.16e %-1.16e %-1.16e\n" % (box[2*i], box[2*i+1], box[6+i]))
+  else:
+    out.write("ITEM: BOX BOUNDS\n")
+    for i in range(3):
+      out.write("%-1.16e %-1.16e\n" % (box[2*i], box[2*i+1]))
+  out.write("ITEM: ATOMS %s\n" % " ".join(columns))
+  data = [frame["data"][name] for name in columns]
+  for i in range(frame["natoms"]):
+    out.write(" ".join([str(v[i]) for v in data]) + "\n")
+
+if __name__ == "__main__":
+  args = sys.argv[1:]
+  if not args:
+    sys.exit("Syntax: dumpcolumn.py file [-f first last] [-c col ...] " +
+             "[-o outfile]")
+  d = DumpColumn(args.pop(0))
+  first, last, columns, outfile = None, None, d.header["names"], None
+  while args:
+    arg = args.pop(0)
+    if arg == "-f":
+      first, last = int(args.pop(0)), int(args.pop(0))
+    elif arg == "-c":
+      columns = []
+      while args and args[0][0] != "-": columns.append(args.pop(0))
+    elif arg == "-o":
+      outfile = args.pop(0)
+    else: sys.exit("Unknown argument %s" % arg)
+
+  frames = [fr for fr in d.frames
+            if first is None or first <= fr[0] <= last]
+  if outfile is None:
+    print("%d frames, columns: %s" % (len(frames), " ".join(d.header["names"])))
+    for step, offset in frames: print("timestep %d at offset %d" % (step, offset))
+  else:
+    out = open(outfile, "w")
+    for step, offset in frames:
+      write_text(out, d.read_frame(offset, columns), columns)
+    out.close()